@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QApplication>
+#include <QScopedPointer>
+#include <QTemporaryFile>
+#include <QXmlStreamWriter>
+#include <QtConcurrent/QtConcurrent>
+#include <QtTest/QtTest>
+#include <Mlt.h>
+
+#include "dataqueue.h"
+#include "mltcontroller.h"
+#include "mltxmlchecker.h"
+#include "models/multitrackmodel.h"
+#include "qmltypes/thumbnailprovider.h"
+#include "sharedframe.h"
+
+static const int kContentionItems = 10000;
+static const int kBulkClips = 50;
+static const int kXmlProducers = 500;
+
+//! SharedFrame clone and image conversion, the cost of handing a frame to
+//! another thread and of the scope widgets' format changes.
+class SharedFrameBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        Mlt::Producer producer(MLT.profile(), "color:red");
+        QVERIFY(producer.is_valid());
+        m_producer.reset(new Mlt::Producer(producer));
+        QScopedPointer<Mlt::Frame> frame(producer.get_frame());
+        QVERIFY(frame && frame->is_valid());
+        mlt_image_format format = mlt_image_yuv422;
+        int width = MLT.profile().width();
+        int height = MLT.profile().height();
+        frame->get_image(format, width, height);
+        m_frame = SharedFrame(*frame);
+        QVERIFY(m_frame.is_valid());
+    }
+
+    void clone()
+    {
+        QBENCHMARK {
+            Mlt::Frame copy = m_frame.clone(false, true, false);
+            Q_UNUSED(copy)
+        }
+    }
+
+    void convert()
+    {
+        QBENCHMARK {
+            // Clone first so each iteration converts instead of reading
+            // the conversion cached on the frame.
+            Mlt::Frame copy = m_frame.clone(false, true, false);
+            SharedFrame shared(copy);
+            shared.get_image(mlt_image_rgb24);
+        }
+    }
+
+private:
+    QScopedPointer<Mlt::Producer> m_producer;
+    SharedFrame m_frame;
+};
+
+//! Queue throughput alone and with a producer and consumer thread
+//! contending, the consumer-to-scope arrangement.
+class DataQueueBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pushPop()
+    {
+        DataQueue<SharedFrame> queue(25, DataQueue<SharedFrame>::OverflowModeDiscardOldest);
+        SharedFrame frame;
+        QBENCHMARK {
+            queue.push(frame);
+            queue.pop();
+        }
+    }
+
+    void contention()
+    {
+        SharedFrame frame;
+        QBENCHMARK {
+            DataQueue<SharedFrame> queue(25, DataQueue<SharedFrame>::OverflowModeDiscardOldest);
+            QFuture<void> producer = QtConcurrent::run([&queue, frame] {
+                for (int i = 0; i < kContentionItems; i++)
+                    queue.push(frame);
+            });
+            while (!producer.isFinished() || queue.count() > 0) {
+                if (queue.count() > 0)
+                    queue.pop();
+            }
+        }
+    }
+
+    void spscContention()
+    {
+        SharedFrame frame;
+        QBENCHMARK {
+            SpscDataQueue<SharedFrame> queue(25, SpscDataQueue<SharedFrame>::OverflowModeDiscardOldest);
+            QFuture<void> producer = QtConcurrent::run([&queue, frame] {
+                for (int i = 0; i < kContentionItems; i++)
+                    queue.push(frame);
+            });
+            while (!producer.isFinished() || queue.count() > 0) {
+                if (queue.count() > 0)
+                    queue.pop();
+            }
+        }
+    }
+};
+
+//! Appending a batch of clips and trimming each one, the shape of a large
+//! paste or a scripted bulk edit.
+class MultitrackModelBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void bulkEdits()
+    {
+        Mlt::Producer clip(MLT.profile(), "color:green");
+        QVERIFY(clip.is_valid());
+        QBENCHMARK {
+            MultitrackModel model;
+            QVERIFY(model.createIfNeeded());
+            int track = model.addVideoTrack();
+            for (int i = 0; i < kBulkClips; i++) {
+                clip.set_in_and_out(0, 99);
+                model.appendClip(track, clip);
+            }
+            for (int i = 0; i < kBulkClips; i++)
+                model.trimClipOut(track, i, 10, false, false);
+            model.close();
+        }
+    }
+};
+
+//! The full thumbnail request: cache key, render on the task pool, and
+//! scaling. The trailing '!' forces a render so the database cache does
+//! not short-circuit the iterations.
+class ThumbnailProviderBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void requestImage()
+    {
+        ThumbnailProvider provider;
+        QSize size;
+        QBENCHMARK {
+            provider.requestImage(QString("/color/red#%1!").arg(m_frameNumber++ % 100),
+                                  &size, QSize(80, 45));
+        }
+    }
+
+private:
+    int m_frameNumber{0};
+};
+
+//! Parse-and-rewrite throughput of project load validation over a
+//! generated document with many producers and playlist entries.
+class MltXmlCheckerBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_file.open());
+        QXmlStreamWriter xml(&m_file);
+        xml.setAutoFormatting(true);
+        xml.writeStartDocument();
+        xml.writeStartElement("mlt");
+        xml.writeAttribute("version", "6.20.0");
+        for (int i = 0; i < kXmlProducers; i++) {
+            xml.writeStartElement("producer");
+            xml.writeAttribute("id", QString("producer%1").arg(i));
+            writeProperty(xml, "mlt_service", "color");
+            writeProperty(xml, "resource", "red");
+            writeProperty(xml, "length", "100");
+            writeProperty(xml, "in", "0");
+            writeProperty(xml, "out", "99");
+            xml.writeEndElement();
+        }
+        xml.writeStartElement("playlist");
+        xml.writeAttribute("id", "main_bin");
+        for (int i = 0; i < kXmlProducers; i++) {
+            xml.writeStartElement("entry");
+            xml.writeAttribute("producer", QString("producer%1").arg(i));
+            xml.writeAttribute("in", "0");
+            xml.writeAttribute("out", "99");
+            xml.writeEndElement();
+        }
+        xml.writeEndElement();
+        xml.writeEndElement();
+        xml.writeEndDocument();
+        m_file.close();
+    }
+
+    void check()
+    {
+        QBENCHMARK {
+            MltXmlChecker checker;
+            QVERIFY(checker.check(m_file.fileName()));
+        }
+    }
+
+private:
+    void writeProperty(QXmlStreamWriter& xml, const QString& name, const QString& value)
+    {
+        xml.writeStartElement("property");
+        xml.writeAttribute("name", name);
+        xml.writeCharacters(value);
+        xml.writeEndElement();
+    }
+
+    QTemporaryFile m_file;
+};
+
+int main(int argc, char** argv)
+{
+    QApplication app(argc, argv);
+    // A distinct application name keeps the benchmarks' settings and
+    // database out of the real installation's.
+    QCoreApplication::setOrganizationName("Meltytech");
+    QCoreApplication::setOrganizationDomain("meltytech.com");
+    QCoreApplication::setApplicationName("Shotcut Benchmarks");
+    // Initialize the MLT factory and the profile the suites share.
+    Mlt::Controller::singleton();
+
+    int status = 0;
+    {
+        SharedFrameBenchmark bench;
+        status |= QTest::qExec(&bench, argc, argv);
+    }
+    {
+        DataQueueBenchmark bench;
+        status |= QTest::qExec(&bench, argc, argv);
+    }
+    {
+        MultitrackModelBenchmark bench;
+        status |= QTest::qExec(&bench, argc, argv);
+    }
+    {
+        ThumbnailProviderBenchmark bench;
+        status |= QTest::qExec(&bench, argc, argv);
+    }
+    {
+        MltXmlCheckerBenchmark bench;
+        status |= QTest::qExec(&bench, argc, argv);
+    }
+    return status;
+}
+
+#include "benchmarks.moc"
@@ -0,0 +1,32 @@
+# Microbenchmarks over the application's hot paths using Qt Test's
+# QBENCHMARK, for regression numbers per release. Build with
+# 'qmake CONFIG+=benchmarks' at the top level (or run qmake here), then
+# run headless with:
+#
+#     benchmarks -platform offscreen
+#
+# The application's project file supplies the Qt modules, sources, and
+# MLT configuration; VPATH resolves its relative file names from here.
+include(../src/src.pro)
+
+TEMPLATE = app
+TARGET = benchmarks
+CONFIG += console
+mac {
+    CONFIG -= app_bundle
+    ICON =
+    QMAKE_INFO_PLIST =
+}
+win32:RC_FILE =
+QT += testlib
+
+VPATH += $$PWD/../src
+INCLUDEPATH += $$PWD/../src
+DEPENDPATH += $$PWD/../src
+
+# The benchmark runner provides main().
+SOURCES -= main.cpp
+SOURCES += benchmarks.cpp
+
+# Not an installable artifact.
+INSTALLS =
@@ -10,6 +10,12 @@ SUBDIRS = CuteLogger src translations
 cache()
 src.depends = CuteLogger
 
+# Opt-in microbenchmark suite: qmake CONFIG+=benchmarks
+benchmarks {
+    SUBDIRS += benchmarks
+    benchmarks.depends = CuteLogger
+}
+
 codespell.target = codespell
 codespell.commands = codespell -w -q 3 \
     -L shotcut,uint,seeked \
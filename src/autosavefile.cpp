@@ -26,6 +26,11 @@
 
 static const QLatin1String subdir("/autosave");
 static const QLatin1String extension(".mlt");
+// Older snapshots are kept as "<name>.mlt.1" (newest) through ".3" so a bad
+// save or project corruption leaves something to go back to, bounded in
+// both count and total size.
+static const int kGenerations = 3;
+static const qint64 kGenerationsSizeBudget = 256 * 1024 * 1024; // 256 MiB
 
 static QString hashName(const QString &name)
 {
@@ -41,18 +46,56 @@ AutoSaveFile::AutoSaveFile(const QString &filename, QObject *parent)
 
 AutoSaveFile::~AutoSaveFile()
 {
-    if (!fileName().isEmpty())
+    if (!fileName().isEmpty()) {
         remove();
+        removeGenerations();
+    }
 }
 
 void AutoSaveFile::changeManagedFile(const QString &filename)
 {
-    if (!fileName().isEmpty())
+    if (!fileName().isEmpty()) {
         remove();
+        removeGenerations();
+    }
     m_managedFile = filename;
     m_managedFileNameChanged = true;
 }
 
+void AutoSaveFile::rotate()
+{
+    if (fileName().isEmpty() || !QFile::exists(fileName()))
+        return;
+    QFile::remove(generationName(kGenerations));
+    for (int i = kGenerations - 1; i >= 1; i--) {
+        if (QFile::exists(generationName(i)))
+            QFile::rename(generationName(i), generationName(i + 1));
+    }
+    QFile::rename(fileName(), generationName(1));
+    // Drop the oldest generations until within the size budget.
+    qint64 total = 0;
+    for (int i = 1; i <= kGenerations; i++)
+        total += QFileInfo(generationName(i)).size();
+    for (int i = kGenerations; i >= 1 && total > kGenerationsSizeBudget; i--) {
+        QFileInfo info(generationName(i));
+        if (info.exists()) {
+            total -= info.size();
+            QFile::remove(generationName(i));
+        }
+    }
+}
+
+QString AutoSaveFile::generationName(int generation) const
+{
+    return fileName() + QChar::fromLatin1('.') + QString::number(generation);
+}
+
+void AutoSaveFile::removeGenerations()
+{
+    for (int i = 1; i <= kGenerations; i++)
+        QFile::remove(generationName(i));
+}
+
 bool AutoSaveFile::open(OpenMode openmode)
 {
     QString tempFile;
@@ -35,11 +35,16 @@ public:
     void changeManagedFile(const QString &filename);
 
     virtual bool open(OpenMode openmode);
+    /// Turns the current file into the newest retained generation, making
+    /// room for a replacement, and prunes old generations to the budget.
+    void rotate();
     static AutoSaveFile* getFile(const QString &filename);
     static QString path();
 
 private:
     Q_DISABLE_COPY(AutoSaveFile)
+    QString generationName(int generation) const;
+    void removeGenerations();
     QString m_managedFile;
     bool m_managedFileNameChanged;
 };
@@ -42,6 +42,7 @@ AppendCommand::AppendCommand(MultitrackModel &model, int trackIndex, const QStri
     , m_undoHelper(m_model)
 {
     setText(QObject::tr("Append to track"));
+    m_undoHelper.setScopeTracks({m_trackIndex});
 }
 
 void AppendCommand::redo()
@@ -88,6 +89,9 @@ InsertCommand::InsertCommand(MultitrackModel &model, int trackIndex,
     , m_rippleAllTracks(Settings.timelineRippleAllTracks())
 {
     setText(QObject::tr("Insert into track"));
+    // Rippling other tracks only moves clips and resizes blanks, neither
+    // of which needs stored XML to undo.
+    m_undoHelper.setScopeTracks({m_trackIndex});
 }
 
 void InsertCommand::redo()
@@ -132,6 +136,7 @@ OverwriteCommand::OverwriteCommand(MultitrackModel &model, int trackIndex,
     , m_seek(seek)
 {
     setText(QObject::tr("Overwrite onto track"));
+    m_undoHelper.setScopeTracks({m_trackIndex});
 }
 
 void OverwriteCommand::redo()
@@ -176,6 +181,7 @@ LiftCommand::LiftCommand(MultitrackModel &model, int trackIndex,
 {
     setText(QObject::tr("Lift from track"));
     m_undoHelper.setHints(UndoHelper::RestoreTracks);
+    m_undoHelper.setScopeTracks({m_trackIndex});
 }
 
 void LiftCommand::redo()
@@ -203,23 +209,148 @@ RemoveCommand::RemoveCommand(MultitrackModel &model, int trackIndex,
 {
     setText(QObject::tr("Remove from track"));
     m_undoHelper.setHints(UndoHelper::RestoreTracks);
+    // With ripple-all-tracks the affected set can span every track, so
+    // only a single-track remove may narrow the captured state.
+    if (!m_rippleAllTracks)
+        m_undoHelper.setScopeTracks({m_trackIndex});
 }
 
 void RemoveCommand::redo()
 {
     LOG_DEBUG() << "trackIndex" << m_trackIndex << "clipIndex" << m_clipIndex;
     m_undoHelper.recordBeforeState();
+    // Rippling every track emits a signal stream per track; batch it
+    // into one re-layout.
+    if (m_rippleAllTracks)
+        m_model.beginMacroEdit();
     m_model.removeClip(m_trackIndex, m_clipIndex, m_rippleAllTracks);
+    if (m_rippleAllTracks)
+        m_model.endMacroEdit();
     m_undoHelper.recordAfterState();
 }
 
 void RemoveCommand::undo()
 {
     LOG_DEBUG() << "trackIndex" << m_trackIndex << "clipIndex" << m_clipIndex;
+    if (m_rippleAllTracks)
+        m_model.beginMacroEdit();
     m_undoHelper.undoChanges();
+    if (m_rippleAllTracks)
+        m_model.endMacroEdit();
 }
 
 
+RemoveListCommand::RemoveListCommand(MultitrackModel &model,
+    const QVector<QUuid> &uuids, QUndoCommand *parent)
+    : QUndoCommand(parent)
+    , m_model(model)
+    , m_uuids(uuids)
+    , m_undoHelper(m_model)
+    , m_rippleAllTracks(Settings.timelineRippleAllTracks())
+{
+    setText(QObject::tr("Remove %1 from timeline").arg(m_uuids.size()));
+    m_undoHelper.setHints(UndoHelper::RestoreTracks);
+}
+
+void RemoveListCommand::redo()
+{
+    LOG_DEBUG() << "clips" << m_uuids.size();
+    m_undoHelper.recordBeforeState();
+    m_model.beginMacroEdit();
+    // Each removal shifts indices on its track; resolve every clip by UUID.
+    foreach (const QUuid& uuid, m_uuids) {
+        int trackIndex, clipIndex;
+        Mlt::ClipInfo* info = m_model.findClipByUuid(uuid, trackIndex, clipIndex);
+        if (info) {
+            delete info;
+            m_model.removeClip(trackIndex, clipIndex, m_rippleAllTracks);
+        }
+    }
+    m_model.endMacroEdit();
+    m_undoHelper.recordAfterState();
+}
+
+void RemoveListCommand::undo()
+{
+    LOG_DEBUG() << "clips" << m_uuids.size();
+    m_model.beginMacroEdit();
+    m_undoHelper.undoChanges();
+    m_model.endMacroEdit();
+}
+
+LiftListCommand::LiftListCommand(MultitrackModel &model,
+    const QVector<QUuid> &uuids, QUndoCommand *parent)
+    : QUndoCommand(parent)
+    , m_model(model)
+    , m_uuids(uuids)
+    , m_undoHelper(m_model)
+{
+    setText(QObject::tr("Lift %1 from timeline").arg(m_uuids.size()));
+    m_undoHelper.setHints(UndoHelper::RestoreTracks);
+}
+
+void LiftListCommand::redo()
+{
+    LOG_DEBUG() << "clips" << m_uuids.size();
+    m_undoHelper.recordBeforeState();
+    m_model.beginMacroEdit();
+    foreach (const QUuid& uuid, m_uuids) {
+        int trackIndex, clipIndex;
+        Mlt::ClipInfo* info = m_model.findClipByUuid(uuid, trackIndex, clipIndex);
+        if (info) {
+            delete info;
+            m_model.liftClip(trackIndex, clipIndex);
+        }
+    }
+    m_model.endMacroEdit();
+    m_undoHelper.recordAfterState();
+}
+
+void LiftListCommand::undo()
+{
+    LOG_DEBUG() << "clips" << m_uuids.size();
+    m_model.beginMacroEdit();
+    m_undoHelper.undoChanges();
+    m_model.endMacroEdit();
+}
+
+PasteFiltersListCommand::PasteFiltersListCommand(MultitrackModel &model,
+    const QVector<QUuid> &uuids, QUndoCommand *parent)
+    : QUndoCommand(parent)
+    , m_model(model)
+    , m_uuids(uuids)
+    , m_undoHelper(m_model)
+{
+    setText(QObject::tr("Paste filters to %1 clips").arg(m_uuids.size()));
+    m_undoHelper.setHints(UndoHelper::RestoreTracks);
+}
+
+void PasteFiltersListCommand::redo()
+{
+    LOG_DEBUG() << "clips" << m_uuids.size();
+    m_undoHelper.recordBeforeState();
+    m_model.beginMacroEdit();
+    foreach (const QUuid& uuid, m_uuids) {
+        int trackIndex, clipIndex;
+        QScopedPointer<Mlt::ClipInfo> info(m_model.findClipByUuid(uuid, trackIndex, clipIndex));
+        // Filters go on the cut so they stay scoped to this clip.
+        if (info && info->cut)
+            MLT.pasteFilters(info->cut);
+    }
+    m_model.endMacroEdit();
+    m_undoHelper.recordAfterState();
+    MLT.refreshConsumer();
+}
+
+void PasteFiltersListCommand::undo()
+{
+    LOG_DEBUG() << "clips" << m_uuids.size();
+    m_model.beginMacroEdit();
+    m_undoHelper.undoChanges();
+    m_model.endMacroEdit();
+    MLT.refreshConsumer();
+}
+
 NameTrackCommand::NameTrackCommand(MultitrackModel &model, int trackIndex,
     const QString &name, QUndoCommand *parent)
     : QUndoCommand(parent)
@@ -409,6 +540,11 @@ void MoveClipCommand::redo()
             return;
         }
     }
+    // A multi-clip move removes then re-adds every selected clip; batch
+    // the model notifications into one re-layout.
+    bool macro = m_selection.size() > 1;
+    if (macro)
+        m_model.beginMacroEdit();
     // First, remove each clip.
     for (auto& clip : m_selection) {
         if (!m_redo) {
@@ -449,6 +585,8 @@ void MoveClipCommand::redo()
                 m_model.overwrite(toTrack, clip, start, false);
         }
     }
+    if (macro)
+        m_model.endMacroEdit();
 
     if (!m_redo) {
         m_redo = true;
@@ -459,7 +597,12 @@ void MoveClipCommand::redo()
 void MoveClipCommand::undo()
 {
     LOG_DEBUG() << "track delta" << m_trackDelta;
+    bool macro = m_selection.size() > 1;
+    if (macro)
+        m_model.beginMacroEdit();
     m_undoHelper.undoChanges();
+    if (macro)
+        m_model.endMacroEdit();
 }
 
 TrimClipInCommand::TrimClipInCommand(MultitrackModel &model, int trackIndex, int clipIndex, int delta, bool ripple, bool redo, QUndoCommand* parent)
@@ -661,6 +804,12 @@ AddTransitionCommand::AddTransitionCommand(TimelineDock& timeline, int trackInde
     , m_rippleAllTracks(Settings.timelineRippleAllTracks())
 {
     setText(QObject::tr("Add transition"));
+    m_undoHelper.setHints(UndoHelper::RestoreTracks);
+    // Creating the cross-fade itself reuses the already-open cuts via
+    // playlist.mix(); the cost of this command is the state capture, so
+    // narrow it to the one mutated track when ripple cannot spread it.
+    if (!m_ripple && !m_rippleAllTracks)
+        m_undoHelper.setScopeTracks({m_trackIndex});
 }
 
 void AddTransitionCommand::redo()
@@ -114,6 +114,48 @@ private:
     bool m_rippleAllTracks;
 };
 
+/// Removes a whole selection in one command: a single UndoHelper state
+/// capture and one batched model transaction instead of one per clip.
+class RemoveListCommand : public QUndoCommand
+{
+public:
+    RemoveListCommand(MultitrackModel& model, const QVector<QUuid>& uuids, QUndoCommand * parent = 0);
+    void redo();
+    void undo();
+private:
+    MultitrackModel& m_model;
+    QVector<QUuid> m_uuids;
+    UndoHelper m_undoHelper;
+    bool m_rippleAllTracks;
+};
+
+class LiftListCommand : public QUndoCommand
+{
+public:
+    LiftListCommand(MultitrackModel& model, const QVector<QUuid>& uuids, QUndoCommand * parent = 0);
+    void redo();
+    void undo();
+private:
+    MultitrackModel& m_model;
+    QVector<QUuid> m_uuids;
+    UndoHelper m_undoHelper;
+};
+
+/// Pastes the copied filter set onto a whole selection in one command:
+/// a single UndoHelper state capture, one batched model transaction, and
+/// one consumer refresh instead of one of each per clip.
+class PasteFiltersListCommand : public QUndoCommand
+{
+public:
+    PasteFiltersListCommand(MultitrackModel& model, const QVector<QUuid>& uuids, QUndoCommand * parent = 0);
+    void redo();
+    void undo();
+private:
+    MultitrackModel& m_model;
+    QVector<QUuid> m_uuids;
+    UndoHelper m_undoHelper;
+};
+
 class NameTrackCommand : public QUndoCommand
 {
 public:
@@ -16,10 +16,12 @@
  */
 
 #include "undohelper.h"
+#include "memoryreport.h"
 #include "mltcontroller.h"
 #include "models/audiolevelstask.h"
 #include "shotcut_mlt_properties.h"
 #include <Logger.h>
+#include <QHash>
 #include <QScopedPointer>
 #include <QUuid>
 
@@ -32,9 +34,16 @@
 UndoHelper::UndoHelper(MultitrackModel& model)
     : m_model(model)
     , m_hints(NoHints)
+    , m_accountedBytes(0)
 {
 }
 
+UndoHelper::~UndoHelper()
+{
+    if (m_accountedBytes)
+        MemoryReport::adjustCounter("undo.helper", -m_accountedBytes, -1);
+}
+
 void UndoHelper::recordBeforeState()
 {
 #ifdef UNDOHELPER_DEBUG
@@ -43,19 +52,34 @@ void UndoHelper::recordBeforeState()
     m_state.clear();
     m_clipsAdded.clear();
     m_insertedOrder.clear();
+    // Serializing a producer is the expensive part of recording state, so
+    // serialize each unique parent once - cuts of one source share the
+    // bytes - and only on tracks the command declared it mutates. The pool
+    // holds the XML compressed (fastest zlib level); undoChanges() inflates
+    // on demand.
+    QHash<void*, QByteArray> xmlPool;
     for (int i = 0; i < m_model.trackList().count(); ++i)
     {
         int mltIndex = m_model.trackList()[i].mlt_index;
         QScopedPointer<Mlt::Producer> trackProducer(m_model.tractor()->track(mltIndex));
         Mlt::Playlist playlist(*trackProducer);
+        bool wantXml = !(m_hints & SkipXML)
+                && (m_scopeTracks.isEmpty() || m_scopeTracks.contains(i));
 
         for (int j = 0; j < playlist.count(); ++j) {
             QScopedPointer<Mlt::Producer> clip(playlist.get_clip(j));
             QUuid uid = MLT.ensureHasUuid(*clip);
             m_insertedOrder << uid;
             Info& info = m_state[uid];
-            if (!(m_hints & SkipXML))
-                info.xml = MLT.XML(&clip->parent());
+            // Blanks are restored by length alone and need no XML.
+            if (wantXml && !playlist.is_blank(j)) {
+                void* key = clip->parent().get_producer();
+                QHash<void*, QByteArray>::iterator it = xmlPool.find(key);
+                if (it == xmlPool.end())
+                    it = xmlPool.insert(key,
+                        qCompress(MLT.XML(&clip->parent()).toUtf8(), 1));
+                info.xml = it.value();
+            }
             Mlt::ClipInfo clipInfo;
             playlist.clip_info(j, &clipInfo);
             info.frame_in = clipInfo.frame_in;
@@ -65,6 +89,16 @@ void UndoHelper::recordBeforeState()
             info.isBlank = playlist.is_blank(j);
         }
     }
+    // Cuts of one source share the pooled bytes, so account each unique
+    // serialization once. items counts helpers currently holding XML.
+    qint64 bytes = 0;
+    foreach (const QByteArray& xml, xmlPool)
+        bytes += xml.size();
+    if (bytes != m_accountedBytes) {
+        MemoryReport::adjustCounter("undo.helper", bytes - m_accountedBytes,
+                                    (bytes != 0) - (m_accountedBytes != 0));
+        m_accountedBytes = bytes;
+    }
 }
 
 void UndoHelper::recordAfterState()
@@ -74,6 +108,7 @@ void UndoHelper::recordAfterState()
 #endif
     QList<QUuid> clipsRemoved = m_state.keys();
     m_clipsAdded.clear();
+    QHash<void*, QByteArray> xmlPool;
     for (int i = 0; i < m_model.trackList().count(); ++i)
     {
         int mltIndex = m_model.trackList()[i].mlt_index;
@@ -107,9 +142,17 @@ void UndoHelper::recordAfterState()
                     m_affectedTracks << info.newTrackIndex;
                 }
 
-                if (!(m_hints & SkipXML) && !info.isBlank) {
-                    QString newXml = MLT.XML(&clip->parent());
-                    if (info.xml != newXml) {
+                // No before-XML means the clip is a blank or outside the
+                // declared scope; there is nothing to compare against.
+                if (!(m_hints & SkipXML) && !info.isBlank && !info.xml.isEmpty()) {
+                    void* key = clip->parent().get_producer();
+                    QHash<void*, QByteArray>::iterator it = xmlPool.find(key);
+                    if (it == xmlPool.end())
+                        it = xmlPool.insert(key,
+                            qCompress(MLT.XML(&clip->parent()).toUtf8(), 1));
+                    // qCompress is deterministic, so equal XML compresses to
+                    // equal bytes and the comparison works on the deflated form.
+                    if (info.xml != it.value()) {
                         UNDOLOG << "Modified xml:" << uid;
                         info.changes |= XMLModified;
                         m_affectedTracks << i;
@@ -201,7 +244,8 @@ void UndoHelper::undoChanges()
                 UNDOLOG << "inserting clip at " << currentIndex;
                 Q_ASSERT(!(m_hints & SkipXML) && "Cannot restore clip without stored XML");
                 Q_ASSERT(!info.xml.isEmpty());
-                Mlt::Producer restoredClip(MLT.profile(), "xml-string", info.xml.toUtf8().constData());
+                QByteArray xml = qUncompress(info.xml);
+                Mlt::Producer restoredClip(MLT.profile(), "xml-string", xml.constData());
                 if (restoredClip.type() == tractor_type) {
                     restoredClip.set("mlt_type", "mlt_producer");
                 }
@@ -282,6 +326,11 @@ void UndoHelper::setHints(OptimizationHints hints)
     m_hints = hints;
 }
 
+void UndoHelper::setScopeTracks(const QSet<int>& tracks)
+{
+    m_scopeTracks = tracks;
+}
+
 void UndoHelper::debugPrintState()
 {
     qDebug("timeline state: {");
@@ -334,7 +383,8 @@ void UndoHelper::restoreAffectedTracks()
                 UNDOLOG << "appending clip at" << currentIndex;
                 Q_ASSERT(!(m_hints & SkipXML) && "Cannot restore clip without stored XML");
                 Q_ASSERT(!info.xml.isEmpty());
-                Mlt::Producer restoredClip(MLT.profile(), "xml-string", info.xml.toUtf8().constData());
+                QByteArray xml = qUncompress(info.xml);
+                Mlt::Producer restoredClip(MLT.profile(), "xml-string", xml.constData());
                 if (restoredClip.type() == tractor_type) {
                     restoredClip.set("mlt_type", "mlt_producer");
                 }
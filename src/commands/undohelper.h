@@ -35,11 +35,17 @@ public:
         RestoreTracks
     };
     UndoHelper(MultitrackModel & model);
+    ~UndoHelper();
 
     void recordBeforeState();
     void recordAfterState();
     void undoChanges();
     void setHints(OptimizationHints hints);
+    /// Declare the only tracks the command mutates so recordBeforeState()
+    /// captures clip XML just for those tracks. Without a scope every
+    /// non-blank clip in the project is serialized as a safe fallback,
+    /// which costs time and undo-stack memory proportional to the project.
+    void setScopeTracks(const QSet<int>& tracks);
 
 private:
     void debugPrintState();
@@ -59,7 +65,11 @@ private:
         int newTrackIndex;
         int newClipIndex;
         bool isBlank;
-        QString xml;
+        // qCompress()ed UTF-8 clip XML. The payload is only read during an
+        // undo-walk, so every stack entry stays compressed for its whole
+        // lifetime; clip XML shrinks roughly an order of magnitude, which
+        // keeps day-long sessions from accumulating gigabytes of undo state.
+        QByteArray xml;
         int frame_in;
         int frame_out;
         int in_delta;
@@ -83,8 +93,12 @@ private:
     QList<QUuid> m_clipsAdded;
     QList<QUuid> m_insertedOrder;
     QSet<int> m_affectedTracks;
+    QSet<int> m_scopeTracks;
     MultitrackModel & m_model;
     OptimizationHints m_hints;
+    // Bytes of clip XML this helper contributes to the undo stack,
+    // reported under "undo.helper" and released in the destructor.
+    qint64 m_accountedBytes;
 };
 
 #endif // UNDOHELPER_H
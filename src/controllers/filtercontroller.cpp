@@ -19,6 +19,10 @@
 #include "filtercontroller.h"
 #include <QQmlEngine>
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QDateTime>
 #include <Logger.h>
 #include <QQmlComponent>
 #include <QTimerEvent>
@@ -32,7 +36,10 @@ FilterController::FilterController(QObject* parent) : QObject(parent),
  m_mltFilter(0),
  m_metadataModel(this),
  m_attachedModel(this),
- m_currentFilterIndex(-1)
+ m_currentFilterIndex(-1),
+ m_isMetadataQueued(false),
+ m_isMetadataIndexStale(false),
+ m_warmUpTimerId(0)
 {
     startTimer(0);
     connect(&m_attachedModel, SIGNAL(changed()), this, SLOT(handleAttachedModelChange()));
@@ -42,8 +49,68 @@ FilterController::FilterController(QObject* parent) : QObject(parent),
     connect(&m_attachedModel, SIGNAL(duplicateAddFailed(int)), this, SLOT(handleAttachDuplicateFailed(int)));
 }
 
-void FilterController::loadFilterMetadata() {
-    QScopedPointer<Mlt::Properties> mltFilters(MLT.repository()->filters());
+static QString metadataIndexPath()
+{
+    return Settings.appDataLocation() + "/filters-index";
+}
+
+static const qint32 kMetadataIndexVersion = 1;
+
+// Walking qml/filters stats every subdirectory, which is slow on
+// network-installed builds. A previous run's index replays the file list
+// in one read; the filters root path and mtime key its validity so an
+// upgraded or relocated install falls back to a fresh walk.
+bool FilterController::readMetadataIndex()
+{
+    QFile file(metadataIndexPath());
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream stream(&file);
+    qint32 version = 0;
+    QString rootPath;
+    QDateTime rootModified;
+    QStringList relativePaths;
+    stream >> version >> rootPath >> rootModified >> relativePaths;
+    QDir dir = QmlUtilities::qmlDir();
+    dir.cd("filters");
+    if (stream.status() != QDataStream::Ok || version != kMetadataIndexVersion
+            || rootPath != dir.absolutePath()
+            || rootModified != QFileInfo(dir.absolutePath()).lastModified())
+        return false;
+    foreach (const QString& relativePath, relativePaths) {
+        QString fileName = dir.absoluteFilePath(relativePath);
+        // A missing file means the index is stale regardless of the key.
+        if (!QFile::exists(fileName)) {
+            m_metadataQueue.clear();
+            return false;
+        }
+        m_metadataQueue << fileName;
+    }
+    return !m_metadataQueue.isEmpty();
+}
+
+void FilterController::writeMetadataIndex()
+{
+    QDir dir = QmlUtilities::qmlDir();
+    dir.cd("filters");
+    QFile file(metadataIndexPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_WARNING() << "failed to write filter metadata index" << file.fileName();
+        return;
+    }
+    QStringList relativePaths;
+    foreach (const QString& fileName, m_metadataQueue)
+        relativePaths << dir.relativeFilePath(fileName);
+    QDataStream stream(&file);
+    stream << kMetadataIndexVersion << dir.absolutePath()
+           << QFileInfo(dir.absolutePath()).lastModified() << relativePaths;
+    m_isMetadataIndexStale = false;
+}
+
+void FilterController::queueMetadataFiles()
+{
+    if (readMetadataIndex())
+        return;
     QDir dir = QmlUtilities::qmlDir();
     dir.cd("filters");
     foreach (QString dirName, dir.entryList(QDir::AllDirs | QDir::NoDotAndDotDot | QDir::Executable)) {
@@ -51,41 +118,61 @@ void FilterController::loadFilterMetadata() {
         subdir.cd(dirName);
         subdir.setFilter(QDir::Files | QDir::NoDotAndDotDot | QDir::Readable);
         subdir.setNameFilters(QStringList("meta*.qml"));
-        foreach (QString fileName, subdir.entryList()) {
-            LOG_DEBUG() << "reading filter metadata" << dirName << fileName;
-            QQmlComponent component(QmlUtilities::sharedEngine(), subdir.absoluteFilePath(fileName));
-            QmlMetadata *meta = qobject_cast<QmlMetadata*>(component.create());
-            if (meta) {
-                // Check if mlt_service is available.
-                if (mltFilters->get_data(meta->mlt_service().toLatin1().constData())) {
-                    LOG_DEBUG() << "added filter" << meta->name();
-                    meta->loadSettings();
-                    meta->setPath(subdir);
-                    meta->setParent(0);
-                    addMetadata(meta);
-
-                    // Check if a keyframes minimum version is required.
-                    QScopedPointer<Mlt::Properties> mltMetadata(MLT.repository()->metadata(filter_type, meta->mlt_service().toLatin1().constData()));
-                    if (mltMetadata && mltMetadata->is_valid() && mltMetadata->get("version") && meta->keyframes()) {
-                        QString version = QString::fromLatin1(mltMetadata->get("version"));
-                        if (version.startsWith("lavfi"))
-                            version.remove(0, 5);
-                        meta->setProperty("version", version);
-                        meta->keyframes()->checkVersion(version);
-                    }
-
-                    if (meta->isDeprecated())
-                        meta->setName(meta->name() + " " + tr("(DEPRECATED)"));
-                }
-            } else if (!meta) {
-                LOG_WARNING() << component.errorString();
+        foreach (QString fileName, subdir.entryList())
+            m_metadataQueue << subdir.absoluteFilePath(fileName);
+    }
+    m_isMetadataIndexStale = true;
+}
+
+void FilterController::loadFilterMetadata(const QString& fileName)
+{
+    LOG_DEBUG() << "reading filter metadata" << fileName;
+    QQmlComponent component(QmlUtilities::sharedEngine(), fileName);
+    QmlMetadata *meta = qobject_cast<QmlMetadata*>(component.create());
+    if (meta) {
+        // Check if mlt_service is available.
+        if (m_mltFilters->get_data(meta->mlt_service().toLatin1().constData())) {
+            LOG_DEBUG() << "added filter" << meta->name();
+            meta->loadSettings();
+            meta->setPath(QFileInfo(fileName).dir());
+            meta->setParent(0);
+            addMetadata(meta);
+
+            // Check if a keyframes minimum version is required.
+            QScopedPointer<Mlt::Properties> mltMetadata(MLT.repository()->metadata(filter_type, meta->mlt_service().toLatin1().constData()));
+            if (mltMetadata && mltMetadata->is_valid() && mltMetadata->get("version") && meta->keyframes()) {
+                QString version = QString::fromLatin1(mltMetadata->get("version"));
+                if (version.startsWith("lavfi"))
+                    version.remove(0, 5);
+                meta->setProperty("version", version);
+                meta->keyframes()->checkVersion(version);
             }
+
+            if (meta->isDeprecated())
+                meta->setName(meta->name() + " " + tr("(DEPRECATED)"));
         }
-    };
+    } else if (!meta) {
+        LOG_WARNING() << component.errorString();
+    }
 }
 
 QmlMetadata *FilterController::metadataForService(Mlt::Service *service)
 {
+    // A lookup must never miss because the background scan has not caught
+    // up; finish any pending metadata synchronously first.
+    if (!m_isMetadataQueued) {
+        m_isMetadataQueued = true;
+        queueMetadataFiles();
+        if (m_isMetadataIndexStale)
+            writeMetadataIndex();
+    }
+    if (!m_metadataQueue.isEmpty()) {
+        if (!m_mltFilters)
+            m_mltFilters.reset(MLT.repository()->filters());
+        while (!m_metadataQueue.isEmpty())
+            loadFilterMetadata(m_metadataQueue.takeFirst());
+    }
+
     QmlMetadata* meta = 0;
     int rowCount = m_metadataModel.rowCount();
     QString uniqueId = service->get(kShotcutFilterProperty);
@@ -108,8 +195,55 @@ QmlMetadata *FilterController::metadataForService(Mlt::Service *service)
 
 void FilterController::timerEvent(QTimerEvent* event)
 {
-    loadFilterMetadata();
+    if (event->timerId() == m_warmUpTimerId) {
+        precompileNextFilterUi();
+        return;
+    }
+    if (!m_isMetadataQueued) {
+        m_isMetadataQueued = true;
+        queueMetadataFiles();
+        if (m_isMetadataIndexStale)
+            writeMetadataIndex();
+        m_mltFilters.reset(MLT.repository()->filters());
+    }
+    // Parse one metadata file per tick so the scan shares the GUI thread
+    // with startup painting instead of blocking it for the whole walk.
+    if (!m_metadataQueue.isEmpty())
+        loadFilterMetadata(m_metadataQueue.takeFirst());
+    if (!m_metadataQueue.isEmpty())
+        return;
     killTimer(event->timerId());
+    m_mltFilters.reset();
+
+    // Queue every filter UI for precompilation so the first click on a
+    // filter does not stall on compiling its QML. One file is compiled per
+    // timer tick to keep the GUI thread responsive.
+    QDir modulePath = QmlUtilities::qmlDir();
+    modulePath.cd("modules");
+    QmlUtilities::sharedEngine()->addImportPath(modulePath.path());
+    for (int i = 0; i < m_metadataModel.rowCount(); i++) {
+        QmlMetadata* meta = m_metadataModel.get(i);
+        if (meta && !meta->qmlFilePath().isEmpty())
+            m_uiWarmUpQueue << meta->qmlFilePath();
+    }
+    if (!m_uiWarmUpQueue.isEmpty())
+        m_warmUpTimerId = startTimer(100);
+}
+
+void FilterController::precompileNextFilterUi()
+{
+    if (m_uiWarmUpQueue.isEmpty()) {
+        killTimer(m_warmUpTimerId);
+        m_warmUpTimerId = 0;
+        return;
+    }
+    // Creating the component compiles the file into the shared engine's
+    // component cache and, with Qt's disk cache, a .qmlc next to it. No
+    // object is instantiated.
+    QUrl url = m_uiWarmUpQueue.takeFirst();
+    QQmlComponent component(QmlUtilities::sharedEngine(), url);
+    if (component.isError())
+        LOG_WARNING() << component.errorString();
 }
 
 MetadataModel* FilterController::metadataModel()
@@ -186,7 +320,7 @@ void FilterController::onFilterOutChanged(int delta, Mlt::Filter* filter)
 
 void FilterController::handleAttachedModelChange()
 {
-    MLT.refreshConsumer();
+    MLT.requestRefresh();
 }
 
 void FilterController::handleAttachedModelAboutToReset()
@@ -70,7 +70,11 @@ private slots:
     void onQmlFilterChanged(const QString& name);
 
 private:
-    void loadFilterMetadata();
+    void queueMetadataFiles();
+    bool readMetadataIndex();
+    void writeMetadataIndex();
+    void loadFilterMetadata(const QString& fileName);
+    void precompileNextFilterUi();
 
     QFuture<void> m_future;
     QScopedPointer<QmlFilter> m_currentFilter;
@@ -78,6 +82,16 @@ private:
     MetadataModel m_metadataModel;
     AttachedFiltersModel m_attachedModel;
     int m_currentFilterIndex;
+    // Metadata files awaiting parsing, drained one per timer tick so the
+    // scan never blocks the GUI thread for its whole duration.
+    QStringList m_metadataQueue;
+    bool m_isMetadataQueued;
+    bool m_isMetadataIndexStale;
+    QScopedPointer<Mlt::Properties> m_mltFilters;
+    // Filter UI files awaiting precompilation into the shared QML engine's
+    // component cache; drained one per timer tick after metadata loads.
+    QList<QUrl> m_uiWarmUpQueue;
+    int m_warmUpTimerId;
 };
 
 #endif // FILTERCONTROLLER_H
@@ -52,9 +52,16 @@ ScopeController::ScopeController(QMainWindow* mainWindow, QMenu* menu)
     LOG_DEBUG() << "end";
 }
 
+void ScopeController::onNewFrame(const SharedFrame& frame)
+{
+    m_frameHub.push(frame);
+    emit frameAvailable();
+}
+
 template<typename ScopeTYPE> void ScopeController::createScopeDock(QMainWindow* mainWindow, QMenu* menu)
 {
     ScopeWidget* scopeWidget = new ScopeTYPE();
+    scopeWidget->setFrameHub(&m_frameHub);
     ScopeDock* scopeDock = new ScopeDock(this, scopeWidget);
     scopeDock->hide();
     menu->addAction(scopeDock->toggleViewAction());
@@ -21,25 +21,75 @@
 
 #include <QObject>
 #include <QString>
+#include <QMutex>
 #include "sharedframe.h"
 
 class QMainWindow;
 class QMenu;
 class QWidget;
 
+/*!
+  \class SharedFrameHub
+  \brief Holds the latest frame once for all scopes.
+
+  \threadsafe
+
+  Rather than pushing a frame into every open scope's queue, the hub keeps
+  a single SharedFrame reference per display tick with a serial number.
+  Each scope fetches the frame only when its refresh actually runs and uses
+  the serial as its dirty flag, so N open scopes cost one stored reference
+  per tick regardless of N.
+*/
+class SharedFrameHub
+{
+public:
+    //! Stores \a frame as the current frame and bumps the serial.
+    void push(const SharedFrame& frame)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_frame = frame;
+        m_serial++;
+    }
+
+    /*!
+      Returns the current frame if its serial differs from \a serial,
+      otherwise an invalid frame. \a serial is updated to the current one.
+    */
+    SharedFrame fetch(int& serial) const
+    {
+        QMutexLocker locker(&m_mutex);
+        if (serial == m_serial)
+            return SharedFrame();
+        serial = m_serial;
+        return m_frame;
+    }
+
+private:
+    mutable QMutex m_mutex;
+    SharedFrame m_frame;
+    int m_serial{0};
+};
+
 class ScopeController Q_DECL_FINAL : public QObject
 {
     Q_OBJECT
 
 public:
     ScopeController(QMainWindow* mainWindow, QMenu* menu);
+    SharedFrameHub* frameHub() { return &m_frameHub; }
+
+public slots:
+    void onNewFrame(const SharedFrame& frame);
 
 signals:
-    void newFrame(const SharedFrame& frame);
+    //! Notifies scopes that the hub holds a newer frame. No payload; the
+    //! scopes fetch from the hub when they refresh.
+    void frameAvailable();
 
 private:
     template<typename ScopeTYPE> void createScopeDock(QMainWindow* mainWindow, QMenu* menu);
 
+    SharedFrameHub m_frameHub;
 };
 
 #endif // SCOPECONTROLLER_H
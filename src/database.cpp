@@ -19,34 +19,150 @@
 #include "models/playlistmodel.h"
 #include "mainwindow.h"
 #include "settings.h"
+#include "perflog.h"
+#include "memoryreport.h"
 #include <QtSql>
+#include <QApplication>
 #include <QDir>
+#include <QImageWriter>
 #include <Logger.h>
 
 struct DatabaseJob {
     enum Type {
         PutThumbnail,
-        GetThumbnail
+        GetThumbnail,
+        PutProbe,
+        GetProbe,
+        PutJobRecord,
+        GetJobRecord,
+        GetStats
     } type;
 
     QImage image;
     QString hash;
+    QString path;
+    qint64 size;
+    qint64 mtime;
+    QByteArray metadata;
+    QString operation;
+    QString parameters;
+    QString output;
+    qint64 duration;
     bool result;
     bool completed;
+    bool async; // owned by the worker thread; no caller is waiting on it
     DatabaseJob()
-        : result(false)
+        : size(0)
+        , mtime(0)
+        , duration(0)
+        , result(false)
         , completed(false)
+        , async(false)
     {}
 };
 
 static Database* instance = 0;
 static bool g_isShutdown = false;
 
+// Thumbnail blob codec. Lossy WebP encodes several times faster than PNG
+// on video frames and produces smaller blobs; PNG remains the fallback
+// when the Qt WebP plugin is not installed, and the decoder accepts both
+// so existing PNG rows keep working.
+static const char* thumbnailFormat()
+{
+    static const bool webp = QImageWriter::supportedImageFormats().contains("webp");
+    return webp? "WEBP" : "PNG";
+}
+
+static QByteArray encodeThumbnail(const QImage& image)
+{
+    QByteArray ba;
+    QBuffer buffer(&ba);
+    buffer.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buffer, thumbnailFormat());
+    writer.setQuality(80);
+    writer.write(image);
+    return ba;
+}
+
+static QImage decodeThumbnail(const QByteArray& ba)
+{
+    // Format is detected from the blob contents.
+    QImage result;
+    result.loadFromData(ba);
+    return result;
+}
+
+// Byte budget for the in-memory thumbnail cache. Timeline thumbnails are
+// small (a few hundred KB decoded), so this holds hundreds of clips' worth.
+static const int kThumbnailCacheBudget = 32 * 1024 * 1024;
+
+// OFFSET is the number of thumbnails to cache, least recently used
+// beyond it purged.
+static const char* kThumbnailSelection =
+        "SELECT hash FROM thumbnails ORDER BY accessed DESC LIMIT -1 OFFSET 10000";
+
+// Statements the worker runs on every job, prepared once after the schema
+// is ready instead of re-parsed per job.
+struct DatabasePreparedQueries {
+    QSqlQuery deleteThumbnail;
+    QSqlQuery insertThumbnail;
+    QSqlQuery selectThumbnail;
+    QSqlQuery touchThumbnail;
+    QSqlQuery migrateThumbnail;
+    QSqlQuery deleteProbe;
+    QSqlQuery insertProbe;
+    QSqlQuery selectProbe;
+    QSqlQuery touchProbe;
+    QSqlQuery purgeThumbnails;
+    QSqlQuery purgeHotThumbnails;
+    QSqlQuery purgeProbes;
+    QSqlQuery deleteJobRecord;
+    QSqlQuery insertJobRecord;
+    QSqlQuery selectJobRecord;
+    QSqlQuery purgeJobRecords;
+
+    DatabasePreparedQueries()
+    {
+        deleteThumbnail.prepare("DELETE FROM thumbnails WHERE hash = :hash;");
+        insertThumbnail.prepare("INSERT INTO thumbnails VALUES (:hash, datetime('now'), :image);");
+        selectThumbnail.prepare("SELECT image FROM thumbnails WHERE hash = :hash;");
+        touchThumbnail.prepare("UPDATE thumbnails SET accessed = datetime('now') WHERE hash = :hash ;");
+        migrateThumbnail.prepare("UPDATE thumbnails SET accessed = datetime('now'), image = :image WHERE hash = :hash ;");
+        deleteProbe.prepare("DELETE FROM probes WHERE path = :path AND size = :size AND mtime = :mtime;");
+        insertProbe.prepare("INSERT INTO probes VALUES (:path, :size, :mtime, datetime('now'), :metadata);");
+        selectProbe.prepare("SELECT metadata FROM probes WHERE path = :path AND size = :size AND mtime = :mtime;");
+        touchProbe.prepare("UPDATE probes SET accessed = datetime('now') WHERE path = :path AND size = :size AND mtime = :mtime;");
+        purgeHotThumbnails.prepare(QString("SELECT COUNT(*) FROM thumbnails WHERE"
+                " accessed > datetime('now', '-7 day') AND hash IN (%1);").arg(kThumbnailSelection));
+        purgeThumbnails.prepare(QString("DELETE FROM thumbnails WHERE hash IN (%1);").arg(kThumbnailSelection));
+        purgeProbes.prepare("DELETE FROM probes WHERE rowid IN"
+                " (SELECT rowid FROM probes ORDER BY accessed DESC LIMIT -1 OFFSET 1000);");
+        deleteJobRecord.prepare("DELETE FROM jobs WHERE hash = :hash AND operation = :operation"
+                " AND parameters = :parameters;");
+        insertJobRecord.prepare("INSERT INTO jobs VALUES"
+                " (:hash, :operation, :parameters, :output, :duration, datetime('now'));");
+        selectJobRecord.prepare("SELECT output FROM jobs WHERE hash = :hash"
+                " AND operation = :operation AND parameters = :parameters;");
+        purgeJobRecords.prepare("DELETE FROM jobs WHERE rowid IN"
+                " (SELECT rowid FROM jobs ORDER BY created DESC LIMIT -1 OFFSET 10000);");
+    }
+};
+
 Database::Database(QObject *parent) :
     QThread(parent)
     , m_commitTimer(0)
+    , m_queries(0)
     , m_isFailing(false)
+    , m_thumbnailCache(kThumbnailCacheBudget)
 {
+    MemoryReport::registerProvider("db.thumbnails", [this] {
+        MemoryReport::Usage usage;
+        QMutexLocker locker(&m_thumbnailCacheMutex);
+        usage.bytes = m_thumbnailCache.totalCost();
+        usage.items = m_thumbnailCache.count();
+        return usage;
+    });
 }
 
 Database &Database::singleton(QWidget *parent)
@@ -73,6 +189,39 @@ bool Database::upgradeVersion1()
     return success;
 }
 
+bool Database::upgradeVersion2()
+{
+    if (!QSqlDatabase::database().isOpen()) return false;
+    bool success = false;
+    QSqlQuery query;
+    if (query.exec("CREATE TABLE probes (path TEXT NOT NULL, size INTEGER NOT NULL, mtime INTEGER NOT NULL,"
+                   " accessed DATETIME NOT NULL, metadata BLOB, PRIMARY KEY (path, size, mtime));")) {
+        success = query.exec("UPDATE version SET version = 2;");
+        if (!success)
+            LOG_ERROR() << query.lastError();
+    } else {
+        LOG_ERROR() << "Failed to create probes table.";
+    }
+    return success;
+}
+
+bool Database::upgradeVersion3()
+{
+    if (!QSqlDatabase::database().isOpen()) return false;
+    bool success = false;
+    QSqlQuery query;
+    if (query.exec("CREATE TABLE jobs (hash TEXT NOT NULL, operation TEXT NOT NULL,"
+                   " parameters TEXT NOT NULL, output TEXT NOT NULL, duration INTEGER NOT NULL,"
+                   " created DATETIME NOT NULL, PRIMARY KEY (hash, operation, parameters));")) {
+        success = query.exec("UPDATE version SET version = 3;");
+        if (!success)
+            LOG_ERROR() << query.lastError();
+    } else {
+        LOG_ERROR() << "Failed to create jobs table.";
+    }
+    return success;
+}
+
 void Database::doJob(DatabaseJob * job)
 {
     if (!m_commitTimer->isActive())
@@ -80,16 +229,11 @@ void Database::doJob(DatabaseJob * job)
     m_commitTimer->start();
 
     if (job->type == DatabaseJob::PutThumbnail) {
-        QByteArray ba;
-        QBuffer buffer(&ba);
-        buffer.open(QIODevice::WriteOnly);
-        job->image.save(&buffer, "PNG");
+        QByteArray ba = encodeThumbnail(job->image);
 
-        QSqlQuery query;
-        query.prepare("DELETE FROM thumbnails WHERE hash = :hash;");
-        query.bindValue(":hash", job->hash);
-        query.exec();
-        query.prepare("INSERT INTO thumbnails VALUES (:hash, datetime('now'), :image);");
+        m_queries->deleteThumbnail.bindValue(":hash", job->hash);
+        m_queries->deleteThumbnail.exec();
+        QSqlQuery& query = m_queries->insertThumbnail;
         query.bindValue(":hash", job->hash);
         query.bindValue(":image", ba);
         job->result = query.exec();
@@ -98,24 +242,140 @@ void Database::doJob(DatabaseJob * job)
         m_isFailing = !job->result;
     } else if (job->type == DatabaseJob::GetThumbnail) {
         QImage result;
-        QSqlQuery query;
-        query.prepare("SELECT image FROM thumbnails WHERE hash = :hash;");
+        QSqlQuery& query = m_queries->selectThumbnail;
         query.bindValue(":hash", job->hash);
         if (query.exec() && query.first()) {
-            result.loadFromData(query.value(0).toByteArray(), "PNG");
-            QSqlQuery update;
-            update.prepare("UPDATE thumbnails SET accessed = datetime('now') WHERE hash = :hash ;");
+            QByteArray ba = query.value(0).toByteArray();
+            query.finish();
+            result = decodeThumbnail(ba);
+            // Lazily migrate legacy PNG rows to the faster codec so their
+            // next read decodes the smaller blob.
+            bool migrate = !result.isNull() && ba.startsWith("\x89PNG")
+                    && qstrcmp(thumbnailFormat(), "PNG");
+            QSqlQuery& update = migrate? m_queries->migrateThumbnail : m_queries->touchThumbnail;
+            if (migrate)
+                update.bindValue(":image", encodeThumbnail(result));
             update.bindValue(":hash", job->hash);
             m_isFailing = !update.exec();
             if (m_isFailing)
                 LOG_ERROR() << update.lastError();
+        } else {
+            query.finish();
         }
         job->image = result;
+    } else if (job->type == DatabaseJob::GetStats) {
+        QString stats;
+        QSqlQuery query;
+        if (query.exec("SELECT COUNT(*), MIN(accessed), MAX(accessed) FROM thumbnails;") && query.first())
+            stats = QString("thumbnails rows=%1 oldest=%2 newest=%3")
+                    .arg(query.value(0).toLongLong())
+                    .arg(query.value(1).toString())
+                    .arg(query.value(2).toString());
+        if (query.exec("SELECT COUNT(*) FROM probes;") && query.first())
+            stats += QString(" probes rows=%1").arg(query.value(0).toLongLong());
+        if (query.exec("SELECT COUNT(*) FROM jobs;") && query.first())
+            stats += QString(" jobs rows=%1").arg(query.value(0).toLongLong());
+        job->metadata = stats.toUtf8();
+    } else if (job->type == DatabaseJob::GetJobRecord) {
+        QSqlQuery& query = m_queries->selectJobRecord;
+        query.bindValue(":hash", job->hash);
+        query.bindValue(":operation", job->operation);
+        query.bindValue(":parameters", job->parameters);
+        if (query.exec() && query.first())
+            job->output = query.value(0).toString();
+        query.finish();
+    } else if (job->type == DatabaseJob::GetProbe) {
+        QSqlQuery& query = m_queries->selectProbe;
+        query.bindValue(":path", job->path);
+        query.bindValue(":size", job->size);
+        query.bindValue(":mtime", job->mtime);
+        if (query.exec() && query.first()) {
+            job->metadata = query.value(0).toByteArray();
+            query.finish();
+            QSqlQuery& update = m_queries->touchProbe;
+            update.bindValue(":path", job->path);
+            update.bindValue(":size", job->size);
+            update.bindValue(":mtime", job->mtime);
+            m_isFailing = !update.exec();
+            if (m_isFailing)
+                LOG_ERROR() << update.lastError();
+        } else {
+            query.finish();
+        }
     }
     deleteOldThumbnails();
+    deleteOldProbes();
+    deleteOldJobRecords();
     job->completed = true;
 }
 
+void Database::doPutBatch(const QList<DatabaseJob*>& batch)
+{
+    if (!m_commitTimer->isActive())
+        QSqlDatabase::database().transaction();
+    m_commitTimer->start();
+
+    QSqlQuery& deleteQuery = m_queries->deleteThumbnail;
+    QSqlQuery& insertQuery = m_queries->insertThumbnail;
+    QSqlQuery& deleteProbeQuery = m_queries->deleteProbe;
+    QSqlQuery& insertProbeQuery = m_queries->insertProbe;
+
+    foreach (DatabaseJob* job, batch) {
+        if (job->type == DatabaseJob::PutJobRecord) {
+            QSqlQuery& deleteJobQuery = m_queries->deleteJobRecord;
+            deleteJobQuery.bindValue(":hash", job->hash);
+            deleteJobQuery.bindValue(":operation", job->operation);
+            deleteJobQuery.bindValue(":parameters", job->parameters);
+            deleteJobQuery.exec();
+            QSqlQuery& insertJobQuery = m_queries->insertJobRecord;
+            insertJobQuery.bindValue(":hash", job->hash);
+            insertJobQuery.bindValue(":operation", job->operation);
+            insertJobQuery.bindValue(":parameters", job->parameters);
+            insertJobQuery.bindValue(":output", job->output);
+            insertJobQuery.bindValue(":duration", job->duration);
+            job->result = insertJobQuery.exec();
+            if (!job->result)
+                LOG_ERROR() << insertJobQuery.lastError();
+            m_isFailing = !job->result;
+            continue;
+        }
+        if (job->type == DatabaseJob::PutProbe) {
+            deleteProbeQuery.bindValue(":path", job->path);
+            deleteProbeQuery.bindValue(":size", job->size);
+            deleteProbeQuery.bindValue(":mtime", job->mtime);
+            deleteProbeQuery.exec();
+            insertProbeQuery.bindValue(":path", job->path);
+            insertProbeQuery.bindValue(":size", job->size);
+            insertProbeQuery.bindValue(":mtime", job->mtime);
+            insertProbeQuery.bindValue(":metadata", job->metadata);
+            job->result = insertProbeQuery.exec();
+            if (!job->result)
+                LOG_ERROR() << insertProbeQuery.lastError();
+            m_isFailing = !job->result;
+            continue;
+        }
+        QByteArray ba = encodeThumbnail(job->image);
+
+        deleteQuery.bindValue(":hash", job->hash);
+        deleteQuery.exec();
+        insertQuery.bindValue(":hash", job->hash);
+        insertQuery.bindValue(":image", ba);
+        job->result = insertQuery.exec();
+        if (!job->result)
+            LOG_ERROR() << insertQuery.lastError();
+        m_isFailing = !job->result;
+    }
+    deleteOldThumbnails();
+    deleteOldProbes();
+    deleteOldJobRecords();
+
+    foreach (DatabaseJob* job, batch) {
+        job->completed = true;
+        if (job->async)
+            delete job;
+    }
+}
+
 void Database::commitTransaction()
 {
     QSqlDatabase::database().commit();
@@ -123,13 +383,22 @@ void Database::commitTransaction()
 
 bool Database::putThumbnail(const QString& hash, const QImage& image)
 {
+    m_thumbnailCacheMutex.lock();
+    // QImage is implicitly shared so this copy does not duplicate pixels.
+    m_thumbnailCache.insert(hash, new QImage(image), qMax(image.byteCount(), 1));
+    m_thumbnailCacheMutex.unlock();
+
     if (!QSqlDatabase::database().isOpen()) return false;
-    DatabaseJob job;
-    job.type = DatabaseJob::PutThumbnail;
-    job.hash = hash;
-    job.image = image;
-    submitAndWaitForJob(&job);
-    return job.result;
+    // Write-behind: queue the thumbnail and return. The worker coalesces
+    // all queued writes into one transaction so bulk import does not pay
+    // an fsync per clip.
+    DatabaseJob* job = new DatabaseJob;
+    job->type = DatabaseJob::PutThumbnail;
+    job->hash = hash;
+    job->image = image;
+    job->async = true;
+    submitAsyncJob(job);
+    return true;
 }
 
 void Database::submitAndWaitForJob(DatabaseJob * job)
@@ -147,16 +416,111 @@ void Database::submitAndWaitForJob(DatabaseJob * job)
     m_mutex.unlock();
 }
 
+void Database::submitAsyncJob(DatabaseJob * job)
+{
+    m_mutex.lock();
+    m_jobs.append(job);
+    if (m_jobs.size() == 1) {
+        //worker was idle until now
+        m_waitForNewJob.wakeAll();
+    }
+    m_mutex.unlock();
+}
+
+bool Database::putProbe(const QString& path, qint64 size, qint64 mtime, const QByteArray& metadata)
+{
+    if (!QSqlDatabase::database().isOpen()) return false;
+    // Write-behind like putThumbnail; the worker batches queued writes.
+    DatabaseJob* job = new DatabaseJob;
+    job->type = DatabaseJob::PutProbe;
+    job->path = path;
+    job->size = size;
+    job->mtime = mtime;
+    job->metadata = metadata;
+    job->async = true;
+    submitAsyncJob(job);
+    return true;
+}
+
+QByteArray Database::getProbe(const QString& path, qint64 size, qint64 mtime)
+{
+    if (!QSqlDatabase::database().isOpen()) return QByteArray();
+    DatabaseJob job;
+    job.type = DatabaseJob::GetProbe;
+    job.path = path;
+    job.size = size;
+    job.mtime = mtime;
+    submitAndWaitForJob(&job);
+    return job.metadata;
+}
+
+bool Database::putJobRecord(const QString& hash, const QString& operation,
+                            const QString& parameters, const QString& output, qint64 durationMs)
+{
+    if (!QSqlDatabase::database().isOpen()) return false;
+    // Write-behind like putThumbnail; the worker batches queued writes.
+    DatabaseJob* job = new DatabaseJob;
+    job->type = DatabaseJob::PutJobRecord;
+    job->hash = hash;
+    job->operation = operation;
+    job->parameters = parameters;
+    job->output = output;
+    job->duration = durationMs;
+    job->async = true;
+    submitAsyncJob(job);
+    return true;
+}
+
+QString Database::getJobRecordOutput(const QString& hash, const QString& operation,
+                                     const QString& parameters)
+{
+    if (!QSqlDatabase::database().isOpen()) return QString();
+    DatabaseJob job;
+    job.type = DatabaseJob::GetJobRecord;
+    job.hash = hash;
+    job.operation = operation;
+    job.parameters = parameters;
+    submitAndWaitForJob(&job);
+    return job.output;
+}
+
 QImage Database::getThumbnail(const QString &hash)
 {
+    m_thumbnailCacheMutex.lock();
+    QImage* cached = m_thumbnailCache.object(hash);
+    if (cached) {
+        QImage result = *cached;
+        m_thumbnailCacheMutex.unlock();
+        PerfLog::count("thumbnail.cache.hit");
+        return result;
+    }
+    m_thumbnailCacheMutex.unlock();
+
     if (!QSqlDatabase::database().isOpen()) return QImage();
     DatabaseJob job;
     job.type = DatabaseJob::GetThumbnail;
     job.hash = hash;
     submitAndWaitForJob(&job);
+    PerfLog::count(job.image.isNull()? "thumbnail.db.miss" : "thumbnail.db.hit");
+
+    if (!job.image.isNull()) {
+        m_thumbnailCacheMutex.lock();
+        m_thumbnailCache.insert(hash, new QImage(job.image),
+                                qMax(job.image.byteCount(), 1));
+        m_thumbnailCacheMutex.unlock();
+    }
     return job.image;
 }
 
+QString Database::cacheStats()
+{
+    if (!QSqlDatabase::database().isOpen()) return QString();
+    DatabaseJob job;
+    job.type = DatabaseJob::GetStats;
+    submitAndWaitForJob(&job);
+    return QString::fromUtf8(job.metadata);
+}
+
 bool Database::isShutdown() const
 {
     return g_isShutdown;
@@ -164,6 +528,7 @@ bool Database::isShutdown() const
 
 void Database::shutdown()
 {
+    LOG_INFO() << qPrintable(cacheStats());
     g_isShutdown = true;
     requestInterruption();
     wait();
@@ -176,16 +541,55 @@ void Database::shutdown()
 
 void Database::deleteOldThumbnails()
 {
-    QSqlQuery query;
-    // OFFSET is the number of thumbnails to cache.
-    if (!query.exec("DELETE FROM thumbnails WHERE hash IN (SELECT hash FROM thumbnails ORDER BY accessed DESC LIMIT -1 OFFSET 10000);"))
+    // Count purge victims that were used recently; a sustained non-zero
+    // counter means the retention limit is evicting thumbnails that are
+    // still hot and should be raised.
+    QSqlQuery& count = m_queries->purgeHotThumbnails;
+    if (count.exec() && count.first() && count.value(0).toInt() > 0) {
+        LOG_WARNING() << "purging" << count.value(0).toInt()
+                      << "thumbnails accessed within the last week";
+        PerfLog::count("thumbnail.db.evicted.hot", count.value(0).toInt());
+    }
+    count.finish();
+    QSqlQuery& query = m_queries->purgeThumbnails;
+    if (!query.exec())
         LOG_ERROR() << query.lastError();
+    else if (query.numRowsAffected() > 0)
+        PerfLog::count("thumbnail.db.evicted", query.numRowsAffected());
+}
+
+void Database::deleteOldProbes()
+{
+    // OFFSET in the statement is the number of probe results to cache.
+    QSqlQuery& query = m_queries->purgeProbes;
+    if (!query.exec())
+        LOG_ERROR() << query.lastError();
+    else if (query.numRowsAffected() > 0)
+        PerfLog::count("probe.db.evicted", query.numRowsAffected());
+}
+
+void Database::deleteOldJobRecords()
+{
+    // OFFSET in the statement is the number of job history rows to keep.
+    QSqlQuery& query = m_queries->purgeJobRecords;
+    if (!query.exec())
+        LOG_ERROR() << query.lastError();
+    else if (query.numRowsAffected() > 0)
+        PerfLog::count("jobs.db.evicted", query.numRowsAffected());
 }
 
 void Database::run()
 {
-    connect(&MAIN, SIGNAL(aboutToShutDown()),
-            this, SLOT(shutdown()), Qt::DirectConnection);
+    // The jobs server runs without a MainWindow and must not construct one
+    // here; it shuts the database down from the application quit signal
+    // instead. A window always exists by the time the GUI session first
+    // touches the database.
+    if (QApplication::topLevelWidgets().isEmpty())
+        connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()),
+                this, SLOT(shutdown()), Qt::DirectConnection);
+    else
+        connect(&MAIN, SIGNAL(aboutToShutDown()),
+                this, SLOT(shutdown()), Qt::DirectConnection);
 
     QDir dir(Settings.appDataLocation());
     if (!dir.exists())
@@ -193,7 +597,18 @@ void Database::run()
 
     QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE");
     db.setDatabaseName(dir.filePath("db.sqlite3"));
-    db.open();
+    if (db.open()) {
+        // Fast storage mode: WAL lets thumbnail reads proceed while the
+        // commit timer's transaction is being written, synchronous=NORMAL
+        // drops the per-commit fsync that WAL makes safe to skip, and the
+        // busy timeout absorbs checkpoint collisions instead of failing
+        // the query.
+        QSqlQuery pragma;
+        if (!pragma.exec("PRAGMA journal_mode = WAL;"))
+            LOG_WARNING() << "failed to enable WAL" << pragma.lastError();
+        pragma.exec("PRAGMA synchronous = NORMAL;");
+        pragma.exec("PRAGMA busy_timeout = 5000;");
+    }
 
     m_commitTimer = new QTimer();
     m_commitTimer->setSingleShot(true);
@@ -215,26 +630,73 @@ void Database::run()
     }
     if (version < 1 && upgradeVersion1())
         version = 1;
+    if (version < 2 && upgradeVersion2())
+        version = 2;
+    if (version < 3 && upgradeVersion3())
+        version = 3;
     LOG_DEBUG() << "Database version is" << version;
 
+    // Prepare after the upgrades so every referenced table exists.
+    m_queries = new DatabasePreparedQueries;
+
     while (true) {
         DatabaseJob * newJob = 0;
+        QList<DatabaseJob*> putBatch;
         m_mutex.lock();
-        if (m_jobs.isEmpty())
+        if (m_jobs.isEmpty()) {
             m_waitForNewJob.wait(&m_mutex, 1000);
-        else
-            newJob = m_jobs.takeFirst();
+        } else {
+            // Serve reads first since a caller is blocked on each one,
+            // then coalesce all queued writes into one batch.
+            for (int i = 0; i < m_jobs.size(); ++i) {
+                if (m_jobs[i]->type == DatabaseJob::GetThumbnail
+                        || m_jobs[i]->type == DatabaseJob::GetProbe
+                        || m_jobs[i]->type == DatabaseJob::GetJobRecord
+                        || m_jobs[i]->type == DatabaseJob::GetStats) {
+                    newJob = m_jobs.takeAt(i);
+                    break;
+                }
+            }
+            if (!newJob) {
+                putBatch = m_jobs;
+                m_jobs.clear();
+            }
+        }
         m_mutex.unlock();
         QCoreApplication::processEvents();
         if (newJob) {
             doJob(newJob);
             m_waitForFinished.wakeAll();
+        } else if (!putBatch.isEmpty()) {
+            doPutBatch(putBatch);
         }
         if (isInterruptionRequested())
             break;
     }
+    // Flush writes still queued at shutdown and release any waiting reader.
+    m_mutex.lock();
+    QList<DatabaseJob*> remaining = m_jobs;
+    m_jobs.clear();
+    m_mutex.unlock();
+    if (!remaining.isEmpty()) {
+        QList<DatabaseJob*> putBatch;
+        foreach (DatabaseJob* job, remaining) {
+            if (job->type == DatabaseJob::PutThumbnail || job->type == DatabaseJob::PutProbe
+                    || job->type == DatabaseJob::PutJobRecord)
+                putBatch << job;
+            else
+                job->completed = true;
+        }
+        if (!putBatch.isEmpty())
+            doPutBatch(putBatch);
+        m_waitForFinished.wakeAll();
+    }
     if (m_commitTimer->isActive())
         commitTransaction();
     delete m_commitTimer;
+    // The prepared statements must go before shutdown() closes and
+    // removes the connection.
+    delete m_queries;
+    m_queries = 0;
 }
 
@@ -20,10 +20,12 @@
 
 #include <QThread>
 #include <QImage>
+#include <QCache>
 #include <QMutex>
 #include <QWaitCondition>
 
 struct DatabaseJob;
+struct DatabasePreparedQueries;
 class QTimer;
 class Database : public QThread
 {
@@ -34,10 +36,26 @@ public:
     static Database& singleton(QWidget* parent = 0);
 
     bool upgradeVersion1();
+    bool upgradeVersion2();
+    bool upgradeVersion3();
     bool putThumbnail(const QString& hash, const QImage& image);
     QImage getThumbnail(const QString& hash);
+    bool putProbe(const QString& path, qint64 size, qint64 mtime, const QByteArray& metadata);
+    QByteArray getProbe(const QString& path, qint64 size, qint64 mtime);
+    //! Records a completed job into the history, keyed by the source media
+    //! hash, the kind of operation, and a fingerprint of its parameters.
+    bool putJobRecord(const QString& hash, const QString& operation,
+                      const QString& parameters, const QString& output, qint64 durationMs);
+    //! Returns the output of a previously completed identical job, or an
+    //! empty string when none is recorded. The caller must verify the file
+    //! still exists. Blocks on the worker thread.
+    QString getJobRecordOutput(const QString& hash, const QString& operation,
+                               const QString& parameters);
     bool isShutdown() const;
     bool isFailing() const { return m_isFailing; }
+    //! Returns row counts and access-time bounds of the on-disk caches as
+    //! one line for debug logging. Blocks on the worker thread.
+    QString cacheStats();
 
 private slots:
     void commitTransaction();
@@ -47,8 +65,12 @@ private slots:
 
 private:
     void doJob(DatabaseJob * job);
+    void doPutBatch(const QList<DatabaseJob*>& batch);
     void submitAndWaitForJob(DatabaseJob * job);
+    void submitAsyncJob(DatabaseJob * job);
     void deleteOldThumbnails();
+    void deleteOldProbes();
+    void deleteOldJobRecords();
     void run();
 
     QList<DatabaseJob*> m_jobs;
@@ -56,7 +78,14 @@ private:
     QWaitCondition m_waitForFinished;
     QWaitCondition m_waitForNewJob;
     QTimer * m_commitTimer;
+    // Statements reused across jobs; owned by the worker thread and only
+    // valid between schema setup and the end of run().
+    DatabasePreparedQueries * m_queries;
     bool m_isFailing;
+    // In-memory LRU of decoded thumbnails above the SQLite store so warm
+    // lookups skip the worker thread round-trip and PNG decode.
+    QCache<QString, QImage> m_thumbnailCache;
+    QMutex m_thumbnailCacheMutex;
 };
 
 #define DB Database::singleton()
@@ -21,8 +21,12 @@
 
 #include <QList>
 #include <QMutex>
+#include <QThread>
 #include <QWaitCondition>
 #include <QMutexLocker>
+#include <atomic>
+#include <utility>
+#include <vector>
 
 /*!
   \class DataQueue
@@ -159,4 +163,137 @@ int DataQueue<T>::count() const
     return m_queue.size();
 }
 
+/*!
+  \class SpscDataQueue
+  \brief The SpscDataQueue is a lock-free alternative to DataQueue for one
+  producer and one consumer.
+
+  \threadsafe
+
+  SpscDataQueue provides the same interface and overflow semantics as
+  DataQueue for the two discard modes, but uses a fixed-capacity ring with
+  per-slot sequence counters instead of a mutex, so a real-time producer
+  (e.g. the MLT consumer thread feeding scopes) never blocks on a UI-side
+  consumer holding a lock. OverflowModeWait is intentionally not offered; a
+  producer that must block should use DataQueue.
+
+  Only one thread may call push() and only one thread may call pop(). The
+  discard-oldest mode is implemented by the producer dequeuing on its own
+  behalf, which the sequence counters make safe against a concurrent pop().
+*/
+
+template <class T>
+class SpscDataQueue
+{
+public:
+    //! Overflow behavior modes.
+    typedef enum {
+        OverflowModeDiscardOldest = 0, //!< Discard oldest items
+        OverflowModeDiscardNewest      //!< Discard newest items
+    } OverflowMode;
+
+    /*!
+      Constructs an SpscDataQueue.
+
+      The \a size will be the maximum queue size and the \a mode will dictate
+      overflow behavior.
+    */
+    explicit SpscDataQueue(int maxSize, OverflowMode mode)
+      : m_slots(maxSize)
+      , m_capacity(maxSize)
+      , m_mode(mode)
+      , m_head(0)
+      , m_tail(0)
+    {
+        for (int i = 0; i < maxSize; i++)
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    //! Destructs an SpscDataQueue.
+    ~SpscDataQueue()
+    {
+    }
+
+    /*!
+      Pushes an item into the queue.
+
+      If the queue is full, an item is discarded according to the overflow
+      mode. This function never blocks.
+    */
+    void push(const T& item)
+    {
+        if (!tryPush(item) && m_mode == OverflowModeDiscardOldest) {
+            T discarded;
+            tryPop(discarded);
+            tryPush(item);
+        }
+    }
+
+    /*!
+      Pops an item from the queue.
+
+      If the queue is empty then this function spins until an item arrives.
+      If blocking is undesired, then check the return of count() before
+      calling pop().
+    */
+    T pop()
+    {
+        T retVal;
+        while (!tryPop(retVal))
+            QThread::yieldCurrentThread();
+        return retVal;
+    }
+
+    //! Returns the number of items in the queue.
+    int count() const
+    {
+        int n = m_tail.load(std::memory_order_acquire) -
+                m_head.load(std::memory_order_acquire);
+        return (n < 0)? 0 : n;
+    }
+
+private:
+    struct Slot {
+        std::atomic<int> sequence;
+        T item;
+    };
+
+    bool tryPush(const T& item)
+    {
+        int tail = m_tail.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[tail % m_capacity];
+        if (slot.sequence.load(std::memory_order_acquire) != tail)
+            return false; // Slot not yet consumed - queue is full.
+        slot.item = item;
+        slot.sequence.store(tail + 1, std::memory_order_release);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item)
+    {
+        // Claim the head slot; the producer may also pop when discarding
+        // the oldest item, so contend with compare-and-swap.
+        int head = m_head.load(std::memory_order_relaxed);
+        forever {
+            Slot& slot = m_slots[head % m_capacity];
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+                return false; // Slot not yet produced - queue is empty.
+            if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel))
+                break;
+        }
+        Slot& slot = m_slots[head % m_capacity];
+        item = std::move(slot.item);
+        slot.item = T();
+        slot.sequence.store(head + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    std::vector<Slot> m_slots;
+    const int m_capacity;
+    const OverflowMode m_mode;
+    std::atomic<int> m_head;
+    std::atomic<int> m_tail;
+};
+
 #endif // DATAQUEUE_H
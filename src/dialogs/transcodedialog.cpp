@@ -18,6 +18,8 @@
 #include "transcodedialog.h"
 #include "ui_transcodedialog.h"
 
+#include <MltProducer.h>
+
 TranscodeDialog::TranscodeDialog(const QString& message, bool isProgressive, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::TranscodeDialog),
@@ -62,3 +64,52 @@ void TranscodeDialog::on_checkBox_clicked(bool checked)
 {
     m_isChecked = checked;
 }
+
+QStringList TranscodeDialog::ffmpegArgs(Mlt::Producer& producer, const QString& resource,
+                                        int format, bool isProgressive, int fieldOrder,
+                                        bool fullRange, QString* suffix)
+{
+    QStringList args;
+
+    args << "-loglevel" << "verbose";
+    args << "-i" << resource;
+    args << "-max_muxing_queue_size" << "9999";
+    // transcode all streams except data, subtitles, and attachments
+    if (producer.get_int("video_index") < producer.get_int("audio_index"))
+        args << "-map" << "0:V?" << "-map" << "0:a?";
+    else
+        args << "-map" << "0:a?" << "-map" << "0:V?";
+    args << "-map_metadata" << "0" << "-ignore_unknown";
+    if (fullRange)
+        args << "-vf" << "scale=flags=accurate_rnd+full_chroma_inp+full_chroma_int:in_range=full:out_range=full" << "-color_range" << "jpeg";
+    else
+        args << "-vf" << "scale=flags=accurate_rnd+full_chroma_inp+full_chroma_int:in_range=mpeg:out_range=mpeg" << "-color_range" << "mpeg";
+    if (!isProgressive)
+        args << "-flags" << "+ildct+ilme" << "-top" << QString::number(fieldOrder);
+
+    switch (format) {
+    case 0:
+        args << "-f" << "mp4" << "-codec:a" << "ac3" << "-b:a" << "512k" << "-codec:v" << "libx264";
+        args << "-preset" << "medium" << "-g" << "1" << "-crf" << "11";
+        if (suffix)
+            *suffix = "mp4";
+        break;
+    case 1:
+        args << "-f" << "mov" << "-codec:a" << "alac";
+        if (isProgressive) {
+            args << "-codec:v" << "dnxhd" << "-profile:v" << "dnxhr_hq" << "-pix_fmt" << "yuv422p";
+        } else { // interlaced
+            args << "-codec:v" << "prores_ks" << "-profile:v" << "standard";
+        }
+        if (suffix)
+            *suffix = "mov";
+        break;
+    case 2:
+        args << "-f" << "matroska" << "-codec:a" << "pcm_f32le" << "-codec:v" << "utvideo";
+        args << "-pix_fmt" << "yuv422p";
+        if (suffix)
+            *suffix = "mkv";
+        break;
+    }
+    return args;
+}
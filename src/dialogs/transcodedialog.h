@@ -19,10 +19,14 @@
 #define TRANSCODEDIALOG_H
 
 #include <QDialog>
+#include <QStringList>
 
 namespace Ui {
 class TranscodeDialog;
 }
+namespace Mlt {
+class Producer;
+}
 class QCheckBox;
 
 class TranscodeDialog : public QDialog
@@ -36,6 +40,13 @@ public:
     void showCheckBox();
     bool isCheckBoxChecked() const { return m_isChecked; }
 
+    //! Build the ffmpeg arguments (everything up to the output file name)
+    //! that convert \a resource to edit-friendly \a format. On return
+    //! \a suffix holds the container file name extension for the format.
+    static QStringList ffmpegArgs(Mlt::Producer& producer, const QString& resource,
+                                  int format, bool isProgressive, int fieldOrder,
+                                  bool fullRange, QString* suffix = nullptr);
+
 private slots:
     void on_horizontalSlider_valueChanged(int position);
 
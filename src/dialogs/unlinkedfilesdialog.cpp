@@ -21,8 +21,12 @@
 #include "mltxmlchecker.h"
 #include "util.h"
 #include <Logger.h>
+#include <QCoreApplication>
+#include <QDirIterator>
 #include <QFileDialog>
+#include <QMultiHash>
 #include <QStringList>
+#include <QtConcurrent/QtConcurrent>
 
 UnlinkedFilesDialog::UnlinkedFilesDialog(QWidget* parent) :
     QDialog(parent),
@@ -132,10 +136,86 @@ bool UnlinkedFilesDialog::lookInDir(const QDir& dir, bool recurse)
     return outstanding;
 }
 
+static void setReplacement(QAbstractItemModel* model, int row, const QString& path,
+                           const QString& hash, bool exact)
+{
+    QModelIndex missingIndex = model->index(row, MltXmlChecker::MissingColumn);
+    QModelIndex replacementIndex = model->index(row, MltXmlChecker::ReplacementColumn);
+    QIcon icon(exact? ":/icons/oxygen/32x32/status/task-complete.png"
+                    : ":/icons/oxygen/32x32/status/task-attempt.png");
+    model->setData(missingIndex, icon, Qt::DecorationRole);
+    QString filePath = QDir::toNativeSeparators(path);
+    model->setData(replacementIndex, filePath);
+    model->setData(replacementIndex, filePath, Qt::ToolTipRole);
+    model->setData(replacementIndex, hash, MltXmlChecker::ShotcutHashRole);
+}
+
+void UnlinkedFilesDialog::searchInFolder(const QString& dirName)
+{
+    LOG_DEBUG() << dirName;
+    QAbstractItemModel* model = ui->tableView->model();
+
+    // Pass 1: index every file name under the chosen root. This touches only
+    // directory entries, not file contents, so it is fast even on large trees.
+    QMultiHash<QString, QString> index;
+    QDirIterator it(dirName, QDir::Files | QDir::Readable | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+    int count = 0;
+    while (it.hasNext()) {
+        it.next();
+        index.insert(it.fileName().toLower(), it.filePath());
+        if ((++count % 1000) == 0)
+            QCoreApplication::processEvents();
+    }
+
+    // Pass 2: resolve each missing entry from the index by name, hashing only
+    // the candidates that share the name - in parallel when there are several -
+    // so an exact content match wins over a coincidental name match.
+    QList<int> unresolved;
+    for (int row = 0; row < model->rowCount(); row++) {
+        QModelIndex replacementIndex = model->index(row, MltXmlChecker::ReplacementColumn);
+        if (!model->data(replacementIndex, MltXmlChecker::ShotcutHashRole).isNull())
+            continue;
+        QModelIndex missingIndex = model->index(row, MltXmlChecker::MissingColumn);
+        QFileInfo missingInfo(model->data(missingIndex).toString());
+        QString missingHash = model->data(missingIndex, MltXmlChecker::ShotcutHashRole).toString();
+        QStringList candidates = index.values(missingInfo.fileName().toLower());
+        if (candidates.isEmpty()) {
+            if (!missingHash.isEmpty())
+                unresolved << row;
+            continue;
+        }
+        QStringList hashes = QtConcurrent::blockingMapped(candidates, &Util::getFileHash);
+        int exact = missingHash.isEmpty()? -1 : hashes.indexOf(missingHash);
+        if (exact >= 0)
+            setReplacement(model, row, candidates[exact], hashes[exact], true);
+        else
+            setReplacement(model, row, candidates.first(), hashes.first(), false);
+        QCoreApplication::processEvents();
+    }
+
+    // Pass 3: entries without a name match were likely renamed. Hash the
+    // indexed files once - in parallel - and match them by content.
+    if (!unresolved.isEmpty()) {
+        QStringList paths = index.values();
+        QStringList hashes = QtConcurrent::blockingMapped(paths, &Util::getFileHash);
+        QHash<QString, QString> pathForHash;
+        for (int i = 0; i < paths.size(); i++)
+            pathForHash.insert(hashes.at(i), paths.at(i));
+        foreach (int row, unresolved) {
+            QModelIndex missingIndex = model->index(row, MltXmlChecker::MissingColumn);
+            QString missingHash = model->data(missingIndex, MltXmlChecker::ShotcutHashRole).toString();
+            if (pathForHash.contains(missingHash))
+                setReplacement(model, row, pathForHash.value(missingHash), missingHash, true);
+        }
+    }
+    ui->tableView->resizeColumnsToContents();
+}
+
 void UnlinkedFilesDialog::on_searchFolderButton_clicked()
 {
     QString dirName = QFileDialog::getExistingDirectory(this, windowTitle(), Settings.openPath());
     if (!dirName.isEmpty()) {
-        lookInDir(dirName);
+        searchInFolder(dirName);
     }
 }
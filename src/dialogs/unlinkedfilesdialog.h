@@ -43,6 +43,7 @@ private slots:
 
 private:
     bool lookInDir(const QDir& dir, bool recurse = false);
+    void searchInFolder(const QString& dirName);
 
     Ui::UnlinkedFilesDialog *ui;
 };
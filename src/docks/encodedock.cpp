@@ -24,9 +24,12 @@
 #include "settings.h"
 #include "qmltypes/qmlapplication.h"
 #include "jobs/encodejob.h"
+#include "jobs/ffmpegjob.h"
+#include "jobs/postjobaction.h"
 #include "shotcut_mlt_properties.h"
 #include "util.h"
 #include "dialogs/listselectiondialog.h"
+#include "dialogs/textviewerdialog.h"
 #include "qmltypes/qmlfilter.h"
 
 #include <Logger.h>
@@ -43,19 +46,47 @@
 #define TO_ABSOLUTE(min, max, rel) qRound(float(min) + float((max) - (min)) * float(rel) / 100.0f)
 #define TO_RELATIVE(min, max, abs) qRound(100.0f * float((abs) - (min)) / float((max) - (min)))
 static const int kOpenCaptureFileDelayMs = 1500;
+// Length of the timeline slice each benchmarked preset encodes.
+static const int kBenchmarkSeconds = 10;
 static const qint64 kFreeSpaceThesholdGB = 25LL * 1024 * 1024 * 1024;
 static const int kCustomPresetFileNameRole = Qt::UserRole + 1;
 
 static double getBufferSize(Mlt::Properties& preset, const char* property);
 
+// Silences every input widget of the dock for one scope so that loading a
+// preset updates each control exactly once instead of running the connected
+// handlers per setter; the dependent update slots run explicitly at the end
+// of loadPresetFromProperties().
+class SignalBlockScope
+{
+public:
+    explicit SignalBlockScope(QWidget* parent)
+    {
+        foreach (QWidget* child, parent->findChildren<QWidget*>()) {
+            if (child->inherits("QComboBox") || child->inherits("QAbstractSpinBox")
+                    || child->inherits("QCheckBox"))
+                m_blockers.append(new QSignalBlocker(child));
+        }
+    }
+    ~SignalBlockScope()
+    {
+        qDeleteAll(m_blockers);
+    }
+
+private:
+    QList<QSignalBlocker*> m_blockers;
+};
+
 EncodeDock::EncodeDock(QWidget *parent) :
     QDockWidget(parent),
     ui(new Ui::EncodeDock),
-    m_presets(Mlt::Repository::presets()),
+    m_presets(0),
     m_immediateJob(0),
     m_profiles(Mlt::Profile::list()),
     m_isDefaultSettings(true),
-    m_fps(0.0)
+    m_fps(0.0),
+    m_isCombosPopulated(false),
+    m_benchmarkPending(0)
 {
     LOG_DEBUG() << "begin";
     ui->setupUi(this);
@@ -81,43 +112,19 @@ EncodeDock::EncodeDock(QWidget *parent) :
     m_presetsModel.setSourceModel(new QStandardItemModel(this));
     m_presetsModel.setFilterCaseSensitivity(Qt::CaseInsensitive);
     ui->presetsTree->setModel(&m_presetsModel);
-    loadPresets();
-
-    // populate the combos
-    Mlt::Consumer c(MLT.profile(), "avformat");
-    c.set("f", "list");
-    c.set("acodec", "list");
-    c.set("vcodec", "list");
-    c.start();
-    c.stop();
-
-    Mlt::Properties* p = new Mlt::Properties(c.get_data("f"));
+    // Loading the presets means walking and parsing every file under the
+    // presets directory, so like the combos below it is deferred until the
+    // dock is first shown.
+
+    // Enumerating every avformat format and codec requires starting an
+    // avformat consumer and dominates cold start, so populateCombos() is
+    // deferred until the dock is first shown. Until then the combos hold
+    // only their default entries, which is all the hidden dock needs.
     ui->formatCombo->blockSignals(true);
-    for (int i = 0; i < p->count(); i++) {
-        if (ui->formatCombo->findText(p->get(i)) == -1)
-            ui->formatCombo->addItem(p->get(i));
-    }
-    delete p;
-    ui->formatCombo->model()->sort(0);
-    ui->formatCombo->insertItem(0, tr("Automatic from extension"));
+    ui->formatCombo->addItem(tr("Automatic from extension"));
     ui->formatCombo->blockSignals(false);
-
-    p = new Mlt::Properties(c.get_data("acodec"));
-    for (int i = 0; i < p->count(); i++)
-        ui->audioCodecCombo->addItem(p->get(i));
-    delete p;
-    ui->audioCodecCombo->model()->sort(0);
-    ui->audioCodecCombo->insertItem(0, tr("Default for format"));
-
-    p = new Mlt::Properties(c.get_data("vcodec"));
-    for (int i = 0; i < p->count(); i++) {
-        if (qstrcmp("nvenc", p->get(i)) // redundant codec names nvenc_...
-            && qstrcmp("wrapped_avframe", p->get(i))) // not usable
-            ui->videoCodecCombo->addItem(p->get(i));
-    }
-    delete p;
-    ui->videoCodecCombo->model()->sort(0);
-    ui->videoCodecCombo->insertItem(0, tr("Default for format"));
+    ui->audioCodecCombo->addItem(tr("Default for format"));
+    ui->videoCodecCombo->addItem(tr("Default for format"));
 
     ui->hwencodeCheckBox->setChecked(Settings.encodeUseHardware() && !Settings.encodeHardware().isEmpty());
 
@@ -141,6 +148,7 @@ void EncodeDock::loadPresetFromProperties(Mlt::Properties& preset)
     int videoQuality = -1;
     QStringList other;
     QChar decimalPoint = MLT.decimalPoint();
+    SignalBlockScope blocker(this);
 
     ui->disableAudioCheckbox->setChecked(preset.get_int("an"));
     ui->disableVideoCheckbox->setChecked(preset.get_int("vn"));
@@ -372,6 +380,7 @@ void EncodeDock::loadPresetFromProperties(Mlt::Properties& preset)
     onVideoCodecComboChanged(ui->videoCodecCombo->currentIndex(), true);
     on_audioRateControlCombo_activated(ui->audioRateControlCombo->currentIndex());
     on_videoRateControlCombo_activated(ui->videoRateControlCombo->currentIndex());
+    on_videoBufferDurationChanged();
 }
 
 bool EncodeDock::isExportInProgress() const
@@ -411,6 +420,7 @@ void EncodeDock::loadPresets()
 {
     QStandardItemModel* sourceModel = (QStandardItemModel*) m_presetsModel.sourceModel();
     sourceModel->clear();
+    m_customPresetCache.clear();
 
     QStandardItem* grandParentItem = new QStandardItem(tr("Custom"));
     QStandardItem* parentItem = grandParentItem;
@@ -508,6 +518,72 @@ void EncodeDock::loadPresets()
     ui->presetsTree->expandAll();
 }
 
+void EncodeDock::populateCombos()
+{
+    m_isCombosPopulated = true;
+
+    Mlt::Consumer c(MLT.profile(), "avformat");
+    c.set("f", "list");
+    c.set("acodec", "list");
+    c.set("vcodec", "list");
+    c.start();
+    c.stop();
+
+    Mlt::Properties* p = new Mlt::Properties(c.get_data("f"));
+    ui->formatCombo->blockSignals(true);
+    ui->formatCombo->clear();
+    for (int i = 0; i < p->count(); i++) {
+        if (ui->formatCombo->findText(p->get(i)) == -1)
+            ui->formatCombo->addItem(p->get(i));
+    }
+    delete p;
+    ui->formatCombo->model()->sort(0);
+    ui->formatCombo->insertItem(0, tr("Automatic from extension"));
+    ui->formatCombo->setCurrentIndex(0);
+    ui->formatCombo->blockSignals(false);
+
+    p = new Mlt::Properties(c.get_data("acodec"));
+    ui->audioCodecCombo->blockSignals(true);
+    ui->audioCodecCombo->clear();
+    for (int i = 0; i < p->count(); i++)
+        ui->audioCodecCombo->addItem(p->get(i));
+    delete p;
+    ui->audioCodecCombo->model()->sort(0);
+    ui->audioCodecCombo->insertItem(0, tr("Default for format"));
+    ui->audioCodecCombo->setCurrentIndex(0);
+    ui->audioCodecCombo->blockSignals(false);
+
+    p = new Mlt::Properties(c.get_data("vcodec"));
+    ui->videoCodecCombo->blockSignals(true);
+    ui->videoCodecCombo->clear();
+    for (int i = 0; i < p->count(); i++) {
+        if (qstrcmp("nvenc", p->get(i)) // redundant codec names nvenc_...
+            && qstrcmp("wrapped_avframe", p->get(i))) // not usable
+            ui->videoCodecCombo->addItem(p->get(i));
+    }
+    delete p;
+    ui->videoCodecCombo->model()->sort(0);
+    ui->videoCodecCombo->insertItem(0, tr("Default for format"));
+    ui->videoCodecCombo->setCurrentIndex(0);
+    ui->videoCodecCombo->blockSignals(false);
+}
+
+void EncodeDock::showEvent(QShowEvent* event)
+{
+    QDockWidget::showEvent(event);
+    if (!m_presets) {
+        m_presets = Mlt::Repository::presets();
+        loadPresets();
+    }
+    if (!m_isCombosPopulated) {
+        populateCombos();
+        // Re-apply the default preset so the usual H.264/AAC defaults are
+        // selected now that the full codec lists exist.
+        if (m_isDefaultSettings)
+            on_resetButton_clicked();
+    }
+}
+
 template<typename T>
 static void setIfNotSet(Mlt::Properties* properties, const char* name, T value)
 {
@@ -980,6 +1056,12 @@ MeltJob* EncodeDock::createMeltJob(Mlt::Producer* service, const QString& target
     int frameRateNum = consumerNode.hasAttribute("frame_rate_num")? consumerNode.attribute("frame_rate_num").toInt() : MLT.profile().frame_rate_num();
     int frameRateDen = consumerNode.hasAttribute("frame_rate_den")? consumerNode.attribute("frame_rate_den").toInt() : MLT.profile().frame_rate_den();
     MeltJob* job = new EncodeJob(QDir::toNativeSeparators(target), dom.toString(2), frameRateNum, frameRateDen);
+    // Group throughput history by video codec so the queue can estimate
+    // pending exports from past runs with comparable encoding cost.
+    job->setRateKey(ui->disableVideoCheckbox->isChecked()?
+        QString("audio-only") : ui->videoCodecCombo->currentText());
+    if (service->get_playtime() > 0)
+        job->setTotalFrames(service->get_playtime());
     job->setUseMultiConsumer(
             ui->widthSpinner->value() != MLT.profile().width() ||
             ui->heightSpinner->value() != MLT.profile().height() ||
@@ -1101,6 +1183,271 @@ void EncodeDock::enqueueAnalysis()
     }
 }
 
+bool EncodeDock::isSegmentable() const
+{
+    // Segments can only be concatenated losslessly if each one is certain
+    // to begin on a key frame: an intra-only codec or a GOP size of one.
+    if (ui->disableVideoCheckbox->isChecked())
+        return false;
+    const QString& vcodec = ui->videoCodecCombo->currentText();
+    if (vcodec.contains("prores") || vcodec == "dnxhd" || vcodec == "mjpeg"
+            || vcodec == "huffyuv" || vcodec == "ffvhuff" || vcodec == "utvideo"
+            || vcodec == "v210" || vcodec == "qtrle" || vcodec == "rawvideo")
+        return true;
+    return ui->gopSpinner->value() == 1;
+}
+
+int EncodeDock::plannedSegments(int length) const
+{
+    // A very short segment spends more time starting a process than
+    // encoding. Shared by enqueueSegmented() and exportRenderBundle() so a
+    // bundle's segment plan matches the checkpoint a later local export
+    // computes, letting worker-rendered parts be ingested by concat alone.
+    int minSegmentFrames = qRound(MLT.profile().fps() * 10.0);
+    return qBound(1, qMin(Settings.encodeParallelSegments(), length / qMax(1, minSegmentFrames)),
+                  QThread::idealThreadCount());
+}
+
+bool EncodeDock::enqueueSegmented(Mlt::Producer* service, const QString& target, int realtime)
+{
+    // Render the export as parallel time segments stitched by a lossless
+    // concat for near-linear scaling on many-core machines. Enabled by the
+    // encode/parallelSegments setting and only used when isSegmentable()
+    // guarantees the segments join on key frame boundaries.
+    if (Settings.encodeParallelSegments() < 2 || Settings.playerGPU()
+            || !isSegmentable() || !MLT.isSeekable(service))
+        return false;
+    int in = service->get_in();
+    int out = service->get_out();
+    int length = out - in + 1;
+    int segments = plannedSegments(length);
+    if (segments < 2)
+        return false;
+
+    // Divide the encoding threads among the segments.
+    if (realtime < -1)
+        realtime = qMin(-1, realtime / segments);
+
+    QFileInfo fi(target);
+
+    // Each completed segment is recorded in a checkpoint file. If the last
+    // export of this target was interrupted, only the missing segments are
+    // re-rendered and concatenated with the surviving part files.
+    QString checkpointFileName = QString("%1/%2-export.checkpoint").arg(fi.path()).arg(fi.baseName());
+    QString plan = QString("%1 %2 %3 %4").arg(in).arg(out).arg(segments)
+                                         .arg(ui->videoCodecCombo->currentText());
+    QStringList completedParts;
+    QFile checkpointFile(checkpointFileName);
+    if (checkpointFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream checkpointStream(&checkpointFile);
+        // A checkpoint from a different segment plan cannot be reused.
+        if (checkpointStream.readLine() == plan) {
+            QString line = checkpointStream.readLine();
+            for (; !line.isNull(); line = checkpointStream.readLine()) {
+                if (!line.isEmpty() && QFile::exists(line))
+                    completedParts << line;
+            }
+        }
+        checkpointFile.close();
+    }
+    if (checkpointFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream checkpointStream(&checkpointFile);
+        checkpointStream << plan << '\n';
+        foreach (const QString& partFile, completedParts)
+            checkpointStream << partFile << '\n';
+        checkpointFile.close();
+    }
+
+    int digits = QString::number(segments).size();
+    QString xml = MLT.XML(service);
+    QList<AbstractJob*> segmentJobs;
+    QStringList partFiles;
+    for (int i = 0; i < segments; i++) {
+        int segmentIn = in + i * length / segments;
+        int segmentOut = (i == segments - 1)? out : (in + (i + 1) * length / segments - 1);
+        QString filename = QString("%1/%2-part%3.%4").arg(fi.path()).arg(fi.baseName())
+                                                     .arg(i + 1, digits, 10, QChar('0')).arg(fi.completeSuffix());
+        partFiles << filename;
+        if (completedParts.contains(filename))
+            continue; // rendered by a previous interrupted run
+        QScopedPointer<Mlt::Producer> producer(
+            new Mlt::Producer(MLT.profile(), "xml-string", xml.toUtf8().constData()));
+        producer->set_in_and_out(segmentIn, segmentOut);
+        MeltJob* job = createMeltJob(producer.data(), filename, realtime);
+        if (!job) {
+            qDeleteAll(segmentJobs);
+            return false;
+        }
+        job->setLane(AbstractJob::SegmentLane);
+        job->setPostJobAction(new RecordCheckpointPostJobAction(checkpointFileName, filename));
+        segmentJobs << job;
+    }
+
+    // The ffmpeg concat demuxer script listing the segments in order.
+    QString listFileName = QString("%1/%2-concat.txt").arg(fi.path()).arg(fi.baseName());
+    QFile listFile(listFileName);
+    if (!listFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDeleteAll(segmentJobs);
+        return false;
+    }
+    QTextStream stream(&listFile);
+    foreach (const QString& partFile, partFiles)
+        stream << "file '" << QString(partFile).replace("'", "'\\''") << "'\n";
+    listFile.close();
+
+    QStringList args;
+    args << "-loglevel" << "verbose";
+    args << "-f" << "concat" << "-safe" << "0";
+    args << "-i" << listFileName;
+    args << "-c" << "copy";
+    args << "-y" << QDir::toNativeSeparators(target);
+    FfmpegJob* concatJob = new FfmpegJob(QDir::toNativeSeparators(target), args, false);
+    concatJob->setLabel(tr("Concatenate %1").arg(Util::baseName(target)));
+    concatJob->setPostJobAction(new RemoveFilesPostJobAction(
+        QStringList(partFiles) << listFileName << checkpointFileName));
+
+    foreach (AbstractJob* job, segmentJobs) {
+        concatJob->addDependency(job);
+        JOBS.add(job);
+    }
+    JOBS.add(concatJob);
+    return true;
+}
+
+void EncodeDock::exportRenderBundle()
+{
+    Mlt::Producer* service = fromProducer();
+    if (!MLT.producer() || !MLT.isSeekable(service)) {
+        MAIN.showStatusMessage(tr("Export bundle requires a seekable project."));
+        return;
+    }
+    QString directory = Settings.encodePath();
+    if (!m_extension.isEmpty() && !MAIN.fileName().isEmpty())
+        directory += QString("/%1.%2").arg(QFileInfo(MAIN.fileName()).completeBaseName())
+                                      .arg(m_extension);
+    QString caption = tr("Export Render Bundle");
+    QString nameFilter;
+    if (!m_extension.isEmpty())
+        nameFilter = tr("%1 (*.%2);;All Files (*)").arg(ui->formatCombo->currentText()).arg(m_extension);
+    QString target = QFileDialog::getSaveFileName(this, caption, directory, nameFilter);
+    if (target.isEmpty())
+        return;
+    QFileInfo fi(target);
+    MLT.pause();
+    Settings.setEncodePath(fi.path());
+    if (!m_extension.isEmpty() && fi.suffix().isEmpty()) {
+        target += '.';
+        target += m_extension;
+        fi.setFile(target);
+    }
+
+    int in = service->get_in();
+    int out = service->get_out();
+    int length = out - in + 1;
+    int segments = (isSegmentable() && !Settings.playerGPU())? plannedSegments(length) : 1;
+
+    // Project XML with relative paths so the bundle can be mounted at any
+    // path on the workers; saveXML() also swaps proxies for originals.
+    QString projectFileName = QString("%1/%2-project.mlt").arg(fi.path()).arg(fi.baseName());
+    if (!MLT.saveXML(projectFileName, service, true)) {
+        MAIN.showStatusMessage(tr("Failed to write %1").arg(projectFileName));
+        return;
+    }
+
+    int digits = QString::number(segments).size();
+    QStringList partFiles;
+    for (int i = 0; i < segments; i++) {
+        partFiles << QString("%1/%2-part%3.%4").arg(fi.path()).arg(fi.baseName())
+                                               .arg(i + 1, digits, 10, QChar('0')).arg(fi.completeSuffix());
+    }
+
+    // Seed the checkpoint enqueueSegmented() reads so ingesting the
+    // worker-rendered parts is a plain local export to the same target:
+    // parts that exist are skipped and only the concat job runs.
+    if (segments >= 2) {
+        QString checkpointFileName = QString("%1/%2-export.checkpoint").arg(fi.path()).arg(fi.baseName());
+        QFile checkpointFile(checkpointFileName);
+        if (checkpointFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            QTextStream stream(&checkpointFile);
+            stream << QString("%1 %2 %3 %4").arg(in).arg(out).arg(segments)
+                                            .arg(ui->videoCodecCombo->currentText()) << '\n';
+            foreach (const QString& partFile, partFiles)
+                stream << partFile << '\n';
+            checkpointFile.close();
+        }
+    }
+
+    // The consumer properties a local export would set, as melt arguments.
+    QStringList consumerArgs;
+    QScopedPointer<Mlt::Properties> p(collectProperties(-1));
+    if (p && p->is_valid()) {
+        for (int i = 0; i < p->count(); i++)
+            consumerArgs << QString("%1=%2").arg(p->get_name(i)).arg(p->get(i));
+    }
+
+    // The manifest the workers consume: one segment per line with its
+    // frame range and part file, all paths relative to the bundle.
+    QString manifestFileName = QString("%1/%2-manifest.txt").arg(fi.path()).arg(fi.baseName());
+    QFile manifestFile(manifestFileName);
+    if (!manifestFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        MAIN.showStatusMessage(tr("Failed to write %1").arg(manifestFileName));
+        return;
+    }
+    QTextStream manifest(&manifestFile);
+    manifest << "# Shotcut render bundle. Render each segment with\n";
+    manifest << "#   melt <project> in=<in> out=<out> -consumer avformat:<part> <consumer args>\n";
+    manifest << "# then export to the same target from Shotcut to concatenate the parts.\n";
+    manifest << "version 1\n";
+    manifest << "project " << QFileInfo(projectFileName).fileName() << '\n';
+    manifest << "target " << fi.fileName() << '\n';
+    manifest << "segments " << segments << '\n';
+    for (int i = 0; i < segments; i++) {
+        int segmentIn = in + i * length / segments;
+        int segmentOut = (i == segments - 1)? out : (in + (i + 1) * length / segments - 1);
+        manifest << "segment " << (i + 1) << ' ' << segmentIn << ' ' << segmentOut
+                 << ' ' << QFileInfo(partFiles[i]).fileName() << '\n';
+    }
+    manifest << "consumer avformat " << consumerArgs.join(" ") << '\n';
+    manifestFile.close();
+
+    // Checksums of the referenced media so the workers can verify their
+    // copy of the share. Uses the same partial-content MD5 as the rest of
+    // the app (see Util::getFileHash()).
+    QString checksumsFileName = QString("%1/%2-checksums.txt").arg(fi.path()).arg(fi.baseName());
+    QFile checksumsFile(checksumsFileName);
+    if (checksumsFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream checksums(&checksumsFile);
+        QFile projectFile(projectFileName);
+        QDomDocument doc;
+        QSet<QString> seen;
+        if (projectFile.open(QIODevice::ReadOnly) && doc.setContent(&projectFile)) {
+            QDomNodeList properties = doc.elementsByTagName("property");
+            for (int i = 0; i < properties.size(); i++) {
+                QDomElement property = properties.at(i).toElement();
+                QString name = property.attribute("name");
+                if (name != "resource" && name != "warp_resource" && name != "filename")
+                    continue;
+                QString value = property.text();
+                if (value.isEmpty() || seen.contains(value))
+                    continue;
+                seen.insert(value);
+                QFileInfo resource(value);
+                if (resource.isRelative())
+                    resource.setFile(fi.path() + '/' + value);
+                if (!resource.isFile())
+                    continue;
+                QString hash = Util::getFileHash(resource.filePath());
+                if (!hash.isEmpty())
+                    checksums << hash << "  " << value << '\n';
+            }
+        }
+        projectFile.close();
+        checksumsFile.close();
+    }
+
+    MAIN.showStatusMessage(tr("Wrote render bundle %1").arg(QFileInfo(manifestFileName).fileName()));
+}
+
 void EncodeDock::enqueueMelt(const QString& target, int realtime)
 {
     Mlt::Producer* service = fromProducer();
@@ -1138,6 +1485,9 @@ void EncodeDock::enqueueMelt(const QString& target, int realtime)
             }
         }
     } else {
+        // Two-pass encoding shares a stats file and cannot be segmented.
+        if (!pass && enqueueSegmented(service, target, realtime))
+            return;
         MeltJob* job = createMeltJob(service, target, realtime, pass);
         if (job) {
             JOBS.add(job);
@@ -1325,10 +1675,15 @@ void EncodeDock::on_presetsTree_clicked(const QModelIndex &index)
         if (m_presetsModel.data(index.parent()).toString() == tr("Custom")
             || m_presetsModel.data(index.parent().parent()).toString() == tr("Custom")) {
             ui->removePresetButton->setEnabled(true);
-            preset = new Mlt::Properties();
-            QDir dir(Settings.appDataLocation());
-            if (dir.cd("presets") && dir.cd("encode"))
-                preset->load(dir.absoluteFilePath(name).toLatin1().constData());
+            QSharedPointer<Mlt::Properties> cached = m_customPresetCache.value(name);
+            if (!cached) {
+                cached.reset(new Mlt::Properties());
+                QDir dir(Settings.appDataLocation());
+                if (dir.cd("presets") && dir.cd("encode"))
+                    cached->load(dir.absoluteFilePath(name).toLatin1().constData());
+                m_customPresetCache.insert(name, cached);
+            }
+            preset = new Mlt::Properties(*cached);
         }
         else {
             ui->removePresetButton->setEnabled(false);
@@ -1337,6 +1692,8 @@ void EncodeDock::on_presetsTree_clicked(const QModelIndex &index)
         if (preset->is_valid()) {
             QStringList textParts = name.split('/');
 
+            // One repaint when everything is set instead of one per widget.
+            setUpdatesEnabled(false);
             resetOptions();
             if (textParts.count() > 3) {
                 // textParts = ['consumer', 'avformat', profile, preset].
@@ -1353,6 +1710,10 @@ void EncodeDock::on_presetsTree_clicked(const QModelIndex &index)
                 }
             }
             loadPresetFromProperties(*preset);
+            // A chosen preset ends the profile-following default mode; with
+            // widget signals blocked this no longer happens as a side effect.
+            m_isDefaultSettings = false;
+            setUpdatesEnabled(true);
         }
         delete preset;
     } else {
@@ -1365,6 +1726,81 @@ void EncodeDock::on_presetsTree_activated(const QModelIndex &index)
     on_presetsTree_clicked(index);
 }
 
+void EncodeDock::on_benchmarkButton_clicked()
+{
+    Mlt::Producer* service = fromProducer();
+    if (!service || !MLT.isSeekable(service))
+        return;
+    if (m_benchmarkPending > 0) {
+        MAIN.showStatusMessage(tr("A benchmark is already running."));
+        return;
+    }
+
+    // Leaf rows only; parents are the grouping folders.
+    QList<QPersistentModelIndex> presets;
+    foreach (const QModelIndex& index, ui->presetsTree->selectionModel()->selectedIndexes()) {
+        if (index.parent().isValid())
+            presets << QPersistentModelIndex(index);
+    }
+    if (presets.isEmpty()) {
+        MAIN.showStatusMessage(tr("Select one or more presets to benchmark."));
+        return;
+    }
+
+    // A slice from the middle of the source so every preset encodes the
+    // same representative frames.
+    const QString xml = MLT.XML(service);
+    int slice = qRound(MLT.profile().fps() * kBenchmarkSeconds);
+    const QPersistentModelIndex current(ui->presetsTree->currentIndex());
+
+    m_benchmarkReport = tr("Preset\tfps\tSize (KB)\n");
+    foreach (const QPersistentModelIndex& index, presets) {
+        // Load the preset into the dock controls; createMeltJob reads them.
+        on_presetsTree_clicked(index);
+        QString presetName = m_presetsModel.data(index).toString();
+        QString fileName = QString("shotcut-benchmark-%1.%2")
+                .arg(QString(presetName).replace(QRegularExpression("[^a-zA-Z0-9]"), "_"))
+                .arg(m_extension.isEmpty()? "mp4" : m_extension);
+        Mlt::Producer producer(MLT.profile(), "xml-string", xml.toUtf8().constData());
+        if (!producer.is_valid())
+            continue;
+        int in = qMax(0, (producer.get_length() - slice) / 2);
+        producer.set_in_and_out(in, qMin(producer.get_length() - 1, in + slice - 1));
+        MeltJob* job = createMeltJob(&producer, QDir::temp().filePath(fileName), -1);
+        if (job) {
+            job->setLabel(tr("Benchmark %1").arg(presetName));
+            connect(job, SIGNAL(finished(AbstractJob*, bool, QString)), this,
+                    SLOT(onBenchmarkFinished(AbstractJob*, bool)));
+            JOBS.add(job);
+            ++m_benchmarkPending;
+        }
+    }
+    // Put the controls back the way the user left them.
+    if (current.isValid())
+        on_presetsTree_clicked(current);
+}
+
+void EncodeDock::onBenchmarkFinished(AbstractJob* job, bool isSuccess)
+{
+    if (isSuccess) {
+        m_benchmarkReport += QString("%1\t%2\t%3\n")
+                .arg(job->label())
+                .arg(job->framesPerSecond(), 0, 'f', 1)
+                .arg(QFileInfo(job->objectName()).size() / 1024);
+    } else {
+        m_benchmarkReport += tr("%1\tfailed\n").arg(job->label());
+    }
+    if (--m_benchmarkPending <= 0) {
+        m_benchmarkPending = 0;
+        // Each result stays in the jobs panel with the usual Measure Video
+        // Quality action for comparing the presets beyond speed and size.
+        TextViewerDialog dialog(this);
+        dialog.setWindowTitle(tr("Export Benchmark"));
+        dialog.setText(m_benchmarkReport);
+        dialog.exec();
+    }
+}
+
 void EncodeDock::on_encodeButton_clicked()
 {
     if (!MLT.producer())
@@ -1646,6 +2082,7 @@ void EncodeDock::on_removePresetButton_clicked()
         QDir dir(Settings.appDataLocation());
         if (dir.cd("presets") && dir.cd("encode")) {
             dir.remove(preset);
+            m_customPresetCache.remove(preset);
             m_presetsModel.removeRow(index.row(), index.parent());
         }
     }
@@ -20,6 +20,8 @@
 
 #include <QDockWidget>
 #include <QDomElement>
+#include <QHash>
+#include <QSharedPointer>
 #include <QStandardItemModel>
 #include <QSortFilterProxyModel>
 #include <MltProperties.h>
@@ -52,6 +54,11 @@ public:
 
     void loadPresetFromProperties(Mlt::Properties&);
     bool isExportInProgress() const;
+    /// Write a directory-relative project XML, segment manifest, and media
+    /// checksums next to a chosen target so external melt workers can
+    /// render the segments; a later export to the same target ingests the
+    /// finished parts through the segment checkpoint.
+    void exportRenderBundle();
 
 signals:
     void captureStateChanged(bool);
@@ -63,10 +70,17 @@ public slots:
     void on_hwencodeButton_clicked();
     bool detectHardwareEncoders();
 
+protected:
+    void showEvent(QShowEvent*) Q_DECL_OVERRIDE;
+
 private slots:
     void on_presetsTree_clicked(const QModelIndex &index);
     void on_presetsTree_activated(const QModelIndex &index);
 
+    void on_benchmarkButton_clicked();
+
+    void onBenchmarkFinished(AbstractJob*, bool isSuccess);
+
     void on_encodeButton_clicked();
 
     void on_streamButton_clicked();
@@ -146,8 +160,17 @@ private:
     QString m_outputFilename;
     bool m_isDefaultSettings;
     double m_fps;
+    bool m_isCombosPopulated;
+    // Benchmark jobs still in the queue and the tab-separated results
+    // shown when the last one finishes.
+    int m_benchmarkPending;
+    QString m_benchmarkReport;
+    // Custom preset files parsed once per loadPresets(), keyed by file
+    // name, so arrowing through the tree does not hit the disk per click.
+    QHash<QString, QSharedPointer<Mlt::Properties> > m_customPresetCache;
 
     void loadPresets();
+    void populateCombos();
     Mlt::Properties* collectProperties(int realtime);
     void collectProperties(QDomElement& node, int realtime);
     MeltJob* createMeltJob(Mlt::Producer* service, const QString& target, int realtime, int pass = 0);
@@ -156,6 +179,9 @@ private:
     void enqueueAnalysis();
 #endif
     void enqueueMelt(const QString& target, int realtime);
+    bool isSegmentable() const;
+    int plannedSegments(int length) const;
+    bool enqueueSegmented(Mlt::Producer* service, const QString& target, int realtime);
     void encode(const QString& target);
     void resetOptions();
     Mlt::Producer* fromProducer() const;
@@ -71,10 +71,20 @@ void JobsDock::onJobAdded()
     label->setText(label->fontMetrics().elidedText(
         JOBS.data(index).toString(), Qt::ElideMiddle, ui->treeView->columnWidth(JobQueue::COLUMN_OUTPUT)));
     connect(JOBS.jobFromIndex(index), SIGNAL(progressUpdated(QStandardItem*, int)), SLOT(onProgressUpdated(QStandardItem*, int)));
+    updateEta();
     show();
     raise();
 }
 
+void JobsDock::updateEta()
+{
+    QTime eta = JOBS.estimateRemaining();
+    if (eta.isValid())
+        ui->etaLabel->setText(tr("ETA %1").arg(eta.toString()));
+    else
+        ui->etaLabel->clear();
+}
+
 void JobsDock::onProgressUpdated(QStandardItem* item, int percent)
 {
     if (item) {
@@ -83,6 +93,7 @@ void JobsDock::onProgressUpdated(QStandardItem* item, int percent)
         if (progressBar)
             progressBar->setValue(percent);
     }
+    updateEta();
 }
 
 void JobsDock::resizeEvent(QResizeEvent *event)
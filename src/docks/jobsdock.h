@@ -46,6 +46,8 @@ protected:
 private:
     Ui::JobsDock *ui;
 
+    void updateEta();
+
 private slots:
     void on_treeView_customContextMenuRequested(const QPoint &pos);
     void on_actionStopJob_triggered();
@@ -21,7 +21,12 @@
 #include "dialogs/filedatedialog.h"
 #include "dialogs/longuitask.h"
 #include "dialogs/slideshowgeneratordialog.h"
+#include "dialogs/transcodedialog.h"
+#include "database.h"
+#include "jobqueue.h"
+#include "jobs/ffmpegjob.h"
 #include "mainwindow.h"
+#include "qmltypes/qmlapplication.h"
 #include "settings.h"
 #include "shotcut_mlt_properties.h"
 #include "widgets/playlisticonview.h"
@@ -36,6 +41,7 @@
 #include <QStyledItemDelegate>
 #include <QPainter>
 #include <QDebug>
+#include <QFileDialog>
 #include <QHeaderView>
 #include <QKeyEvent>
 #include <QDir>
@@ -321,6 +327,7 @@ void PlaylistDock::on_menuButton_clicked()
         menu.addAction(ui->actionUpdate);
         menu.addAction(ui->actionUpdateThumbnails);
         menu.addAction(ui->actionSetFileDate);
+        menu.addAction(ui->actionConvertSelected);
         menu.addSeparator();
     }
     menu.addAction(ui->actionRemoveAll);
@@ -499,6 +506,102 @@ void PlaylistDock::on_actionSetFileDate_triggered()
     }
 }
 
+void PlaylistDock::on_actionConvertSelected_triggered()
+{
+    if (!m_model.playlist() || !m_view->selectionModel()) return;
+
+    // Gather the unique files among the selected items.
+    QStringList resources;
+    QList<int> rows;
+    foreach (auto index, m_view->selectionModel()->selectedIndexes()) {
+        if (rows.contains(index.row())) continue;
+        rows << index.row();
+        QScopedPointer<Mlt::ClipInfo> info(m_model.playlist()->clip_info(index.row()));
+        if (!info || !info->producer || !info->producer->is_valid()) continue;
+        QString resource = ProxyManager::resource(*info->producer);
+        if (QFileInfo(resource).isFile() && !resources.contains(resource))
+            resources << resource;
+    }
+    if (resources.isEmpty()) {
+        emit showStatusMessage(tr("There is nothing to convert in the selection."));
+        return;
+    }
+
+    // One settings application covers the whole batch.
+    TranscodeDialog dialog(tr("Choose an edit-friendly format below and then click OK to choose a folder. "
+                              "A job is created for each of the %1 files, and several run in parallel.\n")
+                           .arg(resources.size()), true, this);
+    dialog.setWindowTitle(tr("Convert Selected Files"));
+    dialog.setWindowModality(QmlApplication::dialogModality());
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+    QString directory = QFileDialog::getExistingDirectory(this, dialog.windowTitle(), Settings.savePath());
+    if (directory.isEmpty())
+        return;
+    Settings.setSavePath(directory);
+
+    int jobNumber = 0;
+    QStringList seen;
+    foreach (int row, rows) {
+        QScopedPointer<Mlt::ClipInfo> info(m_model.playlist()->clip_info(row));
+        if (!info || !info->producer || !info->producer->is_valid()) continue;
+        Mlt::Producer& producer = *info->producer;
+        QString resource = ProxyManager::resource(producer);
+        if (!QFileInfo(resource).isFile() || seen.contains(resource)) continue;
+        seen << resource;
+
+        // Derive the scan and range arguments from each file's metadata.
+        int progressive = producer.get_int("meta.media.progressive");
+        if (producer.get("force_progressive"))
+            progressive = producer.get_int("force_progressive");
+        int tff = producer.get_int("meta.media.top_field_first");
+        if (producer.get("force_tff"))
+            tff = producer.get_int("force_tff");
+        int fullRange = !qstrcmp(producer.get("meta.media.color_range"), "full");
+        if (producer.get("color_range"))
+            fullRange = producer.get_int("color_range") == 2;
+        else if (producer.get("set.force_full_luma"))
+            fullRange = producer.get_int("set.force_full_luma");
+
+        QString suffix;
+        QStringList args = TranscodeDialog::ffmpegArgs(producer, resource, dialog.format(),
+            progressive, tff, fullRange, &suffix);
+        QString filename = QString("%1/%2 - %3.%4").arg(directory)
+            .arg(QFileInfo(resource).completeBaseName()).arg(tr("Converted")).arg(suffix);
+        if (filename == QDir::toNativeSeparators(resource)) continue;
+        if (Util::warnIfNotWritable(filename, this, dialog.windowTitle(), true /* remove */))
+            continue;
+
+        args << "-y" << filename;
+
+        // The job history may already hold this exact conversion, performed
+        // for another project; copy its output instead of re-encoding.
+        QString hash = Util::getHash(producer);
+        QStringList fingerprint = args;
+        fingerprint.removeAll(resource);
+        fingerprint.removeAll(filename);
+        QString parameters = fingerprint.join(' ');
+        QString previous = DB.getJobRecordOutput(hash, "convert", parameters);
+        if (!previous.isEmpty() && QFileInfo(previous).size() > 0
+                && QFile::copy(previous, filename)) {
+            LOG_INFO() << "reusing conversion" << previous << "for" << resource;
+            ConvertReplacePostJobAction action(resource, filename, hash);
+            action.doAction();
+            continue;
+        }
+
+        FfmpegJob* job = new FfmpegJob(filename, args, false);
+        job->setLane(AbstractJob::ConvertLane);
+        job->setLabel(tr("Convert %1 (%2 of %3)").arg(Util::baseName(filename))
+                      .arg(++jobNumber).arg(resources.size()));
+        job->setProvenance(hash, "convert", parameters, filename);
+        job->setPostJobAction(new ConvertReplacePostJobAction(resource, filename, hash));
+        JOBS.add(job);
+    }
+    if (jobNumber > 0)
+        emit showStatusMessage(tr("Created %1 conversion jobs").arg(jobNumber));
+}
+
 void PlaylistDock::setUpdateButtonEnabled(bool modified)
 {
     ui->updateButton->setEnabled(modified);
@@ -559,6 +662,7 @@ void PlaylistDock::viewCustomContextMenuRequested(const QPoint &pos)
         menu.addAction(ui->actionUpdate);
         menu.addAction(ui->actionUpdateThumbnails);
         menu.addAction(ui->actionSetFileDate);
+        menu.addAction(ui->actionConvertSelected);
         menu.exec(mapToGlobal(pos));
     }
 }
@@ -22,8 +22,10 @@
 
 #include <QAction>
 #include <QDir>
+#include <QFileInfo>
 #include <QKeyEvent>
 #include <QMenu>
+#include <QtConcurrent/QtConcurrent>
 #include <Logger.h>
 
 static const int MaxItems = 100;
@@ -65,11 +67,28 @@ RecentDock::RecentDock(QWidget *parent) :
     m_proxyModel.setSourceModel(&m_model);
     m_proxyModel.setFilterCaseSensitivity(Qt::CaseInsensitive);
     ui->listWidget->setModel(&m_proxyModel);
+
+    // Validate the entries on a worker thread. Each result arrives via a
+    // queued signal so the list populates immediately and a stat that hangs
+    // on a dead network mount never blocks the GUI thread.
+    connect(this, SIGNAL(validated(QString,bool)), this, SLOT(onValidated(QString,bool)));
+    const QStringList paths = m_recent;
+    m_validateFuture = QtConcurrent::run([this, paths] {
+        foreach (const QString& s, paths) {
+            if (m_isValidateCanceled.loadAcquire())
+                return;
+            // Only local, absolute paths; leave URLs and protocols alone.
+            if (s.startsWith('/') || s.midRef(1, 2) == ":/" || s.midRef(1, 2) == ":\\")
+                emit validated(s, QFileInfo::exists(s));
+        }
+    });
     LOG_DEBUG() << "end";
 }
 
 RecentDock::~RecentDock()
 {
+    m_isValidateCanceled.storeRelease(1);
+    m_validateFuture.waitForFinished();
     delete ui;
 }
 
@@ -138,6 +157,20 @@ void RecentDock::on_actionDelete_triggered()
     }
 }
 
+void RecentDock::onValidated(const QString& fileName, bool exists)
+{
+    if (exists)
+        return;
+    QString toolTip = QDir::toNativeSeparators(fileName);
+    for (int row = 0; row < m_model.rowCount(); row++) {
+        QStandardItem* item = m_model.item(row);
+        // The tool tip doubles as the URL for activation, so only dim the
+        // text instead of annotating it.
+        if (item && item->toolTip() == toolTip)
+            item->setForeground(palette().brush(QPalette::Disabled, QPalette::Text));
+    }
+}
+
 void RecentDock::on_listWidget_customContextMenuRequested(const QPoint& pos)
 {
     if (ui->listWidget->currentIndex().isValid()) {
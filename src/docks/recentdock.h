@@ -21,6 +21,8 @@
 #include <QDockWidget>
 #include <QStandardItemModel>
 #include <QSortFilterProxyModel>
+#include <QFuture>
+#include <QAtomicInt>
 
 namespace Ui {
     class RecentDock;
@@ -37,6 +39,7 @@ public:
 signals:
     void itemActivated(const QString& url);
     void deleted(const QString& url);
+    void validated(const QString& fileName, bool exists);
 
 public slots:
     void add(const QString&);
@@ -51,12 +54,17 @@ private:
     QStringList m_recent;
     QStandardItemModel m_model;
     QSortFilterProxyModel m_proxyModel;
+    // Checks every local recent path for existence on a worker thread so an
+    // unreachable network share never blocks the GUI thread.
+    QFuture<void> m_validateFuture;
+    QAtomicInt m_isValidateCanceled;
 
 private slots:
     void on_listWidget_activated(const QModelIndex& i);
     void on_lineEdit_textChanged(const QString& search);
     void on_actionDelete_triggered();
     void on_listWidget_customContextMenuRequested(const QPoint& pos);
+    void onValidated(const QString& fileName, bool exists);
 };
 
 #endif // RECENTDOCK_H
@@ -56,9 +56,9 @@ void ScopeDock::resizeEvent(QResizeEvent* e)
 void ScopeDock::onActionToggled(bool checked)
 {
     if(checked) {
-        connect(m_scopeController, SIGNAL(newFrame(const SharedFrame&)), m_scopeWidget, SLOT(onNewFrame(const SharedFrame&)));
+        connect(m_scopeController, SIGNAL(frameAvailable()), m_scopeWidget, SLOT(onFrameAvailable()));
         MLT.refreshConsumer();
     } else {
-        disconnect(m_scopeController, SIGNAL(newFrame(const SharedFrame&)), m_scopeWidget, SLOT(onNewFrame(const SharedFrame&)));
+        disconnect(m_scopeController, SIGNAL(frameAvailable()), m_scopeWidget, SLOT(onFrameAvailable()));
     }
 }
@@ -19,6 +19,7 @@
 #include "ui_timelinedock.h"
 #include "models/audiolevelstask.h"
 #include "models/multitrackmodel.h"
+#include "qmltypes/thumbnailprefetcher.h"
 #include "qmltypes/thumbnailprovider.h"
 #include "mainwindow.h"
 #include "commands/timelinecommands.h"
@@ -34,6 +35,7 @@
 #include <QtQml>
 #include <QtQuick>
 #include <Logger.h>
+#include <algorithm>
 
 static QString kNonSeekableWarning = QObject::tr("You cannot add a non-seekable source.");
 
@@ -45,7 +47,8 @@ TimelineDock::TimelineDock(QWidget *parent) :
     m_ignoreNextPositionChange(false),
     m_trimDelta(0),
     m_transitionDelta(0),
-    m_blockSetSelection(false)
+    m_blockSetSelection(false),
+    m_boundaryIndexDirty(true)
 {
     LOG_DEBUG() << "begin";
     m_selection.selectedTrack = -1;
@@ -59,7 +62,10 @@ TimelineDock::TimelineDock(QWidget *parent) :
     QDir importPath = QmlUtilities::qmlDir();
     importPath.cd("modules");
     m_quickView.engine()->addImportPath(importPath.path());
-    m_quickView.engine()->addImageProvider(QString("thumbnail"), new ThumbnailProvider);
+    ThumbnailProvider* thumbnailProvider = new ThumbnailProvider;
+    m_quickView.engine()->addImageProvider(QString("thumbnail"), thumbnailProvider);
+    // The engine owns the provider and outlives this dock.
+    m_thumbnailPrefetcher = new ThumbnailPrefetcher(thumbnailProvider, &m_model, this);
     QmlUtilities::setCommonProperties(m_quickView.rootContext());
     m_quickView.rootContext()->setContextProperty("view", new QmlView(&m_quickView));
     m_quickView.rootContext()->setContextProperty("timeline", this);
@@ -74,6 +80,11 @@ TimelineDock::TimelineDock(QWidget *parent) :
     connect(&m_model, &MultitrackModel::overWritten, this, &TimelineDock::onOverWritten, Qt::QueuedConnection);
     connect(&m_model, SIGNAL(rowsInserted(QModelIndex,int,int)), SLOT(onRowsInserted(QModelIndex,int,int)));
     connect(&m_model, SIGNAL(rowsRemoved(QModelIndex,int,int)), SLOT(onRowsRemoved(QModelIndex,int,int)));
+    connect(&m_model, SIGNAL(modified()), this, SLOT(invalidateBoundaryIndex()));
+    connect(&m_model, SIGNAL(loaded()), this, SLOT(invalidateBoundaryIndex()));
+    connect(&m_model, SIGNAL(closed()), this, SLOT(invalidateBoundaryIndex()));
+    connect(&m_model, SIGNAL(rowsInserted(QModelIndex,int,int)), SLOT(invalidateBoundaryIndex()));
+    connect(&m_model, SIGNAL(rowsRemoved(QModelIndex,int,int)), SLOT(invalidateBoundaryIndex()));
 
     setWidget(&m_quickView);
 
@@ -101,6 +112,11 @@ void TimelineDock::setPosition(int position)
     }
 }
 
+void TimelineDock::prefetchThumbnails(qreal contentX, qreal viewportWidth, qreal scaleFactor)
+{
+    m_thumbnailPrefetcher->onScrolled(contentX, viewportWidth, scaleFactor);
+}
+
 Mlt::ClipInfo *TimelineDock::getClipInfo(int trackIndex, int clipIndex)
 {
     Mlt::ClipInfo* result = nullptr;
@@ -136,14 +152,8 @@ int TimelineDock::clipIndexAtPosition(int trackIndex, int position)
     int result = -1;
     if (trackIndex < 0)
         trackIndex = currentTrack();
-    if (trackIndex >= 0 && trackIndex < m_model.trackList().size()) {
-        int i = m_model.trackList().at(trackIndex).mlt_index;
-        QScopedPointer<Mlt::Producer> track(m_model.tractor()->track(i));
-        if (track) {
-            Mlt::Playlist playlist(*track);
-            result = playlist.get_clip_index_at(position);
-        }
-    }
+    if (trackIndex >= 0 && trackIndex < m_model.trackList().size())
+        result = m_model.clipIndex(trackIndex, position);
     return result;
 }
 
@@ -551,9 +561,14 @@ void TimelineDock::append(int trackIndex)
     if (MAIN.isSourceClipMyProject()) return;
     if (MLT.isSeekableClip() || MLT.savedProducer()) {
         Mlt::Producer producer(MLT.isClip()? MLT.producer() : MLT.savedProducer());
-        ProxyManager::generateIfNotExists(producer);
+        if (ProxyManager::generateIfNotExists(producer) && !MLT.isClip()) {
+            // Proxy substitution modified the saved producer, so its
+            // cached XML must be refreshed.
+            MLT.setSavedProducer(&producer);
+        }
         MAIN.undoStack()->push(
-            new Timeline::AppendCommand(m_model, trackIndex, MLT.XML(&producer)));
+            new Timeline::AppendCommand(m_model, trackIndex,
+                MLT.isClip()? MLT.XML(&producer) : MLT.savedProducerXml()));
         selectClipUnderPlayhead();
     } else if (!MLT.isSeekableClip()) {
         emit showStatusMessage(kNonSeekableWarning);
@@ -615,16 +630,26 @@ void TimelineDock::removeSelection(bool withCopy)
     }
 
     // Ripple delete
-    int n = selection().size();
-    if (n > 1)
-        MAIN.undoStack()->beginMacro(tr("Remove %1 from timeline").arg(n));
+    if (selection().size() > 1) {
+        // One compound command captures state and re-lays out the model
+        // once for the whole selection instead of once per clip.
+        QVector<QUuid> uuids;
+        int trackIndex, clipIndex;
+        for (const auto& uuid : selectionUuids()) {
+            QScopedPointer<Mlt::ClipInfo> info(m_model.findClipByUuid(uuid, trackIndex, clipIndex));
+            if (!info || isTrackLocked(trackIndex))
+                continue;
+            uuids << uuid;
+        }
+        if (!uuids.isEmpty())
+            MAIN.undoStack()->push(new Timeline::RemoveListCommand(m_model, uuids));
+        return;
+    }
     int trackIndex, clipIndex;
     for (const auto& uuid : selectionUuids()) {
         delete m_model.findClipByUuid(uuid, trackIndex, clipIndex);
         remove(trackIndex, clipIndex);
     }
-    if (n > 1)
-        MAIN.undoStack()->endMacro();
 }
 
 void TimelineDock::liftSelection()
@@ -637,17 +662,45 @@ void TimelineDock::liftSelection()
         selectClipUnderPlayhead();
     if (selection().isEmpty())
         return;
-    int n = selection().size();
-    QVector<QUuid> uuids;
-    if (n > 1)
-        MAIN.undoStack()->beginMacro(tr("Lift %1 from timeline").arg(n));
+    if (selection().size() > 1) {
+        QVector<QUuid> uuids;
+        int trackIndex, clipIndex;
+        for (const auto& uuid : selectionUuids()) {
+            QScopedPointer<Mlt::ClipInfo> info(m_model.findClipByUuid(uuid, trackIndex, clipIndex));
+            if (!info || isTrackLocked(trackIndex) || info->cut->is_blank())
+                continue;
+            uuids << uuid;
+        }
+        if (!uuids.isEmpty()) {
+            MAIN.undoStack()->push(new Timeline::LiftListCommand(m_model, uuids));
+            setSelection();
+        }
+        return;
+    }
     int trackIndex, clipIndex;
     for (const auto& uuid : selectionUuids()) {
         delete m_model.findClipByUuid(uuid, trackIndex, clipIndex);
         lift(trackIndex, clipIndex);
     }
-    if (n > 1)
-        MAIN.undoStack()->endMacro();
+}
+
+void TimelineDock::pasteFiltersOnSelection()
+{
+    if (!MLT.hasFiltersOnClipboard() || selection().isEmpty())
+        return;
+    // Skip locked tracks, blanks, and transitions like the other bulk
+    // selection commands do.
+    QVector<QUuid> uuids;
+    int trackIndex, clipIndex;
+    for (const auto& uuid : selectionUuids()) {
+        QScopedPointer<Mlt::ClipInfo> info(m_model.findClipByUuid(uuid, trackIndex, clipIndex));
+        if (!info || isTrackLocked(trackIndex) || info->cut->is_blank()
+                || info->producer->get(kShotcutTransitionProperty))
+            continue;
+        uuids << uuid;
+    }
+    if (!uuids.isEmpty())
+        MAIN.undoStack()->push(new Timeline::PasteFiltersListCommand(m_model, uuids));
 }
 
 void TimelineDock::selectTrack(int by)
@@ -880,7 +933,7 @@ void TimelineDock::replace(int trackIndex, int clipIndex, const QString& xml)
     if (MLT.isSeekableClip() || MLT.savedProducer() || !xml.isEmpty()) {
         Q_ASSERT(trackIndex >= 0 && clipIndex >= 0);
         QString xmlToUse = !xml.isEmpty()? xml
-            : MLT.XML(MLT.isClip()? nullptr : MLT.savedProducer());
+            : (MLT.isClip()? MLT.XML() : MLT.savedProducerXml());
         MAIN.undoStack()->push(
             new Timeline::ReplaceCommand(m_model, trackIndex, clipIndex, xmlToUse));
     } else if (!MLT.isSeekableClip()) {
@@ -1135,8 +1188,12 @@ void TimelineDock::insert(int trackIndex, int position, const QString &xml, bool
         QString xmlToUse;
         if (xml.isEmpty()) {
             Mlt::Producer producer(MLT.isClip()? MLT.producer() : MLT.savedProducer());
-            ProxyManager::generateIfNotExists(producer);
-            xmlToUse = MLT.XML(&producer);
+            if (ProxyManager::generateIfNotExists(producer) && !MLT.isClip()) {
+                // Proxy substitution modified the saved producer, so its
+                // cached XML must be refreshed.
+                MLT.setSavedProducer(&producer);
+            }
+            xmlToUse = MLT.isClip()? MLT.XML(&producer) : MLT.savedProducerXml();
         } else {
             xmlToUse = convertUrlsToXML(xml);
         }
@@ -1178,8 +1235,12 @@ void TimelineDock::overwrite(int trackIndex, int position, const QString &xml, b
         QString xmlToUse;
         if (xml.isEmpty()) {
             Mlt::Producer producer(MLT.isClip()? MLT.producer() : MLT.savedProducer());
-            ProxyManager::generateIfNotExists(producer);
-            xmlToUse = MLT.XML(&producer);
+            if (ProxyManager::generateIfNotExists(producer) && !MLT.isClip()) {
+                // Proxy substitution modified the saved producer, so its
+                // cached XML must be refreshed.
+                MLT.setSavedProducer(&producer);
+            }
+            xmlToUse = MLT.isClip()? MLT.XML(&producer) : MLT.savedProducerXml();
         } else {
             xmlToUse = convertUrlsToXML(xml);
         }
@@ -1263,26 +1324,58 @@ void TimelineDock::fadeOut(int trackIndex, int clipIndex, int duration)
     emit fadeOutChanged(duration);
 }
 
-void TimelineDock::seekPreviousEdit()
+void TimelineDock::invalidateBoundaryIndex()
 {
-    if (!MLT.isMultitrack()) return;
-    if (!m_model.tractor()) return;
+    m_boundaryIndexDirty = true;
+}
+
+const QVector<int>& TimelineDock::boundaryIndex()
+{
+    if (m_boundaryIndexDirty)
+        rebuildBoundaryIndex();
+    return m_boundaryIndex;
+}
 
-    int newPosition = -1;
+void TimelineDock::rebuildBoundaryIndex()
+{
+    m_boundaryIndex.clear();
+    m_boundaryIndexDirty = false;
+    if (!m_model.tractor()) return;
     int n = m_model.tractor()->count();
     for (int i = 0; i < n; i++) {
         QScopedPointer<Mlt::Producer> track(m_model.tractor()->track(i));
         if (track) {
             Mlt::Playlist playlist(*track);
-            int clipIndex = playlist.get_clip_index_at(m_position);
-            if (clipIndex >= 0 && m_position == playlist.clip_start(clipIndex))
-                --clipIndex;
-            if (clipIndex >= 0)
-                newPosition = qMax(newPosition, playlist.clip_start(clipIndex));
+            int count = playlist.count();
+            // Accumulate clip lengths instead of asking for each clip start;
+            // clip_start() walks the playlist from the beginning every call.
+            int start = 0;
+            for (int j = 0; j < count; j++) {
+                m_boundaryIndex << start;
+                start += playlist.clip_length(j);
+            }
+            // The end of the track is a boundary too.
+            m_boundaryIndex << start;
         }
     }
-    if (newPosition != m_position)
-        setPosition(newPosition);
+    std::sort(m_boundaryIndex.begin(), m_boundaryIndex.end());
+    m_boundaryIndex.erase(std::unique(m_boundaryIndex.begin(), m_boundaryIndex.end()),
+                          m_boundaryIndex.end());
+}
+
+void TimelineDock::seekPreviousEdit()
+{
+    if (!MLT.isMultitrack()) return;
+    if (!m_model.tractor()) return;
+
+    // Largest boundary strictly before the playhead.
+    const QVector<int>& index = boundaryIndex();
+    QVector<int>::const_iterator it =
+        std::lower_bound(index.constBegin(), index.constEnd(), m_position);
+    if (it == index.constBegin()) return;
+    --it;
+    if (*it != m_position)
+        setPosition(*it);
 }
 
 void TimelineDock::seekNextEdit()
@@ -1290,21 +1383,13 @@ void TimelineDock::seekNextEdit()
     if (!MLT.isMultitrack()) return;
     if (!m_model.tractor()) return;
 
-    int newPosition = std::numeric_limits<int>::max();
-    int n = m_model.tractor()->count();
-    for (int i = 0; i < n; i++) {
-        QScopedPointer<Mlt::Producer> track(m_model.tractor()->track(i));
-        if (track) {
-            Mlt::Playlist playlist(*track);
-            int clipIndex = playlist.get_clip_index_at(m_position) + 1;
-            if (clipIndex < playlist.count())
-                newPosition = qMin(newPosition, playlist.clip_start(clipIndex));
-            else if (clipIndex == playlist.count())
-                newPosition = qMin(newPosition, playlist.clip_start(clipIndex) + playlist.clip_length(clipIndex));
-        }
-    }
-    if (newPosition != m_position)
-        setPosition(newPosition);
+    // Smallest boundary strictly after the playhead.
+    const QVector<int>& index = boundaryIndex();
+    QVector<int>::const_iterator it =
+        std::upper_bound(index.constBegin(), index.constEnd(), m_position);
+    if (it == index.constEnd()) return;
+    if (*it != m_position)
+        setPosition(*it);
 }
 
 void TimelineDock::seekInPoint(int clipIndex)
@@ -32,6 +32,7 @@ class UpdateCommand;
 class TrimCommand;
 }
 class UndoHelper;
+class ThumbnailPrefetcher;
 
 class TimelineDock : public QDockWidget
 {
@@ -82,6 +83,7 @@ public:
     Q_INVOKABLE bool isFloating() const { return QDockWidget::isFloating(); }
     Q_INVOKABLE void copyToSource();
     Q_INVOKABLE static void openProperties();
+    Q_INVOKABLE void prefetchThumbnails(qreal contentX, qreal viewportWidth, qreal scaleFactor);
     void emitSelectedChanged(const QVector<int> &roles);
     void replaceClipsWithHash(const QString& hash, Mlt::Producer& producer);
 
@@ -116,6 +118,7 @@ public slots:
     void lift(int trackIndex, int clipIndex);
     void removeSelection(bool withCopy = false);
     void liftSelection();
+    void pasteFiltersOnSelection();
     void selectTrack(int by);
     void selectTrackHead(int trackIndex);
     void selectMultitrack();
@@ -165,6 +168,11 @@ protected:
 private:
     bool isBlank(int trackIndex, int clipIndex);
     void pulseLockButtonOnTrack(int trackIndex);
+    //! Sorted, deduplicated clip boundary positions across all tracks.
+    //! Rebuilt lazily after an edit so prev/next-edit navigation is a
+    //! binary search instead of walking every playlist per keypress.
+    const QVector<int>& boundaryIndex();
+    void rebuildBoundaryIndex();
 
     Ui::TimelineDock *ui;
     QQuickWidget m_quickView;
@@ -181,12 +189,16 @@ private:
     Selection m_savedSelection;
     QScopedPointer<Timeline::TrimCommand> m_trimCommand;
     QScopedPointer<UndoHelper> m_undoHelper;
+    ThumbnailPrefetcher* m_thumbnailPrefetcher;
     int m_trimDelta;
     int m_transitionDelta;
     bool m_blockSetSelection;
+    QVector<int> m_boundaryIndex;
+    bool m_boundaryIndexDirty;
 
 private slots:
     void load(bool force = false);
+    void invalidateBoundaryIndex();
     void onTopLevelChanged(bool floating);
     void onTransitionAdded(int trackIndex, int clipIndex, int position, bool ripple);
     void onInserted(int trackIndex, int clipIndex);
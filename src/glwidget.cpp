@@ -32,6 +32,9 @@
 #include "qmltypes/qmlutilities.h"
 #include "qmltypes/qmlfilter.h"
 #include "mainwindow.h"
+#include "widgets/frametimehud.h"
+#include "perflog.h"
+#include "taskpool.h"
 
 #define USE_GL_SYNC // Use glFinish() if not defined.
 
@@ -70,6 +73,10 @@ GLWidget::GLWidget(QObject *parent)
     , m_shareContext(0)
     , m_snapToGrid(true)
     , m_scrubAudio(false)
+    , m_paintTextureWidth(0)
+    , m_paintTextureHeight(0)
+    , m_adaptiveScale(-1)
+    , m_adaptiveGoodWindows(0)
 {
     LOG_DEBUG() << "begin";
     m_texture[0] = m_texture[1] = m_texture[2] = 0;
@@ -85,8 +92,15 @@ GLWidget::GLWidget(QObject *parent)
     rootContext()->setContextProperty("video", this);
     m_refreshTimer.setInterval(10);
     m_refreshTimer.setSingleShot(true);
-
-    if (Settings.playerGPU())
+    m_frameTimeHud = new FrameTimeHud(this);
+    m_frameTimeHud->move(10, 10);
+    m_frameTimeHud->setVisible(Settings.playerFrameTimeHud());
+    m_frameShowTimer.start();
+
+    // Do not bother loading the Movit plugin when a prior launch already
+    // found it unsupported on this GPU; initializeGL() clears the cached
+    // verdict when the driver identity changes.
+    if (Settings.playerGPU() && Settings.capabilityMovit() != 0)
         m_glslManager = new Filter(profile(), "glsl.manager");
     if ((m_glslManager && !m_glslManager->is_valid())) {
         delete m_glslManager;
@@ -97,6 +111,7 @@ GLWidget::GLWidget(QObject *parent)
     connect(quickWindow(), SIGNAL(sceneGraphInitialized()), SLOT(setBlankScene()), Qt::QueuedConnection);
     connect(quickWindow(), SIGNAL(beforeRendering()), SLOT(paintGL()), Qt::DirectConnection);
     connect(&m_refreshTimer, SIGNAL(timeout()), SLOT(onRefreshTimeout()));
+    connect(this, SIGNAL(statusChanged(QQuickWidget::Status)), SLOT(onVuiStatusChanged(QQuickWidget::Status)));
     LOG_DEBUG() << "end";
 }
 
@@ -136,6 +151,19 @@ void GLWidget::initializeGL()
     LOG_INFO() << "OpenGL threaded?" << quickWindow()->openglContext()->supportsThreadedOpenGL();
     LOG_INFO() << "OpenGL ES?" << quickWindow()->openglContext()->isOpenGLES();
 
+    // The cached capability probe results are only valid for the GPU and
+    // driver they were measured on.
+    QString signature = QString::fromUtf8((const char*) glGetString(GL_VENDOR))
+        .append(' ').append(QString::fromUtf8((const char*) glGetString(GL_RENDERER)))
+        .append(' ').append(QString::fromUtf8((const char*) glGetString(GL_VERSION)));
+    if (signature != Settings.capabilitiesSignature()) {
+        if (!Settings.capabilitiesSignature().isEmpty()) {
+            LOG_INFO() << "GPU or driver changed; clearing cached capabilities";
+            Settings.clearCapabilities();
+        }
+        Settings.setCapabilitiesSignature(signature);
+    }
+
     if (m_glslManager && quickWindow()->openglContext()->isOpenGLES()) {
         delete m_glslManager;
         m_glslManager = 0;
@@ -171,7 +199,7 @@ void GLWidget::initializeGL()
         m_shareContext->setShareContext(quickWindow()->openglContext());
         m_shareContext->create();
     }
-    m_frameRenderer = new FrameRenderer(quickWindow()->openglContext(), &m_offscreenSurface);
+    m_frameRenderer = new FrameRenderer(quickWindow()->openglContext(), &m_offscreenSurface, m_frameTimeHud);
     quickWindow()->openglContext()->makeCurrent(quickWindow());
 
     connect(m_frameRenderer, SIGNAL(frameDisplayed(const SharedFrame&)), SLOT(onFrameDisplayed(const SharedFrame&)), Qt::QueuedConnection);
@@ -190,6 +218,23 @@ void GLWidget::setBlankScene()
     m_savedQmlSource.clear();
 }
 
+void GLWidget::onVuiStatusChanged(QQuickWidget::Status status)
+{
+    // Render the VUI item tree into a cached layer texture. The video drawn
+    // in paintGL forces a scene render every frame, and without a layer that
+    // re-rasterizes complex overlays (spline controls, text handles) at the
+    // video rate. With the layer enabled the scene graph only re-renders the
+    // VUI when one of its items changes and otherwise composites the cached
+    // texture over the video quad. This includes the blank VUI: it hosts the
+    // grid and safe-area overlays, so window exposes and repaints while
+    // paused composite the cached overlay instead of re-rendering it.
+    if (QQuickWidget::Ready == status && rootObject()) {
+        QObject* layer = qvariant_cast<QObject*>(rootObject()->property("layer"));
+        if (layer)
+            layer->setProperty("enabled", true);
+    }
+}
+
 void GLWidget::resizeGL(int width, int height)
 {
     double x, y, w, h;
@@ -284,64 +329,82 @@ void GLWidget::createShader()
     m_texCoordLocation = m_shader->attributeLocation("texCoord");
 }
 
-static void uploadTextures(QOpenGLContext* context, SharedFrame& frame, GLuint texture[])
+#ifndef GL_LUMINANCE8
+#define GL_LUMINANCE8 0x8040
+#endif
+
+// Allocates the three YUV plane textures once per resolution, preferring
+// immutable storage (glTexStorage2D) so the driver never revalidates or
+// reallocates on the per-frame updates. Immutable storage cannot be
+// respecified later, and glTexSubImage2D never allocates, so a caller
+// that rotates through several texture arrays must pass every array
+// through here on each resolution change, not just the one it is about
+// to upload into.
+static void allocatePlaneTextures(QOpenGLContext* context, GLuint texture[], int width, int height)
 {
-    int width = frame.get_image_width();
-    int height = frame.get_image_height();
-    const uint8_t* image = frame.get_image(mlt_image_yuv420p);
     QOpenGLFunctions* f = context->functions();
+    bool immutable = context->hasExtension("GL_ARB_texture_storage")
+        || (context->isOpenGLES() && context->format().majorVersion() >= 3);
 
-    // The planes of pixel data may not be a multiple of the default 4 bytes.
-    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-    // Upload each plane of YUV to a texture.
     if (texture[0])
         f->glDeleteTextures(3, texture);
     check_error(f);
     f->glGenTextures(3, texture);
     check_error(f);
+    for (int i = 0; i < 3; ++i) {
+        int w = i? width / 2 : width;
+        int h = i? height / 2 : height;
+        f->glBindTexture  (GL_TEXTURE_2D, texture[i]);
+        check_error(f);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        check_error(f);
+        if (immutable)
+            context->extraFunctions()->glTexStorage2D(GL_TEXTURE_2D, 1, GL_LUMINANCE8, w, h);
+        else
+            f->glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, w, h, 0,
+                            GL_LUMINANCE, GL_UNSIGNED_BYTE, 0);
+        check_error(f);
+    }
+}
 
-    f->glBindTexture  (GL_TEXTURE_2D, texture[0]);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    check_error(f);
-    f->glTexImage2D   (GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0,
-                    GL_LUMINANCE, GL_UNSIGNED_BYTE, image);
-    check_error(f);
+// Updates the plane textures in place from client memory.
+static void updatePlaneTextures(QOpenGLContext* context, GLuint texture[],
+                                const uint8_t* image, int width, int height)
+{
+    QOpenGLFunctions* f = context->functions();
+    quintptr offset = 0;
+    for (int i = 0; i < 3; ++i) {
+        int w = i? width / 2 : width;
+        int h = i? height / 2 : height;
+        f->glBindTexture(GL_TEXTURE_2D, texture[i]);
+        check_error(f);
+        f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h,
+                        GL_LUMINANCE, GL_UNSIGNED_BYTE, image + offset);
+        check_error(f);
+        offset += w * h;
+    }
+}
 
-    f->glBindTexture  (GL_TEXTURE_2D, texture[1]);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    check_error(f);
-    f->glTexImage2D   (GL_TEXTURE_2D, 0, GL_LUMINANCE, width/2, height/2, 0,
-                    GL_LUMINANCE, GL_UNSIGNED_BYTE, image + width * height);
-    check_error(f);
+static void uploadTextures(QOpenGLContext* context, SharedFrame& frame, GLuint texture[],
+                           int* textureWidth, int* textureHeight)
+{
+    int width = frame.get_image_width();
+    int height = frame.get_image_height();
+    const uint8_t* image = frame.get_image(mlt_image_yuv420p);
+    QOpenGLFunctions* f = context->functions();
 
-    f->glBindTexture  (GL_TEXTURE_2D, texture[2]);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    check_error(f);
-    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    check_error(f);
-    f->glTexImage2D   (GL_TEXTURE_2D, 0, GL_LUMINANCE, width/2, height/2, 0,
-                    GL_LUMINANCE, GL_UNSIGNED_BYTE, image + width * height + width/2 * height/2);
-    check_error(f);
+    // The planes of pixel data may not be a multiple of the default 4 bytes.
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (width != *textureWidth || height != *textureHeight) {
+        allocatePlaneTextures(context, texture, width, height);
+        *textureWidth = width;
+        *textureHeight = height;
+    }
+    updatePlaneTextures(context, texture, image, width, height);
 }
 
 void GLWidget::paintGL()
@@ -349,6 +412,8 @@ void GLWidget::paintGL()
 #ifndef QT_NO_DEBUG
     QOpenGLFunctions* f = quickWindow()->openglContext()->functions();
 #endif
+    QElapsedTimer presentTimer;
+    presentTimer.start();
     float width = this->width() * devicePixelRatio();
     float height = this->height() * devicePixelRatio();
 
@@ -368,7 +433,8 @@ void GLWidget::paintGL()
             m_mutex.unlock();
             return;
         }
-        uploadTextures(quickWindow()->openglContext(), m_sharedFrame, m_texture);
+        uploadTextures(quickWindow()->openglContext(), m_sharedFrame, m_texture,
+                       &m_paintTextureWidth, &m_paintTextureHeight);
         m_mutex.unlock();
     } else if (m_glslManager) {
         m_mutex.lock();
@@ -467,6 +533,7 @@ void GLWidget::paintGL()
         glFinish(); check_error(f);
         m_mutex.unlock();
     }
+    m_frameTimeHud->addSample(FrameTimeHud::PresentStage, presentTimer.nsecsElapsed() / 1000);
 }
 
 void GLWidget::onRefreshTimeout()
@@ -486,7 +553,13 @@ void GLWidget::mousePressEvent(QMouseEvent* event)
 
 void GLWidget::mouseMoveEvent(QMouseEvent* event)
 {
-    QQuickWidget::mouseMoveEvent(event);
+    // With only the blank VUI scene loaded there is nothing interactive to
+    // hit-test, so skip Qt Quick's per-move delivery walk; hovering the
+    // player then costs just the checks below.
+    if (source() == QmlUtilities::blankVui())
+        event->ignore();
+    else
+        QQuickWidget::mouseMoveEvent(event);
     if (event->isAccepted()) return;
     if (event->modifiers() == (Qt::ShiftModifier | Qt::AltModifier) && m_producer) {
         emit seekTo(m_producer->get_length() * event->x() / width());
@@ -578,6 +651,7 @@ void GLWidget::startGlsl()
 {
     if (m_glslManager) {
         m_glslManager->fire_event("init glsl");
+        Settings.setCapabilityMovit(m_glslManager->get_int("glsl_supported"));
         if (!m_glslManager->get_int("glsl_supported")) {
             delete m_glslManager;
             m_glslManager = 0;
@@ -615,6 +689,21 @@ static void onThreadStopped(mlt_properties owner, GLWidget* self)
 
 int GLWidget::setProducer(Mlt::Producer* producer, bool isMulti)
 {
+    endPlaybackSession();
+    // Key seek latency samples by what is being decoded. For avformat the
+    // codec distinguishes camera formats with very different seek cost.
+    m_seekLatencyKey.clear();
+    if (producer && producer->is_valid()) {
+        QString service = QString::fromLatin1(producer->get("mlt_service"));
+        if (service.startsWith("avformat")) {
+            QString property = QString("meta.media.%1.codec.name")
+                    .arg(producer->get_int("video_index"));
+            QString codec = QString::fromLatin1(producer->get(property.toLatin1().constData()));
+            if (!codec.isEmpty())
+                service += "." + codec;
+        }
+        m_seekLatencyKey = service;
+    }
     int error = Controller::setProducer(producer, isMulti);
 
     if (!error) {
@@ -662,10 +751,22 @@ int GLWidget::reconfigure(bool isMulti)
         m_consumer->connect(*m_producer);
         // Make an event handler for when a frame's image should be displayed
         m_consumer->listen("consumer-frame-show", this, (mlt_listener) on_frame_show);
+        // The new consumer brings a new frame thread; hint it again on its
+        // first frame.
+        m_consumerThreadHinted.storeRelease(0);
         m_consumer->set("real_time", MLT.realTime());
-        m_consumer->set("mlt_image_format", "yuv422");
+        // Everything on the on-screen path - the plane upload and all of the
+        // video scopes - consumes yuv420p, so asking the consumer for yuv422
+        // just paid a chroma upsample followed by a downsample back on every
+        // frame. SDI and external monitors keep their native 4:2:2.
+        if (isMulti || serviceName.startsWith("decklink"))
+            m_consumer->set("mlt_image_format", "yuv422");
+        else
+            m_consumer->set("mlt_image_format", "yuv420p");
         m_consumer->set("color_trc", Settings.playerGamma().toLatin1().constData());
         m_consumer->set("channels", property("audio_channels").toInt());
+        // Audio-only preview: only the audio graph is evaluated.
+        m_consumer->set("video_off", videoOff() ? 1 : 0);
 
         if (isMulti) {
             m_consumer->set("terminate_on_pause", 0);
@@ -754,6 +855,14 @@ void GLWidget::requestImage() const
 
 void GLWidget::onFrameDisplayed(const SharedFrame &frame)
 {
+    if (m_seekPending) {
+        // Seek request to first displayed frame; the bulk of it is decode.
+        m_seekPending = false;
+        QString name("player.seek.latency");
+        if (!m_seekLatencyKey.isEmpty())
+            name += "." + m_seekLatencyKey;
+        PerfLog::span(name, m_seekLatencyTimer.nsecsElapsed() / 1000);
+    }
     m_mutex.lock();
     m_sharedFrame = frame;
     m_mutex.unlock();
@@ -764,9 +873,106 @@ void GLWidget::onFrameDisplayed(const SharedFrame &frame)
     } else if (isVui && !m_savedQmlSource.isEmpty() && source() != m_savedQmlSource) {
         setSource(m_savedQmlSource);
     }
+    m_renderedFrames.ref();
+    m_sessionShown.ref();
+    evaluateAdaptiveScale();
     quickWindow()->update();
 }
 
+/// Resets the per-session frame statistics when playback starts.
+void GLWidget::startPlaybackSession()
+{
+    if (m_sessionActive.fetchAndStoreRelaxed(1))
+        return;
+    m_sessionShown.store(0);
+    m_sessionDropped.store(0);
+    m_sessionMaxIntervalUs = 0;
+    m_sessionIntervalSumUs = 0;
+    m_sessionIntervalCount = 0;
+    m_frameShowTimer.restart();
+    // Shrink the shared background pool so decode and render keep their
+    // cores while the player is rolling.
+    TaskPool::singleton().setPlaybackActive(true);
+}
+
+/// Logs one summary line per playback session so reports can carry
+/// actionable numbers instead of "it felt janky".
+void GLWidget::endPlaybackSession()
+{
+    if (!m_sessionActive.fetchAndStoreRelaxed(0))
+        return;
+    TaskPool::singleton().setPlaybackActive(false);
+    int shown = m_sessionShown.load();
+    int dropped = m_sessionDropped.load();
+    if (shown + dropped < 2)
+        return;
+    double avgMs = m_sessionIntervalCount?
+        m_sessionIntervalSumUs / 1000.0 / m_sessionIntervalCount : 0.0;
+    LOG_INFO() << "playback session: frames" << shown
+               << "dropped" << dropped
+               << "longest stall ms" << m_sessionMaxIntervalUs / 1000
+               << "average frame ms" << avgMs;
+    PerfLog::count("player.session");
+    if (dropped > 0)
+        PerfLog::count("player.session.dropped", dropped);
+    PerfLog::span("player.session.maxstall", m_sessionMaxIntervalUs);
+}
+
+void GLWidget::evaluateAdaptiveScale()
+{
+    // Step the preview resolution ladder down while the pipeline cannot
+    // sustain playback and back up when headroom returns. Only the consumer
+    // resolution changes; the user's configured scale is the ceiling and is
+    // never modified.
+    const int kWindowMs = 2000;
+    const int kLadder[] = { 0, 720, 540, 360 };
+    const int kLadderSize = 4;
+
+    if (!Settings.playerAutomaticPreviewScale())
+        return;
+    if (!m_adaptiveScaleTimer.isValid()) {
+        m_adaptiveScaleTimer.start();
+        return;
+    }
+    if (m_adaptiveScaleTimer.elapsed() < kWindowMs)
+        return;
+    int dropped = m_droppedFrames.fetchAndStoreRelaxed(0);
+    int rendered = m_renderedFrames.fetchAndStoreRelaxed(0);
+    m_adaptiveScaleTimer.restart();
+    if (rendered + dropped < 10)
+        return; // Not playing; scrub bursts are judged over full windows too.
+
+    int base = Settings.playerPreviewScale();
+    int current = (m_adaptiveScale >= 0)? m_adaptiveScale : base;
+    int step = 0;
+    while (step < kLadderSize - 1 && kLadder[step] != current)
+        step++;
+    // The user's setting bounds how high the ladder may recover.
+    int minStep = 0;
+    while (minStep < kLadderSize - 1 && kLadder[minStep] != base)
+        minStep++;
+
+    int newStep = step;
+    if (dropped * 10 > rendered) {
+        // More than ~10% dropped in the window: reduce resolution.
+        newStep = qMin(step + 1, kLadderSize - 1);
+        m_adaptiveGoodWindows = 0;
+    } else if (dropped == 0 && step > minStep) {
+        // Require a few clean windows before trying a higher resolution.
+        if (++m_adaptiveGoodWindows >= 3) {
+            newStep = step - 1;
+            m_adaptiveGoodWindows = 0;
+        }
+    }
+    if (newStep != step && kLadder[newStep] != current) {
+        m_adaptiveScale = kLadder[newStep];
+        LOG_INFO() << "adaptive preview scale" << (current? current : profile().height())
+                   << "->" << (m_adaptiveScale? m_adaptiveScale : profile().height());
+        setPreviewScale(m_adaptiveScale);
+        Controller::refreshConsumer();
+    }
+}
+
 void GLWidget::setGrid(int grid)
 {
     m_grid = grid;
@@ -824,13 +1030,44 @@ void GLWidget::updateTexture(GLuint yName, GLuint uName, GLuint vName)
 void GLWidget::on_frame_show(mlt_consumer, void* self, mlt_frame frame_ptr)
 {
     Mlt::Frame frame(frame_ptr);
+    GLWidget* widget = static_cast<GLWidget*>(self);
+    if (widget->videoOff()) {
+        // Audio-only preview: no image was rendered. Forward the frame so
+        // the transport position and the audio scopes stay live, but leave
+        // the video pipeline untouched.
+        emit widget->frameDisplayed(SharedFrame(frame));
+        return;
+    }
     if (frame.get_int("rendered")) {
-        GLWidget* widget = static_cast<GLWidget*>(self);
+        // Runs on the MLT consumer thread: hint its priority once per
+        // consumer so the scheduler keeps it on a performance core.
+        if (Settings.playerThreadHints()
+                && !widget->m_consumerThreadHinted.fetchAndStoreRelaxed(1))
+            QThread::currentThread()->setPriority(QThread::HighPriority);
+        // Cadence of frames leaving the consumer; this includes producer
+        // fetch and the filter chain, which run upstream inside MLT.
+        qint64 intervalUs = widget->m_frameShowTimer.nsecsElapsed() / 1000;
+        widget->m_frameTimeHud->addSample(FrameTimeHud::FrameStage, intervalUs);
+        widget->m_frameShowTimer.restart();
+        if (widget->m_sessionActive.load()) {
+            widget->m_sessionMaxIntervalUs = qMax(widget->m_sessionMaxIntervalUs, intervalUs);
+            widget->m_sessionIntervalSumUs += intervalUs;
+            widget->m_sessionIntervalCount++;
+        }
         int timeout = (widget->consumer()->get_int("real_time") > 0)? 0: 1000;
         if (widget->m_frameRenderer && widget->m_frameRenderer->semaphore()->tryAcquire(1, timeout)) {
-            QMetaObject::invokeMethod(widget->m_frameRenderer, "showFrame", Qt::QueuedConnection, Q_ARG(Mlt::Frame, frame));
-        } else if (!Settings.playerRealtime()) {
-            LOG_WARNING() << "GLWidget dropped frame" << frame.get_position();
+            // Take one reference and pass the bare pointer through the
+            // queue; the handoff transfers ownership instead of copying,
+            // so the queue hop performs no refcount atomics.
+            mlt_properties_inc_ref(MLT_FRAME_PROPERTIES(frame_ptr));
+            QMetaObject::invokeMethod(widget->m_frameRenderer, "showFrame", Qt::QueuedConnection,
+                                      Q_ARG(Mlt::FrameHandoff, Mlt::FrameHandoff(frame_ptr)));
+        } else {
+            widget->m_droppedFrames.ref();
+            widget->m_sessionDropped.ref();
+            PerfLog::count("player.frame.dropped");
+            if (!Settings.playerRealtime())
+                LOG_WARNING() << "GLWidget dropped frame" << frame.get_position();
         }
     }
 }
@@ -863,16 +1100,22 @@ void RenderThread::run()
     }
 }
 
-FrameRenderer::FrameRenderer(QOpenGLContext* shareContext, QSurface* surface)
+FrameRenderer::FrameRenderer(QOpenGLContext* shareContext, QSurface* surface, FrameTimeHud* hud)
      : QThread(0)
      , m_semaphore(3)
      , m_context(0)
      , m_surface(surface)
      , m_previousMSecs(QDateTime::currentMSecsSinceEpoch())
      , m_imageRequested(false)
+     , m_hud(hud)
+     , m_pboIndex(0)
+     , m_pboSize(0)
+     , m_textureWidth(0)
+     , m_textureHeight(0)
      , m_gl32(0)
 {
     Q_ASSERT(shareContext);
+    m_pbo[0] = m_pbo[1] = m_pbo[2] = 0;
     m_renderTexture[0] = m_renderTexture[1] = m_renderTexture[2] = 0;
     m_displayTexture[0] = m_displayTexture[1] = m_displayTexture[2] = 0;
     if (Settings.playerGPU() || shareContext->supportsThreadedOpenGL()) {
@@ -884,7 +1127,10 @@ FrameRenderer::FrameRenderer(QOpenGLContext* shareContext, QSurface* surface)
     }
     setObjectName("FrameRenderer");
     moveToThread(this);
-    start();
+    // A priority hint keeps the OS scheduler from parking this thread on
+    // an efficiency core mid-playback, which shows up as dropped frames
+    // on hybrid-core machines.
+    start(Settings.playerThreadHints()? QThread::HighPriority : QThread::InheritPriority);
 }
 
 FrameRenderer::~FrameRenderer()
@@ -894,8 +1140,19 @@ FrameRenderer::~FrameRenderer()
     delete m_gl32;
 }
 
-void FrameRenderer::showFrame(Mlt::Frame frame)
+void FrameRenderer::showFrame(Mlt::FrameHandoff handoff)
 {
+    mlt_frame frame_ptr = handoff.take();
+    if (!frame_ptr) {
+        m_semaphore.release();
+        return;
+    }
+    // The Frame constructor takes its own reference; close the one the
+    // handoff carried so this function owns the frame through this wrapper.
+    Mlt::Frame frame(frame_ptr);
+    mlt_frame_close(frame_ptr);
+    QElapsedTimer renderTimer;
+    renderTimer.start();
     if (!Settings.playerGPU()) {
         m_displayFrame = SharedFrame(frame);
     }
@@ -907,7 +1164,12 @@ void FrameRenderer::showFrame(Mlt::Frame frame)
             int height = 0;
             frame.set("movit.convert.use_texture", 1);
             mlt_image_format format = mlt_image_glsl_texture;
+            QElapsedTimer stageTimer;
+            stageTimer.start();
             const GLuint* textureId = (GLuint*) frame.get_image(format, width, height);
+            // With GPU processing the Movit chain renders straight into a
+            // texture, so conversion and upload are one stage here.
+            m_hud->addSample(FrameTimeHud::ConvertStage, stageTimer.nsecsElapsed() / 1000);
 
             m_context->makeCurrent(m_surface);
 #ifdef USE_GL_SYNC
@@ -963,7 +1225,7 @@ void FrameRenderer::showFrame(Mlt::Frame frame)
             m_context->makeCurrent(m_surface);
             QOpenGLFunctions* f = m_context->functions();
 
-            uploadTextures(m_context, m_displayFrame, m_renderTexture);
+            uploadTextures(m_displayFrame, m_renderTexture);
             f->glBindTexture(GL_TEXTURE_2D, 0);
             check_error(f);
             f->glFinish();
@@ -981,9 +1243,95 @@ void FrameRenderer::showFrame(Mlt::Frame frame)
         emit imageReady();
     }
 
+    m_hud->addSample(FrameTimeHud::RenderStage, renderTimer.nsecsElapsed() / 1000);
     m_semaphore.release();
 }
 
+void FrameRenderer::uploadTextures(SharedFrame& frame, GLuint texture[])
+{
+    int width = frame.get_image_width();
+    int height = frame.get_image_height();
+    QElapsedTimer stageTimer;
+    stageTimer.start();
+    // This get_image() call performs any pending pixel format conversion.
+    const uint8_t* image = frame.get_image(mlt_image_yuv420p);
+    m_hud->addSample(FrameTimeHud::ConvertStage, stageTimer.nsecsElapsed() / 1000);
+    stageTimer.restart();
+    int imageSize = width * height * 3 / 2;
+    QOpenGLFunctions* f = m_context->functions();
+
+    // The planes of pixel data may not be a multiple of the default 4 bytes.
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // (Re)allocate texture storage and the buffer ring only when the
+    // resolution changes; steady-state playback reuses both. showFrame()
+    // swaps the render and display arrays every frame, so both must be
+    // allocated here - otherwise the never-allocated array swaps in on
+    // the next frame and the plane updates target texture id 0.
+    if (width != m_textureWidth || height != m_textureHeight) {
+        allocatePlaneTextures(m_context, m_renderTexture, width, height);
+        allocatePlaneTextures(m_context, m_displayTexture, width, height);
+        m_textureWidth = width;
+        m_textureHeight = height;
+    }
+    if (imageSize != m_pboSize) {
+        if (m_pbo[0])
+            f->glDeleteBuffers(3, m_pbo);
+        f->glGenBuffers(3, m_pbo);
+        check_error(f);
+        for (int i = 0; i < 3; ++i) {
+            f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo[i]);
+            f->glBufferData(GL_PIXEL_UNPACK_BUFFER, imageSize, 0, GL_STREAM_DRAW);
+            check_error(f);
+        }
+        m_pboSize = imageSize;
+        m_pboIndex = 0;
+    }
+
+    // Write all three planes into the next buffer in the ring. The ring is
+    // as deep as the frame-drop semaphore, so an unsynchronized map never
+    // touches a buffer the GPU is still reading from.
+    f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo[m_pboIndex]);
+    void* mapped = f->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, imageSize,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    check_error(f);
+    if (mapped) {
+        memcpy(mapped, image, imageSize);
+        f->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        check_error(f);
+
+        // Transfer each plane from the buffer; these are GPU-side copies
+        // that do not block this thread.
+        quintptr offset = 0;
+        for (int i = 0; i < 3; ++i) {
+            int w = i? width / 2 : width;
+            int h = i? height / 2 : height;
+            f->glBindTexture(GL_TEXTURE_2D, texture[i]);
+            f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h,
+                            GL_LUMINANCE, GL_UNSIGNED_BYTE, (const void*) offset);
+            check_error(f);
+            offset += w * h;
+        }
+        f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        m_pboIndex = (m_pboIndex + 1) % 3;
+    } else {
+        // Mapping can fail on drivers without usable buffer mapping;
+        // fall back to client-memory uploads.
+        f->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        quintptr offset = 0;
+        for (int i = 0; i < 3; ++i) {
+            int w = i? width / 2 : width;
+            int h = i? height / 2 : height;
+            f->glBindTexture(GL_TEXTURE_2D, texture[i]);
+            f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h,
+                            GL_LUMINANCE, GL_UNSIGNED_BYTE, image + offset);
+            check_error(f);
+            offset += w * h;
+        }
+    }
+    m_hud->addSample(FrameTimeHud::UploadStage, stageTimer.nsecsElapsed() / 1000);
+}
+
 void FrameRenderer::requestImage()
 {
     m_imageRequested = true;
@@ -1002,8 +1350,14 @@ void FrameRenderer::cleanup()
         m_context->functions()->glDeleteTextures(3, m_renderTexture);
         if (m_displayTexture[0] && m_displayTexture[1] && m_displayTexture[2])
             m_context->functions()->glDeleteTextures(3, m_displayTexture);
+        if (m_pbo[0]) {
+            m_context->functions()->glDeleteBuffers(3, m_pbo);
+            m_pbo[0] = m_pbo[1] = m_pbo[2] = 0;
+            m_pboSize = 0;
+        }
         m_context->doneCurrent();
         m_renderTexture[0] = m_renderTexture[1] = m_renderTexture[2] = 0;
         m_displayTexture[0] = m_displayTexture[1] = m_displayTexture[2] = 0;
+        m_textureWidth = m_textureHeight = 0;
     }
 }
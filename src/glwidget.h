@@ -29,6 +29,8 @@
 #include <QThread>
 #include <QRectF>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QAtomicInt>
 #include "mltcontroller.h"
 #include "sharedframe.h"
 
@@ -36,6 +38,7 @@ class QOpenGLFunctions_3_2_Core;
 class QOpenGLTexture;
 class QmlFilter;
 class QmlMetadata;
+class FrameTimeHud;
 
 namespace Mlt {
 
@@ -45,6 +48,52 @@ class FrameRenderer;
 
 typedef void* ( *thread_function_t )( void* );
 
+/*!
+  \class Mlt::FrameHandoff
+
+  Carries one mlt_frame reference through a queued connection without
+  refcount traffic. QMetaType requires a copy constructor, so a strictly
+  move-only type cannot cross a queued connection; instead "copying" a
+  FrameHandoff transfers ownership of the reference, auto_ptr style. The
+  old Q_ARG(Mlt::Frame, ...) hand-off copied the frame several times
+  (local, queued event, slot parameter), and each copy is a pair of
+  atomic refcount operations on the frame properties - measurable at
+  60 fps. Exactly one holder owns the reference; the rest are empty.
+*/
+class FrameHandoff
+{
+public:
+    FrameHandoff() : m_frame(0) {}
+    //! Takes ownership of one reference to \a frame.
+    explicit FrameHandoff(mlt_frame frame) : m_frame(frame) {}
+    FrameHandoff(const FrameHandoff& other) : m_frame(other.take()) {}
+    ~FrameHandoff()
+    {
+        if (m_frame)
+            mlt_frame_close(m_frame);
+    }
+    FrameHandoff& operator=(const FrameHandoff& other)
+    {
+        if (this != &other) {
+            if (m_frame)
+                mlt_frame_close(m_frame);
+            m_frame = other.take();
+        }
+        return *this;
+    }
+    //! Releases ownership to the caller; this handoff becomes empty.
+    mlt_frame take() const
+    {
+        mlt_frame frame = m_frame;
+        m_frame = 0;
+        return frame;
+    }
+private:
+    // Mutable so the copy "constructor" can steal from a const source as
+    // the metatype machinery requires.
+    mutable mlt_frame m_frame;
+};
+
 class GLWidget : public QQuickWidget, public Controller, protected QOpenGLFunctions
 {
     Q_OBJECT
@@ -66,16 +115,24 @@ public:
 
     void play(double speed = 1.0) {
         Controller::play(speed);
-        if (speed == 0) emit paused();
-        else emit playing();
+        if (speed == 0) {
+            endPlaybackSession();
+            emit paused();
+        } else {
+            startPlaybackSession();
+            emit playing();
+        }
     }
     void seek(int position) {
+        m_seekPending = true;
+        m_seekLatencyTimer.restart();
         Controller::seek(position);
         emit paused();
     }
     void refreshConsumer(bool scrubAudio = false);
     void pause() {
         Controller::pause();
+        endPlaybackSession();
         emit paused();
     }
     int displayWidth() const { return m_rect.width(); }
@@ -147,6 +204,41 @@ private:
     bool m_snapToGrid;
     QTimer m_refreshTimer;
     bool m_scrubAudio;
+    // Dimensions the paintGL() upload path textures were allocated with.
+    int m_paintTextureWidth;
+    int m_paintTextureHeight;
+    // Adaptive preview scaling (see evaluateAdaptiveScale()).
+    QAtomicInt m_droppedFrames;
+    QAtomicInt m_renderedFrames;
+    QElapsedTimer m_adaptiveScaleTimer;
+    int m_adaptiveScale;
+    int m_adaptiveGoodWindows;
+    // Opt-in pipeline timing overlay; see widgets/frametimehud.h.
+    FrameTimeHud* m_frameTimeHud;
+    // Consumer frame cadence; only touched from on_frame_show().
+    QElapsedTimer m_frameShowTimer;
+    // Seek-to-display latency reported via PerfLog; GUI thread only. The
+    // key suffixes the span name with the producer service and codec so
+    // latency distributions can be compared per source format.
+    QElapsedTimer m_seekLatencyTimer;
+    bool m_seekPending{false};
+    QString m_seekLatencyKey;
+    // Per playback session (play until pause/stop/close) frame statistics;
+    // see startPlaybackSession()/endPlaybackSession().
+    QAtomicInt m_sessionActive;
+    // Set once the consumer's frame thread has had its priority hinted;
+    // reset whenever a consumer is (re)built.
+    QAtomicInt m_consumerThreadHinted;
+    QAtomicInt m_sessionShown;
+    QAtomicInt m_sessionDropped;
+    qint64 m_sessionMaxIntervalUs{0};   // consumer thread only
+    qint64 m_sessionIntervalSumUs{0};
+    qint64 m_sessionIntervalCount{0};
+
+    void startPlaybackSession();
+    void endPlaybackSession();
+
+    void evaluateAdaptiveScale();
 
     static void on_frame_show(mlt_consumer, void* self, mlt_frame frame);
 
@@ -156,6 +248,7 @@ private slots:
     void updateTexture(GLuint yName, GLuint uName, GLuint vName);
     void paintGL();
     void onRefreshTimeout();
+    void onVuiStatusChanged(QQuickWidget::Status status);
 
 protected:
     void resizeEvent(QResizeEvent* event);
@@ -186,12 +279,12 @@ class FrameRenderer : public QThread
 {
     Q_OBJECT
 public:
-    FrameRenderer(QOpenGLContext* shareContext, QSurface* surface);
+    FrameRenderer(QOpenGLContext* shareContext, QSurface* surface, FrameTimeHud* hud);
     ~FrameRenderer();
     QSemaphore* semaphore() { return &m_semaphore; }
     QOpenGLContext* context() const { return m_context; }
     SharedFrame getDisplayFrame();
-    Q_INVOKABLE void showFrame(Mlt::Frame frame);
+    Q_INVOKABLE void showFrame(Mlt::FrameHandoff handoff);
     void requestImage();
     QImage image() const { return m_image; }
 
@@ -204,6 +297,8 @@ signals:
     void imageReady();
 
 private:
+    void uploadTextures(SharedFrame& frame, GLuint texture[]);
+
     QSemaphore m_semaphore;
     SharedFrame m_displayFrame;
     QOpenGLContext* m_context;
@@ -211,6 +306,14 @@ private:
     qint64 m_previousMSecs;
     bool m_imageRequested;
     QImage m_image;
+    FrameTimeHud* m_hud;
+    // Ring of pixel unpack buffers so the frame thread writes YUV planes
+    // into driver-visible memory instead of stalling in glTexImage2D.
+    GLuint m_pbo[3];
+    int m_pboIndex;
+    int m_pboSize;
+    int m_textureWidth;
+    int m_textureHeight;
 
 public:
     GLuint m_renderTexture[3];
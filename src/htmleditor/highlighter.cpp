@@ -25,8 +25,28 @@
 
 #include <QtWidgets>
 
+// Blocks re-lexed per event loop turn. Lexing is a linear scan, so the
+// bound mostly limits the relayout a chunk's formats trigger; one chunk
+// comfortably covers the block chain a keystroke invalidates.
+static const int kBlocksPerChunk = 256;
+
+static void addFormat(QVector<QTextLayout::FormatRange> *formats,
+                      int start, int length, const QColor &color)
+{
+    if (length <= 0)
+        return;
+    QTextLayout::FormatRange range;
+    range.start = start;
+    range.length = length;
+    range.format.setForeground(color);
+    formats->append(range);
+}
+
 Highlighter::Highlighter(QTextDocument *document)
-        : QSyntaxHighlighter(document)
+        : QObject(document)
+        , m_document(document)
+        , m_nextBlock(-1)
+        , m_dirtyThrough(-1)
 {
     m_colors[DocType]        = QColor(192, 192, 192);
     m_colors[Entity]         = QColor(128, 128, 128);
@@ -34,11 +54,78 @@ Highlighter::Highlighter(QTextDocument *document)
     m_colors[Comment]        = QColor( 35, 110,  37);
     m_colors[AttributeName]  = QColor(153,  69,   0);
     m_colors[AttributeValue] = QColor( 36,  36, 170);
+
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(0);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(processChunk()));
+    connect(document, SIGNAL(contentsChange(int,int,int)),
+            this, SLOT(onContentsChange(int,int,int)));
+
+    // Highlight whatever the document already holds.
+    if (!document->isEmpty())
+        onContentsChange(0, 0, document->characterCount());
+}
+
+void Highlighter::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    Q_UNUSED(charsRemoved)
+    int first = m_document->findBlock(position).blockNumber();
+    int last = m_document->findBlock(position + charsAdded).blockNumber();
+    if (first < 0)
+        return;
+    if (last < first) // the change reaches the end of the document
+        last = m_document->lastBlock().blockNumber();
+    // Coalesce with any pending pass: restart at the earliest dirty block.
+    m_nextBlock = (m_nextBlock < 0)? first : qMin(m_nextBlock, first);
+    m_dirtyThrough = qMax(m_dirtyThrough, last);
+    m_timer.start();
+}
+
+void Highlighter::processChunk()
+{
+    if (m_nextBlock < 0)
+        return;
+    QTextBlock block = m_document->findBlockByNumber(m_nextBlock);
+    if (!block.isValid()) {
+        m_nextBlock = -1;
+        m_dirtyThrough = -1;
+        return;
+    }
+    // Fresh blocks report userState() -1, which is State_Text - exactly
+    // the state an unseen block should start from.
+    int state = block.previous().isValid()? block.previous().userState() : State_Text;
+    int dirtyFrom = block.position();
+    int dirtyLength = 0;
+    for (int processed = 0; processed < kBlocksPerChunk && block.isValid(); ++processed) {
+        int oldState = block.userState();
+        QVector<QTextLayout::FormatRange> formats;
+        state = lexBlock(block.text(), state, &formats);
+        block.layout()->setFormats(formats);
+        block.setUserState(state);
+        dirtyLength = block.position() + block.length() - dirtyFrom;
+        int blockNumber = block.blockNumber();
+        block = block.next();
+        // Past the edited blocks, the chain ends as soon as a block
+        // hands the next one the same state it was last lexed with.
+        if (blockNumber >= m_dirtyThrough && oldState == state) {
+            block = QTextBlock();
+            break;
+        }
+    }
+    // One relayout for the whole chunk instead of one per block.
+    if (dirtyLength > 0)
+        m_document->markContentsDirty(dirtyFrom, dirtyLength);
+    if (block.isValid()) {
+        m_nextBlock = block.blockNumber();
+        m_timer.start();
+    } else {
+        m_nextBlock = -1;
+        m_dirtyThrough = -1;
+    }
 }
 
-void Highlighter::highlightBlock(const QString &text)
+int Highlighter::lexBlock(const QString &text, int state, QVector<QTextLayout::FormatRange> *formats) const
 {
-    int state = previousBlockState();
     int len = text.length();
     int start = 0;
     int pos = 0;
@@ -67,7 +154,7 @@ void Highlighter::highlightBlock(const QString &text)
                     while (pos < len
                             && text.at(pos++) != ';')
                         ;
-                    setFormat(start, pos - start, m_colors[Entity]);
+                    addFormat(formats, start, pos - start, m_colors[Entity]);
                 } else {
                     ++pos;
                 }
@@ -86,7 +173,7 @@ void Highlighter::highlightBlock(const QString &text)
                     ++pos;
                 }
             }
-            setFormat(start, pos - start, m_colors[Comment]);
+            addFormat(formats, start, pos - start, m_colors[Comment]);
             break;
 
         case State_DocType:
@@ -99,7 +186,7 @@ void Highlighter::highlightBlock(const QString &text)
                     break;
                 }
             }
-            setFormat(start, pos - start, m_colors[DocType]);
+            addFormat(formats, start, pos - start, m_colors[DocType]);
             break;
 
         // at '<' in e.g. "<span>foo</span>"
@@ -136,7 +223,7 @@ void Highlighter::highlightBlock(const QString &text)
                     break;
                 }
             }
-            setFormat(start, pos - start, m_colors[Tag]);
+            addFormat(formats, start, pos - start, m_colors[Tag]);
             break;
 
         // anywhere after tag name and before tag closing ('>')
@@ -184,7 +271,7 @@ void Highlighter::highlightBlock(const QString &text)
                 }
             }
 
-            setFormat(start, pos - start, m_colors[AttributeName]);
+            addFormat(formats, start, pos - start, m_colors[AttributeName]);
             break;
 
         // after '=' in e.g. <img src=bla.png/>
@@ -225,7 +312,7 @@ void Highlighter::highlightBlock(const QString &text)
                     ++pos;
                 }
                 state = State_InsideTag;
-                setFormat(start, pos - start, m_colors[AttributeValue]);
+                addFormat(formats, start, pos - start, m_colors[AttributeValue]);
             }
 
             break;
@@ -243,7 +330,7 @@ void Highlighter::highlightBlock(const QString &text)
 
             state = State_InsideTag;
 
-            setFormat(start, pos - start, m_colors[AttributeValue]);
+            addFormat(formats, start, pos - start, m_colors[AttributeValue]);
             break;
 
         // after the opening double quote in an attribute value
@@ -259,11 +346,11 @@ void Highlighter::highlightBlock(const QString &text)
 
             state = State_InsideTag;
 
-            setFormat(start, pos - start, m_colors[AttributeValue]);
+            addFormat(formats, start, pos - start, m_colors[AttributeValue]);
             break;
 
         }
     }
 
-    setCurrentBlockState(state);
+    return state;
 }
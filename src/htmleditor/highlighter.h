@@ -25,11 +25,23 @@
 #define HIGHLIGHTER_H
 
 #include <QHash>
-#include <QSyntaxHighlighter>
+#include <QObject>
+#include <QColor>
+#include <QTextLayout>
+#include <QTimer>
+#include <QVector>
+
+class QTextDocument;
 
 // based on http://doc.trolltech.com/qq/qq21-syntaxhighlighter.html
+//
+// Incremental replacement for the QSyntaxHighlighter version: an edit
+// only re-lexes the edited block chain, the work is time-sliced over the
+// event loop in bounded chunks, and each chunk's formats are applied as
+// one batch. Keystrokes arriving while a pass is pending are coalesced,
+// so typing in very large documents stays smooth.
 
-class Highlighter : public QSyntaxHighlighter
+class Highlighter : public QObject
 {
     Q_OBJECT
 
@@ -60,10 +72,20 @@ protected:
         State_AttributeValue,
     };
 
-    void highlightBlock(const QString &text);
+    //! Lexes one block; returns the state for the next block and appends
+    //! the block's highlighted runs to \a formats.
+    int lexBlock(const QString &text, int state, QVector<QTextLayout::FormatRange> *formats) const;
+
+private slots:
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+    void processChunk();
 
 private:
+    QTextDocument *m_document;
     QHash<int, QColor> m_colors;
+    int m_nextBlock;    //!< next block to re-lex; -1 when idle
+    int m_dirtyThrough; //!< last block covered by pending edits
+    QTimer m_timer;     //!< zero-interval continuation between chunks
 };
 
 
@@ -18,12 +18,18 @@
 #include "jobqueue.h"
 #include <QtWidgets>
 #include <Logger.h>
+#include "database.h"
 #include "settings.h"
+#include <algorithm>
+
+static const int kDisplayIntervalMs = 500;
 
 JobQueue::JobQueue(QObject *parent) :
     QStandardItemModel(0, COLUMN_COUNT, parent),
     m_paused(false)
 {
+    m_displayTimer.setInterval(kDisplayIntervalMs);
+    connect(&m_displayTimer, SIGNAL(timeout()), SLOT(onDisplayTimeout()));
 }
 
 JobQueue& JobQueue::singleton(QObject* parent)
@@ -38,11 +44,11 @@ void JobQueue::cleanup()
 {
     QMutexLocker locker(&m_mutex);
     foreach (AbstractJob* job, m_jobs) {
-        if (job->state() == QProcess::Running) {
+        if (job->isRunning())
             job->stop();
-            break;
-        }
     }
+    // Run any completed-job actions still waiting on their batch timer.
+    PostJobActionQueue::singleton().flush();
     qDeleteAll(m_jobs);
 }
 
@@ -71,10 +77,30 @@ AbstractJob* JobQueue::add(AbstractJob* job)
     m_mutex.unlock();
     emit jobAdded();
     startNextJob();
+    m_displayTimer.start();
 
     return job;
 }
 
+void JobQueue::onDisplayTimeout()
+{
+    QList<AbstractJob*> running;
+    {
+        QMutexLocker locker(&m_mutex);
+        foreach (AbstractJob* job, m_jobs) {
+            if (job->ran() && job->isRunning())
+                running << job;
+        }
+    }
+    // Flush outside the lock: progressUpdated() fans out directly to
+    // listeners such as the dock's ETA update, which call back into this
+    // queue.
+    foreach (AbstractJob* job, running)
+        job->flushProgress();
+    if (running.isEmpty() && !hasIncomplete())
+        m_displayTimer.stop();
+}
+
 void JobQueue::onProgressUpdated(QStandardItem* standardItem, int percent)
 {
     if (standardItem) {
@@ -116,24 +142,103 @@ void JobQueue::onFinished(AbstractJob* job, bool isSuccess, QString time)
         if (item)
             item->setIcon(icon);
     }
+    // Persist completed work into the job history so a later request for
+    // the same content with the same parameters can reuse this output.
+    if (isSuccess && !job->provenanceHash().isEmpty()) {
+        DB.putJobRecord(job->provenanceHash(), job->provenanceOperation(),
+                        job->provenanceParameters(), job->provenanceOutput(),
+                        job->time().elapsed());
+    }
     startNextJob();
 }
 
+// How many jobs of a lane may run concurrently.
+static int laneLimit(AbstractJob::Lane lane)
+{
+    switch (lane) {
+    case AbstractJob::ProxyLane:
+        // Each proxy transcode threads internally but far from saturating
+        // the machine; several in parallel fill it for batch generation.
+        return qBound(1, QThread::idealThreadCount() / 4, 4);
+    case AbstractJob::ProbeLane:
+        // Probes are I/O bound and short.
+        return 8;
+    case AbstractJob::ConvertLane:
+        // Batch conversions are heavier than proxies but each decode still
+        // bottlenecks on one or two threads; a few together fill the cores.
+        return qBound(1, QThread::idealThreadCount() / 4, 3);
+    case AbstractJob::SegmentLane:
+        // Segments of one export run together by design; EncodeDock caps
+        // their count and divides the encoding threads among them.
+        return QThread::idealThreadCount();
+    default:
+        // Full encodes saturate all cores through their own threading,
+        // so keep them serial.
+        return 1;
+    }
+}
+
 void JobQueue::startNextJob()
 {
     if (m_paused) return;
     QMutexLocker locker(&m_mutex);
-    if (!m_jobs.isEmpty()) {
-        foreach(AbstractJob* job, m_jobs) {
-            // if there is already a job started or running, then exit
-            if (job->ran() && job->state() != QProcess::NotRunning)
-                break;
-            // otherwise, start first non-started job and exit
-            if (!job->ran()) {
-                job->start();
+    int running[AbstractJob::LANE_COUNT] = { 0 };
+    foreach (AbstractJob* job, m_jobs) {
+        if (job->ran() && job->isRunning())
+            ++running[job->lane()];
+    }
+
+    // Pending jobs in priority order, FIFO within one priority.
+    QList<AbstractJob*> pending;
+    foreach (AbstractJob* job, m_jobs) {
+        if (!job->ran())
+            pending << job;
+    }
+    std::stable_sort(pending.begin(), pending.end(),
+                     [](AbstractJob* a, AbstractJob* b) { return a->priority() > b->priority(); });
+
+    // Start pending jobs until each lane is at its limit.
+    foreach (AbstractJob* job, pending) {
+        bool waiting = false;
+        bool failed = false;
+        foreach (AbstractJob* dependency, job->dependencies()) {
+            if (!dependency->ran() || dependency->isRunning()) {
+                waiting = true; // wait for the dependency to finish
+            } else if (!dependency->isSuccess()) {
+                failed = true;
                 break;
             }
         }
+        if (failed) {
+            // Deferred so the queue is not re-entered while scheduling.
+            QMetaObject::invokeMethod(job, "skip", Qt::QueuedConnection);
+            continue;
+        }
+        if (waiting)
+            continue;
+        if (running[job->lane()] >= laneLimit(job->lane()))
+            continue;
+        job->start();
+        ++running[job->lane()];
+    }
+
+    // Preemption: while interactive-priority work runs, suspend low
+    // priority processes so it gets the machine; resume them after.
+    bool highActive = false;
+    foreach (AbstractJob* job, m_jobs) {
+        if (job->isRunning() && !job->isSuspended()
+                && job->priority() == AbstractJob::HighPriority) {
+            highActive = true;
+            break;
+        }
+    }
+    foreach (AbstractJob* job, m_jobs) {
+        if (!job->isRunning() || job->priority() != AbstractJob::LowPriority)
+            continue;
+        if (highActive)
+            job->suspend();
+        else
+            job->resume();
     }
 }
 
@@ -158,10 +263,47 @@ bool JobQueue::isPaused() const
     return m_paused;
 }
 
+QTime JobQueue::estimateRemaining()
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 ms = 0;
+    bool known = false;
+    foreach (AbstractJob* job, m_jobs) {
+        if (job->ran() && !job->isRunning())
+            continue;
+        if (job->isRunning()) {
+            int percent = job->lastPercent();
+            if (percent > 2) {
+                ms += job->estimateRemaining(percent).msecsSinceStartOfDay();
+                known = true;
+            }
+        } else if (job->totalFrames() > 0 && !job->rateKey().isEmpty()) {
+            double rate = Settings.jobRate(job->rateKey());
+            if (rate > 0.0) {
+                ms += qint64(job->totalFrames() * 1000 / rate);
+                known = true;
+            }
+        }
+    }
+    if (!known)
+        return QTime();
+    return QTime::fromMSecsSinceStartOfDay(qMin(ms, qint64(24 * 3600000 - 1)));
+}
+
 bool JobQueue::hasIncomplete() const
 {
     foreach (AbstractJob* job, m_jobs) {
-        if (!job->ran() || job->state() == QProcess::Running)
+        if (!job->ran() || job->isRunning())
+            return true;
+    }
+    return false;
+}
+
+bool JobQueue::hasActiveJob(const QString& name)
+{
+    QMutexLocker locker(&m_mutex);
+    foreach (AbstractJob* job, m_jobs) {
+        if (job->objectName() == name && (!job->ran() || job->isRunning()))
             return true;
     }
     return false;
@@ -185,7 +327,7 @@ void JobQueue::removeFinished()
     QMutexLocker locker(&m_mutex);
     auto row = 0;
     foreach (AbstractJob* job, m_jobs) {
-        if (job->ran() && job->state() != QProcess::Running) {
+        if (job->ran() && !job->isRunning()) {
             removeRow(row);
             m_jobs.removeOne(job);
             delete job;
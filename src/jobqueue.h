@@ -21,6 +21,7 @@
 #include "jobs/abstractjob.h"
 #include <QStandardItemModel>
 #include <QMutex>
+#include <QTimer>
 
 class JobQueue : public QStandardItemModel
 {
@@ -45,8 +46,15 @@ public:
     void resume();
     bool isPaused() const;
     bool hasIncomplete() const;
+    //! Estimated time until the whole queue drains: live estimates for
+    //! running jobs plus historical per-key rates for pending ones. Jobs
+    //! are summed as if serial, which is the conservative answer for the
+    //! mostly serial encode lane. Invalid when nothing can be estimated.
+    QTime estimateRemaining();
     void remove(const QModelIndex& index);
     void removeFinished();
+    //! Whether a queued or running job is producing the named output file.
+    bool hasActiveJob(const QString& name);
     QList<AbstractJob*> jobs() const { return m_jobs; }
 
 signals:
@@ -56,10 +64,18 @@ public slots:
     void onProgressUpdated(QStandardItem* standardItem, int percent);
     void onFinished(AbstractJob* job, bool isSuccess, QString time);
 
+private slots:
+    //! Flushes each running job's published progress into the model.
+    void onDisplayTimeout();
+
 private:
     QList<AbstractJob*> m_jobs;
     QMutex m_mutex; // protects m_jobs
     bool m_paused;
+    // Jobs publish progress into a lock-free slot at parse rate; this
+    // timer is the only thing that turns it into model updates, so many
+    // concurrent jobs never serialize through per-tick queued signals.
+    QTimer m_displayTimer;
 };
 
 #define JOBS JobQueue::singleton()
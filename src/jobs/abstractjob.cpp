@@ -17,20 +17,31 @@
 
 #include "abstractjob.h"
 #include "postjobaction.h"
+#include "perflog.h"
+#include "settings.h"
 #include <QApplication>
 #include <QTimer>
 #include <Logger.h>
 #ifdef Q_OS_WIN
 #include <windows.h>
+#else
+#include <signal.h>
 #endif
 
 AbstractJob::AbstractJob(const QString& name)
     : QProcess(0)
     , m_item(0)
+    , m_lane(EncodeLane)
+    , m_priority(NormalPriority)
+    , m_isSuccess(false)
+    , m_isSuspended(false)
     , m_ran(false)
     , m_killed(false)
     , m_label(name)
     , m_startingPercent(0)
+    , m_framesProcessed(0)
+    , m_totalFrames(0)
+    , m_lastPercent(0)
 {
     setObjectName(name);
     connect(this, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onFinished(int, QProcess::ExitStatus)));
@@ -43,6 +54,9 @@ void AbstractJob::start()
 {
     m_killed = false;
     m_ran = true;
+    m_framesProcessed = 0;
+    m_lastPercent = 0;
+    m_publishedPercent.storeRelease(0);
     m_estimateTime.start();
     m_totalTime.start();
     emit progressUpdated(m_item, 0);
@@ -83,6 +97,15 @@ void AbstractJob::setLabel(const QString &label)
     m_label = label;
 }
 
+float AbstractJob::framesPerSecond() const
+{
+    int ms = m_totalTime.elapsed();
+    // Too little progress to be meaningful.
+    if (m_framesProcessed <= 0 || ms < 1000)
+        return 0.0f;
+    return m_framesProcessed * 1000.0f / ms;
+}
+
 QTime AbstractJob::estimateRemaining(int percent)
 {
     QTime result;
@@ -100,21 +123,74 @@ void AbstractJob::setPostJobAction(PostJobAction* action)
 
 void AbstractJob::stop()
 {
+    // A suspended process cannot handle the terminate signal.
+    resume();
     closeWriteChannel();
     terminate();
     QTimer::singleShot(2000, this, SLOT(kill()));
     m_killed = true;
 }
 
+void AbstractJob::skip()
+{
+    if (m_ran)
+        return;
+    m_ran = true;
+    m_killed = true;
+    m_log.append(tr("Skipped because its dependency failed\n"));
+    emit finished(this, false);
+}
+
+void AbstractJob::suspend()
+{
+    if (m_isSuspended || state() != QProcess::Running)
+        return;
+#ifdef Q_OS_WIN
+    // Process suspension is not supported on Windows; the job keeps running.
+#else
+    if (::kill(pid_t(processId()), SIGSTOP) == 0) {
+        LOG_DEBUG() << "suspended" << objectName();
+        m_isSuspended = true;
+    }
+#endif
+}
+
+void AbstractJob::resume()
+{
+    if (!m_isSuspended)
+        return;
+#ifndef Q_OS_WIN
+    if (::kill(pid_t(processId()), SIGCONT) == 0) {
+        LOG_DEBUG() << "resumed" << objectName();
+        m_isSuspended = false;
+    }
+#endif
+}
+
 void AbstractJob::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
     m_log.append(readAll());
     const QTime& time = QTime::fromMSecsSinceStartOfDay(m_totalTime.elapsed());
+    PerfLog::span("job.duration", qint64(m_totalTime.elapsed()) * 1000);
+    PerfLog::count((exitStatus == QProcess::NormalExit && exitCode == 0 && !m_killed)?
+                   "job.succeeded" : m_killed? "job.stopped" : "job.failed");
     if (exitStatus == QProcess::NormalExit && exitCode == 0 && !m_killed) {
         if (m_postJobAction) {
-            m_postJobAction->doAction();
+            PostJobActionQueue::singleton().enqueue(m_postJobAction.take());
         }
         LOG_INFO() << "job succeeeded";
+        m_isSuccess = true;
+        if (!m_rateKey.isEmpty()) {
+            float fps = framesPerSecond();
+            if (fps > 0.0f) {
+                // Blend into the persisted rate so one outlier does not
+                // dominate future queue estimates.
+                double rate = Settings.jobRate(m_rateKey);
+                rate = (rate > 0.0)? 0.7 * rate + 0.3 * fps : fps;
+                Settings.setJobRate(m_rateKey, rate);
+                LOG_INFO() << "job throughput fps" << fps << "for" << m_rateKey;
+            }
+        }
         m_log.append(QString("Completed successfully in %1\n").arg(time.toString()));
         emit progressUpdated(m_item, 100);
         emit finished(this, true);
@@ -151,8 +227,16 @@ void AbstractJob::onStarted()
 #endif
 }
 
+void AbstractJob::flushProgress()
+{
+    int percent = m_publishedPercent.loadAcquire();
+    if (percent != m_lastPercent)
+        emit progressUpdated(m_item, percent);
+}
+
 void AbstractJob::onProgressUpdated(QStandardItem*, int percent)
 {
+    m_lastPercent = percent;
     // Start timer on first reported percentage > 0.
     if (percent == 1) {
         m_estimateTime.restart();
@@ -23,6 +23,7 @@
 #include <QModelIndex>
 #include <QList>
 #include <QTime>
+#include <QAtomicInt>
 
 class QAction;
 class QStandardItem;
@@ -31,9 +32,44 @@ class AbstractJob : public QProcess
 {
     Q_OBJECT
 public:
+    //! Resource class used by JobQueue to decide how many may run at once.
+    enum Lane {
+        EncodeLane = 0, //!< full encodes/renders; saturate the machine alone
+        ProxyLane,      //!< proxy transcodes; several run in parallel
+        ProbeLane,      //!< lightweight probes and analyses
+        SegmentLane,    //!< time segments of one export; thread-limited individually
+        ConvertLane,    //!< batch edit-friendly conversions; a few run in parallel
+        LANE_COUNT
+    };
+
+    //! Scheduling priority; while higher priority work runs, low priority
+    //! processes are suspended.
+    enum JobPriority {
+        LowPriority = 0, //!< long background work such as exports
+        NormalPriority,
+        HighPriority     //!< interactive work the user is waiting on
+    };
+
     explicit AbstractJob(const QString& name);
     virtual ~AbstractJob() {}
 
+    Lane lane() const { return m_lane; }
+    void setLane(Lane lane) { m_lane = lane; }
+    JobPriority priority() const { return m_priority; }
+    void setPriority(JobPriority priority) { m_priority = priority; }
+    //! The job does not start until \a job has finished successfully; if
+    //! any dependency fails, this job is skipped.
+    void addDependency(AbstractJob* job) { m_dependsOn << job; }
+    QList<AbstractJob*> dependencies() const { return m_dependsOn; }
+    bool isSuccess() const { return m_isSuccess; }
+    bool isSuspended() const { return m_isSuspended; }
+    void suspend();
+    void resume();
+
+    //! Whether the job has started and not yet finished. Subclasses that do
+    //! their work in-process instead of in a child process reimplement this.
+    virtual bool isRunning() const { return state() != QProcess::NotRunning; }
+
     void setStandardItem(QStandardItem* item);
     QStandardItem* standardItem();
     bool ran() const;
@@ -46,11 +82,52 @@ public:
     QList<QAction*> successActions() const { return m_successActions; }
     QTime estimateRemaining(int percent);
     QTime time() const { return m_totalTime; }
+    //! Frames rendered so far as parsed from the child process output, 0 if
+    //! the job does not report frames.
+    int framesProcessed() const { return m_framesProcessed; }
+    //! Achieved throughput in frames per second, 0 until measurable.
+    float framesPerSecond() const;
+    //! Expected total frame count, 0 if unknown. Together with a rate key
+    //! this lets the queue estimate a job before it starts.
+    void setTotalFrames(int frames) { m_totalFrames = frames; }
+    int totalFrames() const { return m_totalFrames; }
+    //! Key grouping jobs with comparable throughput, such as the video
+    //! codec. The achieved rate is persisted per key on success and seeds
+    //! queue-wide estimates for future jobs with the same key.
+    void setRateKey(const QString& key) { m_rateKey = key; }
+    QString rateKey() const { return m_rateKey; }
+    //! Provenance recorded into the job history on success: the source
+    //! media hash, the kind of operation, a fingerprint of the parameters
+    //! (excluding input and output paths so identical work matches across
+    //! project folders), and the output file. Jobs without provenance are
+    //! not recorded.
+    void setProvenance(const QString& hash, const QString& operation,
+                       const QString& parameters, const QString& output)
+    {
+        m_provenanceHash = hash;
+        m_provenanceOperation = operation;
+        m_provenanceParameters = parameters;
+        m_provenanceOutput = output;
+    }
+    QString provenanceHash() const { return m_provenanceHash; }
+    QString provenanceOperation() const { return m_provenanceOperation; }
+    QString provenanceParameters() const { return m_provenanceParameters; }
+    QString provenanceOutput() const { return m_provenanceOutput; }
+    //! The most recent percentage reported through progressUpdated().
+    int lastPercent() const { return m_lastPercent; }
+    //! Publishes progress into a lock-free slot. Output parsers call this
+    //! at whatever rate the child process reports; nothing downstream runs
+    //! until the queue's display timer flushes the slot.
+    void publishProgress(int percent) { m_publishedPercent.storeRelease(percent); }
+    //! Emits progressUpdated() if the published percent changed since the
+    //! last flush. Called by JobQueue at display rate.
+    void flushProgress();
     void setPostJobAction(PostJobAction* action);
 
 public slots:
     virtual void start();
     virtual void stop();
+    void skip();
 
 signals:
     void progressUpdated(QStandardItem* item, int percent);
@@ -61,6 +138,8 @@ protected:
     QList<QAction*> m_successActions;
     QStandardItem*  m_item;
 
+    void setFramesProcessed(int frames) { m_framesProcessed = frames; }
+
 protected slots:
     virtual void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
     virtual void onReadyRead();
@@ -70,6 +149,11 @@ private slots:
     void onProgressUpdated(QStandardItem*, int percent);
 
 private:
+    Lane m_lane;
+    JobPriority m_priority;
+    QList<AbstractJob*> m_dependsOn;
+    bool m_isSuccess;
+    bool m_isSuspended;
     bool m_ran;
     bool m_killed;
     QString m_log;
@@ -77,6 +161,15 @@ private:
     QTime m_estimateTime;
     int m_startingPercent;
     QTime m_totalTime;
+    int m_framesProcessed;
+    int m_totalFrames;
+    int m_lastPercent;
+    QAtomicInt m_publishedPercent;
+    QString m_rateKey;
+    QString m_provenanceHash;
+    QString m_provenanceOperation;
+    QString m_provenanceParameters;
+    QString m_provenanceOutput;
     QScopedPointer<PostJobAction> m_postJobAction;
 };
 
@@ -22,6 +22,7 @@
 #include <QFileInfo>
 #include <QFileDialog>
 #include <QTemporaryFile>
+#include <QThread>
 #include <QDir>
 #include <QDomDocument>
 #include <QTextStream>
@@ -35,6 +36,9 @@
 EncodeJob::EncodeJob(const QString &name, const QString &xml, int frameRateNum, int frameRateDen)
     : MeltJob(name, xml, frameRateNum, frameRateDen)
 {
+    // Exports are long background work; let interactive jobs preempt them.
+    setPriority(LowPriority);
+
     QAction* action = new QAction(tr("Open"), this);
     action->setToolTip(tr("Open the output file in the Shotcut player"));
     connect(action, SIGNAL(triggered()), this, SLOT(onOpenTiggered()));
@@ -99,9 +103,16 @@ void EncodeJob::onVideoQualityTriggered()
             consumerNode.setAttribute("real_time", -1);
             consumerNode.setAttribute("terminate_on_pause", 1);
 
-            // Create job and add it to the queue.
-            JOBS.add(new VideoQualityJob(objectName(), dom.toString(2), reportPath,
-                     MLT.profile().frame_rate_num(), MLT.profile().frame_rate_den()));
+            // Create job and add it to the queue. The measurement is CPU
+            // bound and independent per frame range, so shard it across
+            // worker processes; the job itself merges the partial reports.
+            VideoQualityJob* job = new VideoQualityJob(objectName(), dom.toString(2), reportPath,
+                     MLT.profile().frame_rate_num(), MLT.profile().frame_rate_den());
+            foreach (AbstractJob* shard, job->createShards(qBound(1, QThread::idealThreadCount() / 2, 8))) {
+                job->addDependency(shard);
+                JOBS.add(shard);
+            }
+            JOBS.add(job);
         }
     }
 }
@@ -30,8 +30,6 @@
 
 FfmpegJob::FfmpegJob(const QString& name, const QStringList& args, bool isOpenLog)
     : AbstractJob(name)
-    , m_totalFrames(0)
-    , m_previousPercent(0)
     , m_isOpenLog(isOpenLog)
 {
     QAction* action = new QAction(tr("Open"), this);
@@ -83,10 +81,10 @@ void FfmpegJob::onReadyRead()
         if (msg.contains("Duration:")) {
             m_duration = msg.mid(msg.indexOf("Duration:") + 9);
             m_duration = m_duration.left(m_duration.indexOf(','));
-            emit progressUpdated(m_item, 0);
+            publishProgress(0);
             appendToLog(msg);
         }
-        else if (!m_totalFrames && msg.contains(" fps")) {
+        else if (!totalFrames() && msg.contains(" fps")) {
             Mlt::Profile profile;
             QRegularExpression re("(\\d+|\\d+.\\d+) fps");
             QRegularExpressionMatch match = re.match(msg);
@@ -98,18 +96,15 @@ void FfmpegJob::onReadyRead()
             }
             Mlt::Properties props;
             props.set("_profile", profile.get_profile(), 0);
-            m_totalFrames = props.time_to_frames(m_duration.toLatin1().constData());
+            setTotalFrames(props.time_to_frames(m_duration.toLatin1().constData()));
             appendToLog(msg);
         }
-        else if (msg.startsWith("frame=") && m_totalFrames > 0) {
+        else if (msg.startsWith("frame=") && totalFrames() > 0) {
             msg = msg.mid(msg.indexOf("frame=") + 6);
             msg = msg.left(msg.indexOf(" fps"));
             int frame = msg.toInt();
-            int percent = qRound(frame * 100.0 / m_totalFrames);
-            if (percent != m_previousPercent) {
-                emit progressUpdated(m_item, percent);
-                m_previousPercent = percent;
-            }
+            setFramesProcessed(frame);
+            publishProgress(qRound(frame * 100.0 / totalFrames()));
         }
         else {
             if (!msg.trimmed().isEmpty())
@@ -36,8 +36,6 @@ private slots:
 private:
     QStringList m_args;
     QString m_duration;
-    int m_totalFrames;
-    int m_previousPercent;
     bool m_isOpenLog;
 };
 
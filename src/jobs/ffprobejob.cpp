@@ -17,20 +17,26 @@
  */
 
 #include "ffprobejob.h"
+#include "database.h"
 #include "mainwindow.h"
 #include "dialogs/textviewerdialog.h"
 #include "util.h"
 
 #include <QAction>
 #include <QApplication>
+#include <QDateTime>
 #include <QFileInfo>
 #include <QDir>
 #include <Logger.h>
 
 FfprobeJob::FfprobeJob(const QString& name, const QStringList& args)
     : AbstractJob(name)
+    , m_fromCache(false)
 {
     m_args.append(args);
+    setLane(ProbeLane);
+    // The user is waiting on probe output.
+    setPriority(HighPriority);
 }
 
 FfprobeJob::~FfprobeJob()
@@ -40,6 +46,23 @@ FfprobeJob::~FfprobeJob()
 
 void FfprobeJob::start()
 {
+    // Serve the result from the probe cache when this exact file (by path,
+    // size, and mtime) was probed before; on network shares each ffprobe
+    // run costs seconds of wall time.
+    QFileInfo info(objectName());
+    if (info.exists()) {
+        const QByteArray& cached = DB.getProbe(info.filePath(), info.size(),
+                                               info.lastModified().toMSecsSinceEpoch());
+        if (!cached.isEmpty()) {
+            m_fromCache = true;
+            appendToLog(QString::fromUtf8(cached));
+            AbstractJob::start();
+            // Deferred so the job queue is not re-entered from within start().
+            QMetaObject::invokeMethod(this, "onFinished", Qt::QueuedConnection,
+                Q_ARG(int, 0), Q_ARG(QProcess::ExitStatus, QProcess::NormalExit));
+            return;
+        }
+    }
     QString shotcutPath = qApp->applicationDirPath();
     QFileInfo ffprobePath(shotcutPath, "ffprobe");
     setReadChannel(QProcess::StandardOutput);
@@ -50,6 +73,15 @@ void FfprobeJob::start()
 
 void FfprobeJob::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
+    if (exitStatus == QProcess::NormalExit && exitCode == 0 && !m_fromCache) {
+        // Capture any buffered output and remember the result for the next
+        // probe of this file.
+        appendToLog(readAll());
+        QFileInfo info(objectName());
+        if (info.exists())
+            DB.putProbe(info.filePath(), info.size(),
+                        info.lastModified().toMSecsSinceEpoch(), log().toUtf8());
+    }
     AbstractJob::onFinished(exitCode, exitStatus);
     if (exitStatus == QProcess::NormalExit && exitCode == 0) {
         TextViewerDialog dialog(&MAIN);
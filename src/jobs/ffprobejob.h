@@ -35,6 +35,7 @@ private slots:
 
 private:
     QStringList m_args;
+    bool m_fromCache;
 };
 
 #endif // FFPROBEJOB_H
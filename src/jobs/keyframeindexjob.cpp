@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyframeindexjob.h"
+#include "util.h"
+
+#include <QApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <Logger.h>
+
+KeyframeIndexJob::KeyframeIndexJob(const QString& indexPath, const QString& resource)
+    : AbstractJob(indexPath)
+{
+    setLane(ProbeLane);
+    // Nobody waits on an index; it pays off on the next session's seeks.
+    setPriority(LowPriority);
+    setLabel(tr("Index %1").arg(Util::baseName(resource)));
+    m_args << "-loglevel" << "error";
+    m_args << "-select_streams" << "v:0";
+    m_args << "-show_entries" << "packet=pts_time,flags";
+    m_args << "-of" << "csv=p=0";
+    m_args << resource;
+}
+
+void KeyframeIndexJob::start()
+{
+    QString shotcutPath = qApp->applicationDirPath();
+    QFileInfo ffprobePath(shotcutPath, "ffprobe");
+    setReadChannel(QProcess::StandardOutput);
+    LOG_DEBUG() << ffprobePath.absoluteFilePath() << m_args;
+    QProcess::start(ffprobePath.absoluteFilePath(), m_args);
+    AbstractJob::start();
+}
+
+void KeyframeIndexJob::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+        // Capture any buffered output, then keep the pts_time of each
+        // packet flagged as a keyframe ("K__").
+        appendToLog(readAll());
+        QStringList keyframes;
+        foreach (const QString& line, log().split('\n')) {
+            const QStringList fields = line.trimmed().split(',');
+            if (fields.size() < 2 || !fields.last().startsWith('K'))
+                continue;
+            bool ok = false;
+            fields.first().toDouble(&ok);
+            if (ok)
+                keyframes << fields.first();
+        }
+        if (keyframes.isEmpty()) {
+            LOG_WARNING() << "no keyframes found for" << objectName();
+        } else {
+            QFile file(objectName());
+            if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+                QTextStream stream(&file);
+                stream << "shotcut keyframe index 1" << '\n';
+                foreach (const QString& s, keyframes)
+                    stream << s << '\n';
+            } else {
+                LOG_ERROR() << "failed to write" << objectName();
+            }
+        }
+    }
+    AbstractJob::onFinished(exitCode, exitStatus);
+}
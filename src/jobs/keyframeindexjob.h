@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYFRAMEINDEXJOB_H
+#define KEYFRAMEINDEXJOB_H
+
+#include "abstractjob.h"
+#include <QStringList>
+
+//! Runs ffprobe over a file's video packets and writes the keyframe times
+//! to the sidecar read by KeyframeIndex. The job is named after the
+//! sidecar so the queue can dedupe index requests for the same file.
+class KeyframeIndexJob : public AbstractJob
+{
+    Q_OBJECT
+public:
+    KeyframeIndexJob(const QString& indexPath, const QString& resource);
+
+public slots:
+    void start();
+
+protected slots:
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+private:
+    QStringList m_args;
+};
+
+#endif // KEYFRAMEINDEXJOB_H
@@ -24,6 +24,9 @@
 #include <QAction>
 #include <QDialog>
 #include <QDir>
+#include <QDomDocument>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
 #include <Logger.h>
 #include "mainwindow.h"
 #include "dialogs/textviewerdialog.h"
@@ -32,9 +35,9 @@
 MeltJob::MeltJob(const QString& name, const QString& xml, int frameRateNum, int frameRateDen)
     : AbstractJob(name)
     , m_isStreaming(false)
-    , m_previousPercent(0)
     , m_currentFrame(0)
     , m_useMultiConsumer(false)
+    , m_isInProcess(false)
 {
     if (!xml.isEmpty()) {
         QAction* action = new QAction(tr("View XML"), this);
@@ -80,10 +83,37 @@ MeltJob::MeltJob(const QString& name, const QStringList& args, int frameRateNum,
 MeltJob::~MeltJob()
 {
     LOG_DEBUG() << "begin";
+    m_stopRequested.storeRelease(1);
+    m_inProcessFuture.waitForFinished();
+}
+
+void MeltJob::setInProcess(bool inProcess)
+{
+    m_isInProcess = inProcess;
+}
+
+bool MeltJob::isRunning() const
+{
+    if (m_isInProcess)
+        return m_inProcessRunning.loadAcquire();
+    return AbstractJob::isRunning();
+}
+
+void MeltJob::stop()
+{
+    m_stopRequested.storeRelease(1);
+    AbstractJob::stop();
 }
 
 void MeltJob::start()
 {
+    if (m_isInProcess && m_xml) {
+        m_stopRequested.storeRelease(0);
+        m_inProcessRunning.storeRelease(1);
+        AbstractJob::start();
+        m_inProcessFuture = QtConcurrent::run(this, &MeltJob::runInProcess);
+        return;
+    }
     QString shotcutPath = qApp->applicationDirPath();
 #ifdef Q_OS_WIN
     QFileInfo meltPath(shotcutPath, "qmelt.exe");
@@ -141,6 +171,57 @@ void MeltJob::onViewXmlTriggered()
     dialog.exec();
 }
 
+void MeltJob::runInProcess()
+{
+    // Read the consumer element from the XML like melt would.
+    m_xml->open();
+    QDomDocument dom(xmlPath());
+    dom.setContent(m_xml.data());
+    m_xml->close();
+    QDomElement consumerNode = dom.elementsByTagName("consumer").at(0).toElement();
+    QString serviceName = consumerNode.attribute("mlt_service");
+    bool ok = false;
+
+    {
+        Mlt::Profile profile;
+        Mlt::Producer producer(profile, "xml", xmlPath().toUtf8().constData());
+        Mlt::Consumer consumer(profile, serviceName.toUtf8().constData());
+        if (producer.is_valid() && consumer.is_valid()) {
+            QDomNamedNodeMap attributes = consumerNode.attributes();
+            for (int i = 0; i < attributes.count(); i++) {
+                QDomAttr attribute = attributes.item(i).toAttr();
+                if (attribute.name() != "mlt_service")
+                    consumer.set(attribute.name().toUtf8().constData(),
+                                 attribute.value().toUtf8().constData());
+            }
+            consumer.connect(producer);
+            consumer.start();
+            int length = producer.get_length();
+            if (length > 0)
+                setTotalFrames(length);
+            while (!consumer.is_stopped()) {
+                if (m_stopRequested.loadAcquire()) {
+                    consumer.stop();
+                    break;
+                }
+                m_currentFrame = producer.position();
+                setFramesProcessed(m_currentFrame);
+                if (length > 0)
+                    publishProgress(qMin(99, 100 * m_currentFrame / length));
+                QThread::msleep(100);
+            }
+            consumer.stop();
+            ok = !m_stopRequested.loadAcquire();
+        } else {
+            appendToLog(QString("Failed to create \"%1\" consumer in process\n").arg(serviceName));
+        }
+    }
+    m_inProcessRunning.storeRelease(0);
+    // Finish on the main thread through the usual path.
+    QMetaObject::invokeMethod(this, "onFinished", Qt::QueuedConnection,
+        Q_ARG(int, ok? 0 : 1), Q_ARG(QProcess::ExitStatus, QProcess::NormalExit));
+}
+
 void MeltJob::onReadyRead()
 {
     QString msg;
@@ -151,15 +232,11 @@ void MeltJob::onReadyRead()
             index += 6;
             int comma = msg.indexOf(',', index);
             m_currentFrame = msg.mid(index, comma - index).toInt();
+            setFramesProcessed(m_currentFrame);
         }
         index = msg.indexOf("percentage:");
         if (index > -1) {
-            int percent = msg.mid(index + 11).toInt();
-            if (percent != m_previousPercent) {
-                emit progressUpdated(m_item, percent);
-                QCoreApplication::processEvents();
-                m_previousPercent = percent;
-            }
+            publishProgress(msg.mid(index + 11).toInt());
         }
         else {
             appendToLog(msg);
@@ -19,6 +19,8 @@
 #define MELTJOB_H
 
 #include "abstractjob.h"
+#include <QAtomicInt>
+#include <QFuture>
 #include <QTemporaryFile>
 #include <MltProfile.h>
 
@@ -33,9 +35,15 @@ public:
     QString xmlPath() const { return m_xml->fileName(); }
     void setIsStreaming(bool streaming);
     void setUseMultiConsumer(bool multi = true);
+    //! Render in this process with the Mlt++ consumer API instead of
+    //! spawning melt. Only for short jobs where process startup and the XML
+    //! round-trip dominate; big exports keep the process isolation.
+    void setInProcess(bool inProcess = true);
+    bool isRunning() const override;
 
 public slots:
     void start();
+    void stop() override;
     void onViewXmlTriggered();
 
 protected slots:
@@ -48,13 +56,17 @@ protected:
     QScopedPointer<QTemporaryFile> m_xml;
 
 private:
+    void runInProcess();
 
     bool m_isStreaming;
-    int m_previousPercent;
     QStringList m_args;
     int m_currentFrame;
     Mlt::Profile m_profile;
     bool m_useMultiConsumer;
+    bool m_isInProcess;
+    QAtomicInt m_inProcessRunning;
+    QAtomicInt m_stopRequested;
+    QFuture<void> m_inProcessFuture;
 };
 
 #endif // MELTJOB_H
@@ -27,6 +27,46 @@
 
 #include <QFile>
 
+PostJobActionQueue& PostJobActionQueue::singleton()
+{
+    static PostJobActionQueue instance;
+    return instance;
+}
+
+PostJobActionQueue::PostJobActionQueue()
+    : QObject()
+{
+    // Jobs tend to finish in bursts; waiting briefly lets one pass handle
+    // the whole burst instead of interleaving a producer refresh cycle
+    // with every job completion.
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(500);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+PostJobActionQueue::~PostJobActionQueue()
+{
+    qDeleteAll(m_actions);
+}
+
+void PostJobActionQueue::enqueue(PostJobAction* action)
+{
+    m_actions << action;
+    m_timer.start();
+}
+
+void PostJobActionQueue::flush()
+{
+    // The actions replace producers and update models, so the batch runs
+    // on the GUI thread in a single tick, in completion order.
+    QList<PostJobAction*> batch;
+    batch.swap(m_actions);
+    foreach (PostJobAction* action, batch) {
+        action->doAction();
+        delete action;
+    }
+}
+
 void FilePropertiesPostJobAction::doAction()
 {
     // TODO: When QT 5.10 is available, use QFileDevice functions
@@ -109,6 +149,24 @@ void ProxyReplacePostJobAction::doAction()
     }
 }
 
+void RecordCheckpointPostJobAction::doAction()
+{
+    QFile file(m_fileName);
+    if (file.open(QIODevice::Append | QIODevice::Text)) {
+        file.write(m_entry.toUtf8());
+        file.write("\n");
+        file.close();
+    } else {
+        LOG_WARNING() << "failed to open checkpoint file" << m_fileName;
+    }
+}
+
+void RemoveFilesPostJobAction::doAction()
+{
+    foreach (const QString& fileName, m_fileNames)
+        QFile::remove(fileName);
+}
+
 void ProxyFinalizePostJobAction::doAction()
 {
     QFileInfo info(m_dstFile);
@@ -18,7 +18,11 @@
 #ifndef POSTJOBACTION_H
 #define POSTJOBACTION_H
 
+#include <QList>
+#include <QObject>
 #include <QString>
+#include <QStringList>
+#include <QTimer>
 #include <QUuid>
 
 class PostJobAction
@@ -28,6 +32,28 @@ public:
     virtual void doAction() = 0;
 };
 
+//! Collects completed-job actions and executes them in batches so that a
+//! burst of finishing jobs (batch proxy generation) results in one pass of
+//! renames and producer replacements instead of a refresh cycle per job.
+class PostJobActionQueue : public QObject
+{
+    Q_OBJECT
+public:
+    static PostJobActionQueue& singleton();
+    //! Takes ownership; the action runs with the next batch.
+    void enqueue(PostJobAction* action);
+
+public slots:
+    void flush();
+
+private:
+    PostJobActionQueue();
+    ~PostJobActionQueue();
+
+    QList<PostJobAction*> m_actions;
+    QTimer m_timer;
+};
+
 class FilePropertiesPostJobAction : public PostJobAction
 {
 public:
@@ -103,6 +129,34 @@ private:
     QString m_hash;
 };
 
+class RecordCheckpointPostJobAction : public PostJobAction
+{
+public:
+    RecordCheckpointPostJobAction(const QString& fileName, const QString& entry)
+        : PostJobAction()
+        , m_fileName(fileName)
+        , m_entry(entry)
+        {}
+    void doAction();
+
+private:
+    QString m_fileName;
+    QString m_entry;
+};
+
+class RemoveFilesPostJobAction : public PostJobAction
+{
+public:
+    RemoveFilesPostJobAction(const QStringList& fileNames)
+        : PostJobAction()
+        , m_fileNames(fileNames)
+        {}
+    void doAction();
+
+private:
+    QStringList m_fileNames;
+};
+
 class ProxyFinalizePostJobAction : public PostJobAction
 {
 public:
@@ -20,9 +20,12 @@
 #include <QAction>
 #include <QFile>
 #include <QDomDocument>
+#include <QRegularExpression>
 #include <QTextStream>
+#include <QThread>
 #include <QFileInfo>
 #include <QUrl>
+#include <QVector>
 #include <QDesktopServices>
 #include "mainwindow.h"
 #include "dialogs/textviewerdialog.h"
@@ -32,6 +35,8 @@ VideoQualityJob::VideoQualityJob(const QString& name, const QString& xml,
                                  const QString& reportPath, int frameRateNum, int frameRateDen)
     : MeltJob(name, xml, frameRateNum, frameRateDen)
     , m_reportPath(reportPath)
+    , m_frameRateNum(frameRateNum)
+    , m_frameRateDen(frameRateDen)
 {
     QAction* action = new QAction(tr("Open"), this);
     action->setToolTip(tr("Open original and encoded side-by-side in the Shotcut player"));
@@ -50,6 +55,103 @@ VideoQualityJob::VideoQualityJob(const QString& name, const QString& xml,
     setStandardOutputFile(reportPath);
 }
 
+QList<AbstractJob*> VideoQualityJob::createShards(int shards)
+{
+    QList<AbstractJob*> jobs;
+    if (shards < 2)
+        return jobs;
+
+    // Find the time range on the main tractor element.
+    QDomDocument dom(xmlPath());
+    dom.setContent(xml());
+    QDomNodeList tractors = dom.elementsByTagName("tractor");
+    if (tractors.isEmpty())
+        return jobs;
+    QDomElement tractor = tractors.at(tractors.length() - 1).toElement();
+    int in = tractor.attribute("in").toInt();
+    int out = tractor.attribute("out").toInt();
+    int length = out - in + 1;
+    // Do not bother sharding a measurement of a few seconds.
+    shards = qMin(shards, length / 100);
+    if (shards < 2)
+        return jobs;
+
+    for (int i = 0; i < shards; i++) {
+        tractor.setAttribute("in", in + i * length / shards);
+        tractor.setAttribute("out", (i == shards - 1)? out : (in + (i + 1) * length / shards - 1));
+        QString partPath = QString("%1.part%2").arg(m_reportPath).arg(i + 1);
+        MeltJob* job = new MeltJob(objectName(), dom.toString(2), m_frameRateNum, m_frameRateDen);
+        job->setLabel(tr("Measure %1 (part %2)").arg(objectName()).arg(i + 1));
+        job->setLane(SegmentLane);
+        job->setStandardOutputFile(partPath);
+        m_shardReports << partPath;
+        jobs << job;
+    }
+    return jobs;
+}
+
+void VideoQualityJob::start()
+{
+    if (!m_shardReports.isEmpty()) {
+        AbstractJob::start();
+        bool ok = mergeShardReports();
+        // Deferred so the job queue is not re-entered from within start().
+        QMetaObject::invokeMethod(this, "onFinished", Qt::QueuedConnection,
+            Q_ARG(int, ok? 0 : 1), Q_ARG(QProcess::ExitStatus, QProcess::NormalExit));
+        return;
+    }
+    MeltJob::start();
+}
+
+bool VideoQualityJob::mergeShardReports()
+{
+    QFile report(m_reportPath);
+    if (!report.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+    QTextStream merged(&report);
+    QVector<double> sums;
+    qint64 count = 0;
+    bool wroteHeader = false;
+    foreach (const QString& partPath, m_shardReports) {
+        QFile part(partPath);
+        if (!part.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            appendToLog(QString("Missing partial report %1\n").arg(partPath));
+            report.close();
+            return false;
+        }
+        QTextStream stream(&part);
+        while (!stream.atEnd()) {
+            QString line = stream.readLine();
+            // Data lines begin with a frame number; repeat other lines from
+            // the first shard only.
+            if (line.isEmpty() || !line.at(0).isDigit()) {
+                if (!wroteHeader)
+                    merged << line << '\n';
+                continue;
+            }
+            merged << line << '\n';
+            const auto fields = line.split(QRegularExpression("[,\\s]+"), QString::SkipEmptyParts);
+            if (sums.size() < fields.size())
+                sums.resize(fields.size());
+            for (int i = 0; i < fields.size(); i++)
+                sums[i] += fields.at(i).toDouble();
+            ++count;
+        }
+        wroteHeader = true;
+        part.close();
+        part.remove();
+    }
+    // The first column is the frame number; append the per-metric means.
+    if (count > 0) {
+        merged << "average";
+        for (int i = 1; i < sums.size(); i++)
+            merged << ' ' << sums.at(i) / count;
+        merged << '\n';
+    }
+    report.close();
+    return true;
+}
+
 void VideoQualityJob::onOpenTiggered()
 {
     // Parse the XML.
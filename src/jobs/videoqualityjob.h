@@ -19,6 +19,7 @@
 #define VIDEOQUALITYJOB_H
 
 #include "meltjob.h"
+#include <QStringList>
 
 class VideoQualityJob : public MeltJob
 {
@@ -27,12 +28,25 @@ public:
     VideoQualityJob(const QString& name, const QString& xml,
                     const QString& reportPath, int frameRateNum, int frameRateDen);
 
+    //! Split the measurement into jobs that each measure a frame range and
+    //! write a partial report. Add them as dependencies of this job, which
+    //! then only merges the partial reports into the final one.
+    QList<AbstractJob*> createShards(int shards);
+
+public slots:
+    void start();
+
 private slots:
     void onOpenTiggered();
     void onViewReportTriggered();
 
 private:
+    bool mergeShardReports();
+
     QString m_reportPath;
+    QStringList m_shardReports;
+    int m_frameRateNum;
+    int m_frameRateDen;
 };
 
 #endif // VIDEOQUALITYJOB_H
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jobsserver.h"
+#include "jobqueue.h"
+#include "jobs/meltjob.h"
+#include "jobs/ffmpegjob.h"
+#include "mltcontroller.h"
+#include "proxymanager.h"
+#include "util.h"
+#include <QLocalSocket>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QPoint>
+#include <Logger.h>
+
+JobsServer::JobsServer(const QString& serverName, QObject* parent)
+    : QObject(parent)
+{
+    // The proxy command builds producers without the player Controller, so
+    // make sure the MLT repository is loaded. A second init is a no-op.
+    Mlt::Factory::init();
+    connect(&m_server, SIGNAL(newConnection()), SLOT(onNewConnection()));
+    connect(&JOBS, SIGNAL(jobAdded()), SLOT(onJobAdded()));
+    // Remove a socket left behind by a crashed predecessor.
+    QLocalServer::removeServer(serverName);
+    m_server.listen(serverName);
+}
+
+bool JobsServer::isListening() const
+{
+    return m_server.isListening();
+}
+
+QString JobsServer::errorString() const
+{
+    return m_server.errorString();
+}
+
+void JobsServer::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server.nextPendingConnection()) {
+        LOG_INFO() << "jobs client connected";
+        connect(socket, SIGNAL(readyRead()), SLOT(onReadyRead()));
+        connect(socket, SIGNAL(disconnected()), SLOT(onDisconnected()));
+        m_sockets << socket;
+    }
+}
+
+void JobsServer::onDisconnected()
+{
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+    if (socket) {
+        m_sockets.removeOne(socket);
+        socket->deleteLater();
+    }
+}
+
+void JobsServer::onReadyRead()
+{
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+    if (!socket) return;
+    while (socket->canReadLine()) {
+        const QByteArray line = socket->readLine().trimmed();
+        if (line.isEmpty()) continue;
+        QJsonParseError error;
+        const QJsonDocument doc = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            send(socket, makeError(error.error != QJsonParseError::NoError?
+                error.errorString() : QString::fromLatin1("request is not a JSON object")));
+            continue;
+        }
+        send(socket, handleCommand(doc.object()));
+    }
+}
+
+void JobsServer::onJobAdded()
+{
+    // Covers jobs created by ProxyManager as well as the ones made here.
+    const QList<AbstractJob*> jobs = JOBS.jobs();
+    if (!jobs.isEmpty())
+        connect(jobs.last(), SIGNAL(finished(AbstractJob*, bool, QString)),
+                SLOT(onJobFinished(AbstractJob*, bool, QString)), Qt::UniqueConnection);
+}
+
+void JobsServer::onJobFinished(AbstractJob* job, bool isSuccess, QString time)
+{
+    Q_UNUSED(time)
+    QJsonObject event;
+    event.insert("event", QString::fromLatin1("finished"));
+    event.insert("job", job->objectName());
+    event.insert("success", isSuccess);
+    sendToAll(event);
+}
+
+QJsonObject JobsServer::handleCommand(const QJsonObject& request)
+{
+    const QString command = request.value("command").toString();
+    if (command == "export")
+        return handleExport(request);
+    if (command == "ffmpeg")
+        return handleFfmpeg(request);
+    if (command == "proxy")
+        return handleProxy(request);
+    if (command == "status")
+        return handleStatus();
+    return makeError(QString::fromLatin1("unknown command \"%1\"").arg(command));
+}
+
+QJsonObject JobsServer::handleExport(const QJsonObject& request)
+{
+    const QString xmlPath = request.value("xml").toString();
+    const QString target = request.value("target").toString();
+    if (xmlPath.isEmpty() || target.isEmpty())
+        return makeError(QString::fromLatin1("export requires \"xml\" and \"target\""));
+    QFile file(xmlPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return makeError(QString::fromLatin1("cannot read %1").arg(xmlPath));
+    const QString xml = QString::fromUtf8(file.readAll());
+    MeltJob* job = new MeltJob(target, xml,
+        request.value("frame_rate_num").toInt(), request.value("frame_rate_den").toInt());
+    job->setLabel(QObject::tr("Export %1").arg(Util::baseName(target)));
+    JOBS.add(job);
+    QJsonObject result;
+    result.insert("job", target);
+    return result;
+}
+
+QJsonObject JobsServer::handleFfmpeg(const QJsonObject& request)
+{
+    const QString target = request.value("target").toString();
+    if (target.isEmpty() || !request.value("args").isArray())
+        return makeError(QString::fromLatin1("ffmpeg requires \"target\" and \"args\""));
+    QStringList args;
+    foreach (const QJsonValue& value, request.value("args").toArray())
+        args << value.toString();
+    FfmpegJob* job = new FfmpegJob(target, args, false);
+    job->setLabel(QObject::tr("Transcode %1").arg(Util::baseName(target)));
+    JOBS.add(job);
+    QJsonObject result;
+    result.insert("job", target);
+    return result;
+}
+
+QJsonObject JobsServer::handleProxy(const QJsonObject& request)
+{
+    const QString fileName = request.value("file").toString();
+    if (fileName.isEmpty())
+        return makeError(QString::fromLatin1("proxy requires \"file\""));
+    if (!QFileInfo(fileName).isFile())
+        return makeError(QString::fromLatin1("no such file %1").arg(fileName));
+    Mlt::Profile profile;
+    Mlt::Producer producer(profile, fileName.toUtf8().constData());
+    if (!producer.is_valid())
+        return makeError(QString::fromLatin1("cannot open %1").arg(fileName));
+    const QString service = QString::fromLatin1(producer.get("mlt_service"));
+    if (service.startsWith("avformat")) {
+        // Fetch a frame to populate the meta.media properties used by the
+        // proxy arguments.
+        delete producer.get_frame();
+        ProxyManager::generateVideoProxy(producer, Mlt::Controller::fullRange(producer),
+                                         ProxyManager::Automatic, QPoint(), false /* replace */);
+    } else if (service == "qimage" || service == "pixbuf") {
+        delete producer.get_frame();
+        ProxyManager::generateImageProxy(producer, false /* replace */);
+    } else {
+        return makeError(QString::fromLatin1("%1 is not suitable for a proxy").arg(fileName));
+    }
+    QJsonObject result;
+    result.insert("job", fileName);
+    return result;
+}
+
+QJsonObject JobsServer::handleStatus() const
+{
+    QJsonArray jobs;
+    foreach (AbstractJob* job, JOBS.jobs()) {
+        QJsonObject o;
+        o.insert("job", job->objectName());
+        o.insert("label", job->label());
+        o.insert("running", job->isRunning());
+        o.insert("finished", job->ran() && !job->isRunning());
+        o.insert("stopped", job->stopped());
+        o.insert("success", job->isSuccess());
+        o.insert("percent", job->lastPercent());
+        jobs << o;
+    }
+    QJsonObject result;
+    result.insert("jobs", jobs);
+    return result;
+}
+
+void JobsServer::sendToAll(const QJsonObject& message)
+{
+    foreach (QLocalSocket* socket, m_sockets)
+        send(socket, message);
+}
+
+void JobsServer::send(QLocalSocket* socket, const QJsonObject& message)
+{
+    socket->write(QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n");
+    socket->flush();
+}
+
+QJsonObject JobsServer::makeError(const QString& message)
+{
+    QJsonObject result;
+    result.insert("error", message);
+    return result;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOBSSERVER_H
+#define JOBSSERVER_H
+
+#include <QObject>
+#include <QLocalServer>
+#include <QJsonObject>
+#include <QList>
+
+class QLocalSocket;
+class AbstractJob;
+
+//! Accepts job requests over a local socket so render nodes can drive the
+//! job engine without the main window. The protocol is one JSON object per
+//! line; each request gets one JSON object line in response. Supported
+//! commands:
+//!   {"command": "export",  "xml": <.mlt with consumer>, "target": <output>}
+//!   {"command": "ffmpeg",  "target": <output>, "args": [...]}
+//!   {"command": "proxy",   "file": <media file>}
+//!   {"command": "status"}
+//! Job completion is also pushed to every connected client as
+//!   {"event": "finished", "job": <target>, "success": <bool>}
+class JobsServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit JobsServer(const QString& serverName, QObject* parent = 0);
+    bool isListening() const;
+    QString errorString() const;
+
+private slots:
+    void onNewConnection();
+    void onDisconnected();
+    void onReadyRead();
+    void onJobAdded();
+    void onJobFinished(AbstractJob* job, bool isSuccess, QString time);
+
+private:
+    QJsonObject handleCommand(const QJsonObject& request);
+    QJsonObject handleExport(const QJsonObject& request);
+    QJsonObject handleFfmpeg(const QJsonObject& request);
+    QJsonObject handleProxy(const QJsonObject& request);
+    QJsonObject handleStatus() const;
+    void sendToAll(const QJsonObject& message);
+    static void send(QLocalSocket* socket, const QJsonObject& message);
+    static QJsonObject makeError(const QString& message);
+
+    QLocalServer m_server;
+    QList<QLocalSocket*> m_sockets;
+};
+
+#endif // JOBSSERVER_H
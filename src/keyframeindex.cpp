@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyframeindex.h"
+#include "jobqueue.h"
+#include "jobs/keyframeindexjob.h"
+#include "proxymanager.h"
+#include "settings.h"
+#include "util.h"
+#include <Logger.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <algorithm>
+
+static const char* kIndexFileExtension = ".keyframes";
+static const char* kIndexFileMagic = "shotcut keyframe index 1";
+
+// Codecs where every frame is a keyframe; seeking them is already exact
+// and an index would be all frames.
+static bool isIntraOnly(const QString& codec)
+{
+    return codec == "mjpeg" || codec == "prores" || codec == "dnxhd"
+        || codec == "utvideo" || codec == "huffyuv" || codec == "ffv1"
+        || codec == "qtrle" || codec == "rawvideo" || codec == "v210"
+        || codec == "jpeg2000" || codec == "png" || codec == "tiff"
+        || codec == "bmp" || codec == "dpx";
+}
+
+KeyframeIndex& KeyframeIndex::singleton()
+{
+    static KeyframeIndex instance;
+    return instance;
+}
+
+QDir KeyframeIndex::dir()
+{
+    QDir dir(Settings.appDataLocation());
+    const QString subdir("indexes");
+    if (!dir.exists(subdir))
+        dir.mkdir(subdir);
+    dir.cd(subdir);
+    return dir;
+}
+
+QString KeyframeIndex::filePath(const QString& hash)
+{
+    return dir().filePath(hash + kIndexFileExtension);
+}
+
+void KeyframeIndex::buildIfMissing(Mlt::Producer& producer)
+{
+    if (!producer.is_valid())
+        return;
+    QString service = QString::fromLatin1(producer.get("mlt_service"));
+    if (!service.startsWith("avformat"))
+        return;
+    int videoIndex = producer.get_int("video_index");
+    if (videoIndex < 0)
+        return;
+    QString key = QString("meta.media.%1.codec.name").arg(videoIndex);
+    QString codec = QString::fromLatin1(producer.get(key.toLatin1().constData()));
+    if (codec.isEmpty() || isIntraOnly(codec))
+        return;
+    QString resource = ProxyManager::resource(producer);
+    if (!QFileInfo(resource).isFile())
+        return;
+    QString hash = Util::getHash(producer);
+    if (hash.isEmpty())
+        return;
+    QString sidecar = filePath(hash);
+    if (QFile::exists(sidecar) || JOBS.hasActiveJob(sidecar))
+        return;
+    LOG_DEBUG() << "indexing keyframes of" << resource;
+    JOBS.add(new KeyframeIndexJob(sidecar, resource));
+}
+
+QVector<double> KeyframeIndex::keyframes(const QString& hash)
+{
+    QMutexLocker locker(&m_mutex);
+    QHash<QString, QVector<double> >::const_iterator it = m_cache.constFind(hash);
+    if (it != m_cache.constEnd())
+        return it.value();
+
+    QVector<double> times;
+    QFile file(filePath(hash));
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream stream(&file);
+        if (stream.readLine() == kIndexFileMagic) {
+            while (!stream.atEnd()) {
+                bool ok = false;
+                double t = stream.readLine().toDouble(&ok);
+                if (ok)
+                    times << t;
+            }
+            std::sort(times.begin(), times.end());
+            // Only successful loads are cached; a missing sidecar is
+            // re-checked so the index appears once its job completes.
+            m_cache.insert(hash, times);
+        }
+    }
+    return times;
+}
+
+double KeyframeIndex::nearestBefore(const QString& hash, double seconds)
+{
+    const QVector<double> times = keyframes(hash);
+    if (times.isEmpty())
+        return -1.0;
+    QVector<double>::const_iterator it =
+        std::upper_bound(times.constBegin(), times.constEnd(), seconds);
+    if (it == times.constBegin())
+        return times.first();
+    return *(it - 1);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYFRAMEINDEX_H
+#define KEYFRAMEINDEX_H
+
+#include <QDir>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <MltProducer.h>
+
+/*!
+  \class KeyframeIndex
+  \brief Per-file keyframe position sidecars for long-GOP media.
+
+  \threadsafe
+
+  Seeking long-GOP media lands between keyframes, and the decoder pays for
+  every frame from the preceding keyframe to the target. The first open of
+  a file schedules a background ffprobe that records the keyframe times in
+  a sidecar next to the peaks and proxy artifacts, keyed by the same file
+  hash. Later sessions load the sidecar instead of re-discovering the
+  index, and the trick-play shuttle snaps its strided seeks to keyframes
+  so each tick resolves with no partial-GOP decode.
+*/
+class KeyframeIndex
+{
+public:
+    static KeyframeIndex& singleton();
+
+    //! Schedules building the sidecar for the producer's file when the
+    //! file is long-GOP video and no sidecar or index job exists yet.
+    void buildIfMissing(Mlt::Producer& producer);
+
+    //! The keyframe times in seconds for the file hash, sorted ascending;
+    //! empty when there is no sidecar.
+    QVector<double> keyframes(const QString& hash);
+
+    //! The latest keyframe time at or before \a seconds, or a negative
+    //! value when the file has no index.
+    double nearestBefore(const QString& hash, double seconds);
+
+    //! The directory holding the sidecars, created on demand.
+    static QDir dir();
+    static QString filePath(const QString& hash);
+
+private:
+    KeyframeIndex() {}
+
+    QMutex m_mutex;
+    QHash<QString, QVector<double> > m_cache;
+};
+
+#endif // KEYFRAMEINDEX_H
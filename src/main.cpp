@@ -18,7 +18,13 @@
 #include <QtWidgets>
 #include <QtGlobal>
 #include "mainwindow.h"
+#include "mltcontroller.h"
+#include "jobsserver.h"
 #include "settings.h"
+#include "startuptracer.h"
+#include "perflog.h"
+#include "memoryreport.h"
+#include "stalldetector.h"
 #include <Logger.h>
 #include <FileAppender.h>
 #include <ConsoleAppender.h>
@@ -103,9 +109,11 @@ public:
     QStringList resourceArg;
     bool isFullScreen;
     QString appDirArg;
+    QString jobsServerArg;
 
     Application(int &argc, char **argv)
         : QApplication(argc, argv)
+        , mainWindow(0)
     {
         QDir dir(applicationDirPath());
 #ifdef Q_OS_MAC
@@ -150,6 +158,13 @@ public:
         QCommandLineOption clearRecentOption("clear-recent",
             QCoreApplication::translate("main", "Clear Recent on Exit"));
         parser.addOption(clearRecentOption);
+        QCommandLineOption startupTraceOption("startup-trace",
+            QCoreApplication::translate("main", "Write a startup performance trace in Chrome tracing format."));
+        parser.addOption(startupTraceOption);
+        QCommandLineOption jobsServerOption("jobs-server",
+            QCoreApplication::translate("main", "Run without a main window and accept jobs over a local socket with this server name."),
+            QCoreApplication::translate("main", "name"));
+        parser.addOption(jobsServerOption);
         QCommandLineOption appDataOption("appdata",
             QCoreApplication::translate("main", "The directory for app configuration and data."),
             QCoreApplication::translate("main", "directory"));
@@ -172,6 +187,7 @@ public:
 #endif
         setProperty("noupgrade", parser.isSet(noupgradeOption));
         setProperty("clearRecent", parser.isSet(clearRecentOption));
+        jobsServerArg = parser.value(jobsServerOption);
         if (!parser.value(appDataOption).isEmpty()) {
             appDirArg = parser.value(appDataOption);
             ShotcutSettings::setAppDataForSession(appDirArg);
@@ -246,34 +262,39 @@ public:
 #endif
         // Load translations
         QString locale = Settings.language();
-        dir = applicationDirPath();
-    #if defined(Q_OS_MAC)
-        dir.cdUp();
-        dir.cd("Resources");
-        dir.cd("translations");
-    #elif defined(Q_OS_WIN)
-        dir.cd("share");
-        dir.cd("translations");
-    #else
-        dir.cdUp();
-        dir.cd("share");
-        dir.cd("shotcut");
-        dir.cd("translations");
-    #endif
         if (locale.startsWith("pt_"))
             locale = "pt";
         else if (locale.startsWith("en_"))
             locale = "en";
-        if (qtTranslator.load("qt_" + locale, QLibraryInfo::location(QLibraryInfo::TranslationsPath)))
-            installTranslator(&qtTranslator);
-        else if (qtTranslator.load("qt_" + locale, dir.absolutePath()))
-            installTranslator(&qtTranslator);
-        if (qtBaseTranslator.load("qtbase_" + locale, QLibraryInfo::location(QLibraryInfo::TranslationsPath)))
-            installTranslator(&qtBaseTranslator);
-        else if (qtBaseTranslator.load("qtbase_" + locale, dir.absolutePath()))
-            installTranslator(&qtBaseTranslator);
-        if (shotcutTranslator.load("shotcut_" + Settings.language(), dir.absolutePath()))
-            installTranslator(&shotcutTranslator);
+        // The source strings are English, so there is nothing to load for
+        // that locale: skip the translator file probes entirely instead of
+        // letting each load miss in several directories.
+        if (locale != "en" && locale != "C") {
+            dir = applicationDirPath();
+    #if defined(Q_OS_MAC)
+            dir.cdUp();
+            dir.cd("Resources");
+            dir.cd("translations");
+    #elif defined(Q_OS_WIN)
+            dir.cd("share");
+            dir.cd("translations");
+    #else
+            dir.cdUp();
+            dir.cd("share");
+            dir.cd("shotcut");
+            dir.cd("translations");
+    #endif
+            if (qtTranslator.load("qt_" + locale, QLibraryInfo::location(QLibraryInfo::TranslationsPath)))
+                installTranslator(&qtTranslator);
+            else if (qtTranslator.load("qt_" + locale, dir.absolutePath()))
+                installTranslator(&qtTranslator);
+            if (qtBaseTranslator.load("qtbase_" + locale, QLibraryInfo::location(QLibraryInfo::TranslationsPath)))
+                installTranslator(&qtBaseTranslator);
+            else if (qtBaseTranslator.load("qtbase_" + locale, dir.absolutePath()))
+                installTranslator(&qtBaseTranslator);
+            if (shotcutTranslator.load("shotcut_" + Settings.language(), dir.absolutePath()))
+                installTranslator(&shotcutTranslator);
+        }
     }
 
     ~Application()
@@ -328,7 +349,36 @@ int main(int argc, char **argv)
     removeMacosTabBar();
 #endif
 
+    // Enable tracing before Application runs so its constructor is covered;
+    // the QCommandLineParser option exists for --help and validation only.
+    for (int i = 1; i < argc; i++) {
+        if (!::qstrcmp("--startup-trace", argv[i])) {
+            StartupTracer::singleton().setEnabled(true);
+            break;
+        }
+    }
+
+    StartupTracer::singleton().beginPhase("Application");
     Application a(argc, argv);
+    StartupTracer::singleton().endPhase("Application");
+
+    if (!a.jobsServerArg.isEmpty()) {
+        // Headless batch mode: no theme, splash screen, or main window -
+        // just the job engine behind a local socket. Combine with
+        // "-platform offscreen" on display-less render nodes.
+        JobsServer server(a.jobsServerArg);
+        if (!server.isListening()) {
+            LOG_ERROR() << "cannot listen on jobs server socket" << server.errorString();
+            return EXIT_FAILURE;
+        }
+        LOG_INFO() << "jobs server listening at" << a.jobsServerArg;
+        return a.exec();
+    }
+
+    // Overlap the MLT plugin repository scan with theme setup, the splash
+    // screen, and the pre-MLT part of MainWindow construction. The MLT log
+    // handler is already installed by the Application constructor.
+    Mlt::Controller::prepareRepository();
     QSplashScreen splash(QPixmap(":/icons/shotcut-logo-320x320.png"));
     splash.showMessage(QCoreApplication::translate("main", "Loading plugins..."), Qt::AlignRight | Qt::AlignVCenter);
     splash.show();
@@ -336,19 +386,33 @@ int main(int argc, char **argv)
     a.setProperty("system-style", a.style()->objectName());
     MainWindow::changeTheme(Settings.theme());
 
+    StartupTracer::singleton().beginPhase("MainWindow");
     a.mainWindow = &MAIN;
+    StartupTracer::singleton().endPhase("MainWindow");
     if (!a.appDirArg.isEmpty())
         a.mainWindow->hideSetDataDirectory();
+    StartupTracer::singleton().beginPhase("MainWindow::show");
     a.mainWindow->show();
+    StartupTracer::singleton().endPhase("MainWindow::show");
     a.mainWindow->setFullScreen(a.isFullScreen);
     splash.finish(a.mainWindow);
 
-    if (!a.resourceArg.isEmpty())
-        a.mainWindow->openMultiple(a.resourceArg);
-    else
-        a.mainWindow->open(a.mainWindow->untitledFileName());
+    {
+        StartupPhase phase("initial open");
+        if (!a.resourceArg.isEmpty())
+            a.mainWindow->openMultiple(a.resourceArg);
+        else
+            a.mainWindow->open(a.mainWindow->untitledFileName());
+    }
+    if (StartupTracer::singleton().isEnabled())
+        StartupTracer::singleton().write(Settings.appDataLocation() + "/startup-trace.json");
 
+    // Watch only the interactive session; startup blocks the loop by design.
+    StallDetector::singleton().startWatching();
     int result = a.exec();
+    StallDetector::singleton().stopWatching();
+    PerfLog::flush();
+    MemoryReport::log();
 
     if (EXIT_RESTART == result) {
         LOG_DEBUG() << "restarting app";
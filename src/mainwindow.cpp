@@ -80,10 +80,12 @@
 #include "dialogs/longuitask.h"
 #include "dialogs/systemsyncdialog.h"
 #include "proxymanager.h"
+#include "taskpool.h"
 
 #include <QtWidgets>
 #include <Logger.h>
 #include <QThreadPool>
+#include <QRunnable>
 #include <QtConcurrent/QtConcurrentRun>
 #include <QMutexLocker>
 #include <QQuickItem>
@@ -110,6 +112,65 @@ static bool eventDebugCallback(void **data)
 }
 
 static const int AUTOSAVE_TIMEOUT_MS = 60000;
+// Flush the autosave snapshot shortly after an edit batch goes quiet, so a
+// crash loses seconds of work instead of up to a minute; the timeout above
+// remains the upper bound while edits keep coming.
+static const int AUTOSAVE_IDLE_TIMEOUT_MS = 5000;
+
+// Seconds of audio decoded from the clips at the head of the timeline when
+// preheating, so the program mix at position 0 starts clean.
+static const int kPreheatAudioSecs = 2;
+
+class PreheatClipTask : public QRunnable
+{
+public:
+    PreheatClipTask(const QString& resource, int frameIn, int audioFrames)
+        : QRunnable()
+        , m_resource(resource)
+        , m_frameIn(frameIn)
+        , m_audioFrames(audioFrames)
+        , m_epoch(TaskPool::singleton().currentEpoch())
+    {
+    }
+
+    void run()
+    {
+        if (TaskPool::singleton().isStale(m_epoch))
+            return;
+        // A private producer on a private profile: warming the demuxer and
+        // decoder must not touch anything the playback threads use.
+        Mlt::Profile profile;
+        Mlt::Producer producer(profile, m_resource.toUtf8().constData());
+        if (!producer.is_valid())
+            return;
+        producer.seek(m_frameIn);
+        QScopedPointer<Mlt::Frame> frame(producer.get_frame());
+        if (frame && frame->is_valid()) {
+            mlt_image_format format = mlt_image_none;
+            int width = 0;
+            int height = 0;
+            frame->get_image(format, width, height);
+        }
+        for (int i = 0; i < m_audioFrames; i++) {
+            if (TaskPool::singleton().isStale(m_epoch))
+                return;
+            QScopedPointer<Mlt::Frame> audioFrame(producer.get_frame());
+            if (!audioFrame || !audioFrame->is_valid())
+                break;
+            mlt_audio_format format = mlt_audio_s16;
+            int frequency = 48000;
+            int channels = 2;
+            int samples = 0;
+            audioFrame->get_audio(format, frequency, channels, samples);
+        }
+    }
+
+private:
+    QString m_resource;
+    int m_frameIn;
+    int m_audioFrames;
+    int m_epoch;
+};
 
 MainWindow::MainWindow()
     : QMainWindow(0)
@@ -123,6 +184,12 @@ MainWindow::MainWindow()
     , m_navigationPosition(0)
     , m_upgradeUrl("https://www.shotcut.org/download/")
     , m_keyframesDock(0)
+    , m_autosaveDirtyCount(0)
+    , m_autosaveSavedCount(0)
+    , m_openStagingGeneration(0)
+    , m_openStagingActive(false)
+    , m_multipleFilesGeneration(0)
+    , m_multipleFilesTotal(0)
 {
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
     QLibrary libJack("libjack.so.0");
@@ -157,12 +224,18 @@ MainWindow::MainWindow()
 
     LOG_DEBUG() << "begin";
 #ifndef Q_OS_WIN
-    new GLTestWidget(this);
+    // Skip the probe if this GPU and driver already passed it; GLWidget
+    // invalidates the cached result when the driver identity changes.
+    if (!Settings.capabilityOpenGL())
+        new GLTestWidget(this);
 #endif
     Database::singleton(this);
     m_autosaveTimer.setSingleShot(true);
     m_autosaveTimer.setInterval(AUTOSAVE_TIMEOUT_MS);
     connect(&m_autosaveTimer, SIGNAL(timeout()), this, SLOT(onAutosaveTimeout()));
+    m_autosaveIdleTimer.setSingleShot(true);
+    m_autosaveIdleTimer.setInterval(AUTOSAVE_IDLE_TIMEOUT_MS);
+    connect(&m_autosaveIdleTimer, SIGNAL(timeout()), this, SLOT(onAutosaveTimeout()));
 
     // Initialize all QML types
     QmlUtilities::registerCommonTypes();
@@ -308,6 +381,7 @@ MainWindow::MainWindow()
     connect(m_timelineDock, SIGNAL(showStatusMessage(QString)), this, SLOT(showStatusMessage(QString)));
     connect(m_timelineDock->model(), SIGNAL(showStatusMessage(QString)), this, SLOT(showStatusMessage(QString)));
     connect(m_timelineDock->model(), SIGNAL(created()), SLOT(onMultitrackCreated()));
+    connect(m_timelineDock->model(), SIGNAL(loaded()), SLOT(onMultitrackLoaded()));
     connect(m_timelineDock->model(), SIGNAL(closed()), SLOT(onMultitrackClosed()));
     connect(m_timelineDock->model(), SIGNAL(modified()), SLOT(onMultitrackModified()));
     connect(m_timelineDock->model(), SIGNAL(modified()), SLOT(updateAutoSave()));
@@ -446,7 +520,7 @@ MainWindow::MainWindow()
     connect(videoWidget, SIGNAL(seekTo(int)), m_player, SLOT(seek(int)));
     connect(videoWidget, SIGNAL(gpuNotSupported()), this, SLOT(onGpuNotSupported()));
     connect(videoWidget->quickWindow(), SIGNAL(sceneGraphInitialized()), SLOT(onSceneGraphInitialized()), Qt::QueuedConnection);
-    connect(videoWidget, SIGNAL(frameDisplayed(const SharedFrame&)), m_scopeController, SIGNAL(newFrame(const SharedFrame&)));
+    connect(videoWidget, SIGNAL(frameDisplayed(const SharedFrame&)), m_scopeController, SLOT(onNewFrame(const SharedFrame&)));
     connect(m_filterController, SIGNAL(currentFilterChanged(QmlFilter*, QmlMetadata*, int)), videoWidget, SLOT(setCurrentFilter(QmlFilter*, QmlMetadata*)));
 
     readWindowSettings();
@@ -988,19 +1062,38 @@ bool MainWindow::saveRepairedXmlFile(MltXmlChecker& checker, QString& fileName)
     QFile temp(checker.tempFileName());
     if (temp.exists() && repaired.exists()) {
         temp.open(QIODevice::ReadOnly);
-        QByteArray xml = temp.readAll();
-        temp.close();
-
-        qint64 n = repaired.write(xml);
-        while (n > 0 && n < xml.size()) {
-            qint64 x = repaired.write(xml.right(xml.size() - n));
-            if (x > 0)
-                n += x;
-            else
-                n = x;
+        bool success = false;
+        // Map the checker's output instead of reading it all into a byte
+        // array; recovery files can be large and opening after a crash is
+        // exactly when memory is tightest.
+        uchar* data = temp.map(0, temp.size());
+        if (data) {
+            const qint64 size = temp.size();
+            qint64 written = 0;
+            while (written < size) {
+                qint64 x = repaired.write(reinterpret_cast<const char*>(data) + written, size - written);
+                if (x <= 0)
+                    break;
+                written += x;
+            }
+            temp.unmap(data);
+            success = (written == size);
+        } else {
+            // Mapping can fail on some file systems; copy with a bounded buffer.
+            QByteArray buffer;
+            success = true;
+            while (!(buffer = temp.read(1048576LL /*1MiB*/)).isEmpty()) {
+                if (repaired.write(buffer) != buffer.size()) {
+                    success = false;
+                    break;
+                }
+            }
+            if (temp.error() != QFileDevice::NoError)
+                success = false;
         }
+        temp.close();
         repaired.close();
-        if (n == xml.size()) {
+        if (success) {
             fileName = repaired.fileName();
             return true;
         }
@@ -1081,19 +1174,26 @@ void MainWindow::stepLeftBySeconds(int sec)
     m_player->seek(m_player->position() + sec * qRound(MLT.profile().fps()));
 }
 
-void MainWindow::doAutosave()
+void MainWindow::commitAutosave(const QString& tempName)
 {
     QMutexLocker locker(&m_autosaveMutex);
+    bool success = false;
     if (m_autosaveFile) {
-        bool success = false;
         if (m_autosaveFile->isOpen() || m_autosaveFile->open(QIODevice::ReadWrite)) {
             m_autosaveFile->close();
-            success = saveXML(m_autosaveFile->fileName(), false /* without relative paths */);
+            // Move the streamed snapshot into place so a crash mid-write
+            // cannot truncate the previous autosave. The previous snapshot
+            // becomes the newest retained generation, which also clears the
+            // target name for the rename.
+            m_autosaveFile->rotate();
+            success = QFile::rename(tempName, m_autosaveFile->fileName());
             m_autosaveFile->open(QIODevice::ReadWrite);
         }
-        if (!success) {
-            LOG_ERROR() << "failed to open autosave file for writing" << m_autosaveFile->fileName();
-        }
+    }
+    if (!success) {
+        QFile::remove(tempName);
+        if (m_autosaveFile)
+            LOG_ERROR() << "failed to write autosave file" << m_autosaveFile->fileName();
     }
 }
 
@@ -1196,43 +1296,104 @@ void MainWindow::setPreviewScale(int scale)
     MLT.refreshConsumer();
 }
 
-static void autosaveTask(MainWindow* p)
+static void autosaveTask(MainWindow* p, const QString& tempName)
 {
     LOG_DEBUG_TIME();
-    p->doAutosave();
+    // Validate the snapshot before publishing it: a document that cannot
+    // be parsed back must not replace the last good autosave, and running
+    // the check here amortizes it across editing pauses instead of
+    // surprising the user at save time.
+    QString error;
+    if (!MltXmlChecker::validate(tempName, &error)) {
+        LOG_WARNING() << "autosave snapshot failed validation:" << error;
+        QFile::remove(tempName);
+        QMetaObject::invokeMethod(p, "showStatusMessage", Qt::QueuedConnection,
+            Q_ARG(QString, QObject::tr("Detected invalid project XML: %1").arg(error)));
+        return;
+    }
+    p->commitAutosave(tempName);
 }
 
 void MainWindow::onAutosaveTimeout()
 {
-    if (isWindowModified())
-        QtConcurrent::run(autosaveTask, this);
+    // Whichever timer fired, the other's pending save is now redundant.
+    m_autosaveTimer.stop();
+    m_autosaveIdleTimer.stop();
+    // Skip the write when nothing changed since the last snapshot.
+    if (m_autosaveDirtyCount == m_autosaveSavedCount)
+        return;
+    if (isWindowModified()) {
+        // Serialize on the GUI thread, where reading the producers is
+        // safe, streaming through the xml consumer with a bounded buffer
+        // instead of building the whole document as one string; then hand
+        // the temp file to a worker thread for the atomic rename.
+        QString tempName;
+        {
+            QMutexLocker locker(&m_autosaveMutex);
+            if (!m_autosaveFile)
+                return;
+            tempName = m_autosaveFile->fileName() + ".tmp";
+        }
+        if (writeProjectXML(tempName)) {
+            m_autosaveSavedCount = m_autosaveDirtyCount;
+            QtConcurrent::run(autosaveTask, this, tempName);
+        } else {
+            QFile::remove(tempName);
+        }
+    }
 }
 
 void MainWindow::updateAutoSave()
 {
     if (!m_autosaveTimer.isActive())
         m_autosaveTimer.start();
+    // Each modification pushes the idle flush back; a pause in editing
+    // writes the snapshot within seconds.
+    m_autosaveIdleTimer.start();
+    ++m_autosaveDirtyCount;
 }
 
 void MainWindow::open(QString url, const Mlt::Properties* properties, bool play)
 {
     LOG_DEBUG() << url;
     bool modified = false;
-    MltXmlChecker checker;
+    m_xmlChecker.reset();
     QFileInfo info(url);
 
     if (info.isRelative()) {
         QDir pwd(QDir::currentPath());
         url = pwd.filePath(url);
     }
+    // Stage plain media files on a worker first: constructing an avformat
+    // producer probes the file, which can block for seconds on slow network
+    // storage and used to freeze the whole UI. The staging producer uses its
+    // own profile and touches no shared state, so a stale generation (a
+    // newer open, or Escape) is simply discarded; the real open below then
+    // reads from the warm OS cache.
+    if (!url.endsWith(".mlt") && !url.endsWith(".xml") && !properties
+            && m_stagedOpenUrl != url && QFileInfo(url).isFile()) {
+        const int generation = ++m_openStagingGeneration;
+        m_openStagingActive = true;
+        showStatusMessage(tr("Opening %1").arg(url), 60 /* seconds */);
+        QtConcurrent::run(TaskPool::singleton().pool(), [=]() {
+            Mlt::Profile stagingProfile;
+            Mlt::Producer producer(stagingProfile, url.toUtf8().constData());
+            const bool valid = producer.is_valid();
+            QMetaObject::invokeMethod(this, "onOpenStaged", Qt::QueuedConnection,
+                                      Q_ARG(QString, url), Q_ARG(bool, valid),
+                                      Q_ARG(int, generation), Q_ARG(bool, play));
+        });
+        return;
+    }
+    m_stagedOpenUrl.clear();
     if (url.endsWith(".mlt") || url.endsWith(".xml")) {
         if (url != untitledFileName()) {
             showStatusMessage(tr("Opening %1").arg(url));
             QCoreApplication::processEvents();
         }
     }
-    if (checker.check(url)) {
-        if (!isCompatibleWithGpuMode(checker))
+    if (m_xmlChecker.check(url)) {
+        if (!isCompatibleWithGpuMode(m_xmlChecker))
             return;
     }
     if (url.endsWith(".mlt") || url.endsWith(".xml")) {
@@ -1245,8 +1406,12 @@ void MainWindow::open(QString url, const Mlt::Properties* properties, bool play)
             m_playlistDock->model()->close();
         if (multitrack())
             m_timelineDock->model()->close();
+        // Abort background generation for the outgoing project; tasks
+        // notice the stale epoch at their next chunk boundary.
+        AudioLevelsTask::closeAll();
+        TaskPool::singleton().cancelAll();
         MLT.purgeMemoryPool();
-        if (!isXmlRepaired(checker, url))
+        if (!isXmlRepaired(m_xmlChecker, url))
             return;
         modified = checkAutoSave(url);
         // let the new project change the profile
@@ -1266,10 +1431,44 @@ void MainWindow::open(QString url, const Mlt::Properties* properties, bool play)
             MLT.profile().set_explicit(false);
     }
     if (url.endsWith(".mlt") || url.endsWith(".xml")) {
-        checker.setLocale();
+        m_xmlChecker.setLocale();
         LOG_INFO() << "decimal point" << MLT.decimalPoint();
     }
-    QString urlToOpen = checker.isUpdated()? checker.tempFileName() : url;
+    if (url.endsWith(".mlt") || url.endsWith(".xml")) {
+        // Tell the caching policy whether any of this project's media sits on
+        // a network mount so evicted producers are kept alive longer there.
+        bool hasNetworkMedia = false;
+        foreach (const QString& resource, m_xmlChecker.resources()) {
+            if (Util::isNetworkPath(resource)) {
+                hasNetworkMedia = true;
+                break;
+            }
+        }
+        MLT.setHasNetworkMedia(hasNetworkMedia);
+        // The xml producer opens each clip's producer one at a time, and on a
+        // cold cache most of that is waiting on reads. Warm the head and tail
+        // of every media file on the task pool so the workers run ahead of
+        // the serial opens below and they hit the OS cache instead.
+        foreach (const QString& resource, m_xmlChecker.resources()) {
+            QtConcurrent::run(TaskPool::singleton().pool(), [resource]() {
+                QFile file(resource);
+                if (file.open(QIODevice::ReadOnly)) {
+                    // Container headers are at the start, but MP4 moov atoms
+                    // and index data often sit at the end.
+                    const qint64 chunk = 1000000;
+                    QByteArray buffer(chunk, 0);
+                    file.read(buffer.data(), buffer.size());
+                    if (file.size() > chunk * 2) {
+                        file.seek(file.size() - chunk);
+                        file.read(buffer.data(), buffer.size());
+                    }
+                }
+            });
+        }
+    } else if (info.isFile()) {
+        MLT.setHasNetworkMedia(Util::isNetworkPath(url));
+    }
+    QString urlToOpen = m_xmlChecker.isUpdated()? m_xmlChecker.tempFileName() : url;
     if (!MLT.open(QDir::fromNativeSeparators(urlToOpen), QDir::fromNativeSeparators(url))) {
         Mlt::Properties* props = const_cast<Mlt::Properties*>(properties);
         if (props && props->is_valid())
@@ -1297,6 +1496,24 @@ void MainWindow::open(QString url, const Mlt::Properties* properties, bool play)
     }
 }
 
+void MainWindow::onOpenStaged(QString url, bool valid, int generation, bool play)
+{
+    if (generation != m_openStagingGeneration) {
+        // Canceled with Escape or superseded by a newer open.
+        return;
+    }
+    m_openStagingActive = false;
+    if (!valid) {
+        showStatusMessage(tr("Failed to open ") + url);
+        emit openFailed(url);
+        return;
+    }
+    // Re-enter open() with the staging guard set so it proceeds serially.
+    m_stagedOpenUrl = url;
+    open(url, nullptr, play);
+    m_stagedOpenUrl.clear();
+}
+
 void MainWindow::openMultiple(const QStringList& paths)
 {
     if (paths.size() > 1) {
@@ -1445,6 +1662,8 @@ void MainWindow::readPlayerSettings()
     ui->actionRealtime->setChecked(Settings.playerRealtime());
     ui->actionProgressive->setChecked(Settings.playerProgressive());
     ui->actionScrubAudio->setChecked(Settings.playerScrubAudio());
+    ui->actionAudioOnlyPreview->setChecked(Settings.playerAudioOnly());
+    MLT.setVideoOff(Settings.playerAudioOnly());
     if (ui->actionJack)
         ui->actionJack->setChecked(Settings.playerJACK());
     if (ui->actionGPU) {
@@ -1539,12 +1758,18 @@ void MainWindow::readWindowSettings()
     Settings.setWindowStateDefault(saveState());
     Settings.sync();
     if (!Settings.windowGeometry().isEmpty()) {
+        // Suspend painting while geometry and dock state are restored so the
+        // docks settle with one relayout instead of a storm of intermediate
+        // ones, each of which repaints and can recreate the GL surface.
+        setUpdatesEnabled(false);
         restoreGeometry(Settings.windowGeometry());
         restoreState(Settings.windowState());
 #ifdef Q_OS_MAC
         m_filtersDock->setFloating(false);
 #endif
+        setUpdatesEnabled(true);
     } else {
+        // The layout slot batches its own updates.
         on_actionLayoutTimeline_triggered();
     }
     LOG_DEBUG() << "end";
@@ -1884,6 +2109,10 @@ void MainWindow::keyPressEvent(QKeyEvent* event)
             m_playlistDock->show();
             m_playlistDock->raise();
             m_playlistDock->on_actionInsertCut_triggered();
+        } else if ((event->modifiers() & Qt::ControlModifier) && (event->modifiers() & Qt::AltModifier)) {
+            m_timelineDock->show();
+            m_timelineDock->raise();
+            m_timelineDock->pasteFiltersOnSelection();
         } else {
             m_timelineDock->show();
             m_timelineDock->raise();
@@ -1914,6 +2143,13 @@ void MainWindow::keyPressEvent(QKeyEvent* event)
         }
         break;
     case Qt::Key_Escape: // Avid Toggle Active Monitor
+        if (m_openStagingActive) {
+            // Abort a staged open that is still probing the file.
+            ++m_openStagingGeneration;
+            m_openStagingActive = false;
+            showStatusMessage(tr("Canceled opening"));
+            break;
+        }
         if (MLT.isPlaylist()) {
             if (isMultitrackValid())
                 m_player->onTabBarClicked(Player::ProjectTabIndex);
@@ -2390,6 +2626,10 @@ void MainWindow::closeEvent(QCloseEvent* event)
             LOG_DEBUG() << "begin";
             JOBS.cleanup();
             writeSettings();
+            // Remember where the playhead was so reopening this project
+            // resumes there instead of at the start.
+            if (!m_currentFile.isEmpty() && m_player)
+                Settings.setProjectPlayheadPosition(m_currentFile, m_player->position());
             if (m_exitCode == EXIT_SUCCESS) {
                 MLT.stop();
             } else {
@@ -2402,6 +2642,7 @@ void MainWindow::closeEvent(QCloseEvent* event)
             }
             QThreadPool::globalInstance()->clear();
             AudioLevelsTask::closeAll();
+            TaskPool::singleton().cancelAll();
             event->accept();
             emit aboutToShutDown();
             if (m_exitCode == EXIT_SUCCESS) {
@@ -2495,6 +2736,12 @@ void MainWindow::onProducerOpened(bool withReopen)
         setCurrentFile(m_autosaveFile->managedFileName());
     else if (!MLT.URL().isEmpty())
         setCurrentFile(MLT.URL());
+    if (!m_currentFile.isEmpty() && m_currentFile != untitledFileName()
+            && (playlist() || multitrack())) {
+        int position = Settings.projectPlayheadPosition(m_currentFile);
+        if (position > 0)
+            m_player->seek(position);
+    }
     on_actionJack_triggered(ui->actionJack && ui->actionJack->isChecked());
 }
 
@@ -2741,6 +2988,51 @@ void MainWindow::onMultitrackCreated()
     m_player->enableTab(Player::ProjectTabIndex, true);
 }
 
+void MainWindow::onMultitrackLoaded()
+{
+    if (!Settings.playerPreheatOnOpen())
+        return;
+    Mlt::Tractor* tractor = multitrack();
+    if (!tractor || !tractor->is_valid())
+        return;
+    // Pull the first frame of every timeline clip - and the first seconds of
+    // audio from the clips at the head of each track - through private
+    // producers on the task pool, so the decoders and the OS cache are warm
+    // before the first play. Bulk priority keeps the pass behind thumbnails,
+    // audio levels, and anything else the user is actually waiting on.
+    QSet<QString> queued;
+    int n = tractor->count();
+    for (int i = 0; i < n; i++) {
+        QScopedPointer<Mlt::Producer> track(tractor->track(i));
+        if (!track)
+            continue;
+        Mlt::Playlist playlist(*track);
+        int count = playlist.count();
+        for (int j = 0; j < count; j++) {
+            if (playlist.is_blank(j))
+                continue;
+            QScopedPointer<Mlt::ClipInfo> info(playlist.clip_info(j));
+            if (!info || !info->producer || !info->producer->is_valid())
+                continue;
+            if (!MLT.isFileProducer(info->producer))
+                continue;
+            QString resource = QString::fromUtf8(info->producer->get("resource"));
+            if (!qstrcmp("timewarp", info->producer->get("mlt_service")))
+                resource = QString::fromUtf8(info->producer->get("warp_resource"));
+            if (resource.isEmpty())
+                continue;
+            const QString key = resource + '#' + QString::number(info->frame_in);
+            if (queued.contains(key))
+                continue;
+            queued.insert(key);
+            int audioFrames = (j == 0 && info->start == 0)?
+                qRound(MLT.profile().fps() * kPreheatAudioSecs) : 0;
+            TaskPool::singleton().start(
+                new PreheatClipTask(resource, info->frame_in, audioFrames), TaskPool::Bulk);
+        }
+    }
+}
+
 void MainWindow::onMultitrackClosed()
 {
     setAudioChannels(Settings.playerAudioChannels());
@@ -2888,6 +3180,29 @@ bool MainWindow::saveXML(const QString &filename, bool withRelativePaths)
     return result;
 }
 
+bool MainWindow::writeProjectXML(const QString& filename)
+{
+    // The autosave snapshot: the same service selection as saveXML(), but
+    // streamed without the proxy filtering and backup handling.
+    bool result;
+    if (m_timelineDock->model()->rowCount() > 0) {
+        result = MLT.writeXml(filename, multitrack());
+    } else if (m_playlistDock->model()->rowCount() > 0) {
+        int in = MLT.producer()->get_in();
+        int out = MLT.producer()->get_out();
+        MLT.producer()->set_in_and_out(0, MLT.producer()->get_length() - 1);
+        result = MLT.writeXml(filename, playlist());
+        MLT.producer()->set_in_and_out(in, out);
+    } else if (MLT.producer()) {
+        result = MLT.writeXml(filename, (MLT.isMultitrack() || MLT.isPlaylist())? MLT.savedProducer() : 0);
+    } else {
+        // An empty playlist, which is accepted by both MLT and Shotcut.
+        Mlt::Playlist playlist(MLT.profile());
+        result = MLT.writeXml(filename, &playlist);
+    }
+    return result;
+}
+
 void MainWindow::changeTheme(const QString &theme)
 {
     LOG_DEBUG() << "begin";
@@ -3293,33 +3608,28 @@ void MainWindow::processMultipleFiles()
 {
     int count = m_multipleFiles.length();
     if (count > 1) {
-        LongUiTask longTask(tr("Open Files"));
         m_playlistDock->show();
         m_playlistDock->raise();
-        for (int i = 0; i < count; i++) {
-            QString filename = m_multipleFiles.takeFirst();
-            LOG_DEBUG() << filename;
-            longTask.reportProgress(QFileInfo(filename).fileName(), i, count);
-            Mlt::Producer p(MLT.profile(), filename.toUtf8().constData());
-            if (p.is_valid()) {
-                // Convert avformat to avformat-novalidate so that XML loads faster.
-                if (!qstrcmp(p.get("mlt_service"), "avformat")) {
-                    p.set("mlt_service", "avformat-novalidate");
-                    p.set("mute_on_pause", 0);
-                }
-                if (QDir::toNativeSeparators(filename) == QDir::toNativeSeparators(MAIN.fileName())) {
-                    MAIN.showStatusMessage(QObject::tr("You cannot add a project to itself!"));
-                    continue;
-                }
-                MLT.setImageDurationFromDefault(&p);
-                MLT.lockCreationTime(&p);
-                p.get_length_time(mlt_time_clock);
-                Util::getHash(p);
-                undoStack()->push(new Playlist::AppendCommand(*m_playlistDock->model(), MLT.XML(&p), false));
-                m_recentDock->add(filename.toUtf8().constData());
-            }
+        // Probe the files on the task pool instead of opening each producer
+        // synchronously here, which froze the UI for the whole batch.
+        // onMultipleFileStaged() appends them in order as the verdicts
+        // arrive. The staging producer uses its own profile and touches no
+        // shared state; the real open there reads from the warm OS cache.
+        const int generation = ++m_multipleFilesGeneration;
+        m_multipleFilesStatus.clear();
+        m_multipleFilesTotal = count;
+        showStatusMessage(tr("Opening %1 files").arg(count), 60 /* seconds */);
+        foreach (const QString& filename, m_multipleFiles) {
+            QtConcurrent::run(TaskPool::singleton().pool(), [=]() {
+                Mlt::Profile stagingProfile;
+                Mlt::Producer producer(stagingProfile, filename.toUtf8().constData());
+                const bool valid = producer.is_valid();
+                QMetaObject::invokeMethod(this, "onMultipleFileStaged", Qt::QueuedConnection,
+                                          Q_ARG(QString, filename), Q_ARG(bool, valid),
+                                          Q_ARG(int, generation));
+            });
         }
-        emit m_playlistDock->model()->modified();
+        return;
     }
     m_multipleFiles.clear();
     if (m_isPlaylistLoaded && Settings.playerGPU()) {
@@ -3328,6 +3638,55 @@ void MainWindow::processMultipleFiles()
     }
 }
 
+void MainWindow::onMultipleFileStaged(QString filename, bool valid, int generation)
+{
+    if (generation != m_multipleFilesGeneration) {
+        // Superseded by a newer batch (e.g. the project was closed).
+        return;
+    }
+    m_multipleFilesStatus[filename] = valid? 1 : -1;
+    // Append in the original drop order: drain the head of the list while
+    // its verdict is known, holding out-of-order results until their turn.
+    bool appended = false;
+    while (!m_multipleFiles.isEmpty() && m_multipleFilesStatus.contains(m_multipleFiles.first())) {
+        filename = m_multipleFiles.takeFirst();
+        if (m_multipleFilesStatus.value(filename) < 0) {
+            showStatusMessage(tr("Failed to open ") + filename);
+            continue;
+        }
+        LOG_DEBUG() << filename;
+        Mlt::Producer p(MLT.profile(), filename.toUtf8().constData());
+        if (p.is_valid()) {
+            // Convert avformat to avformat-novalidate so that XML loads faster.
+            if (!qstrcmp(p.get("mlt_service"), "avformat")) {
+                p.set("mlt_service", "avformat-novalidate");
+                p.set("mute_on_pause", 0);
+            }
+            if (QDir::toNativeSeparators(filename) == QDir::toNativeSeparators(MAIN.fileName())) {
+                MAIN.showStatusMessage(QObject::tr("You cannot add a project to itself!"));
+                continue;
+            }
+            MLT.setImageDurationFromDefault(&p);
+            MLT.lockCreationTime(&p);
+            p.get_length_time(mlt_time_clock);
+            Util::getHash(p);
+            undoStack()->push(new Playlist::AppendCommand(*m_playlistDock->model(), MLT.XML(&p), false));
+            m_recentDock->add(filename.toUtf8().constData());
+            appended = true;
+        }
+    }
+    if (appended)
+        emit m_playlistDock->model()->modified();
+    if (m_multipleFiles.isEmpty()) {
+        m_multipleFilesStatus.clear();
+        showStatusMessage(tr("Opened %1 files").arg(m_multipleFilesTotal));
+        if (m_isPlaylistLoaded && Settings.playerGPU()) {
+            updateThumbnails();
+            m_isPlaylistLoaded = false;
+        }
+    }
+}
+
 void MainWindow::onLanguageTriggered(QAction* action)
 {
     Settings.setLanguage(action->data().toString());
@@ -3656,17 +4015,17 @@ void MainWindow::on_actionOpenXML_triggered()
         tr("MLT XML (*.mlt);;All Files (*)"));
     if (filenames.length() > 0) {
         QString url = filenames.first();
-        MltXmlChecker checker;
-        if (checker.check(url)) {
-            if (!isCompatibleWithGpuMode(checker))
+        m_xmlChecker.reset();
+        if (m_xmlChecker.check(url)) {
+            if (!isCompatibleWithGpuMode(m_xmlChecker))
                 return;
-            isXmlRepaired(checker, url);
+            isXmlRepaired(m_xmlChecker, url);
             // Check if the locale usage differs.
             // Get current locale.
             QString localeName = QString(::setlocale(MLT_LC_CATEGORY, nullptr)).toUpper();
             // Test if it is C or POSIX.
             bool currentlyUsingLocale = (localeName != "" && localeName != "C" && localeName != "POSIX");
-            if (currentlyUsingLocale != checker.usesLocale()) {
+            if (currentlyUsingLocale != m_xmlChecker.usesLocale()) {
                 // Show a warning dialog and cancel if requested.
                 QMessageBox dialog(QMessageBox::Question,
                    qApp->applicationName(),
@@ -3727,6 +4086,12 @@ void MainWindow::on_actionScrubAudio_triggered(bool checked)
     Settings.setPlayerScrubAudio(checked);
 }
 
+void MainWindow::on_actionAudioOnlyPreview_triggered(bool checked)
+{
+    Settings.setPlayerAudioOnly(checked);
+    MLT.setVideoOff(checked);
+}
+
 #if !defined(Q_OS_MAC)
 void MainWindow::onDrawingMethodTriggered(QAction *action)
 {
@@ -3915,6 +4280,13 @@ void MainWindow::on_actionExportEDL_triggered()
     }
 }
 
+void MainWindow::on_actionExportRenderBundle_triggered()
+{
+    m_encodeDock->show();
+    m_encodeDock->raise();
+    m_encodeDock->exportRenderBundle();
+}
+
 void MainWindow::on_actionExportFrame_triggered()
 {
     if (Settings.playerGPU() || Settings.playerPreviewScale()) {
@@ -4024,15 +4396,19 @@ void MainWindow::on_actionLayoutPlayer_triggered()
 
 void MainWindow::on_actionLayoutPlaylist_triggered()
 {
+    setUpdatesEnabled(false);
     restoreState(Settings.windowStateDefault());
     m_recentDock->show();
     m_recentDock->raise();
     m_playlistDock->show();
     m_playlistDock->raise();
+    setUpdatesEnabled(true);
 }
 
 void MainWindow::on_actionLayoutTimeline_triggered()
 {
+    // Each show/raise below would otherwise trigger its own relayout.
+    setUpdatesEnabled(false);
     restoreState(Settings.windowStateDefault());
     QDockWidget* audioMeterDock = findChild<QDockWidget*>("AudioPeakMeterDock");
     if (audioMeterDock) {
@@ -4045,15 +4421,18 @@ void MainWindow::on_actionLayoutTimeline_triggered()
     m_filtersDock->raise();
     m_timelineDock->show();
     m_timelineDock->raise();
+    setUpdatesEnabled(true);
 }
 
 void MainWindow::on_actionLayoutClip_triggered()
 {
+    setUpdatesEnabled(false);
     restoreState(Settings.windowStateDefault());
     m_recentDock->show();
     m_recentDock->raise();
     m_filtersDock->show();
     m_filtersDock->raise();
+    setUpdatesEnabled(true);
 }
 
 void MainWindow::on_actionLayoutAdd_triggered()
@@ -4076,8 +4455,10 @@ void MainWindow::on_actionLayoutAdd_triggered()
 
 void MainWindow::onLayoutTriggered(QAction* action)
 {
+    setUpdatesEnabled(false);
     restoreGeometry(Settings.layoutGeometry(action->text()));
     restoreState(Settings.layoutState(action->text()));
+    setUpdatesEnabled(true);
 }
 
 void MainWindow::on_actionProfileRemove_triggered()
@@ -4381,14 +4762,14 @@ void MainWindow::on_actionUseProxy_triggered(bool checked)
 
     LOG_DEBUG() << fileName;
     if (MLT.producer() && saveXML(fileName)) {
-        MltXmlChecker checker;
+        m_xmlChecker.reset();
 
         Settings.setProxyEnabled(checked);
-        checker.check(fileName);
-        if (!isXmlRepaired(checker, fileName))
+        m_xmlChecker.check(fileName);
+        if (!isXmlRepaired(m_xmlChecker, fileName))
             return;
-        if (checker.isUpdated())
-            fileName = checker.tempFileName();
+        if (m_xmlChecker.isUpdated())
+            fileName = m_xmlChecker.tempFileName();
 
         // Open the temporary file
         if (!MLT.open(QDir::fromNativeSeparators(fileName), QDir::fromNativeSeparators(m_currentFile))) {
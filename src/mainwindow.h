@@ -61,7 +61,9 @@ public:
     bool continueJobsRunning();
     QUndoStack* undoStack() const;
     bool saveXML(const QString& filename, bool withRelativePaths = true);
+    bool writeProjectXML(const QString& filename);
     static void changeTheme(const QString& theme);
+    EncodeDock* encodeDock() const { return m_encodeDock; }
     PlaylistDock* playlistDock() const { return m_playlistDock; }
     FilterController* filterController() const { return m_filterController; }
     HtmlEditor* htmlEditor() const { return m_htmlEditor.data(); }
@@ -69,7 +71,7 @@ public:
     bool isPlaylistValid() const;
     Mlt::Producer* multitrack() const;
     bool isMultitrackValid() const;
-    void doAutosave();
+    void commitAutosave(const QString& tempName);
     void setFullScreen(bool isFullScreen);
     QString removeFileScheme(QUrl& url);
     QString untitledFileName() const;
@@ -153,14 +155,32 @@ private:
     QMenu* m_customProfileMenu;
     QMenu* m_keyerMenu;
     QStringList m_multipleFiles;
+    // Validation verdicts from the workers probing dropped files; appends
+    // happen in list order as the verdict for the head arrives.
+    QHash<QString, int> m_multipleFilesStatus;
+    int m_multipleFilesGeneration;
+    int m_multipleFilesTotal;
     bool m_isPlaylistLoaded;
     QActionGroup* m_languagesGroup;
     QScopedPointer<HtmlEditor> m_htmlEditor;
     QSharedPointer<AutoSaveFile> m_autosaveFile;
     QMutex m_autosaveMutex;
     QTimer m_autosaveTimer;
+    QTimer m_autosaveIdleTimer;
+    // Counts modifications so a timer tick with nothing new since the last
+    // snapshot skips the write entirely.
+    int m_autosaveDirtyCount;
+    int m_autosaveSavedCount;
     int m_exitCode;
     int m_navigationPosition;
+    // Staged (asynchronous) media open; the generation acts as a cancel
+    // token for results still in flight on the worker.
+    int m_openStagingGeneration;
+    bool m_openStagingActive;
+    QString m_stagedOpenUrl;
+    // One checker reused across open/save operations; reset() before each
+    // use so only its interned strings carry over.
+    MltXmlChecker m_xmlChecker;
     QScopedPointer<QAction> m_statusBarAction;
     QNetworkAccessManager m_network;
     QString m_upgradeUrl;
@@ -201,6 +221,8 @@ public slots:
     bool on_actionSave_triggered();
 
 private slots:
+    void onOpenStaged(QString url, bool valid, int generation, bool play);
+    void onMultipleFileStaged(QString filename, bool valid, int generation);
     void showUpgradePrompt();
     void on_actionAbout_Shotcut_triggered();
     void on_actionOpenOther_triggered();
@@ -221,6 +243,7 @@ private slots:
     void onPlaylistClosed();
     void onPlaylistModified();
     void onMultitrackCreated();
+    void onMultitrackLoaded();
     void onMultitrackClosed();
     void onMultitrackModified();
     void onMultitrackDurationChanged();
@@ -276,6 +299,7 @@ private slots:
     void onTimelineClipSelected();
     void onAddAllToTimeline(Mlt::Playlist* playlist);
     void on_actionScrubAudio_triggered(bool checked);
+    void on_actionAudioOnlyPreview_triggered(bool checked);
 #if !defined(Q_OS_MAC)
     void onDrawingMethodTriggered(QAction*);
 #endif
@@ -290,6 +314,7 @@ private slots:
     void on_actionPaste_triggered();
     void onClipCopied();
     void on_actionExportEDL_triggered();
+    void on_actionExportRenderBundle_triggered();
     void on_actionExportFrame_triggered();
     void onGLWidgetImageReady();
     void on_actionAppDataSet_triggered();
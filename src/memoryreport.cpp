@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memoryreport.h"
+
+#include <Logger.h>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+
+static const qint64 kLogIntervalMs = 3600000;
+
+namespace {
+
+struct ReportData
+{
+    QMutex mutex;
+    QHash<QString, std::function<MemoryReport::Usage()> > providers;
+    QHash<QString, MemoryReport::Usage> counters;
+    QElapsedTimer sinceLog;
+
+    ReportData() { sinceLog.start(); }
+
+    // Called with the mutex held.
+    void logLocked()
+    {
+        foreach (const QString& name, providers.keys()) {
+            MemoryReport::Usage usage = providers.value(name)();
+            LOG_INFO() << qPrintable(QString("memory name=%1 bytes=%2 items=%3")
+                                     .arg(name).arg(usage.bytes).arg(usage.items));
+        }
+        foreach (const QString& name, counters.keys()) {
+            const MemoryReport::Usage& usage = counters.value(name);
+            LOG_INFO() << qPrintable(QString("memory name=%1 bytes=%2 items=%3")
+                                     .arg(name).arg(usage.bytes).arg(usage.items));
+        }
+        sinceLog.restart();
+    }
+};
+
+ReportData& reportData()
+{
+    static ReportData data;
+    return data;
+}
+
+} // namespace
+
+void MemoryReport::registerProvider(const QString& name, const std::function<Usage()>& provider)
+{
+    ReportData& data = reportData();
+    QMutexLocker locker(&data.mutex);
+    data.providers.insert(name, provider);
+}
+
+void MemoryReport::unregisterProvider(const QString& name)
+{
+    ReportData& data = reportData();
+    QMutexLocker locker(&data.mutex);
+    data.providers.remove(name);
+}
+
+void MemoryReport::adjustCounter(const QString& name, qint64 deltaBytes, qint64 deltaItems)
+{
+    ReportData& data = reportData();
+    QMutexLocker locker(&data.mutex);
+    Usage& usage = data.counters[name];
+    usage.bytes += deltaBytes;
+    usage.items += deltaItems;
+    if (data.sinceLog.elapsed() >= kLogIntervalMs)
+        data.logLocked();
+}
+
+void MemoryReport::log()
+{
+    ReportData& data = reportData();
+    QMutexLocker locker(&data.mutex);
+    data.logLocked();
+}
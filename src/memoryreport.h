@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <QString>
+#include <functional>
+
+/// Central registry for per-subsystem memory attribution, so a large RSS
+/// can be blamed on a specific cache instead of guessed at. Subsystems
+/// either register a provider that reports current usage on demand, or
+/// adjust a named counter as they allocate and free. log() writes one
+/// structured line per subsystem:
+///
+///     memory name=db.thumbnails bytes=52428800 items=1312
+///
+/// and is called at shutdown and about once an hour (checked when counters
+/// move). All methods are thread-safe. bytes is -1 when a subsystem can
+/// only count items.
+class MemoryReport
+{
+public:
+    struct Usage {
+        qint64 bytes{0};
+        qint64 items{0};
+    };
+
+    /// Registers a callback queried at reporting time; it must be safe to
+    /// call from any thread and must outlive the subsystem or be
+    /// unregistered first.
+    static void registerProvider(const QString& name, const std::function<Usage()>& provider);
+    static void unregisterProvider(const QString& name);
+
+    /// Adjusts an owned counter for subsystems without a queryable size.
+    static void adjustCounter(const QString& name, qint64 deltaBytes, qint64 deltaItems);
+
+    /// Writes the current usage of every subsystem to the log.
+    static void log();
+
+private:
+    MemoryReport() {}
+};
+
+#endif // MEMORYREPORT_H
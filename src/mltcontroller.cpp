@@ -22,37 +22,75 @@
 #include <QFileInfo>
 #include <QUuid>
 #include <QTemporaryFile>
+#include <QTimer>
 #include <QXmlStreamReader>
+#include <QtConcurrent/QtConcurrent>
 #include <Logger.h>
 #include <Mlt.h>
 #include <cmath>
 #include <clocale>
+#include <utility>
 #include <unistd.h>
 
 #include "glwidget.h"
+#include "scrubaudioengine.h"
+#include "seekprefetcher.h"
 #include "settings.h"
 #include "shotcut_mlt_properties.h"
+#include "startuptracer.h"
 #include "mainwindow.h"
 #include "controllers/filtercontroller.h"
 #include "qmltypes/qmlmetadata.h"
 #include "util.h"
 #include "proxymanager.h"
+#include "keyframeindex.h"
 
 namespace Mlt {
 
 static const int kThumbnailOutSeekFactor = 5;
+// Shuttle speeds above this use trick play (strided seeks) instead of
+// producer speed, which decodes every intermediate frame.
+static const double kTrickPlaySpeedThreshold = 2.0;
+static const int kTrickPlayIntervalMs = 100;
+// Bounds for the avformat image cache used during reverse playback,
+// expressed in frames. The lower bound covers short-GOP and intra-only
+// media; the upper bound caps memory on footage with very long GOPs.
+static const int kReversePlayCacheMinFrames = 25;
+static const int kReversePlayCacheMaxFrames = 250;
+// Rough per-entry cost of the avformat producer cache used to convert the
+// cache budget into an entry count: a few decoded reference frames at
+// project resolution plus codec contexts and demuxer buffers.
+static const int kCachedFramesPerProducer = 8;
+static const qint64 kProducerOverheadBytes = 16 * 1024 * 1024;
 static Controller* instance = nullptr;
+static QFuture<void> factoryFuture;
 const QString XmlMimeType("application/vnd.mlt+xml");
 
+void Controller::prepareRepository()
+{
+    factoryFuture = QtConcurrent::run([] {
+        StartupPhase phase("MLT repository scan");
+        Mlt::Factory::init();
+    });
+}
+
 Controller::Controller()
     : m_profile(kDefaultMltProfile)
     , m_previewProfile(kDefaultMltProfile)
 {
     LOG_DEBUG() << "begin";
-    m_repo = Mlt::Factory::init();
+    {
+        StartupPhase phase("MLT repository init");
+        // Join the worker started by prepareRepository() before touching the
+        // factory; a second Factory::init simply returns the repository.
+        factoryFuture.waitForFinished();
+        m_repo = Mlt::Factory::init();
+    }
     resetLocale();
     m_filtersClipboard.reset(new Mlt::Producer(profile(), "color", "black"));
     updateAvformatCaching(0);
+    m_trickPlayTimer.setInterval(kTrickPlayIntervalMs);
+    QObject::connect(&m_trickPlayTimer, &QTimer::timeout, [this] { onTrickPlayTick(); });
     LOG_DEBUG() << "end";
 }
 
@@ -60,6 +98,7 @@ Controller& Controller::singleton(QObject *parent)
 {
     if (!instance) {
         qRegisterMetaType<Mlt::Frame>("Mlt::Frame");
+        qRegisterMetaType<Mlt::FrameHandoff>("Mlt::FrameHandoff");
         qRegisterMetaType<SharedFrame>("SharedFrame");
         instance = new GLWidget(parent);
     }
@@ -197,6 +236,8 @@ void Controller::close()
     if (isSeekableClip()) {
         setSavedProducer(m_producer.data());
     }
+    m_seekPrefetcher.reset();
+    m_scrubAudioEngine.reset();
     m_producer.reset();
 }
 
@@ -206,18 +247,23 @@ void Controller::closeConsumer()
         m_consumer->stop();
     m_consumer.reset();
     m_jackFilter.reset();
+    m_pitchFilter.reset();
+    m_pitchFilterAttached = false;
 }
 
 void Controller::play(double speed)
 {
+    stopTrickPlay();
     if (m_jackFilter) {
         if (speed == 1.0)
             m_jackFilter->fire_event("jack-start");
         else
             stopJack();
     }
+    updateReversePlayCache(speed);
     if (m_producer)
         m_producer->set_speed(speed);
+    setPitchCompensation(speed);
     if (m_consumer) {
         m_consumer->start();
         refreshConsumer(Settings.playerScrubAudio());
@@ -232,12 +278,22 @@ bool Controller::isPaused() const
 
 void Controller::pause()
 {
+    stopTrickPlay();
+    setPitchCompensation(1.0);
     if (m_producer && !isPaused()) {
         m_producer->set_speed(0);
         if (m_consumer && m_consumer->is_valid()) {
             m_producer->seek(m_consumer->position() + 1);
             m_consumer->purge();
             m_consumer->start();
+            // Preroll: decode ahead of the paused position on the shadow
+            // producer so that resuming playback finds the demuxer and page
+            // cache warm instead of paying a cold GOP decode.
+            if (!m_seekPrefetcher && isSeekableClip()
+                    && QString::fromLatin1(m_producer->get("mlt_service")).startsWith("avformat"))
+                m_seekPrefetcher.reset(new SeekPrefetcher(m_profile, resource()));
+            if (m_seekPrefetcher)
+                m_seekPrefetcher->requestPrefetch(m_consumer->position() + 1);
             // The following fixes a bug with frame-dropping. It is possible a video frame rendering
             // was just dropped. Then, Shotcut does not know the latest position. Next, a filter modifies
             // a value, which refreshes the consumer, and the position advances. If that value change
@@ -259,6 +315,8 @@ void Controller::pause()
 
 void Controller::stop()
 {
+    stopTrickPlay();
+    setPitchCompensation(1.0);
     if (m_consumer && !m_consumer->is_stopped())
         m_consumer->stop();
     if (m_producer)
@@ -382,6 +440,25 @@ bool Controller::enableJack(bool enable)
 	return true;
 }
 
+void Controller::setVideoOff(bool off)
+{
+    if (off == m_videoOff)
+        return;
+    m_videoOff = off;
+    if (m_consumer && m_consumer->is_valid()) {
+        // The consumer samples video_off when its frame thread starts, so a
+        // restart is needed for the change to take effect - same as when
+        // disabling JACK above.
+        m_consumer->set("video_off", off ? 1 : 0);
+        if (!m_consumer->is_stopped()) {
+            m_consumer->stop();
+            m_consumer->start();
+        }
+        // When paused and turning video back on, render the current frame.
+        if (!off)
+            refreshConsumer();
+    }
+}
 
 void Controller::setVolume(double volume, bool muteOnPause)
 {
@@ -419,12 +496,30 @@ void Controller::seek(int position)
         // Always pause before seeking (if not already paused).
         m_producer->set_speed(0);
         m_producer->seek(position);
+        // Warm the caches around the target for subsequent nearby seeks.
+        if (!m_seekPrefetcher && isSeekableClip()
+                && QString::fromLatin1(m_producer->get("mlt_service")).startsWith("avformat"))
+            m_seekPrefetcher.reset(new SeekPrefetcher(m_profile, resource()));
+        if (m_seekPrefetcher)
+            m_seekPrefetcher->requestPrefetch(position);
         if (m_consumer && m_consumer->is_valid()) {
             if (m_consumer->is_stopped()) {
                 m_consumer->start();
+            } else if (Settings.playerScrubAudio()) {
+                // Voice the scrubbed frame through the dedicated engine
+                // instead of restarting consumer audio per tick.
+                if (!m_scrubAudioEngine)
+                    m_scrubAudioEngine.reset(new ScrubAudioEngine(m_profile,
+                        m_consumer->get_int("frequency")? m_consumer->get_int("frequency") : 48000,
+                        m_audioChannels));
+                if (m_scrubAudioEngine->needsSource())
+                    m_scrubAudioEngine->setSource(XML());
+                m_scrubAudioEngine->scrub(position);
+                m_consumer->purge();
+                Controller::refreshConsumer(false);
             } else {
                 m_consumer->purge();
-                Controller::refreshConsumer(Settings.playerScrubAudio());
+                Controller::refreshConsumer(false);
             }
         }
     }
@@ -444,6 +539,28 @@ void Controller::refreshConsumer(bool scrubAudio)
     }
 }
 
+void Controller::invalidateScrubAudio()
+{
+    if (m_scrubAudioEngine)
+        m_scrubAudioEngine->invalidate();
+}
+
+void Controller::requestRefresh()
+{
+    // Coalesce refresh storms (e.g. dragging a filter slider): only one
+    // refresh may be pending at a time, and the consumer evaluates the
+    // pipeline state current at execution time, so the last edit wins
+    // instead of rendering every intermediate state.
+    // Pipeline edits also stale any scrub-audio snapshot.
+    invalidateScrubAudio();
+    if (m_refreshPending.exchange(true))
+        return;
+    QTimer::singleShot(20, [this]() {
+        m_refreshPending.store(false);
+        refreshConsumer();
+    });
+}
+
 bool Controller::saveXML(const QString& filename, Service* service, bool withRelativePaths, bool verify, bool proxy)
 {
     QMutexLocker locker(&m_saveXmlMutex);
@@ -548,6 +665,31 @@ bool Controller::saveXML(const QString& filename, Service* service, bool withRel
     return false;
 }
 
+// Streams XML to a file through the xml consumer with a bounded buffer -
+// no whole-document string - but without the proxy filtering, verification,
+// and backup handling of saveXML(). Used by the autosave snapshot writer.
+bool Controller::writeXml(const QString& filename, Service* service)
+{
+    QMutexLocker locker(&m_saveXmlMutex);
+    Consumer c(profile(), "xml", filename.toUtf8().constData());
+    Service s(service? service->get_service() : (m_producer && m_producer->is_valid())? m_producer->get_service() : nullptr);
+    if (!s.is_valid())
+        return false;
+    int ignore = s.get_int("ignore_points");
+    if (ignore)
+        s.set("ignore_points", 0);
+    c.set("time_format", "clock");
+    c.set("no_meta", 1);
+    c.set("store", "shotcut");
+    c.set("root", "");
+    c.set("title", QString("Shotcut version ").append(SHOTCUT_VERSION).toUtf8().constData());
+    c.connect(s);
+    c.start();
+    if (ignore)
+        s.set("ignore_points", ignore);
+    return QFile::exists(filename);
+}
+
 QString Controller::XML(Service* service, bool withProfile, bool withMetadata)
 {
     static const char* propertyName = "string";
@@ -719,7 +861,7 @@ void Controller::rewind(bool forceChangeDirection)
     // frame before last.
     if (m_producer->position() >= m_producer->get_length() - 1)
         m_producer->seek(m_producer->get_length() - 2);
-    double speed = m_producer->get_speed();
+    double speed = isTrickPlay()? m_trickPlaySpeed : m_producer->get_speed();
     if (speed == 0.0) {
         play(-1.0);
     } else {
@@ -727,9 +869,10 @@ void Controller::rewind(bool forceChangeDirection)
         if (forceChangeDirection && speed > 0.0)
             speed = -0.5;
         if (speed < 0.0)
-            m_producer->set_speed(speed * 2.0);
+            speed *= 2.0;
         else
-            m_producer->set_speed(::floor(speed * 0.5));
+            speed = ::floor(speed * 0.5);
+        setShuttleSpeed(speed);
     }
 }
 
@@ -737,7 +880,7 @@ void Controller::fastForward(bool forceChangeDirection)
 {
     if (!m_producer || !m_producer->is_valid())
         return;
-    double speed = m_producer->get_speed();
+    double speed = isTrickPlay()? m_trickPlaySpeed : m_producer->get_speed();
     if (speed == 0.0) {
         play(1.0);
     } else {
@@ -745,12 +888,142 @@ void Controller::fastForward(bool forceChangeDirection)
         if (forceChangeDirection && speed < 0.0)
             speed = 0.5;
         if (speed > 0.0)
-            m_producer->set_speed(speed * 2.0);
+            speed *= 2.0;
         else
-            m_producer->set_speed(::ceil(speed * 0.5));
+            speed = ::ceil(speed * 0.5);
+        setShuttleSpeed(speed);
+    }
+}
+
+/// Applies a shuttle speed from fastForward()/rewind(). Within 2x the
+/// producer plays at the given speed as before. Above that, long-GOP
+/// sources cannot decode every intermediate frame in time, so shuttle with
+/// strided seeks instead: each seek resolves to a keyframe-aligned decoder
+/// seek, giving smooth high-multiple shuttling like a broadcast deck.
+void Controller::setShuttleSpeed(double speed)
+{
+    if (::qAbs(speed) > kTrickPlaySpeedThreshold && isSeekable()) {
+        m_trickPlaySpeed = speed;
+        m_producer->set_speed(0);
+        if (!m_trickPlayTimer.isActive())
+            m_trickPlayTimer.start();
+    } else {
+        stopTrickPlay();
+        updateReversePlayCache(speed);
+        m_producer->set_speed(speed);
+        setPitchCompensation(speed);
+    }
+}
+
+void Controller::stopTrickPlay()
+{
+    m_trickPlayTimer.stop();
+    m_trickPlaySpeed = 0.0;
+}
+
+/// Keeps shuttle audio intelligible. Playing faster than 1x resamples the
+/// audio, shifting its pitch with the speed. For moderate speeds (up to 2x,
+/// where audio is still voiced) attach a rubberband pitch-shifter to the
+/// consumer scaled by the inverse of the speed so speech keeps its natural
+/// pitch. The DSP runs on the consumer's audio thread. At 1x, in reverse,
+/// or in trick play the filter is detached.
+void Controller::setPitchCompensation(double speed)
+{
+    if (!m_consumer || !m_consumer->is_valid())
+        return;
+    const bool wanted = speed > 0.0 && speed != 1.0 && speed <= kTrickPlaySpeedThreshold;
+    if (wanted && !m_pitchFilterUnavailable) {
+        if (!m_pitchFilter) {
+            m_pitchFilter.reset(new Mlt::Filter(profile(), "rbpitch"));
+            if (!m_pitchFilter->is_valid()) {
+                m_pitchFilter.reset();
+                m_pitchFilterUnavailable = true;
+                LOG_WARNING() << "rbpitch filter unavailable; speed changes will alter audio pitch";
+                return;
+            }
+        }
+        m_pitchFilter->set("pitchscale", 1.0 / speed);
+        if (!m_pitchFilterAttached) {
+            m_consumer->attach(*m_pitchFilter);
+            m_pitchFilterAttached = true;
+        }
+    } else if (m_pitchFilter && m_pitchFilterAttached) {
+        m_consumer->detach(*m_pitchFilter);
+        m_pitchFilterAttached = false;
     }
 }
 
+/// Makes reverse playback at moderate speeds serve whole GOPs from memory.
+/// Stepping backwards through long-GOP media decodes from the preceding
+/// keyframe for every frame served, which is what makes J-key review
+/// stutter on H.264 sources. The avformat producer keeps the frames it
+/// decoded on the way to a backward target in its image cache, so a cache
+/// spanning a GOP means each group is decoded once and then read backwards
+/// from memory. Size that cache from the file's keyframe index sidecar
+/// before the first backward frame is pulled; the producer reads the
+/// property when it builds the cache. Forward playback is unaffected.
+void Controller::updateReversePlayCache(double speed)
+{
+    if (speed >= 0.0 || !m_producer || !m_producer->is_valid() || !isSeekableClip())
+        return;
+    if (!QString::fromLatin1(m_producer->get("mlt_service")).startsWith("avformat"))
+        return;
+    int gopFrames = 0;
+    const char* hash = m_producer->get(kShotcutHashProperty);
+    if (hash && hash[0]) {
+        const QVector<double>& keyframes = KeyframeIndex::singleton().keyframes(hash);
+        double maxSpacing = 0.0;
+        for (int i = 1; i < keyframes.size(); i++)
+            maxSpacing = qMax(maxSpacing, keyframes.at(i) - keyframes.at(i - 1));
+        gopFrames = qRound(maxSpacing * profile().fps());
+    }
+    // Two GOPs so cached frames survive crossing a keyframe boundary,
+    // bounded for intra-only and unindexed files.
+    int frames = qBound(kReversePlayCacheMinFrames, 2 * gopFrames, kReversePlayCacheMaxFrames);
+    if (m_producer->get_int("cache") < frames) {
+        m_producer->set("cache", frames);
+        // The decoder lives on the parent when this is a cut.
+        Mlt::Producer parent = m_producer->parent();
+        if (parent.is_valid() && parent.get_producer() != m_producer->get_producer())
+            parent.set("cache", frames);
+    }
+}
+
+void Controller::onTrickPlayTick()
+{
+    if (!m_producer || !m_producer->is_valid() || !m_consumer || !m_consumer->is_valid()) {
+        stopTrickPlay();
+        return;
+    }
+    int stride = qRound(m_trickPlaySpeed * profile().fps() * kTrickPlayIntervalMs / 1000.0);
+    int position = m_producer->position() + stride;
+    // Long-GOP media: land each strided seek on a keyframe recorded in the
+    // file's index sidecar, so a tick resolves without a partial-GOP
+    // decode. Only snap when it still moves in the shuttle direction so a
+    // GOP longer than the stride cannot stall the shuttle.
+    if (isSeekableClip()) {
+        const char* hash = m_producer->get(kShotcutHashProperty);
+        if (hash && hash[0]) {
+            double fps = profile().fps();
+            double t = KeyframeIndex::singleton().nearestBefore(hash, position / fps);
+            if (t >= 0.0) {
+                int snapped = qRound(t * fps);
+                if (stride > 0? (snapped > m_producer->position())
+                              : (snapped < m_producer->position()))
+                    position = snapped;
+            }
+        }
+    }
+    if (position <= 0) {
+        position = 0;
+        stopTrickPlay();
+    } else if (position >= m_producer->get_length() - 1) {
+        position = m_producer->get_length() - 1;
+        stopTrickPlay();
+    }
+    seek(position);
+}
+
 void Controller::previous(int currentPosition)
 {
     if (isMultitrack()) return;
@@ -873,11 +1146,17 @@ void Controller::restart(const QString& xml)
         return;
     const char* position = m_consumer->frames_to_time(m_consumer->position());
     double speed = m_producer->get_speed();
-    QString loadXml = xml;
-    if (loadXml.isEmpty())
-        loadXml = XML();
     stop();
-    if (!setProducer(new Mlt::Producer(profile(), "xml-string", loadXml.toUtf8().constData()))) {
+    // When the service graph is unchanged - no XML given, or XML matching the
+    // current serialization - keep the live producer and its filters instead
+    // of rebuilding them from XML. The wrapper holds a reference across the
+    // close() inside setProducer(), so initialized GPU (Movit) filters are
+    // preserved and do not recompile their shaders; only the consumer is
+    // rebuilt with the new settings.
+    Mlt::Producer* producer = (xml.isEmpty() || xml == XML())
+        ? new Mlt::Producer(m_producer.data())
+        : new Mlt::Producer(profile(), "xml-string", xml.toUtf8().constData());
+    if (!setProducer(producer)) {
         if (m_producer && m_producer->is_valid())
             m_producer->seek(position);
         play(speed);
@@ -903,7 +1182,9 @@ QImage Controller::image(Mlt::Frame* frame, int width, int height)
         if (image) {
             QImage temp(width, height, QImage::Format_ARGB32);
             memcpy(temp.scanLine(0), image, size_t(width * height * 4));
-            result = temp.rgbSwapped();
+            // The rvalue overload swaps in place instead of allocating a
+            // second full-frame buffer.
+            result = std::move(temp).rgbSwapped();
         }
     } else {
         result = QImage(width, height, QImage::Format_ARGB32);
@@ -931,10 +1212,55 @@ QImage Controller::image(Producer& producer, int frameNumber, int width, int hei
     return result;
 }
 
+void Controller::setHasNetworkMedia(bool has)
+{
+    if (has != m_hasNetworkMedia) {
+        m_hasNetworkMedia = has;
+        updateAvformatCaching(m_cachingTrackCount);
+    }
+}
+
 void Controller::updateAvformatCaching(int trackCount)
 {
+    m_cachingTrackCount = trackCount;
     int i = QThread::idealThreadCount() + trackCount * 2;
-    mlt_service_cache_set_size(nullptr, "producer_avformat", qMax(4, i));
+    // On network mounts an evicted producer costs demux round trips to
+    // reopen rather than warm page-cache reads, so keep more of them
+    // alive; the memory budget below still caps the count.
+    if (m_hasNetworkMedia)
+        i *= qMax(1, Settings.playerNetworkCacheMultiple());
+    // Bound the track-derived count by a memory budget. Each cached
+    // avformat producer pins decoder state plus several reference frames
+    // at project resolution, so on a 30-track project the unbounded count
+    // can exceed physical memory. MLT's service cache already evicts
+    // least recently used, so capping the entry count is the byte budget.
+    const qint64 budgetBytes = qint64(Settings.playerCacheBudgetMB()) * 1024 * 1024;
+    const qint64 perProducerBytes = qint64(profile().width()) * profile().height() * 4
+        * kCachedFramesPerProducer + kProducerOverheadBytes;
+    const int maxEntries = qMax(4, int(budgetBytes / qMax(qint64(1), perProducerBytes)));
+    mlt_service_cache_set_size(nullptr, "producer_avformat", qBound(4, i, maxEntries));
+    applyRealTime(trackCount);
+}
+
+void Controller::applyRealTime(int trackCount)
+{
+    if (!m_consumer || !m_consumer->is_valid())
+        return;
+    int realtime = realTime(trackCount);
+    if (realtime == m_consumer->get_int("real_time"))
+        return;
+    // The worker threads are spawned at consumer start, so cycle the
+    // consumer rather than a full restart() with its XML round trip.
+    LOG_DEBUG() << "real_time" << m_consumer->get_int("real_time") << "->" << realtime;
+    bool wasStopped = m_consumer->is_stopped();
+    if (!wasStopped)
+        m_consumer->stop();
+    m_consumer->set("real_time", realtime);
+    m_consumer->purge();
+    if (!wasStopped) {
+        m_consumer->start();
+        refreshConsumer();
+    }
 }
 
 bool Controller::isAudioFilter(const QString &name)
@@ -952,20 +1278,25 @@ bool Controller::isAudioFilter(const QString &name)
     return false;
 }
 
-int Controller::realTime() const
+int Controller::realTime(int trackCount) const
 {
     int realtime = 1;
     if (!Settings.playerRealtime()) {
         if (Settings.playerGPU()) {
             return -1;
         } 
+        int threadCount = Settings.playerRenderThreads();
+        if (threadCount <= 0) {
 #if QT_POINTER_SIZE == 4
-        // Limit to 1 rendering thread on 32-bit process to reduce memory usage.
-        int threadCount = 1;
+            // Limit to 1 rendering thread on 32-bit process to reduce memory usage.
+            threadCount = 1;
 #else
-        int threadCount = QThread::idealThreadCount();
+            threadCount = QThread::idealThreadCount();
+            // Leave a core for the UI and decoders; let compositing-heavy
+            // timelines scale past the old cap of 4 up to one per track.
+            threadCount = threadCount > 2? qMin(threadCount - 1, qMax(4, trackCount)) : 1;
 #endif
-        threadCount = threadCount > 2? qMin(threadCount - 1, 4) : 1;
+        }
         realtime = -threadCount;
     }
     return realtime;
@@ -1147,6 +1478,16 @@ void Controller::adjustFilters(Producer& producer, int index)
 void Controller::setSavedProducer(Mlt::Producer* producer)
 {
     m_savedProducer.reset(new Mlt::Producer(producer));
+    m_savedProducerXml.clear();
+}
+
+QString Controller::savedProducerXml()
+{
+    // Serialize the saved producer at most once so that repeated pastes of
+    // the same clip reuse the cached XML instead of re-serializing.
+    if (m_savedProducerXml.isEmpty() && m_savedProducer && m_savedProducer->is_valid())
+        m_savedProducerXml = XML(m_savedProducer.data());
+    return m_savedProducerXml;
 }
 
 Filter* Controller::getFilter(const QString& name, Service* service)
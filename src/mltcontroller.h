@@ -23,11 +23,15 @@
 #include <QUuid>
 #include <QScopedPointer>
 #include <QMutex>
+#include <QTimer>
+#include <atomic>
 #include <Mlt.h>
 #include "transportcontrol.h"
 
 // forward declarations
 class QQuickView;
+class ScrubAudioEngine;
+class SeekPrefetcher;
 
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
 #   define MLT_LC_CATEGORY LC_NUMERIC
@@ -71,6 +75,9 @@ public:
     static Controller& singleton(QObject *parent = nullptr);
     virtual ~Controller();
     static void destroy();
+    // Starts loading the MLT plugin repository on a worker thread so the
+    // scan overlaps UI construction; the Controller constructor joins it.
+    static void prepareRepository();
 
     virtual QObject* videoWidget() = 0;
     virtual int setProducer(Mlt::Producer*, bool isMulti = false);
@@ -86,12 +93,24 @@ public:
     virtual void pause();
     void stop();
     bool enableJack(bool enable = true);
+    //! Audio-only preview: tells the consumer to skip image rendering so
+    //! only the audio graph is evaluated; the picture freezes on the last
+    //! rendered frame until the mode is turned off again.
+    void setVideoOff(bool off);
+    bool videoOff() const {
+        return m_videoOff;
+    }
     void setVolume(double volume, bool muteOnPause = true);
     double volume() const;
     void onWindowResize();
     virtual void seek(int position);
     virtual void refreshConsumer(bool scrubAudio = false);
+    void requestRefresh();
+    //! Marks any scrub-audio snapshot stale, e.g. after an edit or a
+    //! track lock change.
+    void invalidateScrubAudio();
     bool saveXML(const QString& filename, Service* service = nullptr, bool withRelativePaths = true, bool verify = true, bool proxy = false);
+    bool writeXml(const QString& filename, Service* service = nullptr);
     QString XML(Service* service = nullptr, bool withProfile = false, bool withMetadata = false);
     int consumerChanged();
     void setProfile(const QString& profile_name);
@@ -106,6 +125,9 @@ public:
     bool isFileProducer(Service* service) const;
     void rewind(bool forceChangeDirection);
     void fastForward(bool forceChangeDirection);
+    /// True while shuttling above 2x via strided, keyframe-aligned seeks
+    /// rather than producer speed (trick play).
+    bool isTrickPlay() const { return m_trickPlayTimer.isActive(); }
     void previous(int currentPosition);
     void next(int currentPosition);
     void setIn(int);
@@ -115,8 +137,14 @@ public:
     QImage image(Frame *frame, int width, int height);
     QImage image(Mlt::Producer& producer, int frameNumber, int width, int height);
     void updateAvformatCaching(int trackCount);
+    //! Tells the caching policy whether the loaded media includes files on
+    //! network mounts, where re-opening an evicted producer costs round
+    //! trips instead of page-cache hits.
+    void setHasNetworkMedia(bool has);
+    bool hasNetworkMedia() const { return m_hasNetworkMedia; }
     bool isAudioFilter(const QString& name);
-    int realTime() const;
+    int realTime(int trackCount = 0) const;
+    void applyRealTime(int trackCount);
     void setImageDurationFromDefault(Service* service) const;
     void setDurationFromDefault(Producer* service) const;
     void lockCreationTime(Producer* producer) const;
@@ -159,6 +187,7 @@ public:
         return m_savedProducer.data();
     }
     void setSavedProducer(Mlt::Producer* producer);
+    QString savedProducerXml();
     static Mlt::Filter* getFilter(const QString& name, Mlt::Service* service);
     QString projectFolder() const { return m_projectFolder; }
     void setProjectFolder(const QString& folderName);
@@ -183,12 +212,30 @@ private:
     QScopedPointer<Mlt::Filter> m_jackFilter;
     QString m_url;
     double m_volume{1.0};
+    bool m_videoOff{false};
+    bool m_hasNetworkMedia{false};
+    int m_cachingTrackCount{0};
     TransportControl m_transportControl;
     QScopedPointer<Mlt::Producer> m_savedProducer;
+    QString m_savedProducerXml;
+    QTimer m_trickPlayTimer;
+    double m_trickPlaySpeed{0.0};
+    QScopedPointer<Mlt::Filter> m_pitchFilter;
+    bool m_pitchFilterAttached{false};
+    bool m_pitchFilterUnavailable{false};
+
+    void setShuttleSpeed(double speed);
+    void stopTrickPlay();
+    void onTrickPlayTick();
+    void setPitchCompensation(double speed);
+    void updateReversePlayCache(double speed);
     QScopedPointer<Mlt::Producer> m_filtersClipboard;
     unsigned m_skipJackEvents{0};
     QString m_projectFolder;
     QMutex m_saveXmlMutex;
+    QScopedPointer<SeekPrefetcher> m_seekPrefetcher;
+    QScopedPointer<ScrubAudioEngine> m_scrubAudioEngine;
+    std::atomic_bool m_refreshPending{false};
 
     static void on_jack_started(mlt_properties owner, void* object, const mlt_position *position);
     void onJackStarted(int position);
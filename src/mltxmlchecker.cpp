@@ -43,7 +43,7 @@ static bool isMltClass(const QStringRef& name)
 static bool isNetworkResource(const QString& string)
 {
     // Check if it looks like a qualified URL. Try parsing it and see.
-    QRegExp schemaTest(QLatin1String("^[a-zA-Z]{2,}\\:.*"));
+    static const QRegExp schemaTest(QLatin1String("^[a-zA-Z]{2,}\\:.*"));
     // Not actually checking network URL due to latency and transience.
     return (schemaTest.exactMatch(string) && QUrl(string).isValid() && !string.startsWith("plain:"));
 }
@@ -67,6 +67,25 @@ MltXmlChecker::MltXmlChecker()
     m_unlinkedFilesModel.setColumnCount(ColumnCount);
 }
 
+void MltXmlChecker::reset()
+{
+    m_needsGPU = false;
+    m_needsCPU = false;
+    m_hasEffects = false;
+    m_isCorrected = false;
+    m_isUpdated = false;
+    m_usesLocale = false;
+    m_decimalPoint = '.';
+    m_numericValueChanged = false;
+    m_unlinkedFilesModel.removeRows(0, m_unlinkedFilesModel.rowCount());
+    m_properties.clear();
+    mlt_class.clear();
+    m_resource.clear();
+    m_dirListingCache.clear();
+    // m_internedNames is deliberately kept; the warm vocabulary is the
+    // point of reusing one instance across operations.
+}
+
 bool MltXmlChecker::check(const QString& fileName)
 {
     LOG_DEBUG() << "begin";
@@ -77,6 +96,12 @@ bool MltXmlChecker::check(const QString& fileName)
     if (file.open(QIODevice::ReadOnly | QIODevice::Text) && m_tempFile->open()) {
         m_tempFile->resize(0);
         m_fileInfo = QFileInfo(fileName);
+        m_fileExistsCache.clear();
+        m_resources.clear();
+        m_resourceSet.clear();
+        m_proxyDir = QDir(Settings.proxyFolder());
+        m_projectProxyDir = m_fileInfo.dir();
+        m_projectProxyDir.cd("proxies");
         m_xml.setDevice(&file);
         m_newXml.setDevice(m_tempFile.data());
         m_newXml.setAutoFormatting(true);
@@ -143,6 +168,49 @@ QString MltXmlChecker::errorString() const
     return m_xml.errorString();
 }
 
+bool MltXmlChecker::validate(const QString& fileName, QString* errorMessage)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("cannot open %1").arg(fileName);
+        return false;
+    }
+    QXmlStreamReader xml(&file);
+    bool isMlt = false;
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement)
+            continue;
+        if (!isMlt) {
+            if (xml.name() != "mlt") {
+                if (errorMessage)
+                    *errorMessage = QObject::tr("The file is not a MLT XML file.");
+                return false;
+            }
+            isMlt = true;
+        } else if (xml.name() == "property") {
+            const QString name = xml.attributes().value("name").toString();
+            if (isNumericProperty(name)) {
+                const QString value = xml.readElementText();
+                if (value.contains(QLatin1String("nan"), Qt::CaseInsensitive)
+                        || value.contains(QLatin1String("inf"), Qt::CaseInsensitive)) {
+                    if (errorMessage)
+                        *errorMessage = QObject::tr("property \"%1\" has invalid value \"%2\"")
+                            .arg(name).arg(value);
+                    return false;
+                }
+            }
+        }
+    }
+    if (xml.hasError() || !isMlt) {
+        if (errorMessage)
+            *errorMessage = xml.hasError()? xml.errorString()
+                : QObject::tr("The file is not a MLT XML file.");
+        return false;
+    }
+    return true;
+}
+
 void MltXmlChecker::setLocale()
 {
     // Returns whether this document uses a non-POSIX/-generic numeric locale.
@@ -187,7 +255,7 @@ void MltXmlChecker::readMlt()
         case QXmlStreamReader::StartElement: {
             const QString element = m_xml.name().toString();
             if (element == "property") {
-                const QString name = m_xml.attributes().value("name").toString();
+                const QString& name = internedName(m_xml.attributes().value("name").toString());
                 m_properties << MltProperty(name, m_xml.readElementText());
                 isPropertyElement = true;
             } else {
@@ -250,6 +318,7 @@ void MltXmlChecker::processProperties()
         checkGpuEffects(mlt_service);
         checkCpuEffects(mlt_service);
         checkUnlinkedFile(mlt_service);
+        collectResource(mlt_service);
         checkIncludesSelf(newProperties);
         checkLumaAlphaOver(mlt_service, newProperties);
         if (Settings.proxyEnabled())
@@ -355,7 +424,7 @@ static QString getPrefix(const QString& name, const QString& value)
 
     // Webvfx and timewarp are only using "resource".
     if (name == "resource") {
-        const QString plain("plain:");
+        static const QString plain("plain:");
         // webvfx "plain:"
         if (value.startsWith(plain)) {
             return plain;
@@ -429,7 +498,7 @@ void MltXmlChecker::checkUnlinkedFile(const QString& mlt_service)
     // not an image sequence
     if ((mlt_service != "pixbuf" && mlt_service != "qimage") || fileName.indexOf('%') == -1)
     // file does not exist
-    if (!m_resource.info.exists())
+    if (!fileExists(m_resource.info.filePath()))
     // not already in the model
     if (m_unlinkedFilesModel.findItems(filePath,
             Qt::MatchFixedString | Qt::MatchCaseSensitive).isEmpty()) {
@@ -442,6 +511,25 @@ void MltXmlChecker::checkUnlinkedFile(const QString& mlt_service)
     }
 }
 
+void MltXmlChecker::collectResource(const QString& mlt_service)
+{
+    // Remember each unique, existing local media file so the caller can warm
+    // the OS cache before the xml producer opens them one by one.
+    const QString filePath = m_resource.info.filePath();
+    if (mlt_service.isEmpty() || mlt_service == "color" || mlt_service == "colour")
+        return;
+    if (filePath.isEmpty() || isNetworkResource(filePath))
+        return;
+    if (m_resource.info.fileName().startsWith('%') || m_resource.info.fileName() == "<producer>")
+        return;
+    if (!fileExists(filePath))
+        return;
+    if (!m_resourceSet.contains(filePath)) {
+        m_resourceSet.insert(filePath);
+        m_resources << filePath;
+    }
+}
+
 bool MltXmlChecker::fixUnlinkedFile(QString& value)
 {
     // Replace unlinked files if model is populated with replacements.
@@ -534,17 +622,15 @@ void MltXmlChecker::checkForProxy(const QString& mlt_service, QVector<MltXmlChec
                 speed = p.second;
             }
         }
-        QDir proxyDir(Settings.proxyFolder());
-        QDir projectDir(QFileInfo(m_tempFile->fileName()).dir());
         QString fileName = hash + ProxyManager::videoFilenameExtension();
-        projectDir.cd("proxies");
-        if (proxyDir.exists(fileName) || projectDir.exists(fileName)) {
+        bool inProjectDir = fileExists(m_projectProxyDir.filePath(fileName));
+        if (inProjectDir || fileExists(m_proxyDir.filePath(fileName))) {
             for (auto& p : properties) {
                 if (p.first == "resource") {
-                    if (projectDir.exists(fileName)) {
-                        p.second = projectDir.filePath(fileName);
+                    if (inProjectDir) {
+                        p.second = m_projectProxyDir.filePath(fileName);
                     } else {
-                        p.second = proxyDir.filePath(fileName);
+                        p.second = m_proxyDir.filePath(fileName);
                     }
                     if (isTimewarp) {
                         p.second = QString("%1:%2").arg(speed).arg(p.second);
@@ -569,17 +655,15 @@ void MltXmlChecker::checkForProxy(const QString& mlt_service, QVector<MltXmlChec
                 hash = p.second;
             }
         }
-        QDir proxyDir(Settings.proxyFolder());
-        QDir projectDir(QFileInfo(m_tempFile->fileName()).dir());
         QString fileName = hash + ProxyManager::imageFilenameExtension();
-        projectDir.cd("proxies");
-        if (proxyDir.exists(fileName) || projectDir.exists(fileName)) {
+        bool inProjectDir = fileExists(m_projectProxyDir.filePath(fileName));
+        if (inProjectDir || fileExists(m_proxyDir.filePath(fileName))) {
             for (auto& p : properties) {
                 if (p.first == "resource") {
-                    if (projectDir.exists(fileName)) {
-                        p.second = projectDir.filePath(fileName);
+                    if (inProjectDir) {
+                        p.second = m_projectProxyDir.filePath(fileName);
                     } else {
-                        p.second = proxyDir.filePath(fileName);
+                        p.second = m_proxyDir.filePath(fileName);
                     }
                     break;
                 }
@@ -590,3 +674,52 @@ void MltXmlChecker::checkForProxy(const QString& mlt_service, QVector<MltXmlChec
         }
     }
 }
+
+const QString& MltXmlChecker::internedName(const QString& name)
+{
+    // Large projects carry thousands of <property> elements drawn from a
+    // vocabulary of a few dozen names; share one allocation per name
+    // instead of holding a fresh copy per element.
+    QHash<QString, QString>::const_iterator it = m_internedNames.constFind(name);
+    if (it == m_internedNames.constEnd())
+        it = m_internedNames.insert(name, name);
+    return it.value();
+}
+
+bool MltXmlChecker::fileExists(const QString& filePath)
+{
+    // On network shares each stat costs a round trip; memoize them since
+    // the unlinked-files scan and the proxy lookups repeat paths heavily.
+    QHash<QString, bool>::iterator it = m_fileExistsCache.find(filePath);
+    if (it == m_fileExistsCache.end()) {
+        // Most resources cluster into a few directories (the project
+        // folder and the proxy folders), so resolve existence against a
+        // directory listing fetched once per directory - one enumeration
+        // round trip covers all of its candidates.
+        QFileInfo info(filePath);
+        QString name = info.fileName();
+#if defined(Q_OS_WIN) || defined(Q_OS_MAC)
+        // Match the case-insensitive file systems the way QFile::exists does.
+        name = name.toLower();
+#endif
+        it = m_fileExistsCache.insert(filePath, dirListing(info.path()).contains(name));
+    }
+    return it.value();
+}
+
+const QSet<QString>& MltXmlChecker::dirListing(const QString& dirPath)
+{
+    QHash<QString, QSet<QString> >::iterator it = m_dirListingCache.find(dirPath);
+    if (it == m_dirListingCache.end()) {
+        QSet<QString> names;
+        foreach (QString name, QDir(dirPath).entryList(
+                QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot)) {
+#if defined(Q_OS_WIN) || defined(Q_OS_MAC)
+            name = name.toLower();
+#endif
+            names.insert(name);
+        }
+        it = m_dirListingCache.insert(dirPath, names);
+    }
+    return it.value();
+}
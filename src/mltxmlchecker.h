@@ -22,7 +22,10 @@
 #include <QXmlStreamWriter>
 #include <QTemporaryFile>
 #include <QString>
+#include <QDir>
 #include <QFileInfo>
+#include <QHash>
+#include <QSet>
 #include <QStandardItemModel>
 #include <QVector>
 #include <QPair>
@@ -44,7 +47,16 @@ public:
     };
 
     MltXmlChecker();
+    //! Clears all per-document state so one checker can be reused across
+    //! open/save operations. This is separate from check() because the
+    //! relink flow re-checks with the unlinked-files model still populated.
+    void reset();
     bool check(const QString& fileName);
+    //! Lightweight streaming validation of a saved document: well-formed
+    //! XML, an mlt root element, and no NaN/infinity in numeric property
+    //! values (the footprint of a crashed filter). Stateless and safe to
+    //! call from a worker thread, e.g. on the autosave snapshot.
+    static bool validate(const QString& fileName, QString* errorMessage = 0);
     QString errorString() const;
     bool needsGPU() const { return m_needsGPU; }
     bool needsCPU() const { return m_needsCPU; }
@@ -53,6 +65,8 @@ public:
     bool isUpdated() const { return m_isUpdated; }
     QString tempFileName() const { return m_tempFile->fileName(); }
     QStandardItemModel& unlinkedFilesModel() { return m_unlinkedFilesModel; }
+    /// The unique, existing local media files referenced by the document.
+    const QStringList& resources() const { return m_resources; }
     void setLocale();
     bool usesLocale() const { return m_usesLocale; }
 
@@ -68,12 +82,14 @@ private:
     void checkGpuEffects(const QString& mlt_service);
     void checkCpuEffects(const QString& mlt_service);
     void checkUnlinkedFile(const QString& mlt_service);
+    void collectResource(const QString& mlt_service);
     bool fixUnlinkedFile(QString& value);
     void fixStreamIndex(QString& value);
     bool fixVersion1701WindowsPathBug(QString& value);
     void checkIncludesSelf(QVector<MltProperty>& properties);
     void checkLumaAlphaOver(const QString& mlt_service, QVector<MltProperty>& properties);
     void checkForProxy(const QString& mlt_service, QVector<MltProperty>& properties);
+    bool fileExists(const QString& filePath);
 
     QXmlStreamReader m_xml;
     QXmlStreamWriter m_newXml;
@@ -87,9 +103,22 @@ private:
     QScopedPointer<QTemporaryFile> m_tempFile;
     bool m_numericValueChanged;
     QFileInfo m_fileInfo;
+    // Stat each unique path once per scan; long projects reference the
+    // same sources many times over.
+    QHash<QString, bool> m_fileExistsCache;
+    QHash<QString, QSet<QString> > m_dirListingCache;
+    const QSet<QString>& dirListing(const QString& dirPath);
+    QDir m_proxyDir;
+    QDir m_projectProxyDir;
     QStandardItemModel m_unlinkedFilesModel;
+    QStringList m_resources;
+    QSet<QString> m_resourceSet;
     QString mlt_class;
     QVector<MltProperty> m_properties;
+    // Property names come from a small, fixed vocabulary repeated across
+    // thousands of <property> elements; share one QString per name.
+    QHash<QString, QString> m_internedNames;
+    const QString& internedName(const QString& name);
     struct MltXmlResource {
         QFileInfo info;
         QString hash;
@@ -222,6 +222,10 @@ bool AttachedFiltersModel::moveRows(const QModelIndex & sourceParent, int source
             }
             int mltSrcIndex = m_mltIndexMap[sourceRow];
             int mltDstIndex = m_mltIndexMap[destinationRow];
+            // Move the filter in place - never detach/reattach, which would
+            // invalidate downstream caches and glitch a playing consumer.
+            // The service-changed listener is blocked so this single
+            // mutation does not trigger a full model reset.
             m_event->block();
             m_producer->move_filter(mltSrcIndex, mltDstIndex);
             m_event->unblock();
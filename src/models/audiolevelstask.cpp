@@ -17,45 +17,143 @@
 
 #include "audiolevelstask.h"
 #include "database.h"
+#include "memoryreport.h"
 #include "mltcontroller.h"
+#include "producercache.h"
 #include "shotcut_mlt_properties.h"
 #include "settings.h"
+#include "taskpool.h"
 #include <QString>
 #include <QVariantList>
+#include <QDir>
+#include <QFile>
 #include <QImage>
 #include <QCryptographicHash>
 #include <QRgb>
 #include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
 #include <QMutex>
 #include <QTime>
+#include <QVector>
 #include <Logger.h>
+#include <string.h>
 
 static QList<AudioLevelsTask*> tasksList;
 static QMutex tasksListMutex;
 
 static void deleteQVariantList(QVariantList* list)
 {
+    MemoryReport::adjustCounter("audio.levels",
+                                -qint64(list->size()) * sizeof(QVariant), -1);
     delete list;
 }
 
+// Binary audio peaks sidecar: a fixed header followed by one uchar level
+// per channel per frame. Written once after generation and memory-mapped
+// on load, so reopening a project renders waveforms without re-decoding
+// audio or going through the database image encoding.
+struct PeaksFileHeader
+{
+    char magic[4];      // "SCPK"
+    quint32 version;
+    quint32 channels;
+    quint32 frames;     // levels per channel; 0 records "no audio"
+};
+
+static const quint32 kPeaksFileVersion = 1;
+
+static QString peaksFilePath(const QString& key)
+{
+    QDir dir(Settings.appDataLocation());
+    const QString subdir("peaks");
+    if (!dir.exists(subdir))
+        dir.mkdir(subdir);
+    dir.cd(subdir);
+    return dir.filePath(QString(key).replace(' ', '-') + ".peaks");
+}
+
+static bool readPeaksFile(const QString& path, QVariantList& levels)
+{
+    QFile file(path);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly))
+        return false;
+    if (file.size() < (qint64)sizeof(PeaksFileHeader))
+        return false;
+    const uchar* data = file.map(0, file.size());
+    if (!data)
+        return false;
+    const PeaksFileHeader* header = (const PeaksFileHeader*)data;
+    if (memcmp(header->magic, "SCPK", 4) || header->version != kPeaksFileVersion)
+        return false;
+    qint64 n = qint64(header->channels) * header->frames;
+    if (file.size() < (qint64)sizeof(PeaksFileHeader) + n)
+        return false;
+    const uchar* p = data + sizeof(PeaksFileHeader);
+    levels.reserve(n);
+    for (qint64 i = 0; i < n; i++)
+        levels << (int)p[i];
+    return true;
+}
+
+static void writePeaksFile(const QString& path, const QVariantList& levels, int channels)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    PeaksFileHeader header;
+    memcpy(header.magic, "SCPK", 4);
+    header.version = kPeaksFileVersion;
+    header.channels = channels;
+    header.frames = levels.size() / qMax(channels, 1);
+    file.write((const char*)&header, sizeof(header));
+    QByteArray data;
+    data.reserve(levels.size());
+    foreach (const QVariant& level, levels)
+        data.append((char)(uchar)qBound(0, level.toInt(), 255));
+    file.write(data);
+}
+
+// All tasks share one profile so that pooled producers, which must not
+// outlive the profile they were created against, survive task teardown.
+static Mlt::Profile& tempProfile()
+{
+    static Mlt::Profile profile;
+    return profile;
+}
+
 AudioLevelsTask::AudioLevelsTask(Mlt::Producer& producer, QObject* object, const QModelIndex& index)
     : QRunnable()
     , m_object(object)
+    , m_tempProducer(0)
     , m_isCanceled(false)
     , m_isForce(false)
+    , m_epoch(TaskPool::singleton().currentEpoch())
 {
     m_producers << ProducerAndIndex(new Mlt::Producer(producer), index);
 }
 
 AudioLevelsTask::~AudioLevelsTask()
 {
+    if (m_tempProducer)
+        ProducerCache::singleton().release(producerKey(), m_tempProducer);
     foreach (ProducerAndIndex p, m_producers)
         delete p.first;
 }
 
-void AudioLevelsTask::start(Mlt::Producer& producer, QObject* object, const QModelIndex& index, bool force)
+bool AudioLevelsTask::isCanceled() const
+{
+    return m_isCanceled || TaskPool::singleton().isStale(m_epoch);
+}
+
+void AudioLevelsTask::start(Mlt::Producer& producer, QObject* object, const QModelIndex& index, bool force, bool interactive)
 {
     if (Settings.timelineShowWaveforms() && producer.is_valid()) {
+        // Levels span the entire resource and do not depend on in/out, so a
+        // producer that already carries them - for example on every mouse
+        // move of a trim drag - has nothing to generate or reload; the
+        // waveform just re-windows the shared list.
+        if (!force && producer.get_data(kAudioLevelsProperty))
+            return;
 
         QString serviceName = producer.get("mlt_service");
         if (DB.isShutdown()
@@ -79,7 +177,8 @@ void AudioLevelsTask::start(Mlt::Producer& producer, QObject* object, const QMod
             // Otherwise, start a new audio levels generation thread.
             task->m_isForce = force;
             tasksList << task;
-            QThreadPool::globalInstance()->start(task);
+            TaskPool::singleton().start(task,
+                interactive? TaskPool::Interactive : TaskPool::Bulk);
         }
         tasksListMutex.unlock();
     }
@@ -112,28 +211,59 @@ bool AudioLevelsTask::operator==(AudioLevelsTask &b)
 Mlt::Producer* AudioLevelsTask::tempProducer()
 {
     if (!m_tempProducer) {
-        Mlt::Producer* producer = m_producers.first().first;
-        QString service = producer->get("mlt_service");
-        if (service == "avformat-novalidate")
-            service = "avformat";
-        else if (service.startsWith("xml"))
-            service = "xml-nogl";
-        m_tempProducer.reset(new Mlt::Producer(m_profile, service.toUtf8().constData(),
-            producer->get("resource")));
-        if (m_tempProducer->is_valid()) {
-            Mlt::Filter channels(m_profile, "audiochannels");
-            Mlt::Filter converter(m_profile, "audioconvert");
-            Mlt::Filter levels(m_profile, "audiolevel");
-            m_tempProducer->attach(channels);
-            m_tempProducer->attach(converter);
-            m_tempProducer->attach(levels);
-            if (producer->get("audio_index")) {
-                m_tempProducer->pass_property(*producer, "audio_index");
-            }
-            m_tempProducer->set("video_index", -1);
+        m_tempProducer = ProducerCache::singleton().acquire(producerKey(), [this]() {
+            return createTempProducer();
+        });
+    }
+    return m_tempProducer;
+}
+
+Mlt::Producer* AudioLevelsTask::createTempProducer()
+{
+    // Each decode thread needs its own producer; MLT producers are not
+    // safe to seek and read from multiple threads at once.
+    Mlt::Producer* producer = m_producers.first().first;
+    QString service = producer->get("mlt_service");
+    if (service == "avformat-novalidate")
+        service = "avformat";
+    else if (service.startsWith("xml"))
+        service = "xml-nogl";
+    Mlt::Producer* tempProducer = new Mlt::Producer(tempProfile(),
+        service.toUtf8().constData(), producer->get("resource"));
+    if (tempProducer->is_valid()) {
+        Mlt::Filter channels(tempProfile(), "audiochannels");
+        Mlt::Filter converter(tempProfile(), "audioconvert");
+        Mlt::Filter levels(tempProfile(), "audiolevel");
+        tempProducer->attach(channels);
+        tempProducer->attach(converter);
+        tempProducer->attach(levels);
+        if (producer->get("audio_index")) {
+            tempProducer->pass_property(*producer, "audio_index");
         }
+        tempProducer->set("video_index", -1);
+    }
+    return tempProducer;
+}
+
+QString AudioLevelsTask::producerKey()
+{
+    Mlt::Producer* producer = m_producers.first().first;
+    return QString("audiolevels %1 %2")
+            .arg(QString::fromUtf8(producer->get("resource")))
+            .arg(producer->get_int("audio_index"));
+}
+
+void AudioLevelsTask::reportProgress(const QVariantList& levels)
+{
+    foreach (ProducerAndIndex p, m_producers) {
+        QVariantList* levelsCopy = new QVariantList(levels);
+        // Approximate: the levels are ints stored inline in QVariant.
+        MemoryReport::adjustCounter("audio.levels",
+                                    qint64(levelsCopy->size()) * sizeof(QVariant), 1);
+        p.first->set(kAudioLevelsProperty, levelsCopy, 0, (mlt_destructor) deleteQVariantList);
+        if (-1 != m_object->metaObject()->indexOfMethod("audioLevelsReady(QModelIndex)"))
+            QMetaObject::invokeMethod(m_object, "audioLevelsReady", Q_ARG(const QModelIndex&, p.second));
     }
-    return m_tempProducer.data();
 }
 
 QString AudioLevelsTask::cacheKey()
@@ -165,8 +295,14 @@ void AudioLevelsTask::run()
 {
     // 2 channels interleaved of uchar values
     QVariantList levels;
-    QImage image = DB.getThumbnail(cacheKey());
-    if ((image.isNull() || m_isForce) && !DB.isFailing()) {
+    const QString peaksPath = peaksFilePath(cacheKey());
+    bool cached = !m_isForce && readPeaksFile(peaksPath, levels);
+    QImage image;
+    if (!cached && !DB.isFailing()) {
+        // Fall back to levels cached in the database by older versions.
+        image = DB.getThumbnail(cacheKey());
+    }
+    if (!cached && (image.isNull() || m_isForce)) {
         const char* key[2] = { "meta.media.audio_level.0", "meta.media.audio_level.1"};
         QTime updateTime; updateTime.start();
         // TODO: use project channel count
@@ -179,67 +315,105 @@ void AudioLevelsTask::run()
             LOG_DEBUG() << "generating audio levels for" << tempProducer()->get("resource");
         }
 
-        // for each frame
+        // Split the clip into contiguous frame ranges decoded in parallel,
+        // each range with its own seekable producer. Short clips stay a
+        // single chunk so they pay no extra producer setup cost.
+        const int kMinChunkFrames = 500;
         int n = tempProducer()->get_playtime();
-        for (int i = 0; i < n && !m_isCanceled; i++) {
-            Mlt::Frame* frame = tempProducer()->get_frame();
-            if (frame && frame->is_valid() && !frame->get_int("test_audio")) {
-                mlt_audio_format format = mlt_audio_s16;
-                int frequency = 48000;
-                int samples = mlt_sample_calculator(m_producers.first().first->get_fps(), frequency, i);
-                frame->get_audio(format, frequency, channels, samples);
-                // for each channel
-                for (int channel = 0; channel < channels; channel++)
-                    // Convert real to uint for caching as image.
-                    // Scale by 0.9 because values may exceed 1.0 to indicate clipping.
-                    levels << 256 * qMin(frame->get_double(key[channel]) * 0.9, 1.0);
-            } else if (!levels.isEmpty()) {
-                for (int channel = 0; channel < channels; channel++)
-                    levels << levels.last();
+        double fps = m_producers.first().first->get_fps();
+        int chunkCount = qBound(1, n / kMinChunkFrames, QThread::idealThreadCount());
+        int chunkFrames = (n + chunkCount - 1) / qMax(chunkCount, 1);
+
+        struct Chunk {
+            int start;
+            int length;
+            QVariantList levels;
+            bool done;
+        };
+        QVector<Chunk> chunks;
+        for (int start = 0; start < n; start += chunkFrames) {
+            Chunk chunk;
+            chunk.start = start;
+            chunk.length = qMin(chunkFrames, n - start);
+            chunk.done = false;
+            chunks << chunk;
+        }
+
+        // Serializes chunk completion state and progress reports.
+        QMutex progressMutex;
+
+        // Publish the contiguous run of levels starting at frame 0 so the
+        // waveform fills in left-to-right while later ranges are still
+        // decoding. Callers must hold progressMutex.
+        auto reportPrefix = [&]() {
+            QVariantList prefix;
+            foreach (const Chunk& chunk, chunks) {
+                prefix << chunk.levels;
+                if (!chunk.done)
+                    break;
             }
-            delete frame;
-
-            // Incrementally update the audio levels every 5 seconds.
-            if (updateTime.elapsed() > 5*1000 && !m_isCanceled) {
-                updateTime.restart();
-                foreach (ProducerAndIndex p, m_producers) {
-                    QVariantList* levelsCopy = new QVariantList(levels);
-                    p.first->set(kAudioLevelsProperty, levelsCopy, 0, (mlt_destructor) deleteQVariantList);
-                    if (-1 != m_object->metaObject()->indexOfMethod("audioLevelsReady(QModelIndex)"))
-                        QMetaObject::invokeMethod(m_object, "audioLevelsReady", Q_ARG(const QModelIndex&, p.second));
-                }
+            if (!prefix.isEmpty())
+                reportProgress(prefix);
+        };
+
+        QtConcurrent::blockingMap(chunks, [&](Chunk& chunk) {
+            if (isCanceled())
+                return;
+            Mlt::Producer* producer = ProducerCache::singleton().acquire(producerKey(), [this]() {
+                return createTempProducer();
+            });
+            if (!producer->is_valid()) {
+                delete producer;
+                return;
             }
-        }
-        if (!m_isCanceled) {
-            // Put into an image for caching.
-            int count = levels.size();
-            QImage image((count + 3) / 4 / channels, channels, QImage::Format_ARGB32);
-            n = image.width() * image.height();
-            for (int i = 0; i < n; i ++) {
-                QRgb p;
-                if ((4*i + 3) < count) {
-                    p = qRgba(levels.at(4*i).toInt(), levels.at(4*i+1).toInt(), levels.at(4*i+2).toInt(), levels.at(4*i+3).toInt());
+            producer->seek(chunk.start);
+            QVariantList chunkLevels;
+            for (int i = 0; i < chunk.length && !isCanceled(); i++) {
+                Mlt::Frame* frame = producer->get_frame();
+                if (frame && frame->is_valid() && !frame->get_int("test_audio")) {
+                    mlt_audio_format format = mlt_audio_s16;
+                    int frequency = 48000;
+                    int samples = mlt_sample_calculator(fps, frequency, chunk.start + i);
+                    frame->get_audio(format, frequency, channels, samples);
+                    // for each channel
+                    for (int channel = 0; channel < channels; channel++)
+                        // Convert real to uint for caching as image.
+                        // Scale by 0.9 because values may exceed 1.0 to indicate clipping.
+                        chunkLevels << 256 * qMin(frame->get_double(key[channel]) * 0.9, 1.0);
                 } else {
-                    int last = levels.last().toInt();
-                    int r = (4*i+0) < count? levels.at(4*i+0).toInt() : last;
-                    int g = (4*i+1) < count? levels.at(4*i+1).toInt() : last;
-                    int b = (4*i+2) < count? levels.at(4*i+2).toInt() : last;
-                    int a = last;
-                    p = qRgba(r, g, b, a);
+                    // Keep every chunk exactly length * channels entries so
+                    // concatenation stays frame-aligned across chunks.
+                    for (int channel = 0; channel < channels; channel++)
+                        chunkLevels << (chunkLevels.isEmpty()? QVariant(0) : chunkLevels.last());
+                }
+                delete frame;
+
+                // Incrementally update the audio levels every 5 seconds.
+                if (updateTime.elapsed() > 5*1000 && !isCanceled()) {
+                    QMutexLocker locker(&progressMutex);
+                    if (updateTime.elapsed() > 5*1000) {
+                        updateTime.restart();
+                        chunk.levels = chunkLevels;
+                        reportPrefix();
+                    }
                 }
-                image.setPixel(i / 2, i % channels, p);
-            }
-            if (!image.isNull()) {
-                DB.putThumbnail(cacheKey(), image);
-            } else {
-                // If the produducer does not produce audio, make a special 1x1 RGBA(0,0,0,0) image,
-                // which is used to prevent QImage::isNull() from being true and continually trying
-                // to regenerate audio levels for this file.
-                QImage image(1, 1, QImage::Format_ARGB32);
-                DB.putThumbnail(cacheKey(), image);
             }
+            ProducerCache::singleton().release(producerKey(), producer);
+            QMutexLocker locker(&progressMutex);
+            chunk.levels = chunkLevels;
+            chunk.done = true;
+            if (!isCanceled())
+                reportPrefix();
+        });
+
+        if (!isCanceled()) {
+            foreach (const Chunk& chunk, chunks)
+                levels << chunk.levels;
+            // An empty sidecar records that the producer has no audio, which
+            // prevents continually trying to regenerate levels for this file.
+            writePeaksFile(peaksPath, levels, channels);
         }
-    } else if (!m_isCanceled && !image.isNull()) {
+    } else if (!cached && !isCanceled() && !image.isNull()) {
         // convert cached image
         int channels = 2;
         int n = image.width() * image.height();
@@ -250,6 +424,8 @@ void AudioLevelsTask::run()
             levels << qBlue(p);
             levels << qAlpha(p);
         }
+        // Migrate to the sidecar so the next open memory-maps it directly.
+        writePeaksFile(peaksPath, levels, channels);
     }
 
     // Remove ourself from the global list of audio tasks.
@@ -262,12 +438,10 @@ void AudioLevelsTask::run()
     }
     tasksListMutex.unlock();
 
-    if (levels.size() > 0 && !m_isCanceled) {
-        foreach (ProducerAndIndex p, m_producers) {
-            QVariantList* levelsCopy = new QVariantList(levels);
-            p.first->set(kAudioLevelsProperty, levelsCopy, 0, (mlt_destructor) deleteQVariantList);
-            if (-1 != m_object->metaObject()->indexOfMethod("audioLevelsReady(QModelIndex)"))
-                QMetaObject::invokeMethod(m_object, "audioLevelsReady", Q_ARG(const QModelIndex&, p.second));
-        }
+    // Report even when empty: an empty list on the producer records "no
+    // audio levels for this clip" so an on-demand read does not schedule
+    // another task for it every time a delegate asks.
+    if (!isCanceled()) {
+        reportProgress(levels);
     }
 }
@@ -31,7 +31,10 @@ class AudioLevelsTask : public QRunnable
 public:
     AudioLevelsTask(Mlt::Producer& producer, QObject* object, const QModelIndex& index);
     virtual ~AudioLevelsTask();
-    static void start(Mlt::Producer& producer, QObject* object, const QModelIndex& index, bool force = false);
+    //! \a interactive schedules the task ahead of bulk pool work; use it
+    //! for levels requested by an on-screen delegate rather than a batch.
+    static void start(Mlt::Producer& producer, QObject* object, const QModelIndex& index,
+                      bool force = false, bool interactive = false);
     static void closeAll();
     bool operator==(AudioLevelsTask& b);
 
@@ -40,15 +43,21 @@ protected:
 
 private:
     Mlt::Producer* tempProducer();
+    Mlt::Producer* createTempProducer();
     QString cacheKey();
+    QString producerKey();
+    void reportProgress(const QVariantList& levels);
+    //! True once closeAll() marked this task or the TaskPool epoch moved
+    //! on (project closed); checked at every decoded frame.
+    bool isCanceled() const;
 
     QObject* m_object;
     typedef QPair<Mlt::Producer*, QPersistentModelIndex> ProducerAndIndex;
     QList<ProducerAndIndex> m_producers;
-    QScopedPointer<Mlt::Producer> m_tempProducer;
+    Mlt::Producer* m_tempProducer;
     bool m_isCanceled;
     bool m_isForce;
-    Mlt::Profile m_profile;
+    int m_epoch;
 };
 
 #endif // AUDIOLEVELSTASK_H
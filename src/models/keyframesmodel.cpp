@@ -21,6 +21,7 @@
 #include "mltcontroller.h"
 
 #include <Logger.h>
+#include <algorithm>
 
 static const quintptr NO_PARENT_ID = quintptr(-1);
 
@@ -172,6 +173,7 @@ void KeyframesModel::load(QmlFilter* filter, QmlMetadata* meta)
     m_propertyNames.clear();
     m_keyframeCounts.clear();
     m_metadataIndex.clear();
+    m_keyframeFrames.clear();
     m_filter = filter;
     m_metadata = meta;
     if (m_filter && m_metadata)
@@ -181,6 +183,7 @@ void KeyframesModel::load(QmlFilter* filter, QmlMetadata* meta)
                 m_propertyNames << m_metadata->keyframes()->parameter(i)->property();
                 m_keyframeCounts << keyframeCount(m_propertyNames.count() - 1);
                 m_metadataIndex << i;
+                m_keyframeFrames << QVector<int>();
 //            LOG_DEBUG() << m_propertyNames.last() << m_filter->get(m_propertyNames.last()) << keyframeCount(i);
             }
         }
@@ -202,6 +205,8 @@ bool KeyframesModel::remove(int parameterIndex, int keyframeIndex)
                 animation.interpolate();
                 beginRemoveRows(index(parameterIndex), keyframeIndex, keyframeIndex);
                 m_keyframeCounts[parameterIndex] -= 1;
+                if (keyframeIndex < m_keyframeFrames[parameterIndex].size())
+                    m_keyframeFrames[parameterIndex].remove(keyframeIndex);
                 endRemoveRows();
                 foreach (name, m_metadata->keyframes()->parameter(m_metadataIndex[parameterIndex])->gangedProperties()) {
                     Mlt::Animation animation = m_filter->getAnimation(name);
@@ -259,17 +264,41 @@ int KeyframesModel::keyframeIndex(int parameterIndex, int currentPosition)
 {
     int result = -1;
     if (m_filter && parameterIndex < m_propertyNames.count()) {
-        QString name = m_propertyNames[parameterIndex];
-        Mlt::Animation animation = m_filter->getAnimation(name);
-        if (animation.is_valid()) {
-            for (int i = 0; i < animation.key_count() && result == -1; i++) {
-                int frame = animation.key_get_frame(i);
-                if (frame == currentPosition)
-                    result = i;
-                else if (frame > currentPosition)
-                    break;
-            }
-        }
+        // Dragging queries this on every mouse move; binary-search the
+        // cached sorted frames instead of enumerating the animation.
+        const QVector<int>& frames = keyframeFrames(parameterIndex);
+        QVector<int>::const_iterator it = std::lower_bound(
+            frames.constBegin(), frames.constEnd(), currentPosition);
+        if (it != frames.constEnd() && *it == currentPosition)
+            result = it - frames.constBegin();
+    }
+    return result;
+}
+
+int KeyframesModel::firstKeyframeIndexInRange(int parameterIndex, int startFrame)
+{
+    int result = -1;
+    if (m_filter && parameterIndex < m_propertyNames.count()) {
+        // The view asks for the keyframes under its viewport on every
+        // scroll or zoom; answer from the sorted frame cache.
+        const QVector<int>& frames = keyframeFrames(parameterIndex);
+        QVector<int>::const_iterator it = std::lower_bound(
+            frames.constBegin(), frames.constEnd(), startFrame);
+        if (it != frames.constEnd())
+            result = it - frames.constBegin();
+    }
+    return result;
+}
+
+int KeyframesModel::lastKeyframeIndexInRange(int parameterIndex, int endFrame)
+{
+    int result = -1;
+    if (m_filter && parameterIndex < m_propertyNames.count()) {
+        const QVector<int>& frames = keyframeFrames(parameterIndex);
+        QVector<int>::const_iterator it = std::upper_bound(
+            frames.constBegin(), frames.constEnd(), endFrame);
+        if (it != frames.constBegin())
+            result = it - frames.constBegin() - 1;
     }
     return result;
 }
@@ -318,6 +347,10 @@ bool KeyframesModel::setPosition(int parameterIndex, int keyframeIndex, int posi
                     if (animation.is_valid())
                         animation.key_set_frame(keyframeIndex, position);
                 }
+                // Neighbors bound the drag, so updating in place keeps
+                // the cached frames sorted.
+                if (keyframeIndex < m_keyframeFrames[parameterIndex].size())
+                    m_keyframeFrames[parameterIndex][keyframeIndex] = position;
                 QModelIndex modelIndex = index(keyframeIndex, 0, index(parameterIndex));
                 emit dataChanged(modelIndex, modelIndex, QVector<int>() << FrameNumberRole << NameRole);
                 updateNeighborsMinMax(parameterIndex, keyframeIndex);
@@ -413,6 +446,7 @@ void KeyframesModel::reload()
     m_propertyNames.clear();
     m_keyframeCounts.clear();
     m_metadataIndex.clear();
+    m_keyframeFrames.clear();
     if (m_filter)
     for (int i = 0; i < m_metadata->keyframes()->parameterCount(); i++) {
         if (!m_metadata->keyframes()->parameter(i)->isSimple() || (m_filter->animateIn() <= 0 && m_filter->animateOut() <= 0)) {
@@ -420,6 +454,7 @@ void KeyframesModel::reload()
                 m_propertyNames << m_metadata->keyframes()->parameter(i)->property();
                 m_keyframeCounts << keyframeCount(m_propertyNames.count() - 1);
                 m_metadataIndex << i;
+                m_keyframeFrames << QVector<int>();
             }
         }
     }
@@ -433,6 +468,7 @@ void KeyframesModel::onFilterChanged(const QString& property)
     if (i > -1) {
         int count = m_keyframeCounts[i];
         m_keyframeCounts[i] = keyframeCount(i);
+        m_keyframeFrames[i].clear();
         if (count > 0) {
             beginRemoveRows(index(i), 0, count - 1);
             endRemoveRows();
@@ -470,6 +506,7 @@ void KeyframesModel::onFilterInChanged(int delta)
                         ++keyframeIndex;
                     }
                 }
+                m_keyframeFrames[parameterIndex].clear();
                 QModelIndex parentIndex = index(parameterIndex);
                 emit dataChanged(index(0, 0, parentIndex), index(count - 1, 0, parentIndex), QVector<int>() << FrameNumberRole);
             }
@@ -498,6 +535,7 @@ void KeyframesModel::onFilterOutChanged(int delta)
                         ++keyframeIndex;
                     }
                 }
+                m_keyframeFrames[parameterIndex].clear();
             }
         }
     }
@@ -511,6 +549,22 @@ int KeyframesModel::keyframeCount(int index) const
         return 0;
 }
 
+const QVector<int>& KeyframesModel::keyframeFrames(int parameterIndex)
+{
+    QVector<int>& frames = m_keyframeFrames[parameterIndex];
+    Mlt::Animation animation = m_filter->getAnimation(m_propertyNames[parameterIndex]);
+    if (!animation.is_valid()) {
+        frames.clear();
+    } else if (frames.size() != animation.key_count()) {
+        // Re-enumerate this one parameter when its cache went stale
+        // through an edit that bypassed the model.
+        frames.resize(animation.key_count());
+        for (int i = 0; i < frames.size(); i++)
+            frames[i] = animation.key_get_frame(i);
+    }
+    return frames;
+}
+
 void KeyframesModel::updateNeighborsMinMax(int parameterIndex, int keyframeIndex)
 {
     QModelIndex modelIndex;
@@ -20,6 +20,7 @@
 
 #include <QAbstractItemModel>
 #include <QString>
+#include <QVector>
 #include <MltProperties.h>
 #include <MltAnimation.h>
 
@@ -67,6 +68,10 @@ public:
     int previousKeyframePosition(int parameterIndex, int currentPosition);
     int nextKeyframePosition(int parameterIndex, int currentPosition);
     Q_INVOKABLE int keyframeIndex(int parameterIndex, int currentPosition);
+    /// Index of the first keyframe at or after startFrame, or -1 if none.
+    Q_INVOKABLE int firstKeyframeIndexInRange(int parameterIndex, int startFrame);
+    /// Index of the last keyframe at or before endFrame, or -1 if none.
+    Q_INVOKABLE int lastKeyframeIndexInRange(int parameterIndex, int endFrame);
     Q_INVOKABLE int parameterIndex(const QString& propertyName) const;
     Q_INVOKABLE bool setInterpolation(int parameterIndex, int keyframeIndex, InterpolationType type);
     Q_INVOKABLE bool setPosition(int parameterIndex, int keyframeIndex, int position);
@@ -91,9 +96,14 @@ private:
     QmlFilter* m_filter;
     QList<int> m_keyframeCounts;
     QList<int> m_metadataIndex;
+    // Per-parameter keyframe frame numbers, sorted by construction, for
+    // binary-search lookups; updated in place by model edits and rebuilt
+    // lazily when an edit bypassed the model.
+    QList<QVector<int> > m_keyframeFrames;
 
     int keyframeCount(int index) const;
     void updateNeighborsMinMax(int parameterIndex, int keyframeIndex);
+    const QVector<int>& keyframeFrames(int parameterIndex);
 };
 
 #endif // KEYFRAMESMODEL_H
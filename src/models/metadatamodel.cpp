@@ -103,18 +103,30 @@ Qt::ItemFlags MetadataModel::flags(const QModelIndex &index) const
 
 void MetadataModel::add(QmlMetadata* data)
 {
+    const QString lower = data->name().toLower();
     int i = 0;
     for( i = 0; i < m_list.size(); i++ ) {
-        if (m_list[i]->name().toLower() > data->name().toLower() ) {
+        if (m_searchIndex[i] > lower) {
             break;
         }
     }
 
     beginInsertRows(QModelIndex(), i, i);
     m_list.insert(i, data);
+    m_searchIndex.insert(i, lower);
     endInsertRows();
 
     data->setParent(this);
+    // Translated names may be assigned after add(); keep the index current.
+    connect(data, SIGNAL(changed()), SLOT(onMetadataChanged()));
+}
+
+void MetadataModel::onMetadataChanged()
+{
+    QmlMetadata* meta = qobject_cast<QmlMetadata*>(sender());
+    int i = m_list.indexOf(meta);
+    if (i >= 0)
+        m_searchIndex[i] = meta->name().toLower();
 }
 
 QmlMetadata* MetadataModel::get(int index) const
@@ -137,6 +149,7 @@ void MetadataModel::setSearch(const QString& search)
 {
     beginResetModel();
     m_search = search;
+    m_searchLower = search.toLower();
     emit searchChanged();
     endResetModel();
 }
@@ -154,7 +167,9 @@ bool MetadataModel::isVisible(int row) const
         if (m_filter == AudioFilter && !meta->isAudio()) return false;
         if (m_filter == VideoFilter && meta->isAudio()) return false;
     } else {
-        if (!meta->name().contains(m_search, Qt::CaseInsensitive)) return false;
+        // Both sides are lowercased once up front, so this is a plain
+        // substring scan rather than a case-folding comparison per row.
+        if (!m_searchIndex.at(row).contains(m_searchLower)) return false;
     }
     return true;
 }
@@ -20,6 +20,7 @@
 
 #include <QAbstractListModel>
 #include <QList>
+#include <QVector>
 
 class QmlMetadata;
 
@@ -72,12 +73,21 @@ signals:
     void filterChanged();
     void searchChanged();
 
+private slots:
+    void onMetadataChanged();
+
 private:
     typedef QList<QmlMetadata*> MetadataList;
     MetadataList m_list;
     MetadataFilter m_filter;
     bool m_isClipProducer;
     QString m_search;
+    // Lowercase copy of each entry's searchable (translated) name kept
+    // parallel to m_list, plus the prepared needle, so the per-keystroke
+    // visibility pass compares ready-made strings instead of case-folding
+    // every name again for every row. Patched when a metadata changes.
+    QVector<QString> m_searchIndex;
+    QString m_searchLower;
 };
 
 #endif // METADATAMODEL_H
@@ -31,20 +31,55 @@
 #include <QApplication>
 #include <qmath.h>
 #include <QTimer>
+#include <algorithm>
+#include <limits.h>
 
 #include <Logger.h>
 
 static const quintptr NO_PARENT_ID = quintptr(-1);
 static const char* kShotcutDefaultTransition = "lumaMix";
 
+// Holds the playlist's service block for the duration of a multi-step edit
+// so the consumer cannot pull a frame between the individual mutations
+// (e.g. resize_clip followed by blank removal). Releasing in the destructor
+// keeps every early return balanced, unlike a manual block()/unblock() pair.
+class ScopedPlaylistBlock
+{
+public:
+    explicit ScopedPlaylistBlock(Mlt::Playlist& playlist)
+        : m_playlist(playlist)
+    {
+        m_playlist.block();
+    }
+    ~ScopedPlaylistBlock()
+    {
+        m_playlist.unblock();
+    }
+private:
+    Mlt::Playlist& m_playlist;
+};
+
 MultitrackModel::MultitrackModel(QObject *parent)
     : QAbstractItemModel(parent)
     , m_tractor(0)
     , m_isMakingTransition(false)
+    , m_macroEditDepth(0)
 {
     connect(this, SIGNAL(modified()), SLOT(adjustBackgroundDuration()));
     connect(this, SIGNAL(modified()), SLOT(adjustTrackFilters()));
     connect(this, SIGNAL(reloadRequested()), SLOT(reload()), Qt::QueuedConnection);
+    // Any change to the tracks or clips invalidates the clip start cache.
+    connect(this, SIGNAL(modified()), SLOT(invalidateClipStartCache()));
+    connect(this, SIGNAL(modelReset()), SLOT(invalidateClipStartCache()));
+    connect(this, SIGNAL(rowsInserted(QModelIndex,int,int)), SLOT(invalidateClipStartCache()));
+    connect(this, SIGNAL(rowsRemoved(QModelIndex,int,int)), SLOT(invalidateClipStartCache()));
+    connect(this, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)), SLOT(invalidateClipStartCache()));
+    // The data() clip memo holds MLT objects; drop it on any change.
+    connect(this, SIGNAL(modified()), SLOT(invalidateClipLookup()));
+    connect(this, SIGNAL(modelReset()), SLOT(invalidateClipLookup()));
+    connect(this, SIGNAL(rowsInserted(QModelIndex,int,int)), SLOT(invalidateClipLookup()));
+    connect(this, SIGNAL(rowsRemoved(QModelIndex,int,int)), SLOT(invalidateClipLookup()));
+    connect(this, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)), SLOT(invalidateClipLookup()));
 }
 
 MultitrackModel::~MultitrackModel()
@@ -85,13 +120,24 @@ QVariant MultitrackModel::data(const QModelIndex &index, int role) const
     if (!m_tractor || !index.isValid())
         return QVariant();
     if (index.parent().isValid()) {
-        // Get data for a clip.
-        int i = m_trackList.at(index.internalId()).mlt_index;
-        QScopedPointer<Mlt::Producer> track(m_tractor->track(i));
-        if (track) {
-            Mlt::Playlist playlist(*track);
-//            LOG_DEBUG() << __FUNCTION__ << index.row();
-            QScopedPointer<Mlt::ClipInfo> info(playlist.clip_info(index.row()));
+        // Get data for a clip, resolved through the one-entry memo (see
+        // ClipLookup) so the per-role reads of one delegate hit MLT once.
+        if (m_clipLookup.track != index.internalId()
+                || m_clipLookup.row != index.row() || !m_clipLookup.info) {
+            m_clipLookup.playlist.reset();
+            m_clipLookup.info.reset();
+            int i = m_trackList.at(index.internalId()).mlt_index;
+            QScopedPointer<Mlt::Producer> track(m_tractor->track(i));
+            if (track) {
+                m_clipLookup.playlist.reset(new Mlt::Playlist(*track));
+                m_clipLookup.info.reset(m_clipLookup.playlist->clip_info(index.row()));
+            }
+            m_clipLookup.track = index.internalId();
+            m_clipLookup.row = index.row();
+        }
+        if (m_clipLookup.playlist) {
+            Mlt::Playlist& playlist = *m_clipLookup.playlist;
+            Mlt::ClipInfo* info = m_clipLookup.info.data();
             if (info)
             switch (role) {
             case NameRole: {
@@ -139,8 +185,16 @@ QVariant MultitrackModel::data(const QModelIndex &index, int role) const
             case AudioLevelsRole:
                 if (info->producer->get_data(kAudioLevelsProperty))
                     return QVariant::fromValue(*((QVariantList*) info->producer->get_data(kAudioLevelsProperty)));
-                else
-                    return QVariant();
+                // An instantiated delegate is asking for a waveform this
+                // producer does not carry yet: load it on demand - from the
+                // peaks sidecar when cached - at interactive priority. This
+                // replaces the whole-project generation pass at load time,
+                // so projects whose timeline is not shown schedule nothing.
+                if (!playlist.is_blank(index.row())
+                        && info->producer->get_int("audio_index") > -1)
+                    AudioLevelsTask::start(*info->producer,
+                        const_cast<MultitrackModel*>(this), index, false, true);
+                return QVariant();
             case FadeInRole: {
                 QScopedPointer<Mlt::Filter> filter(getFilter("fadeInVolume", info->producer));
                 if (!filter || !filter->is_valid())
@@ -379,6 +433,8 @@ void MultitrackModel::setTrackLock(int row, bool lock)
         int i = m_trackList.at(row).mlt_index;
         QScopedPointer<Mlt::Producer> track(m_tractor->track(i));
         track->set(kTrackLockProperty, lock);
+        // The scrub-audio engine caches locked tracks as a mixdown.
+        MLT.invalidateScrubAudio();
 
         QModelIndex modelIndex = index(row, 0);
         QVector<int> roles;
@@ -436,6 +492,9 @@ int MultitrackModel::trimClipIn(int trackIndex, int clipIndex, int delta, bool r
         }
 
         Mlt::Playlist playlist(*track);
+        // Apply this track's trim steps atomically with respect to the
+        // consumer so playback never renders a half-applied edit.
+        ScopedPlaylistBlock blocker(playlist);
         QScopedPointer<Mlt::ClipInfo> info(playlist.clip_info(clipIndex));
         int filterIn = MLT.filterIn(playlist, clipIndex);
         int filterOut = MLT.filterOut(playlist, clipIndex);
@@ -510,7 +569,18 @@ void MultitrackModel::notifyClipIn(int trackIndex, int clipIndex)
         QVector<int> roles;
         roles << AudioLevelsRole;
         emit dataChanged(index, index, roles);
-        MLT.refreshConsumer();
+        // A trim-in touches the timeline from the left neighbor (a blank
+        // may have grown or shrunk there) to the end in case it rippled;
+        // frames before that are unchanged.
+        int start = 0;
+        int i = m_trackList.at(trackIndex).mlt_index;
+        QScopedPointer<Mlt::Producer> track(m_tractor->track(i));
+        if (track) {
+            Mlt::Playlist playlist(*track);
+            if (clipIndex < playlist.count())
+                start = playlist.clip_start(qMax(clipIndex - 1, 0));
+        }
+        notifyRegionChanged(start, INT_MAX);
     }
     m_isMakingTransition = false;
 }
@@ -575,6 +645,8 @@ int MultitrackModel::trimClipOut(int trackIndex, int clipIndex, int delta, bool
             continue;
 
         Mlt::Playlist playlist(*track);
+        // See trimClipIn(): block per-track so the edit lands atomically.
+        ScopedPlaylistBlock blocker(playlist);
         QScopedPointer<Mlt::ClipInfo> info(playlist.clip_info(clipIndex));
         int filterIn = MLT.filterIn(playlist, clipIndex);
         int filterOut = MLT.filterOut(playlist, clipIndex);
@@ -661,11 +733,32 @@ void MultitrackModel::notifyClipOut(int trackIndex, int clipIndex)
         QVector<int> roles;
         roles << AudioLevelsRole;
         emit dataChanged(index, index, roles);
-        MLT.refreshConsumer();
+        // A trim-out changes nothing before the trimmed clip's own start.
+        int start = 0;
+        int i = m_trackList.at(trackIndex).mlt_index;
+        QScopedPointer<Mlt::Producer> track(m_tractor->track(i));
+        if (track) {
+            Mlt::Playlist playlist(*track);
+            if (clipIndex < playlist.count())
+                start = playlist.clip_start(clipIndex);
+        }
+        notifyRegionChanged(start, INT_MAX);
     }
     m_isMakingTransition = false;
 }
 
+void MultitrackModel::notifyRegionChanged(int start, int end)
+{
+    emit regionChanged(start, end);
+    // Only the frame under the playhead is rendered; an edit elsewhere
+    // does not change it, so keep the displayed frame and the decoders'
+    // warm state instead of forcing a re-render.
+    MLT.invalidateScrubAudio();
+    int position = MLT.producer()? MLT.producer()->position() : -1;
+    if (position >= start && position < end)
+        MLT.refreshConsumer();
+}
+
 bool MultitrackModel::moveClip(int fromTrack, int toTrack, int clipIndex,
                                int position, bool ripple, bool rippleAllTracks)
 {
@@ -1098,6 +1191,8 @@ void MultitrackModel::removeClip(int trackIndex, int clipIndex, bool rippleAllTr
 
     if (track) {
         Mlt::Playlist playlist(*track);
+        // Remove, consolidate, and ripple as one atomic edit for the consumer.
+        ScopedPlaylistBlock blocker(playlist);
         if (clipIndex < playlist.count()) {
             // Shotcut does not like the behavior of remove() on a
             // transition (MLT mix clip). So, we null mlt_mix to prevent it.
@@ -1141,6 +1236,8 @@ void MultitrackModel::liftClip(int trackIndex, int clipIndex)
     QScopedPointer<Mlt::Producer> track(m_tractor->track(i));
     if (track) {
         Mlt::Playlist playlist(*track);
+        // Replace-with-blank plus consolidation is atomic for the consumer.
+        ScopedPlaylistBlock blocker(playlist);
         if (clipIndex < playlist.count()) {
             // Shotcut does not like the behavior of replace_with_blank() on a
             // transition (MLT mix clip). So, we null mlt_mix to prevent it.
@@ -3043,7 +3140,8 @@ void MultitrackModel::load()
     if (m_trackList.count() > 0) {
         beginInsertRows(QModelIndex(), 0, m_trackList.count() - 1);
         endInsertRows();
-        getAudioLevels();
+        // Audio levels are requested on demand by the AudioLevelsRole reads
+        // of instantiated delegates rather than generated for every clip here.
     }
     emit loaded();
     emit filteredChanged();
@@ -3057,7 +3155,6 @@ void MultitrackModel::reload(bool asynchronous)
         } else {
             beginResetModel();
             endResetModel();
-            getAudioLevels();
             emit filteredChanged();
         }
     }
@@ -3144,13 +3241,81 @@ void MultitrackModel::close()
 
 int MultitrackModel::clipIndex(int trackIndex, int position)
 {
-    int i = m_trackList.at(trackIndex).mlt_index;
-    QScopedPointer<Mlt::Producer> track(m_tractor->track(i));
-    if (track) {
-        Mlt::Playlist playlist(*track);
-        return playlist.get_clip_index_at(position);
+    // Hit-testing runs on every drag move. Playlist clips - blanks
+    // included - are non-overlapping and contiguous, so a binary search
+    // over the cached, sorted clip starts resolves the position without
+    // walking the playlist.
+    if (trackIndex < 0 || trackIndex >= m_trackList.size() || !m_tractor)
+        return -1; // error
+    const QVector<int>& starts = clipStarts(trackIndex);
+    if (starts.isEmpty())
+        return -1; // error
+    int count = starts.size() - 1;
+    // Out of range returns the clip count like Playlist::get_clip_index_at().
+    if (position < 0 || position >= starts.last())
+        return count;
+    return std::upper_bound(starts.constBegin(), starts.constEnd(), position)
+            - starts.constBegin() - 1;
+}
+
+const QVector<int>& MultitrackModel::clipStarts(int trackIndex)
+{
+    if (m_clipStartCache.size() != m_trackList.size())
+        m_clipStartCache.resize(m_trackList.size());
+    QVector<int>& starts = m_clipStartCache[trackIndex];
+    if (starts.isEmpty()) {
+        int i = m_trackList.at(trackIndex).mlt_index;
+        QScopedPointer<Mlt::Producer> track(m_tractor->track(i));
+        if (track) {
+            Mlt::Playlist playlist(*track);
+            int count = playlist.count();
+            starts.reserve(count + 1);
+            int total = 0;
+            for (int j = 0; j < count; j++) {
+                starts << total;
+                total += playlist.clip_length(j);
+            }
+            // Sentinel holding the playlist length bounds the last clip.
+            starts << total;
+        }
+    }
+    return starts;
+}
+
+void MultitrackModel::invalidateClipStartCache()
+{
+    m_clipStartCache.clear();
+}
+
+void MultitrackModel::invalidateClipLookup()
+{
+    m_clipLookup.track = quintptr(-1);
+    m_clipLookup.row = -1;
+    m_clipLookup.info.reset();
+    m_clipLookup.playlist.reset();
+}
+
+void MultitrackModel::beginMacroEdit()
+{
+    if (m_macroEditDepth++ == 0) {
+        // A multi-clip operation emits dataChanged/rows* per clip, and
+        // every one of them triggers a QML re-layout. Swallow the stream
+        // and notify once from endMacroEdit().
+        blockSignals(true);
+    }
+}
+
+void MultitrackModel::endMacroEdit()
+{
+    if (m_macroEditDepth <= 0)
+        return;
+    if (--m_macroEditDepth == 0) {
+        blockSignals(false);
+        // One reset replaces the suppressed signals; views rebuild once.
+        beginResetModel();
+        endResetModel();
+        emit modified();
     }
-    return -1; // error
 }
 
 void MultitrackModel::refreshTrackList()
@@ -3228,22 +3393,6 @@ void MultitrackModel::refreshTrackList()
     }
 }
 
-void MultitrackModel::getAudioLevels()
-{
-    for (int trackIx = 0; trackIx < m_trackList.size(); trackIx++) {
-        int i = m_trackList.at(trackIx).mlt_index;
-        QScopedPointer<Mlt::Producer> track(m_tractor->track(i));
-        Mlt::Playlist playlist(*track);
-        for (int clipIx = 0; clipIx < playlist.count(); clipIx++) {
-            QScopedPointer<Mlt::Producer> clip(playlist.get_clip(clipIx));
-            if (clip && clip->is_valid() && !clip->is_blank() && clip->get_int("audio_index") > -1) {
-                QModelIndex index = createIndex(clipIx, 0, trackIx);
-                AudioLevelsTask::start(clip->parent(), this, index);
-            }
-        }
-    }
-}
-
 void MultitrackModel::addBlackTrackIfNeeded()
 {
     return;
@@ -21,6 +21,8 @@
 #include <QAbstractItemModel>
 #include <QList>
 #include <QString>
+#include <QVector>
+#include <QScopedPointer>
 #include <MltTractor.h>
 #include <MltPlaylist.h>
 
@@ -98,6 +100,10 @@ public:
     void load();
     void close();
     int clipIndex(int trackIndex, int position);
+    /// Suppress the per-clip signal stream of a multi-clip operation;
+    /// views get one consolidated reset from the outermost endMacroEdit().
+    void beginMacroEdit();
+    void endMacroEdit();
     bool trimClipInValid(int trackIndex, int clipIndex, int delta, bool ripple);
     bool trimClipOutValid(int trackIndex, int clipIndex, int delta, bool ripple);
     int trackHeight() const;
@@ -127,6 +133,9 @@ signals:
     void reloadRequested();
     void inserted(int trackIndex, int clipIndex);
     void overWritten(int trackIndex, int clipIndex);
+    //! The timeline frame range [start, end) touched by an edit, so
+    //! observers can invalidate only what the edit covered.
+    void regionChanged(int start, int end);
 
 public slots:
     void refreshTrackList();
@@ -139,6 +148,10 @@ public slots:
     void notifyClipIn(int trackIndex, int clipIndex);
     int trimClipOut(int trackIndex, int clipIndex, int delta, bool ripple, bool rippleAllTracks);
     void notifyClipOut(int trackIndex, int clipIndex);
+    //! Records that an edit changed frames [start, end): emits
+    //! regionChanged() and re-renders the program frame only when the
+    //! playhead lies inside the range.
+    void notifyRegionChanged(int start, int end);
     bool moveClip(int fromTrack, int toTrack, int clipIndex, int position, bool ripple, bool rippleAllTracks);
     int overwriteClip(int trackIndex, Mlt::Producer& clip, int position, bool seek = true);
     QString overwrite(int trackIndex, Mlt::Producer& clip, int position, bool seek = true);
@@ -175,12 +188,28 @@ private:
     Mlt::Tractor* m_tractor;
     TrackList m_trackList;
     bool m_isMakingTransition;
+    int m_macroEditDepth;
+    // Per-track clip start frames, sorted by construction, for binary-search
+    // position lookups in clipIndex(); rebuilt lazily after any edit.
+    QVector<QVector<int> > m_clipStartCache;
+    // One-entry memo of the clip most recently resolved by data(). A QML
+    // delegate reads a dozen roles of one clip back to back, and each read
+    // otherwise re-acquires the track, playlist, and clip info - all
+    // touching MLT service locks that playback contends on. The model's
+    // change signals drop the memo, so the first read after an edit batch
+    // rebuilds a fresh view.
+    struct ClipLookup {
+        quintptr track {quintptr(-1)};
+        int row {-1};
+        QScopedPointer<Mlt::Playlist> playlist;
+        QScopedPointer<Mlt::ClipInfo> info;
+    };
+    mutable ClipLookup m_clipLookup;
 
     void moveClipToEnd(Mlt::Playlist& playlist, int trackIndex, int clipIndex, int position, bool ripple, bool rippleAllTracks);
     void moveClipInBlank(Mlt::Playlist& playlist, int trackIndex, int clipIndex, int position, bool ripple, bool rippleAllTracks, int duration = 0);
     void consolidateBlanks(Mlt::Playlist& playlist, int trackIndex);
     void consolidateBlanksAllTracks();
-    void getAudioLevels();
     void addBlackTrackIfNeeded();
     void convertOldDoc();
     Mlt::Transition* getTransition(const QString& name, int trackIndex) const;
@@ -194,12 +223,15 @@ private:
     bool isFiltered(Mlt::Producer* producer = 0) const;
     int getDuration();
     void adjustServiceFilterDurations(Mlt::Service& service, int duration);
+    const QVector<int>& clipStarts(int trackIndex);
 
     friend class UndoHelper;
 
 private slots:
     void adjustBackgroundDuration();
     void adjustTrackFilters();
+    void invalidateClipStartCache();
+    void invalidateClipLookup();
 };
 
 #endif // MULTITRACKMODEL_H
@@ -63,7 +63,11 @@ public:
         , m_out(out)
         , m_row(row)
         , m_force(force)
-    {}
+    {
+        // Mark at scheduling time so data() does not request the same
+        // producer again while this task is still queued.
+        m_producer.set(kThumbnailRequestedProperty, 1);
+    }
 
     ~UpdateThumbnailTask()
     {
@@ -334,6 +338,14 @@ QVariant PlaylistModel::data(const QModelIndex &index, int role) const
             }
             else {
                 image.fill(QApplication::palette().base().color().rgb());
+                // Populate on demand: only rows the view actually shows
+                // request an image, and they jump the queue ahead of any
+                // background batch so the viewport fills in first.
+                if (parent.is_valid() && !parent.get_int(kThumbnailRequestedProperty)) {
+                    QThreadPool::globalInstance()->start(
+                        new UpdateThumbnailTask(const_cast<PlaylistModel*>(this),
+                            parent, info->frame_in, info->frame_out, index.row()), 2);
+                }
             }
             return image;
         }
@@ -735,15 +747,20 @@ void PlaylistModel::showThumbnail(int row)
 
 void PlaylistModel::refreshThumbnails()
 {
-    if (m_playlist && m_playlist->is_valid()) {
+    if (m_playlist && m_playlist->is_valid() && m_playlist->count() > 0) {
+        // Drop the cached images and let data() repopulate on demand so
+        // a large bin does not flood the thread pool with a task per row.
         for (int i = 0; i < m_playlist->count(); i++) {
             Mlt::ClipInfo* info = m_playlist->clip_info(i);
             if (info && info->producer && info->producer->is_valid()) {
-                QThreadPool::globalInstance()->start(
-                    new UpdateThumbnailTask(this, *info->producer, info->frame_in, info->frame_out, i), 1);
+                info->producer->Mlt::Properties::clear(kThumbnailInProperty);
+                info->producer->Mlt::Properties::clear(kThumbnailOutProperty);
+                info->producer->Mlt::Properties::clear(kThumbnailRequestedProperty);
             }
             delete info;
         }
+        emit dataChanged(createIndex(0, 0),
+                         createIndex(m_playlist->count() - 1, columnCount() - 1));
     }
 }
 
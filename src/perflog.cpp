@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "perflog.h"
+
+#include <Logger.h>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+#include <algorithm>
+
+static const qint64 kFlushIntervalMs = 60000;
+
+namespace {
+
+struct PerfData
+{
+    QMutex mutex;
+    QHash<QString, qint64> counters;
+    QHash<QString, QVector<qint64> > spans;
+    QElapsedTimer sinceFlush;
+
+    PerfData() { sinceFlush.start(); }
+
+    // Called with the mutex held; emits and clears the aggregates.
+    void flushLocked()
+    {
+        foreach (const QString& name, counters.keys()) {
+            LOG_INFO() << qPrintable(QString("perf counter name=%1 value=%2")
+                                     .arg(name).arg(counters.value(name)));
+        }
+        counters.clear();
+        foreach (const QString& name, spans.keys()) {
+            QVector<qint64> v = spans.value(name);
+            std::sort(v.begin(), v.end());
+            LOG_INFO() << qPrintable(QString("perf span name=%1 n=%2 p50us=%3 p95us=%4 maxus=%5")
+                                     .arg(name)
+                                     .arg(v.size())
+                                     .arg(v.at(v.size() / 2))
+                                     .arg(v.at(qMin(v.size() - 1, v.size() * 95 / 100)))
+                                     .arg(v.last()));
+        }
+        spans.clear();
+        sinceFlush.restart();
+    }
+
+    void maybeFlushLocked()
+    {
+        if (sinceFlush.elapsed() >= kFlushIntervalMs)
+            flushLocked();
+    }
+};
+
+PerfData& perfData()
+{
+    static PerfData data;
+    return data;
+}
+
+} // namespace
+
+void PerfLog::count(const QString& name, qint64 delta)
+{
+    PerfData& data = perfData();
+    QMutexLocker locker(&data.mutex);
+    data.counters[name] += delta;
+    data.maybeFlushLocked();
+}
+
+void PerfLog::span(const QString& name, qint64 microseconds)
+{
+    PerfData& data = perfData();
+    QMutexLocker locker(&data.mutex);
+    data.spans[name].append(microseconds);
+    data.maybeFlushLocked();
+}
+
+void PerfLog::flush()
+{
+    PerfData& data = perfData();
+    QMutexLocker locker(&data.mutex);
+    data.flushLocked();
+}
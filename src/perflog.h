@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PERFLOG_H
+#define PERFLOG_H
+
+#include <QString>
+
+/// Lightweight structured performance event channel. Counters and duration
+/// samples are aggregated in memory and emitted through the regular log as
+/// single lines in a stable key=value format that log tooling can parse
+/// without free-text matching, e.g.:
+///
+///     perf counter name=thumbnail.db.hit value=142
+///     perf span name=player.seek.latency n=37 p50us=8123 p95us=21044 maxus=53210
+///
+/// All methods are thread-safe and cheap enough for per-frame call sites.
+/// Aggregates flush about once a minute (checked opportunistically when
+/// events are recorded) and on explicit flush() at shutdown.
+class PerfLog
+{
+public:
+    /// Adds to a monotonically increasing counter.
+    static void count(const QString& name, qint64 delta = 1);
+
+    /// Records one duration sample in microseconds.
+    static void span(const QString& name, qint64 microseconds);
+
+    /// Emits and resets all aggregates.
+    static void flush();
+
+private:
+    PerfLog() {}
+};
+
+#endif // PERFLOG_H
@@ -24,9 +24,11 @@
 #include "util.h"
 #include "widgets/newprojectfolder.h"
 #include "proxymanager.h"
+#include "qmltypes/thumbnailprovider.h"
 #include <Logger.h>
 
 #include <QtWidgets>
+#include <QtConcurrent/QtConcurrent>
 #include <limits>
 
 #define VOLUME_KNEE (88)
@@ -34,6 +36,9 @@
 #define VOLUME_SLIDER_HEIGHT (300)
 
 static const int STATUS_ANIMATION_MS = 350;
+// Upper bound on how often playback position updates are pushed to the
+// position spinner and scrub bar (~30 Hz).
+static const int POSITION_UPDATE_MS = 33;
 
 Player::Player(QWidget *parent)
     : QWidget(parent)
@@ -48,9 +53,15 @@ Player::Player(QWidget *parent)
     , m_pauseAfterOpen(false)
     , m_monitorScreen(-1)
     , m_currentTransport(nullptr)
+    , m_hoverPreviewFrame(-1)
+    , m_thumbnailProvider(nullptr)
 {
     setObjectName("Player");
     Mlt::Controller::singleton();
+    m_positionUpdateTimer.setSingleShot(true);
+    m_positionUpdateTimer.setInterval(POSITION_UPDATE_MS);
+    connect(&m_positionUpdateTimer, SIGNAL(timeout()), this, SLOT(updatePositionWidgets()));
+    m_sincePositionUpdate.start();
     setupActions(this);
     m_playIcon = actionPlay->icon();
     m_pauseIcon = actionPause->icon();
@@ -183,6 +194,12 @@ Player::Player(QWidget *parent)
     m_scrubber->setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::Preferred);
     vlayout->addWidget(m_scrubber);
 
+    // popup showing a cached thumbnail while hovering the scrub bar
+    m_hoverPreviewLabel = new QLabel(this, Qt::ToolTip | Qt::FramelessWindowHint);
+    m_hoverPreviewLabel->setAttribute(Qt::WA_ShowWithoutActivating);
+    m_hoverPreviewLabel->setFrameShape(QFrame::Box);
+    m_hoverPreviewLabel->hide();
+
     // Add toolbar for transport controls.
     QToolBar* toolbar = new QToolBar(tr("Transport Controls"), this);
     int s = style()->pixelMetric(QStyle::PM_SmallIconSize);
@@ -330,6 +347,9 @@ Player::Player(QWidget *parent)
     connect(m_scrubber, SIGNAL(seeked(int)), this, SLOT(seek(int)));
     connect(m_scrubber, SIGNAL(inChanged(int)), this, SLOT(onInChanged(int)));
     connect(m_scrubber, SIGNAL(outChanged(int)), this, SLOT(onOutChanged(int)));
+    connect(m_scrubber, SIGNAL(hovered(int,QPoint)), this, SLOT(onScrubHovered(int,QPoint)));
+    connect(m_scrubber, SIGNAL(hoverEnded()), this, SLOT(onScrubHoverEnded()));
+    connect(&m_hoverPreviewWatcher, SIGNAL(finished()), this, SLOT(onHoverPreviewFinished()));
     connect(m_positionSpinner, SIGNAL(valueChanged(int)), this, SLOT(seek(int)));
     connect(m_positionSpinner, SIGNAL(editingFinished()), this, SLOT(setFocus()));
     connect(this, SIGNAL(endOfStream()), this, SLOT(pause()));
@@ -572,6 +592,7 @@ void Player::onProducerOpened(bool play)
     m_videoWidget->show();
     m_duration = MLT.producer()->get_length();
     m_isSeekable = MLT.isSeekable();
+    onScrubHoverEnded();
     MLT.producer()->set("ignore_points", 1);
     m_scrubber->setFramerate(MLT.profile().fps());
     m_scrubber->setScale(m_duration);
@@ -689,10 +710,16 @@ void Player::onFrameDisplayed(const SharedFrame& frame)
     int position = frame.get_position();
     if (position < m_duration) {
         m_position = position;
-        m_positionSpinner->blockSignals(true);
-        m_positionSpinner->setValue(position);
-        m_positionSpinner->blockSignals(false);
-        m_scrubber->onSeek(position);
+        // Updating the spinner and scrub bar per displayed frame floods the
+        // event loop during high frame rate playback and delays input
+        // events, so coalesce the widget updates to ~30 Hz. Frames arriving
+        // slower than that (paused seeking) still update immediately.
+        if (!m_positionUpdateTimer.isActive()) {
+            if (m_sincePositionUpdate.hasExpired(POSITION_UPDATE_MS))
+                updatePositionWidgets();
+            else
+                m_positionUpdateTimer.start();
+        }
         if (m_playPosition < m_previousOut && m_position >= m_previousOut) {
             seek(m_previousOut);
         }
@@ -701,6 +728,76 @@ void Player::onFrameDisplayed(const SharedFrame& frame)
         emit endOfStream();
 }
 
+void Player::updatePositionWidgets()
+{
+    m_sincePositionUpdate.restart();
+    m_positionSpinner->blockSignals(true);
+    m_positionSpinner->setValue(m_position);
+    m_positionSpinner->blockSignals(false);
+    m_scrubber->onSeek(m_position);
+}
+
+/// Hover previews ride the shared thumbnail caches (ThumbnailProvider plus
+/// the database cache) so browsing the scrub bar never issues a seek through
+/// the playback pipeline. Positions are quantized to whole seconds to
+/// maximize cache hits and bound the distinct thumbnails per clip.
+void Player::onScrubHovered(int position, QPoint globalPos)
+{
+    if (!MLT.isSeekableClip() || !MLT.producer() || m_duration < 2)
+        return;
+    const int step = qMax(qRound(MLT.profile().fps()), 1);
+    const int frame = qBound(0, position - position % step, m_duration - 1);
+
+    // Track the mouse even when the quantized frame is unchanged.
+    m_hoverPreviewLabel->move(globalPos.x() - m_hoverPreviewLabel->width() / 2,
+        m_scrubber->mapToGlobal(QPoint(0, 0)).y() - m_hoverPreviewLabel->height() - 2);
+    if (frame == m_hoverPreviewFrame)
+        return;
+    const int direction = (m_hoverPreviewFrame >= 0 && frame < m_hoverPreviewFrame)? -1 : 1;
+    m_hoverPreviewFrame = frame;
+
+    if (!m_thumbnailProvider)
+        m_thumbnailProvider = new ThumbnailProvider;
+    ThumbnailProvider* provider = m_thumbnailProvider;
+    const QString idTemplate = QString("%1/%2/%3#%4")
+            .arg(Util::getHash(*MLT.producer()))
+            .arg(QString::fromUtf8(MLT.producer()->get("mlt_service")))
+            .arg(QString::fromUtf8(MLT.producer()->get("resource")));
+    const QString id = idTemplate.arg(frame);
+    m_hoverPreviewWatcher.setFuture(QtConcurrent::run([provider, id] {
+        QSize size;
+        return provider->requestImage(id, &size, QSize());
+    }));
+
+    // Warm the next step in the hover direction while this one displays.
+    const int nextFrame = frame + direction * step;
+    if (nextFrame >= 0 && nextFrame < m_duration) {
+        const QString nextId = idTemplate.arg(nextFrame);
+        QtConcurrent::run([provider, nextId] {
+            QSize size;
+            provider->requestImage(nextId, &size, QSize());
+        });
+    }
+}
+
+void Player::onScrubHoverEnded()
+{
+    m_hoverPreviewFrame = -1;
+    m_hoverPreviewLabel->hide();
+}
+
+void Player::onHoverPreviewFinished()
+{
+    const QImage image = m_hoverPreviewWatcher.result();
+    // Ignore failed renders and results arriving after the hover ended.
+    if (image.width() < 2 || m_hoverPreviewFrame < 0)
+        return;
+    m_hoverPreviewLabel->setPixmap(QPixmap::fromImage(image));
+    m_hoverPreviewLabel->adjustSize();
+    if (!m_hoverPreviewLabel->isVisible())
+        m_hoverPreviewLabel->show();
+}
+
 void Player::updateSelection()
 {
     if (MLT.producer() && MLT.producer()->get_in() > 0) {
@@ -22,9 +22,13 @@
 #include <QIcon>
 #include <QSize>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QImage>
 #include "sharedframe.h"
 
 class ScrubBar;
+class ThumbnailProvider;
 class QSpinBox;
 class QLabel;
 class TimeSpinBox;
@@ -168,9 +172,21 @@ private:
     QTimer m_statusTimer;
     QMenu* m_zoomMenu;
     NewProjectFolder* m_projectWidget;
+    // Coalesces per-frame position updates to the widgets; see onFrameDisplayed().
+    QTimer m_positionUpdateTimer;
+    QElapsedTimer m_sincePositionUpdate;
+    // Hover preview over the scrub bar; see onScrubHovered().
+    QLabel* m_hoverPreviewLabel;
+    int m_hoverPreviewFrame;
+    QFutureWatcher<QImage> m_hoverPreviewWatcher;
+    ThumbnailProvider* m_thumbnailProvider;
 
 private slots:
     void updateSelection();
+    void updatePositionWidgets();
+    void onScrubHovered(int position, QPoint globalPos);
+    void onScrubHoverEnded();
+    void onHoverPreviewFinished();
     void onInChanged(int in);
     void onOutChanged(int out);
     void on_actionSkipNext_triggered();
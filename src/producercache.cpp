@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "producercache.h"
+#include "memoryreport.h"
+
+// Each cached avformat producer holds a demuxer and decoder open, so
+// keep the pool small; it only needs to cover the clips being actively
+// thumbnailed or waveformed.
+static const int kMaxCachedProducers = 12;
+
+ProducerCache::ProducerCache()
+{
+    // Producer memory is owned by FFmpeg and not measurable from here,
+    // so only the entry count is attributed.
+    MemoryReport::registerProvider("producer.cache", [] {
+        MemoryReport::Usage usage;
+        usage.bytes = -1;
+        usage.items = ProducerCache::singleton().count();
+        return usage;
+    });
+}
+
+ProducerCache& ProducerCache::singleton()
+{
+    static ProducerCache instance;
+    return instance;
+}
+
+int ProducerCache::count()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+Mlt::Producer* ProducerCache::acquire(const QString& key, const std::function<Mlt::Producer*()>& create)
+{
+    m_mutex.lock();
+    for (int i = 0; i < m_entries.size(); i++) {
+        if (m_entries[i].key == key) {
+            Mlt::Producer* producer = m_entries[i].producer;
+            m_entries.removeAt(i);
+            m_mutex.unlock();
+            return producer;
+        }
+    }
+    m_mutex.unlock();
+    return create();
+}
+
+void ProducerCache::release(const QString& key, Mlt::Producer* producer)
+{
+    if (!producer)
+        return;
+    if (!producer->is_valid()) {
+        delete producer;
+        return;
+    }
+    m_mutex.lock();
+    Entry entry;
+    entry.key = key;
+    entry.producer = producer;
+    m_entries.prepend(entry);
+    while (m_entries.size() > kMaxCachedProducers) {
+        delete m_entries.last().producer;
+        m_entries.removeLast();
+    }
+    m_mutex.unlock();
+}
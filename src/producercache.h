@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRODUCERCACHE_H
+#define PRODUCERCACHE_H
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <MltProducer.h>
+#include <functional>
+
+/*!
+  \class ProducerCache
+  \brief A keyed pool of opened Mlt::Producer handles.
+
+  \threadsafe
+
+  Opening an avformat producer pays a full demuxer probe, which is
+  expensive on network storage. ProducerCache keeps recently released
+  producers keyed by their purpose and source so repeated requests for
+  the same clip (e.g. ten thumbnails while scrolling) reuse one opened
+  handle and just seek.
+
+  A producer is handed out exclusively: acquire() removes it from the
+  pool, so it may safely be used from the calling thread until it is
+  returned with release(). The caller's create function runs only on a
+  pool miss and is responsible for all one-time configuration (filters,
+  indices), since a pooled handle is returned as-is on the next acquire.
+
+  The profile a cached producer was created against must outlive the
+  pool entry, so callers must construct producers with an application
+  lifetime profile.
+*/
+class ProducerCache
+{
+public:
+    static ProducerCache& singleton();
+
+    /*!
+      Returns a producer for \a key, taking it from the pool or calling
+      \a create on a miss. The caller owns the result until release().
+    */
+    Mlt::Producer* acquire(const QString& key, const std::function<Mlt::Producer*()>& create);
+
+    /*!
+      Returns \a producer to the pool under \a key for reuse. Invalid
+      producers are deleted, and the least recently released entry is
+      evicted when the pool is full.
+    */
+    void release(const QString& key, Mlt::Producer* producer);
+
+    /// Number of producers currently pooled.
+    int count();
+
+private:
+    ProducerCache();
+
+    struct Entry {
+        QString key;
+        Mlt::Producer* producer;
+    };
+    QList<Entry> m_entries; // most recently released first
+    QMutex m_mutex;
+};
+
+#endif // PRODUCERCACHE_H
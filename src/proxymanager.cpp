@@ -16,6 +16,9 @@
  */
 
 #include "proxymanager.h"
+#include "database.h"
+#include "docks/encodedock.h"
+#include "mainwindow.h"
 #include "mltcontroller.h"
 #include "settings.h"
 #include "shotcut_mlt_properties.h"
@@ -24,8 +27,14 @@
 #include "jobs/meltjob.h"
 #include "util.h"
 
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QMutex>
 #include <QObject>
+#include <QSet>
+#include <QTextStream>
 #include <QVector>
+#include <QtConcurrent/QtConcurrent>
 #include <QTemporaryFile>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
@@ -35,15 +44,134 @@ static const char* kProxyVideoExtension = ".mp4";
 static const char* kProxyPendingVideoExtension = ".pending.mp4";
 static const char* kProxyImageExtension = ".jpg";
 static const char* kProxyPendingImageExtension = ".pending.jpg";
+static const char* kProxySourceExtension = ".source";
 static const float kProxyResolutionRatio = 1.3f;
 static const int   kFallbackProxyResolution = 540;
 
+// Caches the proxy directory listings so that the per-clip existence checks
+// do not stat the (possibly network-mounted) proxy folders over and over.
+// A QFileSystemWatcher invalidates a cached listing when its directory
+// changes, e.g. when a proxy job finishes or a pending file is renamed.
+class ProxyDirListingCache
+{
+public:
+    static ProxyDirListingCache& singleton()
+    {
+        static ProxyDirListingCache instance;
+        return instance;
+    }
+
+    bool contains(const QString& dirPath, const QString& fileName)
+    {
+        QMutexLocker locker(&m_mutex);
+        QHash<QString, QSet<QString> >::const_iterator it = m_listings.constFind(dirPath);
+        if (it == m_listings.constEnd()) {
+            QDir dir(dirPath);
+            if (!dir.exists())
+                return false;
+            if (!m_watched.contains(dirPath)) {
+                if (!m_watcher.addPath(dirPath)) {
+                    // Unwatchable (e.g. some network mounts): fall back to a direct stat.
+                    return dir.exists(fileName);
+                }
+                m_watched.insert(dirPath);
+            }
+            QSet<QString> names;
+            foreach (const QString& entry, dir.entryList(QDir::Files | QDir::Hidden))
+                names.insert(entry);
+            it = m_listings.insert(dirPath, names);
+        }
+        return it.value().contains(fileName);
+    }
+
+private:
+    ProxyDirListingCache()
+    {
+        QObject::connect(&m_watcher, &QFileSystemWatcher::directoryChanged, [this](const QString& path) {
+            QMutexLocker locker(&m_mutex);
+            m_listings.remove(path);
+        });
+    }
+
+    QFileSystemWatcher m_watcher;
+    QMutex m_mutex;
+    QHash<QString, QSet<QString> > m_listings;
+    QSet<QString> m_watched;
+};
+
 static bool isValidImage(Mlt::Producer& producer)
 {
     QString service = QString::fromLatin1(producer.get("mlt_service"));
     return (service == "qimage" || service == "pixbuf") && !producer.get_int(kShotcutSequenceProperty);
 }
 
+// Each proxy has a sidecar manifest recording the size and modified time
+// of the source it was generated from. When a source file is replaced in
+// place - a re-ingested camera card, a re-rendered graphic - the stored
+// shotcut:hash in the project would otherwise keep mapping it to the old
+// proxy forever.
+static void writeSourceManifest(const QString& hash, const QString& resource)
+{
+    QFileInfo info(resource);
+    QFile file(ProxyManager::dir().filePath(hash + kProxySourceExtension));
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream stream(&file);
+        stream << info.size() << ' ' << info.lastModified().toMSecsSinceEpoch()
+               << ' ' << info.filePath() << '\n';
+        file.close();
+    }
+}
+
+static QString sourceManifestPath(const QString& hash)
+{
+    QString fileName = hash + kProxySourceExtension;
+    QDir projectDir(MLT.projectFolder());
+    if (projectDir.cd("proxies") && projectDir.exists(fileName))
+        return projectDir.filePath(fileName);
+    QDir proxyDir(Settings.proxyFolder());
+    if (proxyDir.exists(fileName))
+        return proxyDir.filePath(fileName);
+    return QString();
+}
+
+// If the source file changed since its proxy was generated, replace the
+// producer's recorded hash with the file's current content hash so the
+// stale proxy is no longer matched and a fresh one generates. A file that
+// was merely touched (same content, new mtime) keeps its proxy, and the
+// manifest is refreshed so the next check is a pair of stats again.
+static void verifySourceCurrent(Mlt::Producer& producer)
+{
+    QString hash = QString::fromLatin1(producer.get(kShotcutHashProperty));
+    if (hash.isEmpty())
+        return;
+    QString resource = ProxyManager::resource(producer);
+    QFileInfo info(resource);
+    if (!info.isFile())
+        return;
+    QString manifestPath = sourceManifestPath(hash);
+    if (manifestPath.isEmpty())
+        return; // proxy predates manifests; trust the recorded hash
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+    QTextStream stream(&file);
+    qint64 size = 0;
+    qint64 modified = 0;
+    stream >> size >> modified;
+    file.close();
+    if (size == info.size() && modified == info.lastModified().toMSecsSinceEpoch())
+        return;
+    QString newHash = Util::getFileHash(resource);
+    if (newHash.isEmpty())
+        return;
+    if (newHash == hash) {
+        writeSourceManifest(hash, resource);
+    } else {
+        LOG_INFO() << "source file changed, regenerating proxy for" << resource;
+        producer.set(kShotcutHashProperty, newHash.toLatin1().constData());
+    }
+}
+
 QDir ProxyManager::dir()
 {
     // Use project folder + "/proxies" if using project folder and enabled
@@ -83,11 +211,20 @@ void ProxyManager::generateVideoProxy(Mlt::Producer& producer, bool fullRange, S
     auto hwCodecs = Settings.encodeHardware();
     QString hwFilters;
 
+    // The setting may be enabled without the one-time encoder detection
+    // having run; reuse the export panel's probing before falling back to
+    // software encoding.
+    if (Settings.proxyUseHardware() && hwCodecs.isEmpty()) {
+        if (MAIN.encodeDock()->detectHardwareEncoders())
+            hwCodecs = Settings.encodeHardware();
+    }
+
     // Touch file to make it in progress
     QFile file(fileName);
     file.open(QIODevice::WriteOnly);
     file.resize(0);
     file.close();
+    writeSourceManifest(hash, resource);
 
     args << "-loglevel" << "verbose";
     args << "-i" << resource;
@@ -189,8 +326,34 @@ void ProxyManager::generateVideoProxy(Mlt::Producer& producer, bool fullRange, S
     args << "-g" << "1" << "-bf" << "0";
     args << "-y" << fileName;
 
+    // Fingerprint the command line minus the input and output paths so the
+    // same settings on the same content match across project folders.
+    QStringList fingerprint = args;
+    fingerprint.removeAll(resource);
+    fingerprint.removeAll(fileName);
+    const QString parameters = fingerprint.join(' ');
+    const QString finalName = dir().filePath(hash + kProxyVideoExtension);
+
+    // The job history may know an identical proxy made earlier, possibly
+    // under another project's folder; copy it instead of transcoding again.
+    const QString previous = DB.getJobRecordOutput(hash, "proxy-video", parameters);
+    if (!previous.isEmpty() && previous != finalName && QFileInfo(previous).size() > 0) {
+        LOG_INFO() << "reusing proxy" << previous << "for" << resource;
+        QFile::remove(fileName);
+        if (QFile::copy(previous, fileName)) {
+            QScopedPointer<PostJobAction> action(replace
+                ? (PostJobAction*) new ProxyReplacePostJobAction(resource, fileName, hash)
+                : (PostJobAction*) new ProxyFinalizePostJobAction(fileName));
+            action->doAction();
+            return;
+        }
+    }
+
     FfmpegJob* job = new FfmpegJob(fileName, args, false);
+    job->setLane(AbstractJob::ProxyLane);
+    job->setPriority(AbstractJob::HighPriority);
     job->setLabel(QObject::tr("Make proxy for %1").arg(Util::baseName(resource)));
+    job->setProvenance(hash, "proxy-video", parameters, finalName);
     if (replace) {
         job->setPostJobAction(new ProxyReplacePostJobAction(resource, fileName, hash));
     } else {
@@ -213,6 +376,7 @@ void ProxyManager::generateImageProxy(Mlt::Producer& producer, bool replace)
     file.open(QIODevice::WriteOnly);
     file.resize(0);
     file.close();
+    writeSourceManifest(hash, resource);
 
     auto width = producer.get_double("meta.media.width");
     auto height = producer.get_double("meta.media.height");
@@ -223,8 +387,30 @@ void ProxyManager::generateImageProxy(Mlt::Producer& producer, bool replace)
     args << QString("height=%1").arg(resolution());
     args << "pix_fmt=yuvj422p" << "color_range=full";
 
+    // Same content-addressed reuse as generateVideoProxy().
+    QStringList fingerprint = args;
+    fingerprint.removeAll(resource);
+    fingerprint.removeAll(QString("avformat:%1").arg(fileName));
+    const QString parameters = fingerprint.join(' ');
+    const QString finalName = dir().filePath(hash + kProxyImageExtension);
+    const QString previous = DB.getJobRecordOutput(hash, "proxy-image", parameters);
+    if (!previous.isEmpty() && previous != finalName && QFileInfo(previous).size() > 0) {
+        LOG_INFO() << "reusing proxy" << previous << "for" << resource;
+        QFile::remove(fileName);
+        if (QFile::copy(previous, fileName)) {
+            QScopedPointer<PostJobAction> action(replace
+                ? (PostJobAction*) new ProxyReplacePostJobAction(resource, fileName, hash)
+                : (PostJobAction*) new ProxyFinalizePostJobAction(fileName));
+            action->doAction();
+            return;
+        }
+    }
+
     MeltJob* job = new MeltJob(fileName, args, 1, 1);
+    job->setLane(AbstractJob::ProxyLane);
+    job->setPriority(AbstractJob::HighPriority);
     job->setLabel(QObject::tr("Make proxy for %1").arg(Util::baseName(resource)));
+    job->setProvenance(hash, "proxy-image", parameters, finalName);
     if (replace) {
         job->setPostJobAction(new ProxyReplacePostJobAction(resource, fileName, hash));
     } else {
@@ -393,7 +579,9 @@ bool ProxyManager::fileExists(Mlt::Producer& producer)
     } else {
         return false;
     }
-    return (projectDir.cd("proxies") && projectDir.exists(fileName)) || proxyDir.exists(fileName);
+    ProxyDirListingCache& cache = ProxyDirListingCache::singleton();
+    return (projectDir.cd("proxies") && cache.contains(projectDir.path(), fileName))
+        || cache.contains(proxyDir.path(), fileName);
 }
 
 bool ProxyManager::filePending(Mlt::Producer& producer)
@@ -409,13 +597,30 @@ bool ProxyManager::filePending(Mlt::Producer& producer)
     } else {
         return false;
     }
-    return (projectDir.cd("proxies") && projectDir.exists(fileName)) || proxyDir.exists(fileName);
+    ProxyDirListingCache& cache = ProxyDirListingCache::singleton();
+    QString pendingPath;
+    if (projectDir.cd("proxies") && cache.contains(projectDir.path(), fileName))
+        pendingPath = projectDir.filePath(fileName);
+    else if (cache.contains(proxyDir.path(), fileName))
+        pendingPath = proxyDir.filePath(fileName);
+    if (pendingPath.isEmpty())
+        return false;
+    // The rename from pending to final is the completion marker, so a
+    // pending file with no live job behind it is the leftover of a killed
+    // job. Remove it rather than treating the proxy as in progress forever.
+    if (!JOBS.hasActiveJob(pendingPath)) {
+        LOG_WARNING() << "removing partial proxy from an interrupted job" << pendingPath;
+        QFile::remove(pendingPath);
+        return false;
+    }
+    return true;
 }
 
 // Returns true if the producer exists and was updated with proxy info
 bool ProxyManager::generateIfNotExists(Mlt::Producer& producer, bool replace)
 {
     if (Settings.proxyEnabled() && producer.is_valid() && !producer.get_int(kDisableProxyProperty) && !producer.get_int(kIsProxyProperty)) {
+        verifySourceCurrent(producer);
         QString service = QString::fromLatin1(producer.get("mlt_service"));
         if (ProxyManager::fileExists(producer)) {
             QDir proxyDir(Settings.proxyFolder());
@@ -519,6 +724,23 @@ void ProxyManager::generateIfNotExistsAll(Mlt::Producer& producer)
 {
     FindNonProxyProducersParser parser;
     parser.start(producer);
+    if (Settings.proxyEnabled()) {
+        // Hashing and opening each file to read its resolution dominates
+        // this loop, so stat and probe all producers in parallel before
+        // queueing any jobs.
+        QtConcurrent::blockingMap(parser.producers(), [](Mlt::Producer& clip) {
+            if (!clip.is_valid() || clip.get_int(kDisableProxyProperty) || clip.get_int(kIsProxyProperty))
+                return;
+            QString service = QString::fromLatin1(clip.get("mlt_service"));
+            if (!service.startsWith("avformat") && !isValidImage(clip))
+                return;
+            // Re-hash changed sources here too so the content reads run in
+            // this parallel pass rather than in the serial loop below.
+            verifySourceCurrent(clip);
+            if (!fileExists(clip) && !filePending(clip))
+                delete clip.get_frame();
+        });
+    }
     for (auto& clip : parser.producers()) {
         generateIfNotExists(clip, false /* replace */);
         clip.set(kIsProxyProperty, 1);
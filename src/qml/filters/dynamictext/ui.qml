@@ -306,15 +306,36 @@ Item {
             Layout.maximumWidth: preset.width
             text: '__empty__' // workaround initialization problem
             property int maxLength: 256
+
+            function commitText() {
+                if (!parseInt(filter.get(useFontSizeProperty)))
+                    filter.set('size', profile.height / text.split('\n').length)
+                filter.set('argument', text)
+            }
+
+            Timer {
+                // Writing 'argument' makes the MLT filter lay out and
+                // rasterize the text again for the preview, so coalesce a
+                // typing burst into one write instead of one per keystroke.
+                id: commitTimer
+                interval: 150
+                onTriggered: textArea.commitText()
+            }
+
+            Component.onDestruction: {
+                if (commitTimer.running) {
+                    commitTimer.stop()
+                    commitText()
+                }
+            }
+
             onTextChanged: {
                 if (text === '__empty__') return
                 if (length > maxLength) {
                     text = text.substring(0, maxLength)
                     cursorPosition = maxLength
                 }
-                if (!parseInt(filter.get(useFontSizeProperty)))
-                    filter.set('size', profile.height / text.split('\n').length)
-                filter.set('argument', text)
+                commitTimer.restart()
             }
         }
 
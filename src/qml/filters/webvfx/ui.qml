@@ -156,6 +156,29 @@ Item {
                 role: 'name'
                 resizable: false
             }
+            rowDelegate: Rectangle {
+                height: 40
+                color: styleData.selected? activePalette.highlight
+                     : (styleData.alternate? activePalette.alternateBase : activePalette.base)
+            }
+            itemDelegate: Row {
+                spacing: 8
+                Image {
+                    // Posters come from the database cache; the web engine
+                    // renders a template at most once, not per browse.
+                    source: (styleData.row >= 0)? templatesModel.data(styleData.row, Shotcut.WebvfxTemplatesModel.PosterRole) : ''
+                    asynchronous: true
+                    width: 64
+                    height: 36
+                    fillMode: Image.PreserveAspectFit
+                    anchors.verticalCenter: parent.verticalCenter
+                }
+                Label {
+                    text: styleData.value
+                    color: styleData.selected? activePalette.highlightedText : activePalette.text
+                    anchors.verticalCenter: parent.verticalCenter
+                }
+            }
             property int selectedRow: -1
             onClicked : {
                 selectedRow = row
@@ -30,6 +30,50 @@ Item {
 
     signal clicked(var keyframe, var parameter)
 
+    onWidthChanged: updateVisibleRange()
+    Component.onCompleted: updateVisibleRange()
+
+    Connections {
+        target: scrollView.flickableItem
+        onContentXChanged: updateVisibleRange()
+    }
+    Connections {
+        target: scrollView
+        onWidthChanged: updateVisibleRange()
+    }
+    Connections {
+        // Keyframes added or removed enter outside the visible group;
+        // reapply the range so new ones under the viewport materialize.
+        target: keyframeDelegateModel.items
+        onChanged: updateVisibleRange()
+    }
+
+    function updateVisibleRange() {
+        // Materialize only the keyframe delegates in and just beyond the
+        // viewport. The model answers frame-range queries over its sorted
+        // cache, so a lane with thousands of keyframes only instantiates a
+        // handful of items while panning.
+        var count = keyframeDelegateModel.items.count
+        if (count <= 0) return
+        var parameterIndex = parameterRoot.DelegateModel.itemsIndex
+        var offset = filter.in - producer.in
+        var startFrame = Math.floor(scrollView.flickableItem.contentX / timeScale) - offset
+        var endFrame = Math.ceil((scrollView.flickableItem.contentX + scrollView.width) / timeScale) - offset
+        var first = parameters.firstKeyframeIndexInRange(parameterIndex, startFrame)
+        var last = parameters.lastKeyframeIndexInRange(parameterIndex, endFrame)
+        if (first < 0) first = count // all keyframes are left of the viewport
+        // Keep two keyframes of overscan on each side so curve segments
+        // crossing the viewport edges are drawn with their true neighbors.
+        first = Math.max(0, first - 2)
+        last = Math.min(count - 1, last + 2)
+        if (first > 0)
+            keyframeDelegateModel.items.setGroups(0, first, ['items'])
+        if (last >= first)
+            keyframeDelegateModel.items.setGroups(first, last - first + 1, ['items', 'visible'])
+        if (last + 1 < count)
+            keyframeDelegateModel.items.setGroups(last + 1, count - last - 1, ['items'])
+    }
+
     function getKeyframeCount() {
         return keyframesRepeater.count
     }
@@ -109,6 +153,8 @@ Item {
     DelegateModel {
         id: keyframeDelegateModel
         model: parameters
+        groups: DelegateModelGroup { name: 'visible' }
+        filterOnGroup: 'visible'
         Keyframe {
             position: (filter.in - producer.in) + model.frame
             interpolation: model.interpolation
@@ -116,7 +162,7 @@ Item {
             value: model.value
             minDragX: (filter.in - producer.in + model.minimumFrame) * timeScale - width/2
             maxDragX: (filter.in - producer.in + model.maximumFrame) * timeScale - width/2
-            isSelected: root.currentTrack === parameterRoot.DelegateModel.itemsIndex && root.selection.indexOf(index) !== -1
+            isSelected: root.currentTrack === parameterRoot.DelegateModel.itemsIndex && root.selection.indexOf(DelegateModel.itemsIndex) !== -1
             isCurve: parameterRoot.isCurve
             minimum: parameterRoot.minimum
             maximum: parameterRoot.maximum
@@ -45,6 +45,14 @@ Rectangle {
     property double speed: 1.0
     property string audioIndex: ''
     property bool isTrackMute: false
+    // When true the track's TimelineClipStrip batch-renders this clip's
+    // body and the per-item gradient and border are dropped. States that
+    // need distinct visuals - selected, dragging, blank, transition -
+    // fall back to drawing themselves on top of the batch.
+    property bool batchedBody: false
+    property bool dragging: Drag.active
+    readonly property bool bodyInStrip: batchedBody && !isBlank && !isTransition && !selected
+                                        && !dragging && trackIndex == originalTrackIndex
 
     signal clicked(var clip, var mouse)
     signal moved(var clip)
@@ -57,7 +65,10 @@ Rectangle {
     signal trimmedOut(var clip)
 
     SystemPalette { id: activePalette }
-    gradient: Gradient {
+    color: 'transparent'
+    gradient: bodyInStrip? null : bodyGradient
+    Gradient {
+        id: bodyGradient
         GradientStop {
             id: gradientStop
             position: 0.00
@@ -71,7 +82,7 @@ Rectangle {
     }
 
     border.color: (selected || Drag.active || trackIndex != originalTrackIndex)? 'red' : 'black'
-    border.width: isBlank? 0 : 1
+    border.width: (isBlank || bodyInStrip)? 0 : 1
     clip: true
     Drag.active: mouseArea.drag.active
     Drag.proposedAction: Qt.MoveAction
@@ -641,6 +652,11 @@ Rectangle {
             text: qsTr('Copy')
             onTriggered: timeline.copyClip(trackIndex, index)
         }
+        MenuItem {
+            visible: !isBlank && !isTransition && application.hasFiltersOnClipboard()
+            text: qsTr('Paste Filters to Selection')
+            onTriggered: timeline.pasteFiltersOnSelection()
+        }
         MenuSeparator {
             visible: !isBlank && !isTransition
         }
@@ -93,6 +93,8 @@ function dragging(pos, duration) {
 function dropped() {
     dropTarget.visible = false
     scrollTimer.running = false
+    for (var i = 0; i < tracksRepeater.count; i++)
+        tracksRepeater.itemAt(i).resetSnap()
 }
 
 function acceptDrop(xml) {
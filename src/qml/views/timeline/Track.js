@@ -18,6 +18,61 @@
 var SNAP = 10
 var SNAP_TRIM = 4
 
+// Snap candidates are precomputed once per drag gesture as sorted arrays of
+// edge positions (pixels) and queried with a binary search per mouse move,
+// instead of scanning every clip item at mouse-event rate. The view calls
+// invalidateSnapEdges() (via Track.resetSnap()) when a gesture ends, a clip
+// changes track, or the zoom changes.
+var snapEdges = null
+var snapEdgesClip = null
+var trimEdges = null
+var trimEdgesClip = null
+
+function invalidateSnapEdges() {
+    snapEdges = null
+    snapEdgesClip = null
+    trimEdges = null
+    trimEdgesClip = null
+}
+
+// Collects this track's clip edges, excluding the dragged clip (if any),
+// as sorted arrays: left edges, right edges, and both combined.
+function buildSnapEdges(repeater, clip) {
+    var numeric = function(a, b) { return a - b }
+    var edges = { lefts: [], rights: [], all: [] }
+    for (var i = 0; i < repeater.count; i++) {
+        var item = repeater.itemAt(i)
+        // Do not snap to self.
+        if (clip && i === clip.DelegateModel.itemsIndex && clip.trackIndex === item.trackIndex)
+            continue
+        edges.lefts.push(item.x)
+        edges.rights.push(item.x + item.width)
+    }
+    edges.lefts.sort(numeric)
+    edges.rights.sort(numeric)
+    edges.all = edges.lefts.concat(edges.rights).sort(numeric)
+    return edges
+}
+
+// Returns the edge nearest to x if within threshold, else -1.
+function nearestEdge(edges, x, threshold) {
+    if (!edges.length)
+        return -1
+    var lo = 0
+    var hi = edges.length - 1
+    while (lo < hi) {
+        var mid = (lo + hi) >> 1
+        if (edges[mid] < x)
+            lo = mid + 1
+        else
+            hi = mid
+    }
+    var best = edges[lo]
+    if (lo > 0 && x - edges[lo - 1] < Math.abs(best - x))
+        best = edges[lo - 1]
+    return (Math.abs(best - x) < threshold)? best : -1
+}
+
 function snapClip(clip, repeater) {
     var left = clip.x
     var right = clip.x + clip.width
@@ -27,30 +82,19 @@ function snapClip(clip, repeater) {
         return
     } else {
         // Snap to other clips on the same track.
-        for (var i = 0; i < repeater.count; i++) {
-            // Do not snap to self.
-            if (i === clip.DelegateModel.itemsIndex && clip.trackIndex === repeater.itemAt(i).trackIndex)
-                continue
-            var itemLeft = repeater.itemAt(i).x
-            var itemRight = itemLeft + repeater.itemAt(i).width
-            // Snap to blank
-            if (right > itemLeft - SNAP && right < itemLeft + SNAP) {
-                // Snap right edge to left edge.
-                clip.x = itemLeft - clip.width
-                return
-            } else if (left > itemRight - SNAP && left < itemRight + SNAP) {
-                // Snap left edge to right edge.
-                clip.x = itemRight
-                return
-            } else if (right > itemRight - SNAP && right < itemRight + SNAP) {
-                // Snap right edge to right edge.
-                clip.x = itemRight - clip.width
-                return
-            } else if (left > itemLeft - SNAP && left < itemLeft + SNAP) {
-                // Snap left edge to left edge.
-                clip.x = itemLeft
-                return
-            }
+        if (!snapEdges || snapEdgesClip !== clip) {
+            snapEdges = buildSnapEdges(repeater, clip)
+            snapEdgesClip = clip
+        }
+        var leftEdge = nearestEdge(snapEdges.all, left, SNAP)
+        var rightEdge = nearestEdge(snapEdges.all, right, SNAP)
+        // Prefer whichever of the clip's edges is closer to a candidate.
+        if (rightEdge >= 0 && (leftEdge < 0 || Math.abs(rightEdge - right) <= Math.abs(leftEdge - left))) {
+            clip.x = rightEdge - clip.width
+            return
+        } else if (leftEdge >= 0) {
+            clip.x = leftEdge
+            return
         }
     }
     if (!toolbar.scrub) {
@@ -63,39 +107,55 @@ function snapClip(clip, repeater) {
     }
 }
 
+// Collects trim snap candidates: non-blank, non-transition edges on this
+// track (excluding the trimmed clip) and non-blank edges on other tracks.
+// Other clips keep their positions across a trim gesture (snap is disabled
+// with ripple), so this is built once per gesture.
+function buildTrimEdges(clip, timeline, trackIndex) {
+    var numeric = function(a, b) { return a - b }
+    var edges = { own: [], others: [] }
+    for (var i = 0; i < repeater.count; i++) {
+        var item = repeater.itemAt(i)
+        if (i === clip.DelegateModel.itemsIndex || item.isBlank || item.isTransition)
+            continue
+        edges.own.push(item.x)
+        edges.own.push(item.x + item.width)
+    }
+    edges.own.sort(numeric)
+    for (var j = 0; j < timeline.trackCount; j++) {
+        if (j === trackIndex)
+            continue
+        var track = timeline.trackAt(j)
+        for (i = 0; i < track.clipCount; i++) {
+            var other = track.clipAt(i)
+            if (other.isBlank)
+                continue
+            edges.others.push(other.x)
+            edges.others.push(other.x + other.width)
+        }
+    }
+    edges.others.sort(numeric)
+    return edges
+}
+
 function snapTrimIn(clip, delta, timeline, trackIndex) {
     var x = clip.x + delta * timeScale
     var cursorX = scrollView.flickableItem.contentX + cursor.x
+    if (!trimEdges || trimEdgesClip !== clip) {
+        trimEdges = buildTrimEdges(clip, timeline, trackIndex)
+        trimEdgesClip = clip
+    }
+    var edge
     if (delta < 0) {
         // Snap to other clips on the same track.
-        for (var i = 0; i < repeater.count; i++) {
-            if (i === clip.DelegateModel.itemsIndex || repeater.itemAt(i).isBlank || repeater.itemAt(i).isTransition)
-                continue
-            var itemLeft = repeater.itemAt(i).x
-            var itemRight = itemLeft + repeater.itemAt(i).width
-            if (x > itemLeft - SNAP_TRIM && x < itemLeft + SNAP_TRIM)
-                return Math.round((itemLeft - clip.x) / timeScale)
-            else if (x > itemRight - SNAP_TRIM && x < itemRight + SNAP_TRIM)
-                return Math.round((itemRight - clip.x) / timeScale)
-        }
+        edge = nearestEdge(trimEdges.own, x, SNAP_TRIM)
+        if (edge >= 0)
+            return Math.round((edge - clip.x) / timeScale)
     }
     // Snap to clips on other tracks.
-    for (var j = 0; j < timeline.trackCount; j++) {
-        if (j !== trackIndex) {
-            var track = timeline.trackAt(j)
-            for (i = 0; i < track.clipCount; i++) {
-                var item = track.clipAt(i)
-                if (item.isBlank)
-                    continue
-                itemLeft = item.x
-                itemRight = itemLeft + item.width
-                if (x > itemLeft - SNAP_TRIM && x < itemLeft + SNAP_TRIM)
-                    return Math.round((itemLeft - clip.x) / timeScale)
-                else if (x > itemRight - SNAP_TRIM && x < itemRight + SNAP_TRIM)
-                    return Math.round((itemRight - clip.x) / timeScale)
-            }
-        }
-    }
+    edge = nearestEdge(trimEdges.others, x, SNAP_TRIM)
+    if (edge >= 0)
+        return Math.round((edge - clip.x) / timeScale)
     if (x > -SNAP_TRIM && x < SNAP_TRIM) {
         // Snap around origin.
         return Math.round(-clip.x / timeScale)
@@ -110,36 +170,21 @@ function snapTrimOut(clip, delta, timeline, trackIndex) {
     var rightEdge = clip.x + clip.width
     var x = rightEdge - delta * timeScale
     var cursorX = scrollView.flickableItem.contentX + cursor.x
+    if (!trimEdges || trimEdgesClip !== clip) {
+        trimEdges = buildTrimEdges(clip, timeline, trackIndex)
+        trimEdgesClip = clip
+    }
+    var edge
     if (delta < 0) {
         // Snap to other clips.
-        for (var i = 0; i < repeater.count; i++) {
-            if (i === clip.DelegateModel.itemsIndex || repeater.itemAt(i).isBlank || repeater.itemAt(i).isTransition)
-                continue
-            var itemLeft = repeater.itemAt(i).x
-            var itemRight = itemLeft + repeater.itemAt(i).width
-            if (x > itemLeft - SNAP_TRIM && x < itemLeft + SNAP_TRIM)
-                return Math.round((rightEdge - itemLeft) / timeScale)
-            else if (x > itemRight - SNAP_TRIM && x < itemRight + SNAP_TRIM)
-                return Math.round((rightEdge - itemRight) / timeScale)
-        }
+        edge = nearestEdge(trimEdges.own, x, SNAP_TRIM)
+        if (edge >= 0)
+            return Math.round((rightEdge - edge) / timeScale)
     }
     // Snap to clips on other tracks.
-    for (var j = 0; j < timeline.trackCount; j++) {
-        if (j !== trackIndex) {
-            var track = timeline.trackAt(j)
-            for (i = 0; i < track.clipCount; i++) {
-                var item = track.clipAt(i)
-                if (item.isBlank)
-                    continue
-                itemLeft = item.x
-                itemRight = itemLeft + item.width
-                if (x > itemLeft - SNAP_TRIM && x < itemLeft + SNAP_TRIM)
-                    return Math.round((rightEdge - itemLeft) / timeScale)
-                else if (x > itemRight - SNAP_TRIM && x < itemRight + SNAP_TRIM)
-                    return Math.round((rightEdge - itemRight) / timeScale)
-            }
-        }
-    }
+    edge = nearestEdge(trimEdges.others, x, SNAP_TRIM)
+    if (edge >= 0)
+        return Math.round((rightEdge - edge) / timeScale)
     if (x > cursorX - SNAP_TRIM && x < cursorX + SNAP_TRIM) {
         // Snap around cursor/playhead.
         return Math.round((rightEdge - cursorX) / timeScale)
@@ -155,17 +200,21 @@ function snapDrop(pos, repeater) {
         dropTarget.x = headerWidth
         return
     } else {
-        // Snap to other clips.
-        for (var i = 0; i < repeater.count; i++) {
-            var itemLeft = repeater.itemAt(i).x
-            var itemRight = itemLeft + repeater.itemAt(i).width
-            if (right > itemLeft - SNAP && right < itemLeft + SNAP) {
-                dropTarget.x = itemLeft - dropTarget.width + headerWidth - scrollView.flickableItem.contentX
-                return
-            } else if (left > itemRight - SNAP && left < itemRight + SNAP) {
-                dropTarget.x = itemRight + headerWidth - scrollView.flickableItem.contentX
-                return
-            }
+        // Snap to other clips (abutting only: right edge to a left edge,
+        // left edge to a right edge).
+        if (!snapEdges || snapEdgesClip !== null) {
+            snapEdges = buildSnapEdges(repeater, null)
+            snapEdgesClip = null
+        }
+        var leftEdge = nearestEdge(snapEdges.lefts, right, SNAP)
+        if (leftEdge >= 0) {
+            dropTarget.x = leftEdge - dropTarget.width + headerWidth - scrollView.flickableItem.contentX
+            return
+        }
+        var rightEdge = nearestEdge(snapEdges.rights, left, SNAP)
+        if (rightEdge >= 0) {
+            dropTarget.x = rightEdge + headerWidth - scrollView.flickableItem.contentX
+            return
         }
     }
     if (!toolbar.scrub) {
@@ -17,6 +17,7 @@
 
 import QtQuick 2.0
 import QtQml.Models 2.1
+import Shotcut.Controls 1.0
 import 'Track.js' as Logic
 
 Rectangle {
@@ -55,13 +56,37 @@ Rectangle {
         Logic.snapDrop(clip, repeater)
     }
 
+    /// Drops the precomputed snap candidate edges; called when a drag
+    /// gesture ends or the clip layout changes.
+    function resetSnap() {
+        Logic.invalidateSnapEdges()
+    }
+
     function clipAt(index) {
         return repeater.itemAt(index)
     }
 
+    /// Schedules a rebuild of the batch strip's clip list, coalesced
+    /// through a zero-interval timer because drag and trim gestures change
+    /// several clip geometries within one frame.
+    function requestClipStripUpdate() {
+        clipStripTimer.restart()
+    }
+
+    function updateClipStrip() {
+        var bodies = []
+        for (var i = 0; i < repeater.count; i++) {
+            var clip = repeater.itemAt(i)
+            if (clip && clip.bodyInStrip)
+                bodies.push({'x': clip.x, 'width': clip.width, 'color': clip.getColor()})
+        }
+        clipStrip.clips = bodies
+    }
+
     color: 'transparent'
     width: clipRow.width
     onIsMuteChanged: if (!isMute) redrawWaveforms(true)
+    onTimeScaleChanged: Logic.invalidateSnapEdges()
 
     DelegateModel {
         id: trackModel
@@ -86,6 +111,12 @@ Rectangle {
             audioIndex: model.audioIndex
             selected: Logic.selectionContains(timeline.selection, trackIndex, index)
             isTrackMute: trackRoot.isMute
+            batchedBody: true
+
+            onXChanged: trackRoot.requestClipStripUpdate()
+            onWidthChanged: trackRoot.requestClipStripUpdate()
+            onIsAudioChanged: trackRoot.requestClipStripUpdate()
+            onBodyInStripChanged: trackRoot.requestClipStripUpdate()
 
             onClicked: trackRoot.clipClicked(clip, trackRoot, mouse);
             onMoved: {
@@ -232,8 +263,27 @@ Rectangle {
         }
     }
 
+    // All regular clip bodies of this track in one pair of draw calls;
+    // clips draw themselves on top only while selected, dragging, blank,
+    // or a transition.
+    TimelineClipStrip {
+        id: clipStrip
+        anchors.fill: parent
+    }
+
     Row {
         id: clipRow
-        Repeater { id: repeater; model: trackModel }
+        Repeater {
+            id: repeater
+            model: trackModel
+            onItemAdded: trackRoot.requestClipStripUpdate()
+            onItemRemoved: trackRoot.requestClipStripUpdate()
+        }
+    }
+
+    Timer {
+        id: clipStripTimer
+        interval: 0
+        onTriggered: updateClipStrip()
     }
 }
@@ -280,7 +280,10 @@ Rectangle {
                     width: root.width - headerWidth
                     height: root.height - ruler.height - toolbar.height
                     // workaround to fix https://github.com/mltframework/shotcut/issues/777
-                    flickableItem.onContentXChanged: rulerFlickable.contentX = flickableItem.contentX
+                    flickableItem.onContentXChanged: {
+                        rulerFlickable.contentX = flickableItem.contentX
+                        timeline.prefetchThumbnails(flickableItem.contentX, scrollView.width, multitrack.scaleFactor)
+                    }
         
                     MouseArea {
                         width: tracksContainer.width + headerWidth
@@ -598,12 +601,17 @@ Rectangle {
                 scrollTimer.running = false
                 bubbleHelp.hide()
                 selectionContainer.visible = false
+                for (var i = 0; i < tracksRepeater.count; i++)
+                    tracksRepeater.itemAt(i).resetSnap()
             }
             onClipDraggedToTrack: {
                 var i = clip.trackIndex + direction
                 var track = trackAt(i)
                 clip.reparent(track)
                 clip.trackIndex = track.DelegateModel.itemsIndex
+                // The placeholder insertion changes the snap candidates.
+                for (var j = 0; j < tracksRepeater.count; j++)
+                    tracksRepeater.itemAt(j).resetSnap()
             }
             onCheckSnap: {
                 for (var i = 0; i < tracksRepeater.count; i++)
@@ -23,6 +23,7 @@
 #include "mainwindow.h"
 #include <QPainter>
 #include <QCursor>
+#include <QQuickWindow>
 #include <qmath.h>
 #include <cstdio>
 
@@ -34,6 +35,7 @@ ColorWheelItem::ColorWheelItem(QQuickItem *parent)
     , m_isMouseDown(false)
     , m_lastPoint(0, 0)
     , m_size(0, 0)
+    , m_devicePixelRatio(1.0)
     , m_margin(5)
     , m_color(0, 0, 0, 0)
     , m_isInWheel(false)
@@ -51,11 +53,22 @@ QColor ColorWheelItem::color()
 
 void ColorWheelItem::setColor(const QColor& color)
 {
-    if(m_color != color) {
-        m_color = color;
-        update();
-        emit colorChanged(m_color);
-    }
+    applyColor(color);
+}
+
+// Change the color and repaint only the small marker areas - the old and new
+// dot and slider bar rectangles - instead of the whole item, so dragging a
+// wheel during playback does not re-rasterize the gradient every frame.
+void ColorWheelItem::applyColor(const QColor& color)
+{
+    if (m_color == color) return;
+    QRect dirty = dotRect().united(sliderBarRect());
+    m_color = color;
+    dirty = dirty.united(dotRect()).united(sliderBarRect());
+    // Pad for the pen width and antialiasing.
+    dirty.adjust(-2, -2, 2, 2);
+    update(dirty);
+    emit colorChanged(m_color);
 }
 
 int ColorWheelItem::red()
@@ -65,11 +78,9 @@ int ColorWheelItem::red()
 
 void ColorWheelItem::setRed(int red)
 {
-    if(m_color.red() != red) {
-        m_color.setRed(red);
-        update();
-        emit colorChanged(m_color);
-    }
+    QColor color = m_color;
+    color.setRed(red);
+    applyColor(color);
 }
 
 int ColorWheelItem::green()
@@ -79,11 +90,9 @@ int ColorWheelItem::green()
 
 void ColorWheelItem::setGreen(int green)
 {
-    if(m_color.green() != green) {
-        m_color.setGreen(green);
-        update();
-        emit colorChanged(m_color);
-    }
+    QColor color = m_color;
+    color.setGreen(green);
+    applyColor(color);
 }
 
 int ColorWheelItem::blue()
@@ -93,11 +102,9 @@ int ColorWheelItem::blue()
 
 void ColorWheelItem::setBlue(int blue)
 {
-    if(m_color.blue() != blue) {
-        m_color.setBlue(blue);
-        update();
-        emit colorChanged(m_color);
-    }
+    QColor color = m_color;
+    color.setBlue(blue);
+    applyColor(color);
 }
 
 qreal ColorWheelItem::redF()
@@ -107,11 +114,9 @@ qreal ColorWheelItem::redF()
 
 void ColorWheelItem::setRedF(qreal red)
 {
-    if(m_color.redF() != red) {
-        m_color.setRedF(red);
-        update();
-        emit colorChanged(m_color);
-    }
+    QColor color = m_color;
+    color.setRedF(red);
+    applyColor(color);
 }
 
 qreal ColorWheelItem::greenF()
@@ -121,11 +126,9 @@ qreal ColorWheelItem::greenF()
 
 void ColorWheelItem::setGreenF(qreal green)
 {
-    if(m_color.greenF() != green) {
-        m_color.setGreenF(green);
-        update();
-        emit colorChanged(m_color);
-    }
+    QColor color = m_color;
+    color.setGreenF(green);
+    applyColor(color);
 }
 
 qreal ColorWheelItem::blueF()
@@ -135,11 +138,9 @@ qreal ColorWheelItem::blueF()
 
 void ColorWheelItem::setBlueF(qreal blue)
 {
-    if(m_color.blueF() != blue) {
-        m_color.setBlueF(blue);
-        update();
-        emit colorChanged(m_color);
-    }
+    QColor color = m_color;
+    color.setBlueF(blue);
+    applyColor(color);
 }
 
 qreal ColorWheelItem::step()
@@ -261,16 +262,42 @@ void ColorWheelItem::wheelEvent(QWheelEvent *event)
     event->accept();
 }
 
+// The bounding rectangle of the dot marker drawn by drawWheelDot().
+QRect ColorWheelItem::dotRect() const
+{
+    qreal r = wheelSize() / 2;
+    qreal distance = m_color.saturationF() * r - m_margin;
+    // drawWheelDot() rotates by (360 - hue) then -105 degrees.
+    qreal angle = (255.0 - m_color.hue()) * M_PI / 180.0;
+    QPointF center(r + distance * qCos(angle), r + distance * qSin(angle));
+    return QRect(center.x() - 8, center.y() - 8, 16, 16);
+}
+
+// The bounding rectangle of the bar marker drawn by drawSliderBar().
+QRect ColorWheelItem::sliderBarRect() const
+{
+    qreal value = 1.0 - m_color.valueF();
+    int ws = wheelSize() * MAIN.devicePixelRatio();
+    int w = (qreal)ws / WHEEL_SLIDER_RATIO;
+    int h = ws - m_margin * 2;
+    return QRect(ws - 2, m_margin + value * h - 2, w + 4, 8);
+}
+
 void ColorWheelItem::paint(QPainter *painter)
 {
     QSize size( width(), height() );
+    qreal devicePixelRatio = window()? window()->effectiveDevicePixelRatio() : 1.0;
 
-    if( m_size != size ) {
-        m_image = QImage(QSize(width(), height()), QImage::Format_ARGB32_Premultiplied);
+    // The gradient background is cached per size and DPI; repaints for a
+    // marker move just blit from it under the dirty rectangle.
+    if (m_size != size || m_devicePixelRatio != devicePixelRatio) {
+        m_image = QImage(size * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+        m_image.setDevicePixelRatio(devicePixelRatio);
         m_image.fill(qRgba(0,0,0,0));
         drawWheel();
         drawSlider();
         m_size = size;
+        m_devicePixelRatio = devicePixelRatio;
     }
 
     painter->setRenderHint(QPainter::Antialiasing);
@@ -70,6 +70,7 @@ private:
     bool m_isMouseDown;
     QPoint m_lastPoint;
     QSize m_size;
+    qreal m_devicePixelRatio;
     int m_margin;
     QRegion m_wheelRegion;
     QRegion m_sliderRegion;
@@ -80,6 +81,9 @@ private:
 
     int wheelSize() const;
     QColor colorForPoint(const QPoint &point);
+    void applyColor(const QColor &color);
+    QRect dotRect() const;
+    QRect sliderBarRect() const;
     void drawWheel();
     void drawWheelDot(QPainter &painter);
     void drawSliderBar(QPainter &painter);
@@ -31,6 +31,7 @@
 #include <QIODevice>
 #include <QTemporaryFile>
 #include <QFile>
+#include <QVector>
 #include <QtXml>
 #include <MltProducer.h>
 
@@ -56,10 +57,35 @@ QmlFilter::QmlFilter(Mlt::Filter& mltFilter, const QmlMetadata* metadata, QObjec
     , m_isNew(false)
 {
     connect(this, SIGNAL(changed(QString)), SIGNAL(changed()));
+    // Coalesce change notifications to roughly one per frame so a slider
+    // drag does not emit hundreds of changed() signals - and consumer
+    // refreshes - per second.
+    m_changeTimer.setSingleShot(true);
+    m_changeTimer.setInterval(qRound(1000.0 / MLT.profile().fps()));
+    connect(&m_changeTimer, &QTimer::timeout, this, &QmlFilter::flushPendingChanges);
 }
 
 QmlFilter::~QmlFilter()
 {
+    // Do not lose the last notification of a drag that just ended.
+    flushPendingChanges();
+}
+
+void QmlFilter::signalChange(const QString& name)
+{
+    if (!m_pendingChanges.contains(name))
+        m_pendingChanges.append(name);
+    if (!m_changeTimer.isActive())
+        m_changeTimer.start();
+}
+
+void QmlFilter::flushPendingChanges()
+{
+    // An emission may re-enter set(); iterate over a local copy.
+    QStringList names = m_pendingChanges;
+    m_pendingChanges.clear();
+    foreach (const QString& name, names)
+        emit changed(name);
 }
 
 QString QmlFilter::get(QString name, int position)
@@ -135,7 +161,7 @@ void QmlFilter::set(QString name, QString value, int position)
 #else
             m_filter.set(qUtf8Printable(name), qUtf8Printable(value)) ;
 #endif
-            emit changed(name);
+            signalChange(name);
         }
     } else {
         // Only set an animation keyframe if it does not already exist with the same value.
@@ -143,7 +169,7 @@ void QmlFilter::set(QString name, QString value, int position)
         if (!animation.is_valid() || !animation.is_key(position)
                 || value != m_filter.anim_get(qUtf8Printable(name), position, duration())) {
             m_filter.anim_set(qUtf8Printable(name), qUtf8Printable(value), position, duration());
-            emit changed(name);
+            signalChange(name);
         }
     }
 }
@@ -156,7 +182,7 @@ void QmlFilter::set(QString name, double value, int position, mlt_keyframe_type
             || m_filter.get_double(qUtf8Printable(name)) != value) {
             double delta = value - m_filter.get_double(qUtf8Printable(name));
             m_filter.set(qUtf8Printable(name), value);
-            emit changed(name);
+            signalChange(name);
             if (name == "in") {
                 emit inChanged(delta);
             } else if (name == "out") {
@@ -170,7 +196,7 @@ void QmlFilter::set(QString name, double value, int position, mlt_keyframe_type
                 || value != m_filter.anim_get_double(qUtf8Printable(name), position, duration())) {
             mlt_keyframe_type type = getKeyframeType(animation, position, keyframeType);
             m_filter.anim_set(qUtf8Printable(name), value, position, duration(), type);
-            emit changed(name);
+            signalChange(name);
         }
     }
 }
@@ -183,7 +209,7 @@ void QmlFilter::set(QString name, int value, int position, mlt_keyframe_type key
             || m_filter.get_int(qUtf8Printable(name)) != value) {
             int delta = value - m_filter.get_int(qUtf8Printable(name));
             m_filter.set(qUtf8Printable(name), value);
-            emit changed(name);
+            signalChange(name);
             if (name == "in") {
                 emit inChanged(delta);
             } else if (name == "out") {
@@ -197,7 +223,7 @@ void QmlFilter::set(QString name, int value, int position, mlt_keyframe_type key
                 || value != m_filter.anim_get_int(qUtf8Printable(name), position, duration())) {
             mlt_keyframe_type type = getKeyframeType(animation, position, keyframeType);
             m_filter.anim_set(qUtf8Printable(name), value, position, duration(), type);
-            emit changed(name);
+            signalChange(name);
         }
     }
 }
@@ -216,7 +242,7 @@ void QmlFilter::set(QString name, double x, double y, double width, double heigh
         if (!m_filter.get(qUtf8Printable(name)) || x != rect.x || y != rect.y
             || width != rect.w || height != rect.h || opacity != rect.o) {
             m_filter.set(qUtf8Printable(name), x, y, width, height, opacity);
-            emit changed(name);
+            signalChange(name);
         }
     } else {
         mlt_rect rect = m_filter.anim_get_rect(qUtf8Printable(name), position, duration());
@@ -231,7 +257,7 @@ void QmlFilter::set(QString name, double x, double y, double width, double heigh
             rect.o = opacity;
             mlt_keyframe_type type = getKeyframeType(animation, position, keyframeType);
             m_filter.anim_set(qUtf8Printable(name), rect, position, duration(), type);
-            emit changed(name);
+            signalChange(name);
         }
     }
 }
@@ -333,7 +359,28 @@ void QmlFilter::analyze(bool isAudio)
     int disable = m_filter.get_int("disable");
     m_filter.set("disable", 0);
     if (!isAudio) m_filter.set("analyze", 1);
+    // Filters attached after the analyzed one cannot affect its input, but
+    // they would still render every frame of the analysis pass. Disable them
+    // in the saved XML so analyzing a graded and titled clip only pays for
+    // decode plus the filters feeding the analyzer.
+    QVector<int> disabledFilters;
+    int analyzedIndex = -1;
+    for (int i = 0; i < service.filter_count(); i++) {
+        QScopedPointer<Mlt::Filter> filter(service.filter(i));
+        if (!filter || !filter->is_valid()) continue;
+        if (filter->get_filter() == m_filter.get_filter()) {
+            analyzedIndex = i;
+        } else if (analyzedIndex >= 0 && !filter->get_int("disable")) {
+            filter->set("disable", 1);
+            disabledFilters << i;
+        }
+    }
     MLT.saveXML(tmp->fileName(), &service, false /* without relative paths */, false /* without verify */);
+    foreach (int i, disabledFilters) {
+        QScopedPointer<Mlt::Filter> filter(service.filter(i));
+        if (filter && filter->is_valid())
+            filter->set("disable", 0);
+    }
     if (!isAudio) m_filter.set("analyze", 0);
     m_filter.set("disable", disable);
 
@@ -365,9 +412,12 @@ void QmlFilter::analyze(bool isAudio)
     consumerNode.setAttribute("no_meta", 1);
     consumerNode.setAttribute("resource", tmpTarget->fileName());
 
-    AbstractJob* job = new MeltJob(tmpTarget->fileName(), dom.toString(2),
+    MeltJob* job = new MeltJob(tmpTarget->fileName(), dom.toString(2),
         MLT.profile().frame_rate_num(), MLT.profile().frame_rate_den());
     if (job) {
+        // Analysis is short enough that spawning melt and re-parsing the
+        // XML dominates; render it with the in-process consumer instead.
+        job->setInProcess();
         AnalyzeDelegate* delegate = new AnalyzeDelegate(m_filter);
         connect(job, &AbstractJob::finished, delegate, &AnalyzeDelegate::onAnalyzeFinished);
         connect(job, &AbstractJob::finished, this, &QmlFilter::analyzeFinished);
@@ -446,6 +496,11 @@ int QmlFilter::in()
     return result;
 }
 
+// Note on playback cost: trimming writes the real MLT filter in/out, and MLT
+// enforces that range itself. mlt_service_apply_filters() skips the process
+// call for attached filters whose range excludes the frame position, so an
+// out-of-range filter never pushes its image callback and costs only the
+// per-filter range check. No Shotcut-side disconnect/reconnect is needed.
 void QmlFilter::setIn(int value)
 {
     set("in", value);
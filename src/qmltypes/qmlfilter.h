@@ -20,6 +20,8 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
+#include <QTimer>
 #include <QVariant>
 #include <QRectF>
 #include <QUuid>
@@ -130,9 +132,17 @@ private:
     QString m_path;
     bool m_isNew;
     QStringList m_presets;
-    
+    // Property names with a pending changed() notification. The writes
+    // themselves go straight into the filter; only the notifications are
+    // coalesced to one emission per name per frame interval so slider drags
+    // do not flood the consumer with refreshes.
+    QStringList m_pendingChanges;
+    QTimer m_changeTimer;
+
     QString objectNameOrService();
     int keyframeIndex(Mlt::Animation& animation, int position);
+    void signalChange(const QString& name);
+    void flushPendingChanges();
 };
 
 class AnalyzeDelegate : public QObject
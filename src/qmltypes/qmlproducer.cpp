@@ -32,6 +32,61 @@ QmlProducer::QmlProducer(QObject *parent)
 {
     connect(this, SIGNAL(inChanged(int)), this, SIGNAL(durationChanged()));
     connect(this, SIGNAL(outChanged(int)), this, SIGNAL(durationChanged()));
+    updateSnapshot();
+}
+
+// Refresh the cached values behind the producerChanged-bound properties in
+// one pass over the producer.
+void QmlProducer::updateSnapshot()
+{
+    m_aspectRatio = 1.0;
+    m_displayAspectRatio = 1.0;
+    m_resource.clear();
+    m_service.clear();
+    m_hash.clear();
+    m_name.clear();
+    m_fadeIn = 0;
+    m_fadeOut = 0;
+    m_speed = 1.0;
+    if (!m_producer.is_valid())
+        return;
+    m_displayAspectRatio = MLT.profile().dar();
+
+    if (m_producer.get(kHeightProperty)) {
+        double sar = 1.0;
+        if (m_producer.get(kAspectDenProperty)) {
+            sar = m_producer.get_double(kAspectNumProperty) /
+                  m_producer.get_double(kAspectDenProperty);
+        }
+        m_aspectRatio = sar * m_producer.get_double(kWidthProperty) / m_producer.get_double(kHeightProperty);
+        m_displayAspectRatio = m_aspectRatio;
+    } else {
+        m_aspectRatio = MLT.profile().dar();
+    }
+
+    m_resource = QString::fromUtf8(m_producer.get("resource"));
+    m_service = QString::fromUtf8(m_producer.get("mlt_service"));
+    if (m_resource == "<producer>" && !m_service.isEmpty())
+        m_resource = m_service;
+    m_hash = QString::fromUtf8(m_producer.get(kShotcutHashProperty));
+    m_name = Util::producerTitle(m_producer);
+
+    QScopedPointer<Mlt::Filter> filter(MLT.getFilter("fadeInVolume", &m_producer));
+    if (!filter || !filter->is_valid())
+        filter.reset(MLT.getFilter("fadeInBrightness", &m_producer));
+    if (!filter || !filter->is_valid())
+        filter.reset(MLT.getFilter("fadeInMovit", &m_producer));
+    m_fadeIn = (filter && filter->is_valid())? filter->get_length() : 0;
+
+    filter.reset(MLT.getFilter("fadeOutVolume", &m_producer));
+    if (!filter || !filter->is_valid())
+        filter.reset(MLT.getFilter("fadeOutBrightness", &m_producer));
+    if (!filter || !filter->is_valid())
+        filter.reset(MLT.getFilter("fadeOutMovit", &m_producer));
+    m_fadeOut = (filter && filter->is_valid())? filter->get_length() : 0;
+
+    if (m_service == "timewarp")
+        m_speed = m_producer.get_double("warp_speed");
 }
 
 int QmlProducer::in()
@@ -58,34 +113,6 @@ int QmlProducer::out()
         return m_producer.get_out();
 }
 
-double QmlProducer::aspectRatio()
-{
-    if (!m_producer.is_valid()) return 1.0;
-    if (m_producer.get(kHeightProperty)) {
-        double sar = 1.0;
-        if (m_producer.get(kAspectDenProperty)) {
-            sar = m_producer.get_double(kAspectNumProperty) /
-                  m_producer.get_double(kAspectDenProperty);
-        }
-        return sar * m_producer.get_double(kWidthProperty) / m_producer.get_double(kHeightProperty);
-    }
-    return MLT.profile().dar();
-}
-
-QString QmlProducer::resource()
-{
-    if (!m_producer.is_valid()) return QString();
-    QString result = QString::fromUtf8(m_producer.get("resource"));
-    if (result == "<producer>" && m_producer.get("mlt_service"))
-        result = QString::fromUtf8(m_producer.get("mlt_service"));
-    return result;
-}
-
-QString QmlProducer::name()
-{
-    return Util::producerTitle(m_producer);
-}
-
 QVariant QmlProducer::audioLevels()
 {
     if (!m_producer.is_valid()) return QVariant();
@@ -95,39 +122,6 @@ QVariant QmlProducer::audioLevels()
         return QVariant();
 }
 
-int QmlProducer::fadeIn()
-{
-    if (!m_producer.is_valid()) return 0;
-    QScopedPointer<Mlt::Filter> filter(MLT.getFilter("fadeInVolume", &m_producer));
-    if (!filter || !filter->is_valid())
-        filter.reset(MLT.getFilter("fadeInBrightness", &m_producer));
-    if (!filter || !filter->is_valid())
-        filter.reset(MLT.getFilter("fadeInMovit", &m_producer));
-    return (filter && filter->is_valid())? filter->get_length() : 0;
-}
-
-int QmlProducer::fadeOut()
-{
-    if (!m_producer.is_valid()) return 0;
-    QScopedPointer<Mlt::Filter> filter(MLT.getFilter("fadeOutVolume", &m_producer));
-    if (!filter || !filter->is_valid())
-        filter.reset(MLT.getFilter("fadeOutBrightness", &m_producer));
-    if (!filter || !filter->is_valid())
-        filter.reset(MLT.getFilter("fadeOutMovit", &m_producer));
-    return (filter && filter->is_valid())? filter->get_length() : 0;
-}
-
-double QmlProducer::speed()
-{
-    double result = 1.0;
-    if (!m_producer.is_valid()) return result;
-    if (m_producer.is_valid()) {
-        if (!qstrcmp("timewarp", m_producer.get("mlt_service")))
-            result = m_producer.get_double("warp_speed");
-    }
-    return result;
-}
-
 void QmlProducer::setPosition(int position)
 {
     if (!m_producer.is_valid()) return;
@@ -168,19 +162,6 @@ void QmlProducer::remakeAudioLevels(bool isKeyframesVisible)
         AudioLevelsTask::start(m_producer, this, QModelIndex());
 }
 
-double QmlProducer::displayAspectRatio()
-{
-    if (m_producer.is_valid() && m_producer.get(kHeightProperty)) {
-        double sar = 1.0;
-        if (m_producer.get(kAspectDenProperty)) {
-            sar = m_producer.get_double(kAspectNumProperty) /
-                  m_producer.get_double(kAspectDenProperty);
-        }
-        return sar * m_producer.get_double(kWidthProperty) / m_producer.get_double(kHeightProperty);
-    }
-    return MLT.profile().dar();
-}
-
 QString QmlProducer::get(QString name, int position)
 {
     if (m_producer.is_valid()) {
@@ -232,6 +213,7 @@ QRectF QmlProducer::getRect(QString name, int position)
 void QmlProducer::setProducer(Mlt::Producer& producer)
 {
     m_producer = producer;
+    updateSnapshot();
     if (m_producer.is_valid())
         remakeAudioLevels(MAIN.keyframesDockIsVisible());
     emit producerChanged();
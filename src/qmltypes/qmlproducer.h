@@ -49,23 +49,23 @@ public:
 
     int in();
     int out();
-    double aspectRatio();
+    double aspectRatio() { return m_aspectRatio; }
     int duration() { return m_producer.is_valid()? out() - in() + 1 : 0; }
-    QString resource();
-    QString mlt_service() { return m_producer.is_valid()? m_producer.get("mlt_service") : QString(); }
-    QString hash() { return m_producer.is_valid()? m_producer.get(kShotcutHashProperty) : QString(); }
-    QString name();
+    QString resource() { return m_resource; }
+    QString mlt_service() { return m_service; }
+    QString hash() { return m_hash; }
+    QString name() { return m_name; }
     QVariant audioLevels();
-    int fadeIn();
-    int fadeOut();
-    double speed();
+    int fadeIn() { return m_fadeIn; }
+    int fadeOut() { return m_fadeOut; }
+    double speed() { return m_speed; }
     int position() const { return m_position; }
     void setPosition(int position);
     void seek(int position);
     Mlt::Producer& producer() { return m_producer; }
     Q_INVOKABLE void audioLevelsReady(const QModelIndex &index);
     Q_INVOKABLE void remakeAudioLevels();
-    double displayAspectRatio();
+    double displayAspectRatio() { return m_displayAspectRatio; }
     Q_INVOKABLE QString get(QString name, int position = -1);
     Q_INVOKABLE double getDouble(QString name, int position = -1);
     Q_INVOKABLE QRectF getRect(QString name, int position = -1);
@@ -86,6 +86,20 @@ public slots:
 private:
     Mlt::Producer m_producer;
     int m_position;
+    // Snapshot of everything bound through NOTIFY producerChanged, taken in
+    // one pass over the producer in setProducer() so each QML binding
+    // evaluation reads a plain member instead of locking the properties.
+    double m_aspectRatio;
+    double m_displayAspectRatio;
+    QString m_resource;
+    QString m_service;
+    QString m_hash;
+    QString m_name;
+    int m_fadeIn;
+    int m_fadeOut;
+    double m_speed;
+
+    void updateSnapshot();
 };
 
 #endif // QMLPRODUCER_H
@@ -28,6 +28,7 @@
 #include "qmltypes/timelineitems.h"
 #include "qmltypes/webvfxtemplatesmodel.h"
 #include "settings.h"
+#include "startuptracer.h"
 #include "models/metadatamodel.h"
 #include "models/keyframesmodel.h"
 #include <QCoreApplication>
@@ -88,16 +89,26 @@ QDir QmlUtilities::qmlDir()
 QQmlEngine * QmlUtilities::sharedEngine()
 {
     static QQmlEngine * s_engine = 0;
-    if (!s_engine)
+    if (!s_engine) {
+        StartupPhase phase("QML engine creation");
         s_engine = new QQmlEngine;
+        // Cached gallery posters for the WebVfx filter's template list.
+        s_engine->addImageProvider(QString("webvfxposter"), new WebvfxPosterProvider);
+    }
     return s_engine;
 }
 
 QUrl QmlUtilities::blankVui()
 {
-    QDir dir = qmlDir();
-    dir.cd("modules");
-    dir.cd("Shotcut");
-    dir.cd("Controls");
-    return QUrl::fromLocalFile(dir.absoluteFilePath("VuiBase.qml"));
+    // Cached: this is compared against the current source on every displayed
+    // frame and every mouse move over the player.
+    static QUrl url;
+    if (url.isEmpty()) {
+        QDir dir = qmlDir();
+        dir.cd("modules");
+        dir.cd("Shotcut");
+        dir.cd("Controls");
+        url = QUrl::fromLocalFile(dir.absoluteFilePath("VuiBase.qml"));
+    }
+    return url;
 }
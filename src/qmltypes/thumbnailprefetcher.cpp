@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "thumbnailprefetcher.h"
+#include "thumbnailprovider.h"
+#include "models/multitrackmodel.h"
+#include "settings.h"
+#include <QRunnable>
+#include <QThreadPool>
+
+// Minimum interval between scans; scrolling emits contentX changes per frame.
+static const int kScrollScanIntervalMs = 150;
+// Cap on remembered ids so the set does not grow without bound on very
+// long sessions; the thumbnail caches make a re-warm after a clear cheap.
+static const int kMaxWarmedIds = 2000;
+
+class ThumbnailPrefetchJob : public QRunnable
+{
+public:
+    ThumbnailPrefetchJob(ThumbnailProvider* provider, const QString& id)
+        : QRunnable()
+        , m_provider(provider)
+        , m_id(id)
+    {
+    }
+
+    void run()
+    {
+        // Generates the thumbnail and populates the caches exactly as the
+        // QML image request will; an empty requested size matches the
+        // timeline's request so the cache key is identical.
+        QSize size;
+        m_provider->requestImage(m_id, &size, QSize());
+    }
+
+private:
+    ThumbnailProvider* m_provider;
+    QString m_id;
+};
+
+ThumbnailPrefetcher::ThumbnailPrefetcher(ThumbnailProvider* provider, MultitrackModel* model,
+                                         QObject* parent)
+    : QObject(parent)
+    , m_provider(provider)
+    , m_model(model)
+    , m_lastContentX(0.0)
+{
+}
+
+void ThumbnailPrefetcher::onScrolled(qreal contentX, qreal viewportWidth, qreal scaleFactor)
+{
+    if (!Settings.timelineShowThumbnails() || scaleFactor <= 0.0 || viewportWidth <= 0.0)
+        return;
+    if (m_scrollTimer.isValid() && m_scrollTimer.elapsed() < kScrollScanIntervalMs) {
+        return;
+    }
+
+    // Estimate scroll velocity in pixels per second from the previous scan.
+    qreal velocity = 0.0;
+    if (m_scrollTimer.isValid() && m_scrollTimer.elapsed() > 0)
+        velocity = (contentX - m_lastContentX) * 1000.0 / m_scrollTimer.elapsed();
+    m_scrollTimer.restart();
+    m_lastContentX = contentX;
+
+    // Warm at least one viewport beyond the edge being scrolled toward,
+    // further when flinging fast.
+    qreal lookahead = viewportWidth + qMin(qAbs(velocity) * 0.5, viewportWidth * 3.0);
+    qreal beginX, endX;
+    if (velocity >= 0.0) {
+        beginX = contentX + viewportWidth;
+        endX = beginX + lookahead;
+    } else {
+        endX = contentX;
+        beginX = endX - lookahead;
+    }
+    int beginFrame = qMax(qRound(beginX / scaleFactor), 0);
+    int endFrame = qMax(qRound(endX / scaleFactor), 0);
+    if (endFrame <= beginFrame)
+        return;
+
+    int trackCount = m_model->rowCount();
+    for (int trackIndex = 0; trackIndex < trackCount; trackIndex++) {
+        QModelIndex trackModelIndex = m_model->index(trackIndex);
+        if (m_model->data(trackModelIndex, MultitrackModel::IsAudioRole).toBool())
+            continue;
+        int clipCount = m_model->rowCount(trackModelIndex);
+        for (int clipIndex = 0; clipIndex < clipCount; clipIndex++) {
+            QModelIndex index = m_model->makeIndex(trackIndex, clipIndex);
+            int start = m_model->data(index, MultitrackModel::StartRole).toInt();
+            int duration = m_model->data(index, MultitrackModel::DurationRole).toInt();
+            if (start + duration < beginFrame || start > endFrame)
+                continue;
+            if (m_model->data(index, MultitrackModel::IsBlankRole).toBool()
+                    || m_model->data(index, MultitrackModel::IsTransitionRole).toBool())
+                continue;
+            QString service = m_model->data(index, MultitrackModel::ServiceRole).toString();
+            QString resource = m_model->data(index, MultitrackModel::ResourceRole).toString();
+            QString hash = m_model->data(index, MultitrackModel::FileHashRole).toString();
+            int inPoint = m_model->data(index, MultitrackModel::InPointRole).toInt();
+            int outPoint = m_model->data(index, MultitrackModel::OutPointRole).toInt();
+
+            // Same id format the timeline Clip.qml builds for its Images.
+            QString idBase = hash + '/' + service + '/' + resource + '#';
+            // Nearest clips get the highest thread pool priority.
+            int distance = (velocity >= 0.0)? qAbs(start - beginFrame) : qAbs(start + duration - endFrame);
+            warm(idBase + QString::number(inPoint), -distance);
+            warm(idBase + QString::number(outPoint), -distance);
+        }
+    }
+}
+
+void ThumbnailPrefetcher::warm(const QString& id, int priority)
+{
+    if (m_warmed.contains(id))
+        return;
+    if (m_warmed.size() >= kMaxWarmedIds)
+        m_warmed.clear();
+    m_warmed.insert(id);
+    QThreadPool::globalInstance()->start(new ThumbnailPrefetchJob(m_provider, id), priority);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THUMBNAILPREFETCHER_H
+#define THUMBNAILPREFETCHER_H
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QElapsedTimer>
+
+class MultitrackModel;
+class ThumbnailProvider;
+
+/*!
+  \class ThumbnailPrefetcher
+  \brief Warms timeline thumbnails for clips about to scroll into view.
+
+  The timeline requests thumbnails on demand when QML asks the image
+  provider, which shows placeholder frames while scrolling until each
+  one is generated. ThumbnailPrefetcher watches the timeline scroll
+  position, estimates the scroll velocity, and generates thumbnails for
+  clips just beyond the viewport edge on the global thread pool,
+  nearest clips first, so they are already cached when QML requests
+  them.
+*/
+class ThumbnailPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ThumbnailPrefetcher(ThumbnailProvider* provider, MultitrackModel* model,
+                                 QObject* parent = 0);
+
+public slots:
+    //! Called with the timeline scroll offset, viewport width, and pixels-per-frame.
+    void onScrolled(qreal contentX, qreal viewportWidth, qreal scaleFactor);
+
+private:
+    void warm(const QString& id, int priority);
+
+    ThumbnailProvider* m_provider;
+    MultitrackModel* m_model;
+    qreal m_lastContentX;
+    QElapsedTimer m_scrollTimer;
+    QSet<QString> m_warmed;
+};
+
+#endif // THUMBNAILPREFETCHER_H
@@ -18,9 +18,14 @@
 #include "thumbnailprovider.h"
 #include <QQuickImageProvider>
 #include <QCryptographicHash>
+#include <QtConcurrent/QtConcurrent>
 #include "mltcontroller.h"
 #include "models/playlistmodel.h"
 #include "database.h"
+#include "producercache.h"
+#include "util.h"
+#include "perflog.h"
+#include "taskpool.h"
 
 #include <Logger.h>
 
@@ -28,6 +33,16 @@ ThumbnailProvider::ThumbnailProvider()
     : QQuickImageProvider(QQmlImageProviderBase::Image, QQmlImageProviderBase::ForceAsynchronousImageLoading)
     , m_profile("atsc_720p_60")
 {
+#if LIBMLT_VERSION_INT >= MLT_VERSION_PREVIEW_SCALE
+    // Producers normalize to the profile resolution, so shrink this
+    // profile to a few times the thumbnail size. With preview scaling
+    // support, avformat then scales a 4K source down once near the
+    // decoder instead of handing full frames to the per-request software
+    // scaler; the attached swscale filter still handles the exact fit.
+    m_profile.set_width(Util::coerceMultiple(PlaylistModel::THUMBNAIL_WIDTH * 4));
+    m_profile.set_height(Util::coerceMultiple(PlaylistModel::THUMBNAIL_HEIGHT * 4));
+    m_profile.set_explicit(1);
+#endif
 }
 
 QImage ThumbnailProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
@@ -56,18 +71,34 @@ QImage ThumbnailProvider::requestImage(const QString &id, QSize *size, const QSi
         properties.set("_profile", m_profile.get_profile(), 0);
 
         QString key = cacheKey(properties, service, resource, hash, frameNumber);
-        result = DB.getThumbnail(key);
-        if (force || result.isNull()) {
-            if (service == "avformat-novalidate")
-                service = "avformat";
-            else if (service.startsWith("xml"))
-                service = "xml-nogl";
-            Mlt::Producer producer(m_profile, service.toUtf8().constData(), resource.toUtf8().constData());
-            if (producer.is_valid()) {
-                result = makeThumbnail(producer, frameNumber, requestedSize);
-                DB.putThumbnail(key, result);
+
+        // Share one render among concurrent requests for the same key. Five
+        // timeline delegates asking for the same clip head thumbnail attach
+        // to one in-flight future and the MLT work happens once, on the
+        // bounded pool.
+        QFuture<QImage> future;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (!force && m_inFlight.contains(key)) {
+                future = m_inFlight.value(key);
+            } else {
+                // The shared pool bounds how many decoders a burst of
+                // requests can open and keeps thumbnails ahead of bulk
+                // work like audio level generation.
+                const int epoch = TaskPool::singleton().currentEpoch();
+                future = QtConcurrent::run(TaskPool::singleton().pool(), [=]() {
+                    return render(service, resource, key, frameNumber, requestedSize, force, epoch);
+                });
+                m_inFlight.insert(key, future);
             }
         }
+        result = future.result();
+        {
+            QMutexLocker locker(&m_mutex);
+            // Only remove our own entry; a forced request may have replaced it.
+            if (m_inFlight.value(key) == future)
+                m_inFlight.remove(key);
+        }
     }
     if (result.isNull()) {
         result = QImage(1, 1, QImage::Format_Alpha8);
@@ -78,6 +109,48 @@ QImage ThumbnailProvider::requestImage(const QString &id, QSize *size, const QSi
     return result;
 }
 
+QImage ThumbnailProvider::render(const QString& service, const QString& resource,
+                                 const QString& key, int frameNumber,
+                                 const QSize& requestedSize, bool force, int epoch)
+{
+    // The epoch was captured when the request entered the queue and goes
+    // stale when the project closes; skip the render and let the delegate
+    // re-request if it still wants the image.
+    if (TaskPool::singleton().isStale(epoch))
+        return QImage();
+    QImage result = DB.getThumbnail(key);
+    if (force || result.isNull()) {
+        PerfLog::count("thumbnail.render");
+        QString myService = service;
+        if (myService == "avformat-novalidate")
+            myService = "avformat";
+        else if (myService.startsWith("xml"))
+            myService = "xml-nogl";
+        // Reuse an opened handle for this clip when one is pooled so a
+        // burst of requests pays one demuxer probe, not one per frame.
+        QString producerKey = QString("thumbnail %1 %2").arg(myService).arg(resource);
+        Mlt::Producer* producer = ProducerCache::singleton().acquire(producerKey, [&]() {
+            Mlt::Producer* p = new Mlt::Producer(m_profile, myService.toUtf8().constData(),
+                                                 resource.toUtf8().constData());
+            if (p->is_valid()) {
+                Mlt::Filter scaler(m_profile, "swscale");
+                Mlt::Filter padder(m_profile, "resize");
+                Mlt::Filter converter(m_profile, "avcolor_space");
+                p->attach(scaler);
+                p->attach(padder);
+                p->attach(converter);
+            }
+            return p;
+        });
+        if (producer->is_valid()) {
+            result = makeThumbnail(*producer, frameNumber, requestedSize);
+            DB.putThumbnail(key, result);
+        }
+        ProducerCache::singleton().release(producerKey, producer);
+    }
+    return result;
+}
+
 QString ThumbnailProvider::cacheKey(Mlt::Properties& properties, const QString& service,
                                     const QString& resource, const QString& hash, int frameNumber)
 {
@@ -102,9 +175,8 @@ QString ThumbnailProvider::cacheKey(Mlt::Properties& properties, const QString&
 
 QImage ThumbnailProvider::makeThumbnail(Mlt::Producer &producer, int frameNumber, const QSize& requestedSize)
 {
-    Mlt::Filter scaler(m_profile, "swscale");
-    Mlt::Filter padder(m_profile, "resize");
-    Mlt::Filter converter(m_profile, "avcolor_space");
+    // The scaler, padder, and converter filters are attached once when the
+    // producer is created for the pool.
     int height = PlaylistModel::THUMBNAIL_HEIGHT * 2;
     int width = PlaylistModel::THUMBNAIL_WIDTH * 2;
 
@@ -113,8 +185,5 @@ QImage ThumbnailProvider::makeThumbnail(Mlt::Producer &producer, int frameNumber
         height = requestedSize.height();
     }
 
-    producer.attach(scaler);
-    producer.attach(padder);
-    producer.attach(converter);
     return MLT.image(producer, frameNumber, width, height);
 }
@@ -20,6 +20,9 @@
 #define THUMBNAILPROVIDER_H
 
 #include <QQuickImageProvider>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
 #include <MltProducer.h>
 #include <MltProfile.h>
 
@@ -32,8 +35,16 @@ public:
 private:
     QString cacheKey(Mlt::Properties& properties, const QString& service,
                      const QString& resource, const QString& hash, int frameNumber);
+    //! \a epoch is the TaskPool epoch captured when the request was queued;
+    //! a stale epoch aborts the render before it opens a decoder.
+    QImage render(const QString& service, const QString& resource, const QString& key,
+                  int frameNumber, const QSize& requestedSize, bool force, int epoch);
     QImage makeThumbnail(Mlt::Producer&, int frameNumber, const QSize& requestedSize);
     Mlt::Profile m_profile;
+    // Rendering runs on the shared TaskPool; concurrent requests for the
+    // same cache key share the in-flight future instead of racing.
+    QMutex m_mutex;
+    QHash<QString, QFuture<QImage> > m_inFlight;
 };
 
 #endif // THUMBNAILPROVIDER_H
@@ -23,6 +23,11 @@
 #include <QPalette>
 #include <QPainterPath>
 #include <QLinearGradient>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <QVariantMap>
+#include <QVector>
 
 class TimelineTransition : public QQuickPaintedItem
 {
@@ -89,10 +94,14 @@ public:
     }
 };
 
-class TimelineWaveform : public QQuickPaintedItem
+// Renders the waveform as scene graph geometry - a triangle strip for the
+// fill and a line strip for the outline - instead of CPU-rasterizing a
+// QPainterPath into a texture per item per change. Panning a timeline with
+// many tracks then only re-uploads small vertex buffers.
+class TimelineWaveform : public QQuickItem
 {
     Q_OBJECT
-    Q_PROPERTY(QVariant levels MEMBER m_audioLevels NOTIFY propertyChanged)
+    Q_PROPERTY(QVariant levels READ levels WRITE setLevels NOTIFY propertyChanged)
     Q_PROPERTY(QColor fillColor MEMBER m_color NOTIFY propertyChanged)
     Q_PROPERTY(int inPoint MEMBER m_inPoint NOTIFY inPointChanged)
     Q_PROPERTY(int outPoint MEMBER m_outPoint NOTIFY outPointChanged)
@@ -100,15 +109,37 @@ class TimelineWaveform : public QQuickPaintedItem
 public:
     TimelineWaveform()
     {
-        setAntialiasing(QPainter::Antialiasing);
+        setFlag(ItemHasContents, true);
         connect(this, SIGNAL(propertyChanged()), this, SLOT(update()));
+        connect(this, SIGNAL(inPointChanged()), this, SLOT(update()));
+        connect(this, SIGNAL(outPointChanged()), this, SLOT(update()));
     }
 
-    void paint(QPainter *painter)
+    QVariant levels() const
     {
-        QVariantList data = m_audioLevels.toList();
-        if (data.isEmpty())
-            return;
+        return m_audioLevels;
+    }
+
+    void setLevels(const QVariant& levels)
+    {
+        m_audioLevels = levels;
+        buildLods();
+        emit propertyChanged();
+    }
+
+protected:
+    void geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry)
+    {
+        QQuickItem::geometryChanged(newGeometry, oldGeometry);
+        update();
+    }
+
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
+    {
+        if (m_lods.isEmpty() || width() <= 0.0 || height() <= 0.0) {
+            delete oldNode;
+            return nullptr;
+        }
 
         // In and out points are # frames at current fps,
         // but audio levels are created at 25 fps.
@@ -117,23 +148,82 @@ public:
         const int outPoint = qRound(m_outPoint / MLT.profile().fps() * 25.0);
         const qreal indicesPrPixel = qreal(outPoint - inPoint) / width();
 
-        QPainterPath path;
-        path.moveTo(-1, height());
-        int i = 0;
-        for (; i < width(); ++i)
-        {
-            int idx = inPoint + int(i * indicesPrPixel);
-            if (idx + 1 >= data.length())
+        // Pick the coarsest mip level that still has at least two samples
+        // per pixel, so a zoomed-out track reads a few hundred values
+        // instead of every frame's level.
+        int lod = 0;
+        while (lod + 1 < m_lods.size() && indicesPrPixel / (1 << (lod + 1)) >= 2.0)
+            ++lod;
+        const QVector<qreal>& data = m_lods.at(lod);
+        const qreal lodIndicesPrPixel = indicesPrPixel / (1 << lod);
+        const int lodInPoint = inPoint >> lod;
+
+        // One column of the waveform per pixel of width.
+        QVector<float> tops;
+        tops.reserve(int(width()));
+        for (int i = 0; i < width(); ++i) {
+            int idx = lodInPoint + int(i * lodIndicesPrPixel);
+            if (idx + 1 >= data.size())
                 break;
-            qreal level = qMax(data.at(idx).toReal(), data.at(idx + 1).toReal()) / 256;
-            path.lineTo(i, height() - level * height());
+            qreal level = qMax(data.at(idx), data.at(idx + 1)) / 256;
+            tops << float(height() - level * height());
+        }
+        if (tops.isEmpty()) {
+            delete oldNode;
+            return nullptr;
         }
-        path.lineTo(i, height());
-        painter->fillPath(path, m_color.lighter());
 
-        QPen pen(painter->pen());
-        pen.setColor(m_color.darker());
-        painter->strokePath(path, pen);
+        QSGNode* node = oldNode;
+        QSGGeometryNode* fillNode;
+        QSGGeometryNode* strokeNode;
+        if (!node) {
+            node = new QSGNode;
+
+            fillNode = new QSGGeometryNode;
+            QSGGeometry* fill = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+            fill->setDrawingMode(QSGGeometry::DrawTriangleStrip);
+            fillNode->setGeometry(fill);
+            fillNode->setFlag(QSGNode::OwnsGeometry);
+            fillNode->setMaterial(new QSGFlatColorMaterial);
+            fillNode->setFlag(QSGNode::OwnsMaterial);
+            node->appendChildNode(fillNode);
+
+            strokeNode = new QSGGeometryNode;
+            QSGGeometry* stroke = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+            stroke->setDrawingMode(QSGGeometry::DrawLineStrip);
+            stroke->setLineWidth(1);
+            strokeNode->setGeometry(stroke);
+            strokeNode->setFlag(QSGNode::OwnsGeometry);
+            strokeNode->setMaterial(new QSGFlatColorMaterial);
+            strokeNode->setFlag(QSGNode::OwnsMaterial);
+            node->appendChildNode(strokeNode);
+        } else {
+            fillNode = static_cast<QSGGeometryNode*>(node->firstChild());
+            strokeNode = static_cast<QSGGeometryNode*>(fillNode->nextSibling());
+        }
+
+        const int n = tops.size();
+        QSGGeometry* fill = fillNode->geometry();
+        fill->allocate(2 * n);
+        QSGGeometry::Point2D* v = fill->vertexDataAsPoint2D();
+        for (int i = 0; i < n; ++i) {
+            v[2 * i].set(i, height());
+            v[2 * i + 1].set(i, tops.at(i));
+        }
+        static_cast<QSGFlatColorMaterial*>(fillNode->material())->setColor(m_color.lighter());
+        fillNode->markDirty(QSGNode::DirtyGeometry | QSGNode::DirtyMaterial);
+
+        QSGGeometry* stroke = strokeNode->geometry();
+        stroke->allocate(n + 2);
+        v = stroke->vertexDataAsPoint2D();
+        v[0].set(0, height());
+        for (int i = 0; i < n; ++i)
+            v[i + 1].set(i, tops.at(i));
+        v[n + 1].set(n - 1, height());
+        static_cast<QSGFlatColorMaterial*>(strokeNode->material())->setColor(m_color.darker());
+        strokeNode->markDirty(QSGNode::DirtyGeometry | QSGNode::DirtyMaterial);
+
+        return node;
     }
 
 signals:
@@ -142,18 +232,193 @@ signals:
     void outPointChanged();
 
 private:
+    void buildLods()
+    {
+        // m_lods[0] is the levels list converted out of QVariants once
+        // instead of on every repaint; each next level halves the sample
+        // count keeping the peak of each pair so zoomed-out rendering
+        // does not miss transients.
+        m_lods.clear();
+        const QVariantList data = m_audioLevels.toList();
+        if (data.isEmpty())
+            return;
+        QVector<qreal> base;
+        base.reserve(data.size());
+        foreach (const QVariant& level, data)
+            base << level.toReal();
+        m_lods << base;
+        while (m_lods.last().size() > 512) {
+            const QVector<qreal>& prev = m_lods.last();
+            QVector<qreal> next;
+            next.reserve((prev.size() + 1) / 2);
+            for (int i = 0; i < prev.size(); i += 2)
+                next << ((i + 1 < prev.size())? qMax(prev.at(i), prev.at(i + 1)) : prev.at(i));
+            m_lods << next;
+        }
+    }
+
     QVariant m_audioLevels;
+    QVector<QVector<qreal> > m_lods;
     int m_inPoint;
     int m_outPoint;
     QColor m_color;
 };
 
+// Draws every clip body of a track - the vertical gradient fill and the
+// black border - as two geometry batches sharing one vertex-color material
+// each, instead of one Rectangle node with its own gradient and border per
+// clip. A project with many tracks then costs a couple of draw calls per
+// track when panning rather than thousands overall. Clips that need
+// distinct visuals - selected, dragging, blank, transition - opt out in
+// QML and draw themselves as sparse overlays on top of the batch.
+class TimelineClipStrip : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariant clips READ clips WRITE setClips NOTIFY clipsChanged)
+
+public:
+    TimelineClipStrip()
+    {
+        setFlag(ItemHasContents, true);
+        connect(this, SIGNAL(clipsChanged()), this, SLOT(update()));
+    }
+
+    QVariant clips() const
+    {
+        return m_clips;
+    }
+
+    void setClips(const QVariant& clips)
+    {
+        m_bodies.clear();
+        foreach (const QVariant& entry, clips.toList()) {
+            const QVariantMap map = entry.toMap();
+            Body body;
+            body.x = float(map.value("x").toReal());
+            body.width = float(map.value("width").toReal());
+            const QVariant color = map.value("color");
+            body.color = color.value<QColor>();
+            if (!body.color.isValid())
+                body.color = QColor(color.toString());
+            if (body.width > 0.0f && body.color.isValid())
+                m_bodies << body;
+        }
+        m_clips = clips;
+        emit clipsChanged();
+    }
+
+protected:
+    void geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry)
+    {
+        QQuickItem::geometryChanged(newGeometry, oldGeometry);
+        update();
+    }
+
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
+    {
+        if (m_bodies.isEmpty() || height() <= 0.0) {
+            delete oldNode;
+            return nullptr;
+        }
+
+        QSGNode* node = oldNode;
+        QSGGeometryNode* fillNode;
+        QSGGeometryNode* borderNode;
+        if (!node) {
+            node = new QSGNode;
+
+            fillNode = new QSGGeometryNode;
+            QSGGeometry* fill = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+            fill->setDrawingMode(QSGGeometry::DrawTriangles);
+            fillNode->setGeometry(fill);
+            fillNode->setFlag(QSGNode::OwnsGeometry);
+            fillNode->setMaterial(new QSGVertexColorMaterial);
+            fillNode->setFlag(QSGNode::OwnsMaterial);
+            node->appendChildNode(fillNode);
+
+            borderNode = new QSGGeometryNode;
+            QSGGeometry* border = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+            border->setDrawingMode(QSGGeometry::DrawLines);
+            border->setLineWidth(1);
+            borderNode->setGeometry(border);
+            borderNode->setFlag(QSGNode::OwnsGeometry);
+            borderNode->setMaterial(new QSGVertexColorMaterial);
+            borderNode->setFlag(QSGNode::OwnsMaterial);
+            node->appendChildNode(borderNode);
+        } else {
+            fillNode = static_cast<QSGGeometryNode*>(node->firstChild());
+            borderNode = static_cast<QSGGeometryNode*>(fillNode->nextSibling());
+        }
+
+        const int n = m_bodies.size();
+        const float h = float(height());
+
+        // Two triangles per body; the top row of vertices carries the
+        // lighter color so interpolation reproduces the Rectangle's
+        // vertical gradient.
+        QSGGeometry* fill = fillNode->geometry();
+        fill->allocate(6 * n);
+        QSGGeometry::ColoredPoint2D* v = fill->vertexDataAsColoredPoint2D();
+        for (int i = 0; i < n; ++i) {
+            const Body& body = m_bodies.at(i);
+            const QColor top = body.color.lighter();
+            const QColor& bottom = body.color;
+            const float x0 = body.x;
+            const float x1 = body.x + body.width;
+            v[6 * i + 0].set(x0, 0, top.red(), top.green(), top.blue(), top.alpha());
+            v[6 * i + 1].set(x1, 0, top.red(), top.green(), top.blue(), top.alpha());
+            v[6 * i + 2].set(x0, h, bottom.red(), bottom.green(), bottom.blue(), bottom.alpha());
+            v[6 * i + 3].set(x1, 0, top.red(), top.green(), top.blue(), top.alpha());
+            v[6 * i + 4].set(x1, h, bottom.red(), bottom.green(), bottom.blue(), bottom.alpha());
+            v[6 * i + 5].set(x0, h, bottom.red(), bottom.green(), bottom.blue(), bottom.alpha());
+        }
+        fillNode->markDirty(QSGNode::DirtyGeometry);
+
+        // Four lines per body, inset half a pixel so they rasterize crisp.
+        QSGGeometry* border = borderNode->geometry();
+        border->allocate(8 * n);
+        v = border->vertexDataAsColoredPoint2D();
+        for (int i = 0; i < n; ++i) {
+            const Body& body = m_bodies.at(i);
+            const float x0 = body.x + 0.5f;
+            const float x1 = body.x + body.width - 0.5f;
+            const float y0 = 0.5f;
+            const float y1 = h - 0.5f;
+            v[8 * i + 0].set(x0, y0, 0, 0, 0, 255);
+            v[8 * i + 1].set(x1, y0, 0, 0, 0, 255);
+            v[8 * i + 2].set(x1, y0, 0, 0, 0, 255);
+            v[8 * i + 3].set(x1, y1, 0, 0, 0, 255);
+            v[8 * i + 4].set(x1, y1, 0, 0, 0, 255);
+            v[8 * i + 5].set(x0, y1, 0, 0, 0, 255);
+            v[8 * i + 6].set(x0, y1, 0, 0, 0, 255);
+            v[8 * i + 7].set(x0, y0, 0, 0, 0, 255);
+        }
+        borderNode->markDirty(QSGNode::DirtyGeometry);
+
+        return node;
+    }
+
+signals:
+    void clipsChanged();
+
+private:
+    struct Body {
+        float x;
+        float width;
+        QColor color;
+    };
+
+    QVariant m_clips;
+    QVector<Body> m_bodies;
+};
+
 void registerTimelineItems()
 {
     qmlRegisterType<TimelineTransition>("Shotcut.Controls", 1, 0, "TimelineTransition");
     qmlRegisterType<TimelinePlayhead>("Shotcut.Controls", 1, 0, "TimelinePlayhead");
     qmlRegisterType<TimelineTriangle>("Shotcut.Controls", 1, 0, "TimelineTriangle");
     qmlRegisterType<TimelineWaveform>("Shotcut.Controls", 1, 0, "TimelineWaveform");
+    qmlRegisterType<TimelineClipStrip>("Shotcut.Controls", 1, 0, "TimelineClipStrip");
 }
 
 #include "timelineitems.moc"
@@ -18,9 +18,15 @@
 #include "webvfxtemplatesmodel.h"
 #include "qmlutilities.h"
 #include "mltcontroller.h"
+#include "database.h"
+#include "models/playlistmodel.h"
 #include <Logger.h>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QUrl>
 
 WebvfxTemplatesModel::WebvfxTemplatesModel(QObject *parent)
     : QAbstractListModel(parent)
@@ -68,6 +74,9 @@ QVariant WebvfxTemplatesModel::data(const QModelIndex& index, int role) const
             break;
         case PathRole:
             return dir.path();
+        case PosterRole:
+            return QString("image://webvfxposter/")
+                    + QString::fromUtf8(QUrl::toPercentEncoding(dir.path()));
         default:
             break;
         }
@@ -87,6 +96,7 @@ QHash<int, QByteArray> WebvfxTemplatesModel::roleNames() const
      result[PathRole] = "path";
      result[ProtocolRole] = "protocol";
      result[CategoryRole] = "category";
+     result[PosterRole] = "poster";
      return result;
 }
 
@@ -136,6 +146,64 @@ QString WebvfxTemplatesModel::copyTemplate(int row, QString path) const
     return result;
 }
 
+WebvfxPosterProvider::WebvfxPosterProvider()
+    : QQuickImageProvider(QQmlImageProviderBase::Image, QQmlImageProviderBase::ForceAsynchronousImageLoading)
+    , m_profile("atsc_720p_60")
+{
+}
+
+QImage WebvfxPosterProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    QImage result;
+
+    // id is the percent-encoded template folder.
+    QDir templateDir(QUrl::fromPercentEncoding(id.toUtf8()));
+    QString htmlFileName;
+    foreach (QString fileName, templateDir.entryList(QDir::Files | QDir::Readable | QDir::NoDotAndDotDot)) {
+        if (fileName.endsWith(".html") || fileName.endsWith(".htm")) {
+            htmlFileName = templateDir.filePath(fileName);
+            break;
+        }
+    }
+    if (!htmlFileName.isEmpty()) {
+        // Key on the modification time so editing a template (or shipping a
+        // new version) invalidates its poster.
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(QString("webvfx-poster %1 %2").arg(htmlFileName)
+                     .arg(QFileInfo(htmlFileName).lastModified().toMSecsSinceEpoch()).toUtf8());
+        QString key = hash.result().toHex();
+        result = DB.getThumbnail(key);
+        if (result.isNull()) {
+            // Templates under the "plain" protocol are loaded without the
+            // WebVfx JavaScript extension, same as the filter does.
+            QString resource = htmlFileName;
+            QDir protocolDir(templateDir);
+            if (protocolDir.cdUp() && protocolDir.cdUp() && protocolDir.dirName() == "plain")
+                resource.prepend("plain:");
+            Mlt::Producer producer(m_profile, "webvfx", resource.toUtf8().constData());
+            if (producer.is_valid()) {
+                int width = PlaylistModel::THUMBNAIL_WIDTH * 2;
+                int height = PlaylistModel::THUMBNAIL_HEIGHT * 2;
+                if (!requestedSize.isEmpty()) {
+                    width = requestedSize.width();
+                    height = requestedSize.height();
+                }
+                result = MLT.image(producer, 0, width, height);
+                DB.putThumbnail(key, result);
+            } else {
+                LOG_WARNING() << "failed to open webvfx producer for" << resource;
+            }
+        }
+    }
+    if (result.isNull()) {
+        result = QImage(1, 1, QImage::Format_Alpha8);
+        result.fill(0);
+    }
+    if (size)
+        *size = result.size();
+    return result;
+}
+
 QString WebvfxTemplatesModel::copyTemplate(int row) const
 {
     QString result;
@@ -19,7 +19,9 @@
 #define WEBVFXTEMPLATESMODEL_H
 
 #include <QAbstractListModel>
+#include <QQuickImageProvider>
 #include <QVariant>
+#include <MltProfile.h>
 
 class WebvfxTemplatesModel : public QAbstractListModel
 {
@@ -31,7 +33,8 @@ public:
     enum Roles  {
         PathRole = Qt::UserRole + 1,
         ProtocolRole,
-        CategoryRole
+        CategoryRole,
+        PosterRole
     };
     Q_ENUM(Roles)
 
@@ -47,4 +50,18 @@ private:
     QStringList m_list;
 };
 
+/// Serves the gallery poster images for the "webvfxposter" scheme. Each
+/// template is rendered once through the MLT webvfx producer into the
+/// database thumbnail store; browsing afterwards only reads the cache and
+/// never spawns a web render.
+class WebvfxPosterProvider : public QQuickImageProvider
+{
+public:
+    explicit WebvfxPosterProvider();
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize);
+
+private:
+    Mlt::Profile m_profile;
+};
+
 #endif // WEBVFXTEMPLATESMODEL_H
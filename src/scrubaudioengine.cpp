@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "scrubaudioengine.h"
+#include "shotcut_mlt_properties.h"
+
+#include <QAudioOutput>
+#include <QAudioFormat>
+#include <QIODevice>
+#include <QList>
+#include <Mlt.h>
+#include <Logger.h>
+
+// Enough device buffer for a couple of frames of audio at 60 fps project
+// rates; anything larger makes the scrub feel laggy.
+static const int kBufferMs = 80;
+
+// Upper bound on cached locked-track frames; at 48 kHz stereo 16-bit this
+// is a few tens of megabytes. The whole cache is dropped when full, like
+// a snapshot rebuild, because a scrub revisits a small window anyway.
+static const int kLockedCacheMaxFrames = 4000;
+
+ScrubAudioEngine::ScrubAudioEngine(Mlt::Profile& profile, int frequency, int channels)
+    : QThread(0)
+    , m_profile(profile)
+    , m_frequency(frequency)
+    , m_channels(channels)
+    , m_output(0)
+    , m_device(0)
+    , m_sourceDirty(true)
+    , m_producerStale(true)
+    , m_position(-1)
+{
+    setObjectName("ScrubAudioEngine");
+    moveToThread(this);
+    start();
+}
+
+ScrubAudioEngine::~ScrubAudioEngine()
+{
+    quit();
+    wait();
+    delete m_output;
+}
+
+bool ScrubAudioEngine::needsSource() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_sourceDirty;
+}
+
+void ScrubAudioEngine::setSource(const QString& xml)
+{
+    QMutexLocker locker(&m_mutex);
+    m_xml = xml;
+    m_sourceDirty = false;
+    m_producerStale = true;
+}
+
+void ScrubAudioEngine::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_sourceDirty = true;
+}
+
+void ScrubAudioEngine::scrub(int position)
+{
+    // Latest-wins: processScrub() voices whatever position is current when
+    // it runs, so a fast drag does not queue stale audio.
+    m_position.storeRelease(position);
+    QMetaObject::invokeMethod(this, "processScrub", Qt::QueuedConnection);
+}
+
+void ScrubAudioEngine::processScrub()
+{
+    int position = m_position.fetchAndStoreAcquire(-1);
+    if (position < 0)
+        return; // Already voiced by a previous invocation.
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_xml.isEmpty())
+            return;
+        if (!m_producer || m_producerStale) {
+            m_producer.reset(new Mlt::Producer(m_profile, "xml-string", m_xml.toUtf8().constData()));
+            if (!m_producer->is_valid()) {
+                m_producer.reset();
+                return;
+            }
+            m_producerStale = false;
+            splitLockedTracks();
+        }
+    }
+
+    if (!m_output) {
+        QAudioFormat format;
+        format.setSampleRate(m_frequency);
+        format.setChannelCount(m_channels);
+        format.setSampleSize(16);
+        format.setCodec("audio/pcm");
+        format.setByteOrder(QAudioFormat::LittleEndian);
+        format.setSampleType(QAudioFormat::SignedInt);
+        m_output = new QAudioOutput(format);
+        m_output->setBufferSize(m_frequency * m_channels * 2 * kBufferMs / 1000);
+        m_device = m_output->start();
+        if (!m_device) {
+            LOG_WARNING() << "no audio device for scrub audio";
+            delete m_output;
+            m_output = 0;
+            return;
+        }
+    }
+
+    m_producer->seek(position);
+    QScopedPointer<Mlt::Frame> frame(m_producer->get_frame());
+    if (!frame || !frame->is_valid())
+        return;
+    mlt_audio_format format = mlt_audio_s16;
+    int frequency = m_frequency;
+    int channels = m_channels;
+    int samples = mlt_sample_calculator(m_profile.fps(), m_frequency, position);
+    const int16_t* audio = (int16_t*) frame->get_audio(format, frequency, channels, samples);
+    if (!audio)
+        return;
+    qint64 bytes = qint64(samples) * channels * 2;
+    QByteArray mixed;
+    if (m_lockedProducer) {
+        QByteArray locked = lockedMixdown(position, samples);
+        if (locked.size() == int(bytes)) {
+            // Sum the cached locked mixdown into the live unlocked tracks,
+            // saturating like a mixer.
+            mixed.resize(int(bytes));
+            const int16_t* cached = (const int16_t*) locked.constData();
+            int16_t* mix = (int16_t*) mixed.data();
+            int count = samples * channels;
+            for (int i = 0; i < count; i++)
+                mix[i] = int16_t(qBound(-32768, int(audio[i]) + int(cached[i]), 32767));
+            audio = (const int16_t*) mixed.constData();
+        }
+    }
+    // Drop rather than block when the device buffer is full; the next
+    // request supplies fresher audio anyway.
+    qint64 free = m_output->bytesFree();
+    m_device->write((const char*) audio, qMin(bytes, free));
+}
+
+void ScrubAudioEngine::splitLockedTracks()
+{
+    m_lockedProducer.reset();
+    m_lockedCache.clear();
+    Mlt::Tractor tractor(*m_producer);
+    if (!tractor.is_valid())
+        return; // Scrubbing a clip, not a timeline.
+    QList<int> locked;
+    QList<int> unlocked;
+    for (int i = 0; i < tractor.count(); i++) {
+        QScopedPointer<Mlt::Producer> track(tractor.track(i));
+        if (track && track->is_valid()) {
+            if (track->get_int(kTrackLockProperty))
+                locked << i;
+            else
+                unlocked << i;
+        }
+    }
+    if (locked.isEmpty() || unlocked.isEmpty())
+        return;
+    // Build a second shadow producer voicing only the locked tracks for
+    // the mixdown cache, and silence those tracks in the live producer.
+    QScopedPointer<Mlt::Producer> producer(
+        new Mlt::Producer(m_profile, "xml-string", m_xml.toUtf8().constData()));
+    if (!producer->is_valid())
+        return;
+    Mlt::Tractor lockedTractor(*producer);
+    if (!lockedTractor.is_valid())
+        return;
+    foreach (int i, locked) {
+        QScopedPointer<Mlt::Producer> track(tractor.track(i));
+        track->set("hide", track->get_int("hide") | 2);
+    }
+    foreach (int i, unlocked) {
+        QScopedPointer<Mlt::Producer> track(lockedTractor.track(i));
+        track->set("hide", track->get_int("hide") | 2);
+    }
+    m_lockedProducer.reset(producer.take());
+}
+
+QByteArray ScrubAudioEngine::lockedMixdown(int position, int samples)
+{
+    QHash<int, QByteArray>::const_iterator it = m_lockedCache.constFind(position);
+    if (it != m_lockedCache.constEnd())
+        return it.value();
+    QByteArray result;
+    m_lockedProducer->seek(position);
+    QScopedPointer<Mlt::Frame> frame(m_lockedProducer->get_frame());
+    if (!frame || !frame->is_valid())
+        return result;
+    mlt_audio_format format = mlt_audio_s16;
+    int frequency = m_frequency;
+    int channels = m_channels;
+    const char* audio = (const char*) frame->get_audio(format, frequency, channels, samples);
+    if (!audio)
+        return result;
+    result = QByteArray(audio, samples * channels * 2);
+    if (m_lockedCache.size() >= kLockedCacheMaxFrames)
+        m_lockedCache.clear();
+    m_lockedCache.insert(position, result);
+    return result;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCRUBAUDIOENGINE_H
+#define SCRUBAUDIOENGINE_H
+
+#include <QThread>
+#include <QMutex>
+#include <QString>
+#include <QScopedPointer>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QHash>
+#include <MltProfile.h>
+#include <MltProducer.h>
+
+class QAudioOutput;
+class QIODevice;
+
+/*!
+  \class ScrubAudioEngine
+  \brief Plays tape-style audio while scrubbing without touching the consumer.
+
+  The scrub_audio property on the consumer restarts audio rendering per
+  scrub tick, which stutters on multitrack projects. This engine owns a
+  shadow producer (built from a project XML snapshot on its own thread) and
+  a small QAudioOutput. Each scrub() decodes just the audio of the frame at
+  the playhead into the output's preallocated buffer. Requests are
+  coalesced so a drag only voices frames the device can accept.
+
+  The XML snapshot is marked stale by invalidate() whenever the pipeline
+  changes; the next scrub() rebuilds the shadow producer.
+
+  Locked tracks cannot change, so their audio is split into a second
+  shadow producer and cached per frame as one mixed PCM stream. A scrub
+  pass decodes only the unlocked tracks live and sums in the cached
+  mixdown, cutting the decode cost roughly by the locked fraction of the
+  project. The cache dies with the snapshot, so an unlock or edit
+  rebuilds it.
+*/
+class ScrubAudioEngine : public QThread
+{
+    Q_OBJECT
+public:
+    ScrubAudioEngine(Mlt::Profile& profile, int frequency, int channels);
+    virtual ~ScrubAudioEngine();
+
+    //! Returns true if setSource() must be called before scrubbing.
+    bool needsSource() const;
+    //! Provides a project XML snapshot for the shadow producer.
+    void setSource(const QString& xml);
+    //! Marks the snapshot stale; the producer is rebuilt on the next scrub.
+    void invalidate();
+    //! Requests audio for \a position; latest request wins.
+    void scrub(int position);
+
+private:
+    Q_INVOKABLE void processScrub();
+    void splitLockedTracks();
+    QByteArray lockedMixdown(int position, int samples);
+
+    Mlt::Profile& m_profile;
+    int m_frequency;
+    int m_channels;
+
+    // Worker-thread-only members.
+    QScopedPointer<Mlt::Producer> m_producer;
+    QScopedPointer<Mlt::Producer> m_lockedProducer;
+    QHash<int, QByteArray> m_lockedCache;
+    QAudioOutput* m_output;
+    QIODevice* m_device;
+
+    // Members accessed in multiple threads (mutex protected).
+    mutable QMutex m_mutex;
+    QString m_xml;
+    bool m_sourceDirty;
+    bool m_producerStale;
+    QAtomicInt m_position;
+};
+
+#endif // SCRUBAUDIOENGINE_H
@@ -86,21 +86,21 @@ int ScrubBar::position() const
 void ScrubBar::setInPoint(int in)
 {
     m_in = qMax(in, -1);
-    updatePixmap();
+    composePixmap();
     emit inChanged(in);
 }
 
 void ScrubBar::setOutPoint(int out)
 {
     m_out = qMin(out, m_max);
-    updatePixmap();
+    composePixmap();
     emit outChanged(out);
 }
 
 void ScrubBar::setMarkers(const QList<int> &list)
 {
     m_markers = list;
-    updatePixmap();
+    composePixmap();
 }
 
 void ScrubBar::mousePressEvent(QMouseEvent * event)
@@ -131,6 +131,7 @@ void ScrubBar::mousePressEvent(QMouseEvent * event)
             update(m_margin + x - offset, 0, w + 2 * offset, height());
         }
     }
+    emit hoverEnded();
     emit seeked(pos);
 }
 
@@ -159,9 +160,17 @@ void ScrubBar::mouseMoveEvent(QMouseEvent * event)
             m_head = pos;
         }
         emit seeked(pos);
+    } else if (isEnabled() && m_max > 1 && x >= 0 && x <= width() - 2 * m_margin) {
+        emit hovered(pos, event->globalPos());
     }
 }
 
+void ScrubBar::leaveEvent(QEvent * event)
+{
+    QWidget::leaveEvent(event);
+    emit hoverEnded();
+}
+
 bool ScrubBar::onSeek(int value)
 {
     if (m_activeControl != CONTROL_HEAD)
@@ -236,6 +245,15 @@ bool ScrubBar::event(QEvent *event)
 }
 
 void ScrubBar::updatePixmap()
+{
+    updateGridPixmap();
+    composePixmap();
+}
+
+/// Renders the expensive, rarely changing layer: background, time ticks,
+/// and timecode labels. Redone only on resize, scale, palette, or enabled
+/// state changes.
+void ScrubBar::updateGridPixmap()
 {
     const int ratio = devicePixelRatio();
     const int l_width = width() * ratio;
@@ -244,34 +262,21 @@ void ScrubBar::updatePixmap()
     const int l_selectionSize = selectionSize * ratio;
     const int l_interval = m_interval * ratio;
     const int l_timecodeWidth = m_timecodeWidth * ratio;
-    m_pixmap = QPixmap(l_width, l_height);
-    m_pixmap.fill(palette().window().color());
-    QPainter p(&m_pixmap);
+    m_gridPixmap = QPixmap(l_width, l_height);
+    m_gridPixmap.fill(palette().window().color());
+    QPainter p(&m_gridPixmap);
     p.setFont(font());
-    const int markerHeight = fontMetrics().ascent() + 2 * ratio;
     QPen pen;
 
     if (!isEnabled()) {
         p.fillRect(0, 0, l_width, l_height, palette().background().color());
         p.end();
-        update();
         return;
     }
 
     // background color
     p.fillRect(l_margin, 0, l_width - 2 * l_margin, l_height, palette().base().color());
 
-    // selected region
-    if (m_in > -1 && m_out > m_in) {
-        const int in = m_in * m_scale * ratio;
-        const int out = m_out * m_scale * ratio;
-        p.fillRect(l_margin + in, 0, out - in, l_selectionSize, Qt::red);
-        p.fillRect(l_margin + in + (2 + ratio), ratio, // 2 for the in point line
-                   out - in - 2 * (2 + ratio) - qFloor(0.5 * ratio),
-                   l_selectionSize - ratio * 2,
-                   palette().highlight().color());
-    }
-
     // draw time ticks
     pen.setColor(palette().text().color());
     pen.setWidth(ratio);
@@ -298,16 +303,52 @@ void ScrubBar::updatePixmap()
         }
     }
 
-    // draw markers
-    if (m_in < 0 && m_out < 0) {
-        int i = 1;
-        foreach (int pos, m_markers) {
-            int x = l_margin + pos * m_scale * ratio;
-            QString s = QString::number(i++);
-            int markerWidth = fontMetrics().width(s) * 1.5;
-            p.fillRect(x, 0, 1, l_height, palette().highlight().color());
-            p.fillRect(x - markerWidth/2, 0, markerWidth, markerHeight, palette().highlight().color());
-            p.drawText(x - markerWidth/3, markerHeight - 2 * ratio, s);
+    p.end();
+}
+
+/// Composes the displayed pixmap from the cached grid layer plus the
+/// selected region and markers. This is the only work done per in/out
+/// drag step: one pixmap copy and a few fills.
+void ScrubBar::composePixmap()
+{
+    const int ratio = devicePixelRatio();
+    const int l_margin = m_margin * ratio;
+    const int l_height = height() * ratio;
+    const int l_selectionSize = selectionSize * ratio;
+    if (m_gridPixmap.isNull())
+        updateGridPixmap();
+    m_pixmap = m_gridPixmap;
+    QPainter p(&m_pixmap);
+    p.setFont(font());
+    const int markerHeight = fontMetrics().ascent() + 2 * ratio;
+    QPen pen;
+
+    if (isEnabled()) {
+        // selected region
+        if (m_in > -1 && m_out > m_in) {
+            const int in = m_in * m_scale * ratio;
+            const int out = m_out * m_scale * ratio;
+            p.fillRect(l_margin + in, 0, out - in, l_selectionSize, Qt::red);
+            p.fillRect(l_margin + in + (2 + ratio), ratio, // 2 for the in point line
+                       out - in - 2 * (2 + ratio) - qFloor(0.5 * ratio),
+                       l_selectionSize - ratio * 2,
+                       palette().highlight().color());
+        }
+
+        // draw markers
+        if (m_in < 0 && m_out < 0) {
+            pen.setColor(palette().text().color());
+            pen.setWidth(ratio);
+            p.setPen(pen);
+            int i = 1;
+            foreach (int pos, m_markers) {
+                int x = l_margin + pos * m_scale * ratio;
+                QString s = QString::number(i++);
+                int markerWidth = fontMetrics().width(s) * 1.5;
+                p.fillRect(x, 0, 1, l_height, palette().highlight().color());
+                p.fillRect(x - markerWidth/2, 0, markerWidth, markerHeight, palette().highlight().color());
+                p.drawText(x - markerWidth/3, markerHeight - 2 * ratio, s);
+            }
         }
     }
 
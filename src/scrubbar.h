@@ -38,6 +38,7 @@ public:
     virtual void mousePressEvent(QMouseEvent * event);
     virtual void mouseReleaseEvent(QMouseEvent * event);
     virtual void mouseMoveEvent(QMouseEvent * event);
+    virtual void leaveEvent(QEvent * event);
     void setScale(int maximum);
     void setFramerate(double fps);
     int position() const;
@@ -53,6 +54,9 @@ signals:
     void seeked(int);
     void inChanged(int);
     void outChanged(int);
+    /// Mouse is over the bar with no button pressed.
+    void hovered(int position, QPoint globalPos);
+    void hoverEnded();
 
 public slots:
     bool onSeek(int value);
@@ -74,11 +78,15 @@ private:
     int m_margin;
     enum controls m_activeControl;
     QPixmap m_pixmap;
+    /// background, ticks, and timecode only - invariant while dragging in/out
+    QPixmap m_gridPixmap;
     int m_timecodeWidth;
     int m_secondsPerTick;
     QList<int> m_markers;
 
     void updatePixmap();
+    void updateGridPixmap();
+    void composePixmap();
 };
 
 #endif // SCRUBBAR_H
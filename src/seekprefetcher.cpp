@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "seekprefetcher.h"
+#include "settings.h"
+#include "util.h"
+
+#include <QScopedPointer>
+#include <Mlt.h>
+#include <Logger.h>
+
+// How far to decode ahead of the seek target in the scrub direction, and
+// behind it in case the user reverses. Media on network mounts gets a
+// deeper window from Settings: each cache miss there is a round trip, so
+// running further ahead of the playhead pays for itself.
+static const int kFramesAhead = 8;
+static const int kFramesBehind = 2;
+
+SeekPrefetcher::SeekPrefetcher(Mlt::Profile& profile, const QString& resource)
+    : QThread(0)
+    , m_profile(profile)
+    , m_resource(resource)
+    , m_requestedPosition(-1)
+    , m_previousPosition(-1)
+    , m_running(true)
+{
+    setObjectName("SeekPrefetcher");
+    start(QThread::LowPriority);
+}
+
+SeekPrefetcher::~SeekPrefetcher()
+{
+    m_mutex.lock();
+    m_running = false;
+    m_condition.wakeOne();
+    m_mutex.unlock();
+    wait();
+}
+
+void SeekPrefetcher::requestPrefetch(int position)
+{
+    QMutexLocker locker(&m_mutex);
+    m_requestedPosition = position;
+    m_condition.wakeOne();
+}
+
+bool SeekPrefetcher::isSuperseded(int position)
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_running || m_requestedPosition != position;
+}
+
+void SeekPrefetcher::run()
+{
+    // The shadow producer has its own demuxer and decoder so it never
+    // contends with the playback pipeline.
+    QScopedPointer<Mlt::Producer> producer(
+        new Mlt::Producer(m_profile, "avformat-novalidate", m_resource.toUtf8().constData()));
+    if (!producer->is_valid()) {
+        LOG_DEBUG() << "no prefetch producer for" << m_resource;
+        return;
+    }
+    producer->set("mlt_service", "avformat-novalidate");
+
+    const int framesAhead = Util::isNetworkPath(m_resource)?
+        qMax(kFramesAhead, Settings.playerNetworkPrefetchFrames()) : kFramesAhead;
+
+    forever {
+        int position;
+        int direction;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_running && m_requestedPosition < 0)
+                m_condition.wait(&m_mutex);
+            if (!m_running)
+                break;
+            position = m_requestedPosition;
+            direction = (m_previousPosition >= 0 && position < m_previousPosition)? -1 : 1;
+            m_previousPosition = position;
+        }
+
+        // Decode beyond the target in the scrub direction first, then a
+        // couple of frames the other way. Requesting the image is what
+        // forces the decode and fills the caches.
+        for (int i = 1; i <= framesAhead + kFramesBehind; i++) {
+            int offset = (i <= framesAhead)? i * direction : (framesAhead - i) * direction;
+            int target = position + offset;
+            if (target < 0 || target >= producer->get_length())
+                continue;
+            if (isSuperseded(position))
+                break;
+            producer->seek(target);
+            QScopedPointer<Mlt::Frame> frame(producer->get_frame());
+            if (frame && frame->is_valid()) {
+                mlt_image_format format = mlt_image_none;
+                int width = 0;
+                int height = 0;
+                frame->get_image(format, width, height);
+            }
+        }
+
+        QMutexLocker locker(&m_mutex);
+        if (m_requestedPosition == position)
+            m_requestedPosition = -1;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEEKPREFETCHER_H
+#define SEEKPREFETCHER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QString>
+#include <MltProfile.h>
+
+/*!
+  \class SeekPrefetcher
+  \brief Speculatively decodes around recent seek targets.
+
+  Scrubbing long-GOP media pays a full GOP decode on every seek. The
+  SeekPrefetcher owns a shadow producer for the same resource on a worker
+  thread. Each seek reported through requestPrefetch() makes the worker
+  decode a few frames on either side of the target, weighted toward the
+  direction the user is scrubbing, so the demuxer, the OS page cache, and
+  the decoder's reference state are warm when the next seek lands nearby.
+
+  Requests are coalesced: a new request abandons whatever the worker was
+  prefetching.
+*/
+class SeekPrefetcher : public QThread
+{
+    Q_OBJECT
+public:
+    /*! Constructs a prefetcher decoding \a resource against \a profile. */
+    SeekPrefetcher(Mlt::Profile& profile, const QString& resource);
+    virtual ~SeekPrefetcher();
+
+    //! Reports a seek target; wakes the worker. Callable from any thread.
+    void requestPrefetch(int position);
+
+protected:
+    void run() override;
+
+private:
+    bool isSuperseded(int position);
+
+    Mlt::Profile& m_profile;
+    QString m_resource;
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    int m_requestedPosition;
+    int m_previousPosition;
+    bool m_running;
+};
+
+#endif // SEEKPREFETCHER_H
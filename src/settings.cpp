@@ -16,17 +16,105 @@
  */
 
 #include "settings.h"
+#include <QCryptographicHash>
 #include <QLocale>
 #include <QStandardPaths>
 #include <QFile>
 #include <QDir>
+#include <QThread>
 #include <Logger.h>
 
 static const QString APP_DATA_DIR_KEY("appdatadir");
 static const QString SHOTCUT_INI_FILENAME("/shotcut.ini");
+static const int SETTINGS_FLUSH_TIMEOUT_MS = 2000;
 static QScopedPointer<ShotcutSettings> instance;
 static QString appDataForSession;
 
+BatchedSettings::BatchedSettings()
+{
+    initTimer();
+}
+
+BatchedSettings::BatchedSettings(const QString& fileName, QSettings::Format format)
+    : m_settings(fileName, format)
+{
+    initTimer();
+}
+
+BatchedSettings::~BatchedSettings()
+{
+    sync();
+}
+
+void BatchedSettings::initTimer()
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(SETTINGS_FLUSH_TIMEOUT_MS);
+    QObject::connect(&m_flushTimer, &QTimer::timeout, &m_flushTimer, [this] {
+        sync();
+    });
+}
+
+QVariant BatchedSettings::value(const QString& key, const QVariant& defaultValue) const
+{
+    if (m_removedKeys.contains(key))
+        return defaultValue;
+    QHash<QString, QVariant>::const_iterator it = m_shadow.constFind(key);
+    if (it != m_shadow.constEnd())
+        return it.value();
+    return m_settings.value(key, defaultValue);
+}
+
+void BatchedSettings::setValue(const QString& key, const QVariant& value)
+{
+    m_shadow.insert(key, value);
+    m_dirtyKeys.insert(key);
+    m_removedKeys.remove(key);
+    scheduleFlush();
+}
+
+void BatchedSettings::remove(const QString& key)
+{
+    m_shadow.remove(key);
+    m_dirtyKeys.remove(key);
+    m_removedKeys.insert(key);
+    scheduleFlush();
+}
+
+QStringList BatchedSettings::allKeys()
+{
+    flush();
+    return m_settings.allKeys();
+}
+
+void BatchedSettings::sync()
+{
+    flush();
+    m_settings.sync();
+}
+
+void BatchedSettings::scheduleFlush()
+{
+    // QTimer may only be started from the thread that owns it; a write
+    // from a worker thread is rare enough to take the synchronous path.
+    if (QThread::currentThread() != m_flushTimer.thread()) {
+        sync();
+        return;
+    }
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+void BatchedSettings::flush()
+{
+    foreach (const QString& key, m_removedKeys)
+        m_settings.remove(key);
+    m_removedKeys.clear();
+    foreach (const QString& key, m_dirtyKeys)
+        m_settings.setValue(key, m_shadow.value(key));
+    m_dirtyKeys.clear();
+}
+
 ShotcutSettings &ShotcutSettings::singleton()
 {
     if (!instance) {
@@ -277,6 +365,16 @@ void ShotcutSettings::setEncodeAdvanced(bool b)
     settings.setValue("encode/advanced", b);
 }
 
+int ShotcutSettings::encodeParallelSegments() const
+{
+    return settings.value("encode/parallelSegments", 0).toInt();
+}
+
+void ShotcutSettings::setEncodeParallelSegments(int n)
+{
+    settings.setValue("encode/parallelSegments", n);
+}
+
 bool ShotcutSettings::showConvertClipDialog() const
 {
     return settings.value("showConvertClipDialog", true).toBool();
@@ -297,6 +395,53 @@ void ShotcutSettings::setEncodeParallelProcessing(bool b)
     settings.setValue("encode/parallelProcessing", b);
 }
 
+double ShotcutSettings::jobRate(const QString& key) const
+{
+    return settings.value(QString("jobs/rate/%1").arg(key)).toDouble();
+}
+
+void ShotcutSettings::setJobRate(const QString& key, double fps)
+{
+    settings.setValue(QString("jobs/rate/%1").arg(key), fps);
+}
+
+QString ShotcutSettings::capabilitiesSignature() const
+{
+    return settings.value("capabilities/signature").toString();
+}
+
+void ShotcutSettings::setCapabilitiesSignature(const QString& s)
+{
+    settings.setValue("capabilities/signature", s);
+}
+
+bool ShotcutSettings::capabilityOpenGL() const
+{
+    return settings.value("capabilities/opengl", false).toBool();
+}
+
+void ShotcutSettings::setCapabilityOpenGL(bool b)
+{
+    settings.setValue("capabilities/opengl", b);
+}
+
+int ShotcutSettings::capabilityMovit() const
+{
+    return settings.value("capabilities/movit", -1).toInt();
+}
+
+void ShotcutSettings::setCapabilityMovit(bool b)
+{
+    settings.setValue("capabilities/movit", b);
+}
+
+void ShotcutSettings::clearCapabilities()
+{
+    settings.remove("capabilities");
+    // The hardware encoders were detected against the same GPU.
+    settings.remove("encode/hardware");
+}
+
 int ShotcutSettings::playerAudioChannels() const
 {
     return settings.value("player/audioChannels", 2).toInt();
@@ -430,6 +575,26 @@ void ShotcutSettings::setPlayerRealtime(bool b)
     settings.setValue("player/realtime", b);
 }
 
+bool ShotcutSettings::playerThreadHints() const
+{
+    return settings.value("player/threadHints", true).toBool();
+}
+
+void ShotcutSettings::setPlayerThreadHints(bool b)
+{
+    settings.setValue("player/threadHints", b);
+}
+
+int ShotcutSettings::playerCacheBudgetMB() const
+{
+    return settings.value("player/cacheBudgetMB", 2048).toInt();
+}
+
+void ShotcutSettings::setPlayerCacheBudgetMB(int mb)
+{
+    settings.setValue("player/cacheBudgetMB", mb);
+}
+
 bool ShotcutSettings::playerScrubAudio() const
 {
     return settings.value("player/scrubAudio", true).toBool();
@@ -440,6 +605,46 @@ void ShotcutSettings::setPlayerScrubAudio(bool b)
     settings.setValue("player/scrubAudio", b);
 }
 
+bool ShotcutSettings::playerAudioOnly() const
+{
+    return settings.value("player/audioOnly", false).toBool();
+}
+
+void ShotcutSettings::setPlayerAudioOnly(bool b)
+{
+    settings.setValue("player/audioOnly", b);
+}
+
+int ShotcutSettings::playerNetworkCacheMultiple() const
+{
+    return settings.value("player/networkCacheMultiple", 2).toInt();
+}
+
+void ShotcutSettings::setPlayerNetworkCacheMultiple(int n)
+{
+    settings.setValue("player/networkCacheMultiple", n);
+}
+
+int ShotcutSettings::playerNetworkPrefetchFrames() const
+{
+    return settings.value("player/networkPrefetchFrames", 16).toInt();
+}
+
+void ShotcutSettings::setPlayerNetworkPrefetchFrames(int n)
+{
+    settings.setValue("player/networkPrefetchFrames", n);
+}
+
+bool ShotcutSettings::playerPreheatOnOpen() const
+{
+    return settings.value("player/preheatOnOpen", true).toBool();
+}
+
+void ShotcutSettings::setPlayerPreheatOnOpen(bool b)
+{
+    settings.setValue("player/preheatOnOpen", b);
+}
+
 int ShotcutSettings::playerVolume() const
 {
     return settings.value("player/volume", 88).toInt();
@@ -470,6 +675,27 @@ void ShotcutSettings::setPlayerPreviewScale(int i)
     settings.setValue("player/previewScale", i);
 }
 
+bool ShotcutSettings::playerAutomaticPreviewScale() const
+{
+    return settings.value("player/automaticPreviewScale", false).toBool();
+}
+
+void ShotcutSettings::setPlayerAutomaticPreviewScale(bool b)
+{
+    settings.setValue("player/automaticPreviewScale", b);
+    emit playerAutomaticPreviewScaleChanged();
+}
+
+int ShotcutSettings::playerRenderThreads() const
+{
+    return settings.value("player/renderThreads", 0).toInt();
+}
+
+void ShotcutSettings::setPlayerRenderThreads(int n)
+{
+    settings.setValue("player/renderThreads", n);
+}
+
 int ShotcutSettings::playerVideoDelayMs() const
 {
     return settings.value("player/videoDelayMs", 0).toInt();
@@ -480,6 +706,16 @@ void ShotcutSettings::setPlayerVideoDelayMs(int i)
     settings.setValue("player/videoDelayMs", i);
 }
 
+bool ShotcutSettings::playerFrameTimeHud() const
+{
+    return settings.value("player/frameTimeHud", false).toBool();
+}
+
+void ShotcutSettings::setPlayerFrameTimeHud(bool b)
+{
+    settings.setValue("player/frameTimeHud", b);
+}
+
 QString ShotcutSettings::playlistThumbnails() const
 {
     return settings.value("playlist/thumbnails", "small").toString();
@@ -588,6 +824,18 @@ void ShotcutSettings::setTimelineTrackHeight(int n)
     settings.setValue("timeline/trackHeight", n);
 }
 
+int ShotcutSettings::projectPlayheadPosition(const QString& filePath)
+{
+    QString key = QCryptographicHash::hash(filePath.toUtf8(), QCryptographicHash::Md5).toHex();
+    return settings.value("resume/" + key, -1).toInt();
+}
+
+void ShotcutSettings::setProjectPlayheadPosition(const QString& filePath, int position)
+{
+    QString key = QCryptographicHash::hash(filePath.toUtf8(), QCryptographicHash::Md5).toHex();
+    settings.setValue("resume/" + key, position);
+}
+
 QString ShotcutSettings::filterFavorite(const QString& filterName)
 {
     return settings.value("filter/favorite/" + filterName, "").toString();
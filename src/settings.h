@@ -22,6 +22,46 @@
 #include <QSettings>
 #include <QStringList>
 #include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QVariant>
+
+/*!
+  \class BatchedSettings
+  \brief A QSettings front end that batches writes.
+
+  Values written are held in an in-memory shadow map and flushed to
+  QSettings - and from there to the INI file or registry - in one batch
+  when a short timer expires, on sync(), and at destruction. Reads are
+  served from the shadow map when a write is pending so callers always
+  see their own writes. This keeps settings churn during editing from
+  doing synchronous file I/O on the GUI thread.
+*/
+class BatchedSettings
+{
+public:
+    BatchedSettings();
+    BatchedSettings(const QString& fileName, QSettings::Format format);
+    ~BatchedSettings();
+
+    QVariant value(const QString& key, const QVariant& defaultValue = QVariant()) const;
+    void setValue(const QString& key, const QVariant& value);
+    void remove(const QString& key);
+    QStringList allKeys();
+    void sync();
+
+private:
+    void initTimer();
+    void scheduleFlush();
+    void flush();
+
+    QSettings m_settings;
+    QHash<QString, QVariant> m_shadow;
+    QSet<QString> m_dirtyKeys;
+    QSet<QString> m_removedKeys;
+    QTimer m_flushTimer;
+};
 
 class ShotcutSettings : public QObject
 {
@@ -92,10 +132,31 @@ public:
     void setEncodeHardware(const QStringList&);
     bool encodeAdvanced() const;
     void setEncodeAdvanced(bool);
+    int encodeParallelSegments() const;
+    void setEncodeParallelSegments(int);
     bool showConvertClipDialog() const;
     void setShowConvertClipDialog(bool);
     bool encodeParallelProcessing() const;
     void setEncodeParallelProcessing(bool);
+    /// Historical throughput in frames per second for jobs sharing \p key
+    /// (typically the video codec); 0.0 when no job with that key has
+    /// completed yet.
+    double jobRate(const QString& key) const;
+    void setJobRate(const QString& key, double fps);
+
+    /// Cached results of the GPU capability probes (startup GL feature
+    /// test, Movit support), valid while capabilitiesSignature() matches
+    /// the driver identity reported by the current GL context.
+    QString capabilitiesSignature() const;
+    void setCapabilitiesSignature(const QString&);
+    bool capabilityOpenGL() const;
+    void setCapabilityOpenGL(bool);
+    /// -1 when Movit support has not been probed for this GPU yet.
+    int capabilityMovit() const;
+    void setCapabilityMovit(bool);
+    /// Forget all cached probe results, including the detected hardware
+    /// encoders, because they were measured on a different GPU or driver.
+    void clearCapabilities();
 
     int playerAudioChannels() const;
     void setPlayerAudioChannels(int);
@@ -122,16 +183,45 @@ public:
     void setPlayerProgressive(bool);
     bool playerRealtime() const;
     void setPlayerRealtime(bool);
+    //! Whether to hint thread scheduling for playback: the render and
+    //! consumer threads run at high priority and bulk pool tasks at low,
+    //! which on hybrid-core machines steers playback onto the performance
+    //! cores. Hints only; nothing is hard-pinned.
+    bool playerThreadHints() const;
+    void setPlayerThreadHints(bool);
+    //! Upper bound, in MiB, on the memory the avformat producer cache may
+    //! hold; updateAvformatCaching() converts it into an entry count using
+    //! a per-producer cost estimate at project resolution.
+    int playerCacheBudgetMB() const;
+    void setPlayerCacheBudgetMB(int mb);
     bool playerScrubAudio() const;
     void setPlayerScrubAudio(bool);
+    bool playerAudioOnly() const;
+    void setPlayerAudioOnly(bool);
+    // Latency tier for media on network mounts; local media keeps the
+    // defaults.
+    int playerNetworkCacheMultiple() const;
+    void setPlayerNetworkCacheMultiple(int n);
+    int playerNetworkPrefetchFrames() const;
+    void setPlayerNetworkPrefetchFrames(int n);
+    //! Decode the first frame of each timeline clip in the background after
+    //! a project loads so the first playback does not stutter on cold caches.
+    bool playerPreheatOnOpen() const;
+    void setPlayerPreheatOnOpen(bool);
     int playerVolume() const;
     void setPlayerVolume(int);
     float playerZoom() const;
     void setPlayerZoom(float);
     int playerPreviewScale() const;
     void setPlayerPreviewScale(int);
+    bool playerAutomaticPreviewScale() const;
+    void setPlayerAutomaticPreviewScale(bool);
+    int playerRenderThreads() const;
+    void setPlayerRenderThreads(int);
     int playerVideoDelayMs() const;
     void setPlayerVideoDelayMs(int);
+    bool playerFrameTimeHud() const;
+    void setPlayerFrameTimeHud(bool);
 
     QString playlistThumbnails() const;
     void setPlaylistThumbnails(const QString&);
@@ -156,6 +246,10 @@ public:
     int timelineTrackHeight() const;
     void setTimelineTrackHeight(int);
 
+    // Per-project resume state, keyed by a hash of the project file path.
+    int projectPlayheadPosition(const QString& filePath);
+    void setProjectPlayheadPosition(const QString& filePath, int position);
+
     QString filterFavorite(const QString& filterName);
     void setFilterFavorite(const QString& filterName, const QString& value);
 
@@ -224,6 +318,7 @@ signals:
     void timelineCenterPlayheadChanged();
     void playerAudioChannelsChanged(int);
     void playerGpuChanged();
+    void playerAutomaticPreviewScaleChanged();
     void audioInDurationChanged();
     void audioOutDurationChanged();
     void videoInDurationChanged();
@@ -233,7 +328,7 @@ signals:
     void smallIconsChanged();
 
 private:
-    QSettings settings;
+    BatchedSettings settings;
     QString m_appDataLocation;
 };
 
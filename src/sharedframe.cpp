@@ -16,8 +16,13 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "sharedframe.h"
+#include "videoconvert.h"
+#include "widgets/iecscale.h"
 
+#include <cmath>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 void destroyFrame(void* p)
 {
@@ -31,12 +36,49 @@ public:
     FrameData(Mlt::Frame& frame) : f(frame) {};
     ~FrameData() {};
 
+    // Recycle the nodes: playback creates and destroys one FrameData per
+    // frame, which otherwise shows up as steady allocator churn and
+    // fragmentation over long sessions.
+    static void* operator new(size_t size);
+    static void operator delete(void* p);
+
     Mlt::Frame f;
     std::mutex m;
 private:
     Q_DISABLE_COPY(FrameData)
 };
 
+static std::mutex g_frameDataPoolMutex;
+static std::vector<void*> g_frameDataPool;
+// A handful of frames are ever in flight (consumer queue, scope queues,
+// display); this comfortably covers them without pinning real memory.
+static const size_t kFrameDataPoolMax = 32;
+
+void* FrameData::operator new(size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_frameDataPoolMutex);
+        if (!g_frameDataPool.empty()) {
+            void* p = g_frameDataPool.back();
+            g_frameDataPool.pop_back();
+            return p;
+        }
+    }
+    return ::operator new(size);
+}
+
+void FrameData::operator delete(void* p)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_frameDataPoolMutex);
+        if (g_frameDataPool.size() < kFrameDataPoolMax) {
+            g_frameDataPool.push_back(p);
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
 SharedFrame::SharedFrame()
   : d(new FrameData())
 {
@@ -52,6 +94,11 @@ SharedFrame::SharedFrame(const SharedFrame& other)
 {
 }
 
+SharedFrame::SharedFrame(SharedFrame&& other)
+  : d(std::move(other.d))
+{
+}
+
 SharedFrame::~SharedFrame()
 {
 }
@@ -62,6 +109,12 @@ SharedFrame& SharedFrame::operator=(const SharedFrame& other)
    return *this;
 }
 
+SharedFrame& SharedFrame::operator=(SharedFrame&& other)
+{
+   d = std::move(other.d);
+   return *this;
+}
+
 bool SharedFrame::is_valid() const
 {
     return d && d->f.is_valid();
@@ -197,6 +250,27 @@ const uint8_t* SharedFrame::get_image(mlt_image_format format) const
 
         nonConstData->m.lock();
 
+        // The common scope/thumbnail request is RGBA from a YUV 4:2:0 frame.
+        // Convert it once with the vectorized kernel and share the plane with
+        // all consumers instead of letting MLT convert per cache frame.
+        if (format == mlt_image_rgb24a && native_format == mlt_image_yuv420p) {
+            uint8_t* cached = static_cast<uint8_t*>(nonConstData->f.get_data("shotcut.rgb24a"));
+            if (!cached) {
+                const uint8_t* source = (uint8_t*)nonConstData->f.get_image(native_format, width, height, 0);
+                if (source) {
+                    int size = width * height * 4;
+                    cached = (uint8_t*)mlt_pool_alloc(size);
+                    VideoConvert::yuv420pToRgba(source, cached, width, height,
+                                                nonConstData->f.get_int("colorspace"));
+                    nonConstData->f.set("shotcut.rgb24a", cached, size, mlt_pool_release);
+                }
+            }
+            if (cached) {
+                nonConstData->m.unlock();
+                return cached;
+            }
+        }
+
         Mlt::Frame* cacheFrame = static_cast<Mlt::Frame*>(nonConstData->f.get_data(formatName));
         if (cacheFrame == nullptr) {
             // A cached image does not exist, create one.
@@ -224,6 +298,45 @@ const uint8_t* SharedFrame::get_image(mlt_image_format format) const
     return image;
 }
 
+bool SharedFrame::get_pixel_rgb(int x, int y, uint8_t* rgb) const
+{
+    if (!is_valid()) return false;
+    int width = get_image_width();
+    int height = get_image_height();
+    if (x < 0 || y < 0 || x >= width || y >= height) return false;
+
+    mlt_image_format format = get_image_format();
+    if (format == mlt_image_yuv420p) {
+        const uint8_t* image = get_image(format);
+        if (!image) return false;
+        uint8_t rgba[4];
+        VideoConvert::yuv420pRectToRgba(image, rgba, width, height, x, y, 1, 1,
+                                        get_int("colorspace"));
+        rgb[0] = rgba[0];
+        rgb[1] = rgba[1];
+        rgb[2] = rgba[2];
+        return true;
+    } else if (format == mlt_image_rgb24 || format == mlt_image_rgb24a) {
+        const uint8_t* image = get_image(format);
+        if (!image) return false;
+        const uint8_t* p = image + (y * width + x) * (format == mlt_image_rgb24? 3 : 4);
+        rgb[0] = p[0];
+        rgb[1] = p[1];
+        rgb[2] = p[2];
+        return true;
+    } else {
+        // Other native formats are uncommon in the scope path; fall back to
+        // the cached full-frame conversion.
+        const uint8_t* image = get_image(mlt_image_rgb24a);
+        if (!image) return false;
+        const uint8_t* p = image + (y * width + x) * 4;
+        rgb[0] = p[0];
+        rgb[1] = p[1];
+        rgb[2] = p[2];
+        return true;
+    }
+}
+
 mlt_audio_format SharedFrame::get_audio_format() const
 {
     return (mlt_audio_format)d->f.get_int( "audio_format" );
@@ -252,3 +365,43 @@ const int16_t* SharedFrame::get_audio() const
     int samples = get_audio_samples();
     return (int16_t*)d->f.get_audio(format, frequency, channels, samples);
 }
+
+const double* SharedFrame::get_audio_peaks() const
+{
+    if (!is_valid() || get_audio_format() != mlt_audio_s16)
+        return 0;
+    int channels = get_audio_channels();
+    int samples = get_audio_samples();
+    if (channels <= 0 || samples <= 0)
+        return 0;
+
+    // Like the cached image conversion above: compute once under lock and
+    // share the result with every consumer of this frame.
+    FrameData* nonConstData = const_cast<FrameData*>(d.data());
+    nonConstData->m.lock();
+    double* cached = static_cast<double*>(nonConstData->f.get_data("shotcut.audiopeaks"));
+    if (!cached) {
+        const int16_t* audio = (const int16_t*)nonConstData->f.get_audio(
+            mlt_audio_s16, get_audio_frequency(), channels, samples);
+        if (audio) {
+            std::vector<int> peaks(channels, 0);
+            for (int s = 0; s < samples; s++) {
+                const int16_t* sample = audio + s * channels;
+                for (int c = 0; c < channels; c++) {
+                    int v = sample[c] < 0? -sample[c] : sample[c];
+                    if (v > peaks[c])
+                        peaks[c] = v;
+                }
+            }
+            int size = channels * sizeof(double);
+            cached = (double*)mlt_pool_alloc(size);
+            std::vector<float> ratios(channels);
+            for (int c = 0; c < channels; c++)
+                ratios[c] = peaks[c] / 32768.0f;
+            IEC_DbBatch(ratios.data(), cached, channels, -100.0);
+            nonConstData->f.set("shotcut.audiopeaks", cached, size, mlt_pool_release);
+        }
+    }
+    nonConstData->m.unlock();
+    return cached;
+}
@@ -51,8 +51,10 @@ public:
     SharedFrame();
     SharedFrame(Mlt::Frame& frame);
     SharedFrame(const SharedFrame& other);
+    SharedFrame(SharedFrame&& other);
     ~SharedFrame();
     SharedFrame& operator=(const SharedFrame& other);
+    SharedFrame& operator=(SharedFrame&& other);
 
     bool is_valid() const;
     Mlt::Frame clone(bool audio = false, bool image = false, bool alpha = false) const;
@@ -64,11 +66,19 @@ public:
     int get_image_width() const;
     int get_image_height() const;
     const uint8_t* get_image(mlt_image_format format) const;
+    /// Reads the RGB value of a single pixel, converting only that pixel
+    /// from the native image format instead of the whole frame. Returns
+    /// false if the frame or coordinates are invalid.
+    bool get_pixel_rgb(int x, int y, uint8_t* rgb) const;
     mlt_audio_format get_audio_format() const;
     int get_audio_channels() const;
     int get_audio_frequency() const;
     int get_audio_samples() const;
     const int16_t* get_audio() const;
+    /// Per-channel peak levels in dBFS (-100.0 for silence), computed in a
+    /// single pass over the samples and cached on the frame so all visible
+    /// meters share one analysis. Returns 0 if the frame has no s16 audio.
+    const double* get_audio_peaks() const;
 private:
     QExplicitlySharedDataPointer<FrameData> d;
 };
@@ -13,6 +13,7 @@ SOURCES += main.cpp\
     dialogs/systemsyncdialog.cpp \
     mainwindow.cpp \
     mltcontroller.cpp \
+    producercache.cpp \
     proxymanager.cpp \
     scrubbar.cpp \
     openotherdialog.cpp \
@@ -43,11 +44,13 @@ SOURCES += main.cpp\
     widgets/imageproducerwidget.cpp \
     widgets/timespinbox.cpp \
     widgets/audiometerwidget.cpp \
+    widgets/frametimehud.cpp \
     docks/recentdock.cpp \
     docks/encodedock.cpp \
     dialogs/addencodepresetdialog.cpp \
     dialogs/filedatedialog.cpp \
     jobqueue.cpp \
+    jobsserver.cpp \
     docks/jobsdock.cpp \
     dialogs/slideshowgeneratordialog.cpp \
     dialogs/textviewerdialog.cpp \
@@ -71,6 +74,7 @@ SOURCES += main.cpp\
     htmleditor/htmleditor.cpp \
     htmleditor/highlighter.cpp \
     settings.cpp \
+    startuptracer.cpp \
     widgets/lineeditclear.cpp \
     leapnetworklistener.cpp \
     widgets/webvfxproducer.cpp \
@@ -80,11 +84,16 @@ SOURCES += main.cpp\
     docks/timelinedock.cpp \
     qmltypes/qmlutilities.cpp \
     qmltypes/qmlview.cpp \
+    qmltypes/thumbnailprefetcher.cpp \
     qmltypes/thumbnailprovider.cpp \
     commands/timelinecommands.cpp \
     util.cpp \
     widgets/lumamixtransition.cpp \
     autosavefile.cpp \
+    perflog.cpp \
+    memoryreport.cpp \
+    stalldetector.cpp \
+    taskpool.cpp \
     widgets/directshowvideowidget.cpp \
     jobs/abstractjob.cpp \
     jobs/meltjob.cpp \
@@ -106,7 +115,12 @@ SOURCES += main.cpp\
     widgets/scopes/videowaveformscopewidget.cpp \
     widgets/scopes/videozoomscopewidget.cpp \
     widgets/scopes/videozoomwidget.cpp \
+    scrubaudioengine.cpp \
+    seekprefetcher.cpp \
+    keyframeindex.cpp \
     sharedframe.cpp \
+    stftengine.cpp \
+    videoconvert.cpp \
     widgets/audioscale.cpp \
     widgets/playlisttable.cpp \
     widgets/playlisticonview.cpp \
@@ -118,6 +132,7 @@ SOURCES += main.cpp\
     widgets/trackpropertieswidget.cpp \
     widgets/timelinepropertieswidget.cpp \
     jobs/ffprobejob.cpp \
+    jobs/keyframeindexjob.cpp \
     jobs/ffmpegjob.cpp \
     dialogs/unlinkedfilesdialog.cpp \
     dialogs/transcodedialog.cpp \
@@ -137,6 +152,7 @@ mac: OBJECTIVE_SOURCES = macos.mm
 HEADERS  += mainwindow.h \
     dialogs/systemsyncdialog.h \
     mltcontroller.h \
+    producercache.h \
     proxymanager.h \
     scrubbar.h \
     openotherdialog.h \
@@ -168,11 +184,13 @@ HEADERS  += mainwindow.h \
     widgets/timespinbox.h \
     widgets/iecscale.h \
     widgets/audiometerwidget.h \
+    widgets/frametimehud.h \
     docks/recentdock.h \
     docks/encodedock.h \
     dialogs/addencodepresetdialog.h \
     dialogs/filedatedialog.h \
     jobqueue.h \
+    jobsserver.h \
     docks/jobsdock.h \
     dialogs/slideshowgeneratordialog.h \
     dialogs/textviewerdialog.h \
@@ -197,6 +215,7 @@ HEADERS  += mainwindow.h \
     htmleditor/htmleditor.h \
     htmleditor/highlighter.h \
     settings.h \
+    startuptracer.h \
     widgets/lineeditclear.h \
     leapnetworklistener.h \
     widgets/webvfxproducer.h \
@@ -206,11 +225,16 @@ HEADERS  += mainwindow.h \
     docks/timelinedock.h \
     qmltypes/qmlutilities.h \
     qmltypes/qmlview.h \
+    qmltypes/thumbnailprefetcher.h \
     qmltypes/thumbnailprovider.h \
     commands/timelinecommands.h \
     util.h \
     widgets/lumamixtransition.h \
     autosavefile.h \
+    perflog.h \
+    memoryreport.h \
+    stalldetector.h \
+    taskpool.h \
     widgets/directshowvideowidget.h \
     jobs/abstractjob.h \
     jobs/meltjob.h \
@@ -233,7 +257,12 @@ HEADERS  += mainwindow.h \
     widgets/scopes/videozoomscopewidget.h \
     widgets/scopes/videozoomwidget.h \
     dataqueue.h \
+    scrubaudioengine.h \
+    seekprefetcher.h \
+    keyframeindex.h \
     sharedframe.h \
+    stftengine.h \
+    videoconvert.h \
     widgets/audioscale.h \
     widgets/playlisttable.h \
     widgets/playlisticonview.h \
@@ -246,6 +275,7 @@ HEADERS  += mainwindow.h \
     widgets/trackpropertieswidget.h \
     widgets/timelinepropertieswidget.h \
     jobs/ffprobejob.h \
+    jobs/keyframeindexjob.h \
     jobs/ffmpegjob.h \
     dialogs/unlinkedfilesdialog.h \
     dialogs/transcodedialog.h \
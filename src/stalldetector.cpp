@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stalldetector.h"
+#include "perflog.h"
+#include <QElapsedTimer>
+#include <QTimer>
+#include <Logger.h>
+#ifdef Q_OS_UNIX
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <stdlib.h>
+#endif
+
+// The heartbeat runs at a fraction of the threshold so a healthy loop is
+// never flagged by sampling phase.
+static const int kHeartbeatIntervalMs = 25;
+static const int kStallThresholdMs = 100;
+static const int kMaxFrames = 64;
+
+#ifdef Q_OS_UNIX
+static pthread_t g_mainThread;
+static void* g_stack[kMaxFrames];
+static volatile sig_atomic_t g_stackSize = 0;
+static volatile sig_atomic_t g_stackReady = 0;
+
+// Runs on the stalled main thread; backtrace() is async-signal-safe,
+// symbolization is deferred to the watchdog thread.
+static void captureHandler(int)
+{
+    g_stackSize = backtrace(g_stack, kMaxFrames);
+    g_stackReady = 1;
+}
+#endif
+
+StallDetector::StallDetector()
+    : QThread()
+    , m_heartbeatTimer(nullptr)
+    , m_heartbeat(0)
+{
+    setObjectName("StallDetector");
+}
+
+StallDetector& StallDetector::singleton()
+{
+    static StallDetector instance;
+    return instance;
+}
+
+void StallDetector::beat()
+{
+    m_heartbeat.ref();
+}
+
+void StallDetector::startWatching()
+{
+#ifdef Q_OS_UNIX
+    g_mainThread = pthread_self();
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = captureHandler;
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR2, &action, nullptr);
+#endif
+    m_heartbeatTimer = new QTimer;
+    m_heartbeatTimer->setInterval(kHeartbeatIntervalMs);
+    connect(m_heartbeatTimer, SIGNAL(timeout()), this, SLOT(beat()), Qt::DirectConnection);
+    m_heartbeatTimer->start();
+    m_stop.storeRelease(0);
+    start();
+}
+
+void StallDetector::stopWatching()
+{
+    if (!m_heartbeatTimer)
+        return;
+    m_stop.storeRelease(1);
+    wait();
+    delete m_heartbeatTimer;
+    m_heartbeatTimer = nullptr;
+}
+
+void StallDetector::run()
+{
+    quint32 lastBeat = m_heartbeat.loadAcquire();
+    QElapsedTimer sinceBeat;
+    sinceBeat.start();
+    bool captureRequested = false;
+    while (!m_stop.loadAcquire()) {
+        msleep(kStallThresholdMs / 4);
+        quint32 beat = m_heartbeat.loadAcquire();
+        if (beat != lastBeat) {
+            qint64 ms = sinceBeat.elapsed();
+            if (ms >= kStallThresholdMs) {
+                LOG_WARNING() << "main loop stalled for ms" << ms;
+                PerfLog::span("ui.stall", ms * 1000);
+                logBacktrace();
+            }
+            lastBeat = beat;
+            sinceBeat.restart();
+            captureRequested = false;
+        } else if (!captureRequested && sinceBeat.elapsed() >= kStallThresholdMs) {
+#ifdef Q_OS_UNIX
+            g_stackReady = 0;
+            pthread_kill(g_mainThread, SIGUSR2);
+#endif
+            captureRequested = true;
+        }
+    }
+}
+
+void StallDetector::logBacktrace()
+{
+#ifdef Q_OS_UNIX
+    if (!g_stackReady)
+        return;
+    char** symbols = backtrace_symbols(g_stack, g_stackSize);
+    if (symbols) {
+        for (int i = 0; i < g_stackSize; i++)
+            LOG_WARNING() << "stall frame" << i << symbols[i];
+        free(symbols);
+    }
+    g_stackReady = 0;
+#endif
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STALLDETECTOR_H
+#define STALLDETECTOR_H
+
+#include <QThread>
+#include <QAtomicInteger>
+
+class QTimer;
+
+/*!
+  \class StallDetector
+  \brief Watchdog that detects and attributes main-loop stalls.
+
+  A timer on the main thread advances a heartbeat counter, and a watchdog
+  thread flags any gap over a threshold. While the loop is stalled the
+  watchdog signals the main thread to capture its own backtrace, and once
+  the loop recovers the stall duration and symbolized frames are written
+  to the log, so intermittent freezes reported from the field can be
+  attributed to the code that caused them. Backtrace capture is POSIX
+  only; on Windows just the duration is logged (ExcHndl covers crashes,
+  not stalls).
+*/
+class StallDetector : public QThread
+{
+    Q_OBJECT
+public:
+    static StallDetector& singleton();
+    //! Call on the main thread; installs the heartbeat timer there and
+    //! starts the watchdog thread.
+    void startWatching();
+    void stopWatching();
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private slots:
+    void beat();
+
+private:
+    StallDetector();
+    void logBacktrace();
+
+    QTimer* m_heartbeatTimer;
+    QAtomicInteger<quint32> m_heartbeat;
+    QAtomicInt m_stop;
+};
+
+#endif // STALLDETECTOR_H
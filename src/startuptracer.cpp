@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "startuptracer.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThread>
+#include <Logger.h>
+
+StartupTracer& StartupTracer::singleton()
+{
+    static StartupTracer instance;
+    return instance;
+}
+
+StartupTracer::StartupTracer()
+    : m_isEnabled(false)
+{
+    m_timer.start();
+}
+
+void StartupTracer::setEnabled(bool enabled)
+{
+    m_isEnabled = enabled;
+}
+
+void StartupTracer::beginPhase(const char* name)
+{
+    if (!m_isEnabled) return;
+    QMutexLocker locker(&m_mutex);
+    Event event = {name, 'B', m_timer.nsecsElapsed() / 1000,
+                   quintptr(QThread::currentThreadId())};
+    m_events.append(event);
+}
+
+void StartupTracer::endPhase(const char* name)
+{
+    if (!m_isEnabled) return;
+    QMutexLocker locker(&m_mutex);
+    Event event = {name, 'E', m_timer.nsecsElapsed() / 1000,
+                   quintptr(QThread::currentThreadId())};
+    m_events.append(event);
+}
+
+void StartupTracer::write(const QString& fileName)
+{
+    if (!m_isEnabled) return;
+    QMutexLocker locker(&m_mutex);
+    QJsonArray traceEvents;
+    foreach (const Event& event, m_events) {
+        QJsonObject o;
+        o.insert("name", event.name);
+        o.insert("cat", "startup");
+        o.insert("ph", QString(QChar(event.phase)));
+        o.insert("ts", event.timestamp);
+        o.insert("pid", 1);
+        o.insert("tid", qint64(event.threadId));
+        traceEvents.append(o);
+    }
+    QJsonObject root;
+    root.insert("traceEvents", traceEvents);
+    root.insert("displayTimeUnit", "ms");
+    QFile file(fileName);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        file.write(QJsonDocument(root).toJson());
+        LOG_INFO() << "wrote startup trace" << fileName;
+    } else {
+        LOG_WARNING() << "failed to write startup trace" << fileName;
+    }
+}
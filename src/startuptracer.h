@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STARTUPTRACER_H
+#define STARTUPTRACER_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/*!
+  \class StartupTracer
+  \brief Records named startup phases and writes them as a Chrome trace.
+
+  Enabled by the --startup-trace command line option. Phases recorded with
+  beginPhase()/endPhase() - or the scoped StartupPhase helper - are written
+  in the Chrome tracing JSON format, viewable in chrome://tracing, so
+  startup regressions between releases can be compared with data instead
+  of stopwatch guesses. When disabled, recording is a no-op.
+*/
+class StartupTracer
+{
+public:
+    static StartupTracer& singleton();
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_isEnabled; }
+    void beginPhase(const char* name);
+    void endPhase(const char* name);
+    void write(const QString& fileName);
+
+private:
+    StartupTracer();
+
+    struct Event {
+        const char* name;
+        char phase;        // 'B' begins a span, 'E' ends it
+        qint64 timestamp;  // microseconds since the tracer started
+        quintptr threadId;
+    };
+
+    bool m_isEnabled;
+    QElapsedTimer m_timer;
+    QMutex m_mutex;
+    QVector<Event> m_events;
+};
+
+//! Records a startup phase spanning the enclosing scope.
+class StartupPhase
+{
+public:
+    explicit StartupPhase(const char* name)
+        : m_name(name)
+    {
+        StartupTracer::singleton().beginPhase(m_name);
+    }
+    ~StartupPhase()
+    {
+        StartupTracer::singleton().endPhase(m_name);
+    }
+
+private:
+    const char* m_name;
+};
+
+#endif // STARTUPTRACER_H
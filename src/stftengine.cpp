@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "stftengine.h"
+
+#include <math.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static int nextPowerOfTwo(int n)
+{
+    int result = 1;
+    while (result < n)
+        result <<= 1;
+    return result;
+}
+
+StftEngine::StftEngine(int windowSize)
+    : m_windowSize(nextPowerOfTwo(windowSize))
+    , m_writePos(0)
+    , m_totalSamples(0)
+    , m_windowSum(0.0f)
+{
+    m_ring.resize(m_windowSize);
+    m_ring.fill(0.0f);
+    m_window.resize(m_windowSize);
+    m_real.resize(m_windowSize);
+    m_imaginary.resize(m_windowSize);
+    for (int i = 0; i < m_windowSize; i++) {
+        m_window[i] = 0.5f - 0.5f * cosf(2.0f * M_PI * i / (m_windowSize - 1));
+        m_windowSum += m_window[i];
+    }
+    // Precompute the bit-reversal permutation for the radix-2 reorder.
+    m_reverseTable.resize(m_windowSize);
+    int bits = 0;
+    while ((1 << bits) < m_windowSize)
+        bits++;
+    for (int i = 0; i < m_windowSize; i++) {
+        int reversed = 0;
+        for (int b = 0; b < bits; b++)
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        m_reverseTable[i] = reversed;
+    }
+}
+
+void StftEngine::push(const int16_t* pcm, int samples, int channels)
+{
+    const float scale = 1.0f / (32768.0f * channels);
+    for (int i = 0; i < samples; i++) {
+        int sum = 0;
+        for (int c = 0; c < channels; c++)
+            sum += pcm[i * channels + c];
+        m_ring[m_writePos] = sum * scale;
+        m_writePos = (m_writePos + 1) & (m_windowSize - 1);
+    }
+    m_totalSamples += samples;
+}
+
+bool StftEngine::analyze(QVector<float>& magnitudes)
+{
+    if (m_totalSamples < m_windowSize)
+        return false;
+
+    // Unroll the ring into the FFT work buffers in time order, applying the
+    // Hann window and the bit-reversal permutation in one pass. Only the
+    // samples that arrived since the previous analyze() were touched by
+    // push(); the overlapping remainder is reused as-is.
+    float* real = m_real.data();
+    float* imaginary = m_imaginary.data();
+    const int mask = m_windowSize - 1;
+    for (int i = 0; i < m_windowSize; i++) {
+        int j = m_reverseTable[i];
+        real[j] = m_ring[(m_writePos + i) & mask] * m_window[i];
+        imaginary[j] = 0.0f;
+    }
+
+    // Iterative radix-2 Cooley-Tukey. The inner loop is laid out as plain
+    // strided float math so the compiler's vectorizer can keep the
+    // butterflies in SIMD registers on SSE2 and NEON targets.
+    for (int size = 2; size <= m_windowSize; size <<= 1) {
+        const int half = size / 2;
+        const float angle = -2.0f * M_PI / size;
+        const float wReal = cosf(angle);
+        const float wImaginary = sinf(angle);
+        for (int start = 0; start < m_windowSize; start += size) {
+            float twiddleReal = 1.0f;
+            float twiddleImaginary = 0.0f;
+            for (int k = 0; k < half; k++) {
+                const int even = start + k;
+                const int odd = even + half;
+                const float tReal = real[odd] * twiddleReal - imaginary[odd] * twiddleImaginary;
+                const float tImaginary = real[odd] * twiddleImaginary + imaginary[odd] * twiddleReal;
+                real[odd] = real[even] - tReal;
+                imaginary[odd] = imaginary[even] - tImaginary;
+                real[even] += tReal;
+                imaginary[even] += tImaginary;
+                const float nextReal = twiddleReal * wReal - twiddleImaginary * wImaginary;
+                twiddleImaginary = twiddleReal * wImaginary + twiddleImaginary * wReal;
+                twiddleReal = nextReal;
+            }
+        }
+    }
+
+    // Normalize so a full-scale sine reports 1.0 regardless of window size.
+    const int bins = m_windowSize / 2;
+    magnitudes.resize(bins);
+    float* out = magnitudes.data();
+    const float norm = 2.0f / m_windowSum;
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 vNorm = _mm_set1_ps(norm);
+    for (; i + 4 <= bins; i += 4) {
+        __m128 re = _mm_loadu_ps(real + i);
+        __m128 im = _mm_loadu_ps(imaginary + i);
+        __m128 power = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_sqrt_ps(power), vNorm));
+    }
+#endif
+    for (; i < bins; i++)
+        out[i] = sqrtf(real[i] * real[i] + imaginary[i] * imaginary[i]) * norm;
+    return true;
+}
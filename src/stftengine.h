@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STFTENGINE_H
+#define STFTENGINE_H
+
+#include <QVector>
+#include <stdint.h>
+
+/*!
+  \class StftEngine
+  \brief Incremental short-time Fourier transform over a sliding window.
+
+  The engine keeps the last window of mono samples in a ring buffer, so each
+  analysis only appends the newly arrived audio and reuses the overlapping
+  samples from previous frames instead of gathering a full window per
+  refresh. analyze() applies a Hann window and an iterative radix-2 FFT
+  (the window multiply and magnitude passes are vectorized with SSE2 when
+  the build targets it) and reports normalized bin magnitudes where a
+  full-scale sine is 1.0.
+
+  Not threadsafe; intended for use from a single scope refresh thread.
+*/
+class StftEngine
+{
+public:
+    //! Constructs an engine with \a windowSize samples (rounded up to a power of 2).
+    explicit StftEngine(int windowSize);
+
+    //! Mixes \a samples frames of interleaved 16-bit PCM to mono and appends them.
+    void push(const int16_t* pcm, int samples, int channels);
+
+    /*!
+      Computes the spectrum of the current window into \a magnitudes
+      (windowSize / 2 bins). Returns false until a full window has arrived.
+    */
+    bool analyze(QVector<float>& magnitudes);
+
+    //! Returns the width of one bin in Hz for \a frequency samples per second.
+    double binWidth(int frequency) const { return double(frequency) / m_windowSize; }
+
+    //! Returns the number of magnitude bins produced by analyze().
+    int binCount() const { return m_windowSize / 2; }
+
+private:
+    int m_windowSize;
+    int m_writePos;
+    qint64 m_totalSamples;
+    QVector<float> m_ring;
+    QVector<float> m_window;    // Hann coefficients
+    float m_windowSum;
+    QVector<float> m_real;
+    QVector<float> m_imaginary;
+    QVector<int> m_reverseTable;
+};
+
+#endif // STFTENGINE_H
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "taskpool.h"
+#include "settings.h"
+#include <QThread>
+
+namespace {
+
+// Runs a Bulk task with the worker thread dropped to low priority, which
+// on hybrid-core machines steers whole-project generation onto the
+// efficiency cores and away from playback. The priority is restored so
+// the pooled thread serves its next task normally.
+class LowPriorityRunnable : public QRunnable
+{
+public:
+    explicit LowPriorityRunnable(QRunnable* inner) : m_inner(inner)
+    {
+        setAutoDelete(true);
+    }
+    void run() Q_DECL_OVERRIDE
+    {
+        QThread* thread = QThread::currentThread();
+        thread->setPriority(QThread::LowPriority);
+        m_inner->run();
+        if (m_inner->autoDelete())
+            delete m_inner;
+        thread->setPriority(QThread::NormalPriority);
+    }
+private:
+    QRunnable* m_inner;
+};
+
+} // namespace
+
+TaskPool::TaskPool()
+{
+    m_normalThreads = qMax(1, QThread::idealThreadCount() - 1);
+    m_playbackThreads = qMax(1, QThread::idealThreadCount() / 2);
+    m_pool.setMaxThreadCount(m_normalThreads);
+}
+
+TaskPool& TaskPool::singleton()
+{
+    static TaskPool instance;
+    return instance;
+}
+
+void TaskPool::start(QRunnable* runnable, TaskClass taskClass)
+{
+    if (taskClass == Bulk && Settings.playerThreadHints())
+        runnable = new LowPriorityRunnable(runnable);
+    m_pool.start(runnable, taskClass);
+}
+
+void TaskPool::setPlaybackActive(bool active)
+{
+    m_pool.setMaxThreadCount(active? m_playbackThreads : m_normalThreads);
+}
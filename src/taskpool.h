@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <QThreadPool>
+#include <QAtomicInt>
+
+/*!
+  \class TaskPool
+  \brief The one shared thread pool for in-process background work.
+
+  \threadsafe
+
+  Audio level generation, thumbnail rendering, and scope refreshes used
+  to run on independent pools whose thread counts added up to more than
+  the machine, so a bulk import starved playback. They all share this
+  pool instead: idle threads pull the next queued task regardless of who
+  submitted it, and the task class orders the queue so interactive work
+  runs before whole-project generation.
+
+  One core is always left for the GUI thread, and while playback runs
+  the pool shrinks further so the decode and render threads keep their
+  cores. The reservation takes effect as running tasks retire; threads
+  already working are not interrupted.
+*/
+class TaskPool
+{
+public:
+    //! Queue ordering for start(). QtConcurrent submissions to pool()
+    //! cannot carry a priority and run at Background.
+    enum TaskClass {
+        Bulk = -1,       //!< whole-project generation, e.g. audio levels
+        Background = 0,  //!< near-term needs, e.g. prefetch
+        Interactive = 1  //!< the user is waiting on it
+    };
+
+    static TaskPool& singleton();
+
+    //! Starts \a runnable on the shared pool, which takes ownership per
+    //! the usual QThreadPool semantics.
+    void start(QRunnable* runnable, TaskClass taskClass);
+
+    //! The underlying pool for QtConcurrent::run() callers needing a
+    //! QFuture.
+    QThreadPool* pool() { return &m_pool; }
+
+    //! Call with true while the player is rolling to shrink the pool and
+    //! leave cores for decode and render.
+    void setPlaybackActive(bool active);
+
+    //! Cooperative cancellation: long tasks capture the epoch when they
+    //! start and test isStale() at chunk boundaries (per decoded frame,
+    //! before a thumbnail render). Capturing is free and there is nothing
+    //! to unregister.
+    int currentEpoch() const { return m_epoch.loadAcquire(); }
+    bool isStale(int epoch) const { return epoch != m_epoch.loadAcquire(); }
+
+    //! Invalidates every task captured under the current epoch, e.g. when
+    //! the project closes. Queued tasks still run but return at their
+    //! first staleness check, so the pool drains in milliseconds. The
+    //! queue is deliberately not cleared: a QtConcurrent future whose
+    //! runnable is discarded before running never finishes, which would
+    //! hang anyone blocked on its result.
+    void cancelAll() { m_epoch.ref(); }
+
+private:
+    TaskPool();
+
+    QThreadPool m_pool;
+    int m_normalThreads;
+    int m_playbackThreads;
+    QAtomicInt m_epoch;
+};
+
+#endif // TASKPOOL_H
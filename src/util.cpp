@@ -31,6 +31,11 @@
 #include <QTemporaryFile>
 #include <QApplication>
 #include <QCryptographicHash>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStorageInfo>
 
 #include <MltProducer.h>
 #include <Logger.h>
@@ -380,25 +385,64 @@ void Util::applyCustomProperties(Mlt::Producer& destination, Mlt::Producer& sour
     destination.set_in_and_out(in, out);
 }
 
+struct FileHashCacheEntry {
+    QDateTime modified;
+    qint64 size;
+    QString hash;
+};
+// Results keyed by (path, mtime, size): a project commonly references the
+// same file from many producers, and re-reading megabytes per reference
+// stalls badly on network storage.
+static QHash<QString, FileHashCacheEntry> fileHashCache;
+static QMutex fileHashCacheMutex;
+
 QString Util::getFileHash(const QString& path)
 {
+    QFileInfo info(path);
+    const QDateTime modified = info.lastModified();
+    const qint64 size = info.size();
+    {
+        QMutexLocker locker(&fileHashCacheMutex);
+        QHash<QString, FileHashCacheEntry>::const_iterator it = fileHashCache.constFind(path);
+        if (it != fileHashCache.constEnd() && it->modified == modified && it->size == size)
+            return it->hash;
+    }
+
     // This routine is intentionally copied from Kdenlive.
+    QString result;
     QFile file(path);
     if (file.open(QIODevice::ReadOnly)) {
-        QByteArray fileData;
+        QCryptographicHash hash(QCryptographicHash::Md5);
          // 1 MB = 1 second per 450 files (or faster)
          // 10 MB = 9 seconds per 450 files (or faster)
-        if (file.size() > 1000000*2) {
-            fileData = file.read(1000000);
-            if (file.seek(file.size() - 1000000))
-                fileData.append(file.readAll());
+        const qint64 chunk = 1000000;
+        if (file.size() > chunk*2) {
+            // Map the bounded head and tail ranges to avoid copying them
+            // through a read buffer.
+            uchar* head = file.map(0, chunk);
+            uchar* tail = file.map(file.size() - chunk, chunk);
+            if (head && tail) {
+                hash.addData((const char*) head, chunk);
+                hash.addData((const char*) tail, chunk);
+            } else {
+                // Some file systems cannot map; fall back to reads.
+                QByteArray fileData = file.read(chunk);
+                if (file.seek(file.size() - chunk))
+                    fileData.append(file.readAll());
+                hash.addData(fileData);
+            }
         } else {
-            fileData = file.readAll();
+            hash.addData(&file);
         }
         file.close();
-        return QCryptographicHash::hash(fileData, QCryptographicHash::Md5).toHex();
+        result = hash.result().toHex();
     }
-    return QString();
+    if (!result.isEmpty()) {
+        QMutexLocker locker(&fileHashCacheMutex);
+        FileHashCacheEntry entry = { modified, size, result };
+        fileHashCache.insert(path, entry);
+    }
+    return result;
 }
 
 QString Util::getHash(Mlt::Properties& properties)
@@ -420,3 +464,41 @@ QString Util::getHash(Mlt::Properties& properties)
     }
     return hash;
 }
+
+// Classified once per directory: QStorageInfo stats the volume, which
+// itself costs a round trip on the mounts this is meant to identify, and
+// project media clusters into a few directories.
+static QHash<QString, bool> networkMountCache;
+static QMutex networkMountCacheMutex;
+
+bool Util::isNetworkPath(const QString& path)
+{
+    if (path.startsWith(QLatin1String("//")) || path.startsWith(QLatin1String("\\\\")))
+        return true;
+    const QString dir = QFileInfo(path).absolutePath();
+    {
+        QMutexLocker locker(&networkMountCacheMutex);
+        QHash<QString, bool>::const_iterator it = networkMountCache.constFind(dir);
+        if (it != networkMountCache.constEnd())
+            return it.value();
+    }
+    QStorageInfo storage(dir);
+    if (!storage.isValid()) {
+        QMutexLocker locker(&networkMountCacheMutex);
+        networkMountCache.insert(dir, false);
+        return false;
+    }
+    const QString fsType = QString::fromLatin1(storage.fileSystemType()).toLower();
+    bool result = fsType.contains(QLatin1String("nfs"))  // nfs, nfs4
+        || fsType.contains(QLatin1String("cifs"))
+        || fsType.contains(QLatin1String("smb"))         // smbfs, smb2
+        || fsType.contains(QLatin1String("sshfs"))
+        || fsType.contains(QLatin1String("davfs"))
+        || fsType.contains(QLatin1String("fuse.sshfs"))
+        || fsType.contains(QLatin1String("afp"))
+        || fsType.contains(QLatin1String("9p"))
+        || fsType.contains(QLatin1String("ncpfs"));
+    QMutexLocker locker(&networkMountCacheMutex);
+    networkMountCache.insert(dir, result);
+    return result;
+}
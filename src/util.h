@@ -54,6 +54,10 @@ public:
     static void applyCustomProperties(Mlt::Producer& destination, Mlt::Producer& source, int in, int out);
     static QString getFileHash(const QString& path);
     static QString getHash(Mlt::Properties& properties);
+    //! Whether the path resides on a network-mounted file system (NFS,
+    //! SMB/CIFS, SSHFS, and friends). Classified once per mount point and
+    //! cached; safe to call from any thread.
+    static bool isNetworkPath(const QString& path);
 };
 
 #endif // UTIL_H
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "videoconvert.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace VideoConvert
+{
+
+// Fixed point (x64) limited-range coefficients. Using 6 fractional bits
+// keeps every intermediate sum within int16 (with saturation) for the
+// SSE2 path.
+// R = (yc (Y-16) + vr (V-128) + 32) >> 6
+// G = (yc (Y-16) - gu (U-128) - gv (V-128) + 32) >> 6
+// B = (yc (Y-16) + bu (U-128) + 32) >> 6
+struct Coefficients {
+    int16_t yc;
+    int16_t vr;
+    int16_t gu;
+    int16_t gv;
+    int16_t bu;
+};
+
+static const Coefficients kBt601 = { 74, 102, 25, 52, 129 };
+static const Coefficients kBt709 = { 74, 115, 14, 34, 135 };
+
+static inline uint8_t clamp255(int x)
+{
+    return (x < 0)? 0 : (x > 255)? 255 : uint8_t(x);
+}
+
+static inline void convertPixel(int y, int u, int v, uint8_t* q, const Coefficients& c)
+{
+    int luma = c.yc * (y - 16);
+    u -= 128;
+    v -= 128;
+    q[0] = clamp255((luma + c.vr * v + 32) >> 6);
+    q[1] = clamp255((luma - c.gu * u - c.gv * v + 32) >> 6);
+    q[2] = clamp255((luma + c.bu * u + 32) >> 6);
+    q[3] = 255;
+}
+
+#if !defined(__SSE2__) && !defined(__ARM_NEON)
+static void convertScalar(const uint8_t* srcY, const uint8_t* srcU, const uint8_t* srcV,
+                          uint8_t* dst, int width, int height, const Coefficients& c)
+{
+    for (int y = 0; y < height; y++) {
+        const uint8_t* pY = srcY + y * width;
+        const uint8_t* pU = srcU + (y / 2) * (width / 2);
+        const uint8_t* pV = srcV + (y / 2) * (width / 2);
+        uint8_t* p = dst + y * width * 4;
+        for (int x = 0; x < width; x++)
+            convertPixel(pY[x], pU[x / 2], pV[x / 2], p + x * 4, c);
+    }
+}
+#endif
+
+#if defined(__SSE2__)
+
+// Convert 8 pixels whose luma is in the low 8 bytes of yRow, with chroma
+// expanded to one sample per pixel in u16/v16 (8 x 16-bit each).
+static inline void convert8(__m128i y8, __m128i u16, __m128i v16,
+                            uint8_t* dst, const Coefficients& c)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i y16 = _mm_unpacklo_epi8(y8, zero);
+    y16 = _mm_sub_epi16(y16, _mm_set1_epi16(16));
+    __m128i luma = _mm_mullo_epi16(y16, _mm_set1_epi16(c.yc));
+    u16 = _mm_sub_epi16(u16, _mm_set1_epi16(128));
+    v16 = _mm_sub_epi16(v16, _mm_set1_epi16(128));
+
+    // Saturating adds clamp the rare bright-chroma overflow instead of
+    // wrapping; packus then clamps to 8 bits.
+    __m128i r = _mm_adds_epi16(luma, _mm_mullo_epi16(v16, _mm_set1_epi16(c.vr)));
+    __m128i g = _mm_subs_epi16(luma, _mm_mullo_epi16(u16, _mm_set1_epi16(c.gu)));
+    g = _mm_subs_epi16(g, _mm_mullo_epi16(v16, _mm_set1_epi16(c.gv)));
+    __m128i b = _mm_adds_epi16(luma, _mm_mullo_epi16(u16, _mm_set1_epi16(c.bu)));
+
+    const __m128i rounding = _mm_set1_epi16(32);
+    r = _mm_srai_epi16(_mm_adds_epi16(r, rounding), 6);
+    g = _mm_srai_epi16(_mm_adds_epi16(g, rounding), 6);
+    b = _mm_srai_epi16(_mm_adds_epi16(b, rounding), 6);
+
+    __m128i r8 = _mm_packus_epi16(r, zero);
+    __m128i g8 = _mm_packus_epi16(g, zero);
+    __m128i b8 = _mm_packus_epi16(b, zero);
+    __m128i a8 = _mm_set1_epi8(char(255));
+
+    // Interleave to R G B A.
+    __m128i rg = _mm_unpacklo_epi8(r8, g8);
+    __m128i ba = _mm_unpacklo_epi8(b8, a8);
+    _mm_storeu_si128((__m128i*) dst, _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128((__m128i*) (dst + 16), _mm_unpackhi_epi16(rg, ba));
+}
+
+static void convertSse2(const uint8_t* srcY, const uint8_t* srcU, const uint8_t* srcV,
+                        uint8_t* dst, int width, int height, const Coefficients& c)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int vectorWidth = width & ~15;
+    for (int y = 0; y < height; y++) {
+        const uint8_t* pY = srcY + y * width;
+        const uint8_t* pU = srcU + (y / 2) * (width / 2);
+        const uint8_t* pV = srcV + (y / 2) * (width / 2);
+        uint8_t* p = dst + y * width * 4;
+        for (int x = 0; x < vectorWidth; x += 16) {
+            __m128i y16px = _mm_loadu_si128((const __m128i*) (pY + x));
+            __m128i u8 = _mm_loadl_epi64((const __m128i*) (pU + x / 2));
+            __m128i v8 = _mm_loadl_epi64((const __m128i*) (pV + x / 2));
+            // Duplicate each chroma sample across its two pixels.
+            __m128i u16 = _mm_unpacklo_epi8(u8, u8);
+            __m128i v16 = _mm_unpacklo_epi8(v8, v8);
+            convert8(y16px, _mm_unpacklo_epi8(u16, zero), _mm_unpacklo_epi8(v16, zero),
+                     p + x * 4, c);
+            convert8(_mm_srli_si128(y16px, 8),
+                     _mm_unpackhi_epi8(u16, zero), _mm_unpackhi_epi8(v16, zero),
+                     p + x * 4 + 32, c);
+        }
+        // Scalar tail for widths that are not a multiple of 16.
+        for (int x = vectorWidth; x < width; x++)
+            convertPixel(pY[x], pU[x / 2], pV[x / 2], p + x * 4, c);
+    }
+}
+
+#elif defined(__ARM_NEON)
+
+static void convertNeon(const uint8_t* srcY, const uint8_t* srcU, const uint8_t* srcV,
+                        uint8_t* dst, int width, int height, const Coefficients& c)
+{
+    int vectorWidth = width & ~15;
+    for (int y = 0; y < height; y++) {
+        const uint8_t* pY = srcY + y * width;
+        const uint8_t* pU = srcU + (y / 2) * (width / 2);
+        const uint8_t* pV = srcV + (y / 2) * (width / 2);
+        uint8_t* p = dst + y * width * 4;
+        for (int x = 0; x < vectorWidth; x += 16) {
+            uint8x16_t y8 = vld1q_u8(pY + x);
+            uint8x8_t u8 = vld1_u8(pU + x / 2);
+            uint8x8_t v8 = vld1_u8(pV + x / 2);
+            uint8x8x2_t u2 = vzip_u8(u8, u8);
+            uint8x8x2_t v2 = vzip_u8(v8, v8);
+            for (int half = 0; half < 2; half++) {
+                int16x8_t y16 = vreinterpretq_s16_u16(vmovl_u8(
+                    half? vget_high_u8(y8) : vget_low_u8(y8)));
+                int16x8_t u16 = vreinterpretq_s16_u16(vmovl_u8(u2.val[half]));
+                int16x8_t v16 = vreinterpretq_s16_u16(vmovl_u8(v2.val[half]));
+                int32x4_t lumaLo = vmull_n_s16(vget_low_s16(vsubq_s16(y16, vdupq_n_s16(16))), c.yc);
+                int32x4_t lumaHi = vmull_n_s16(vget_high_s16(vsubq_s16(y16, vdupq_n_s16(16))), c.yc);
+                int16x8_t u0 = vsubq_s16(u16, vdupq_n_s16(128));
+                int16x8_t v0 = vsubq_s16(v16, vdupq_n_s16(128));
+
+                int32x4_t rLo = vmlal_n_s16(lumaLo, vget_low_s16(v0), c.vr);
+                int32x4_t rHi = vmlal_n_s16(lumaHi, vget_high_s16(v0), c.vr);
+                int32x4_t gLo = vmlsl_n_s16(vmlsl_n_s16(lumaLo, vget_low_s16(u0), c.gu),
+                                            vget_low_s16(v0), c.gv);
+                int32x4_t gHi = vmlsl_n_s16(vmlsl_n_s16(lumaHi, vget_high_s16(u0), c.gu),
+                                            vget_high_s16(v0), c.gv);
+                int32x4_t bLo = vmlal_n_s16(lumaLo, vget_low_s16(u0), c.bu);
+                int32x4_t bHi = vmlal_n_s16(lumaHi, vget_high_s16(u0), c.bu);
+
+                uint8x8x4_t rgba;
+                rgba.val[0] = vqmovun_s16(vcombine_s16(vrshrn_n_s32(rLo, 6), vrshrn_n_s32(rHi, 6)));
+                rgba.val[1] = vqmovun_s16(vcombine_s16(vrshrn_n_s32(gLo, 6), vrshrn_n_s32(gHi, 6)));
+                rgba.val[2] = vqmovun_s16(vcombine_s16(vrshrn_n_s32(bLo, 6), vrshrn_n_s32(bHi, 6)));
+                rgba.val[3] = vdup_n_u8(255);
+                vst4_u8(p + (x + half * 8) * 4, rgba);
+            }
+        }
+        for (int x = vectorWidth; x < width; x++)
+            convertPixel(pY[x], pU[x / 2], pV[x / 2], p + x * 4, c);
+    }
+}
+
+#endif
+
+void yuv420pToRgba(const uint8_t* src, uint8_t* dst, int width, int height,
+                   int colorspace)
+{
+    const Coefficients& c = (colorspace == 709)? kBt709 : kBt601;
+    const uint8_t* srcY = src;
+    const uint8_t* srcU = src + width * height;
+    const uint8_t* srcV = srcU + width / 2 * height / 2;
+#if defined(__SSE2__)
+    convertSse2(srcY, srcU, srcV, dst, width, height, c);
+#elif defined(__ARM_NEON)
+    convertNeon(srcY, srcU, srcV, dst, width, height, c);
+#else
+    convertScalar(srcY, srcU, srcV, dst, width, height, c);
+#endif
+}
+
+void yuv420pRectToRgba(const uint8_t* src, uint8_t* dst, int width, int height,
+                       int rectX, int rectY, int rectWidth, int rectHeight,
+                       int colorspace)
+{
+    const Coefficients& c = (colorspace == 709)? kBt709 : kBt601;
+    const uint8_t* srcY = src;
+    const uint8_t* srcU = src + width * height;
+    const uint8_t* srcV = srcU + width / 2 * height / 2;
+    for (int y = 0; y < rectHeight; y++) {
+        const uint8_t* pY = srcY + (rectY + y) * width + rectX;
+        const uint8_t* pU = srcU + ((rectY + y) / 2) * (width / 2) + rectX / 2;
+        const uint8_t* pV = srcV + ((rectY + y) / 2) * (width / 2) + rectX / 2;
+        uint8_t* p = dst + y * rectWidth * 4;
+        for (int x = 0; x < rectWidth; x++)
+            convertPixel(pY[x], pU[(rectX % 2 + x) / 2], pV[(rectX % 2 + x) / 2], p + x * 4, c);
+    }
+}
+
+} // namespace VideoConvert
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIDEOCONVERT_H
+#define VIDEOCONVERT_H
+
+#include <stdint.h>
+
+namespace VideoConvert
+{
+
+/*!
+  Converts a planar YUV 4:2:0 image to packed RGBA.
+
+  \a src points to contiguous Y, U, and V planes as produced by MLT for
+  mlt_image_yuv420p. \a dst must hold width * height * 4 bytes. The BT.709
+  matrix is used when \a colorspace is 709, otherwise BT.601. Both are
+  limited (video) range. The conversion uses SSE2 or NEON when the build
+  targets such a machine and falls back to a scalar loop otherwise.
+*/
+void yuv420pToRgba(const uint8_t* src, uint8_t* dst, int width, int height,
+                   int colorspace);
+
+/*!
+  Converts only a crop rectangle of a planar YUV 4:2:0 image to packed RGBA.
+
+  \a src is the full image as for yuv420pToRgba() with \a width and
+  \a height describing the full image; \a dst must hold
+  rectWidth * rectHeight * 4 bytes and receives the crop at
+  (\a rectX, \a rectY). The cost is proportional to the crop, not the image.
+*/
+void yuv420pRectToRgba(const uint8_t* src, uint8_t* dst, int width, int height,
+                       int rectX, int rectY, int rectWidth, int rectHeight,
+                       int colorspace);
+
+} // namespace VideoConvert
+
+#endif // VIDEOCONVERT_H
@@ -24,9 +24,15 @@
 #include <QToolTip>
 
 static const int TEXT_PAD = 2;
+// Repaint rate for the meter; decouples the widget from the audio frame rate.
+static const int UPDATE_INTERVAL_MS = 33;
 
 AudioMeterWidget::AudioMeterWidget(QWidget *parent): QWidget(parent)
+    , m_pendingNew(false)
 {
+    m_updateTimer.setInterval(UPDATE_INTERVAL_MS);
+    connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(updateMeter()));
+    m_updateTimer.start();
     const QFont& font = QWidget::font();
     const int fontSize = font.pointSize() - (font.pointSize() > 10? 2 : (font.pointSize() > 8? 1 : 0));
     QWidget::setFont(QFont(font.family(), fontSize));
@@ -60,6 +66,26 @@ void AudioMeterWidget::setOrientation(Qt::Orientation orientation)
     calcGraphRect();
 }
 
+void AudioMeterWidget::setLevels(const QVector<double>& dbLevels)
+{
+    QMutexLocker locker(&m_pendingMutex);
+    m_pendingLevels = dbLevels;
+    m_pendingNew = true;
+}
+
+void AudioMeterWidget::updateMeter()
+{
+    QVector<double> levels;
+    {
+        QMutexLocker locker(&m_pendingMutex);
+        if (!m_pendingNew)
+            return;
+        m_pendingNew = false;
+        levels = m_pendingLevels;
+    }
+    showAudio(levels);
+}
+
 void AudioMeterWidget::showAudio(const QVector<double>& dbLevels)
 {
     m_levels = dbLevels;
@@ -75,6 +101,16 @@ void AudioMeterWidget::showAudio(const QVector<double>& dbLevels)
             }
         }
     }
+    const int count = m_levels.size();
+    const double maxScale = IEC_Scale(m_maxDb);
+    m_scaledLevels.resize(count);
+    m_scaledPeaks.resize(count);
+    IEC_ScaleBatch(m_levels.constData(), m_scaledLevels.data(), count);
+    IEC_ScaleBatch(m_peaks.constData(), m_scaledPeaks.data(), count);
+    for (int i = 0; i < count; i++) {
+        m_scaledLevels[i] /= maxScale;
+        m_scaledPeaks[i] /= maxScale;
+    }
     update();
     updateToolTip();
 }
@@ -239,12 +275,12 @@ void AudioMeterWidget::drawChanLabels(QPainter& p)
 
 void AudioMeterWidget::drawBars(QPainter& p)
 {
-    int chanCount = m_levels.size();
+    int chanCount = qMin(m_levels.size(), m_scaledLevels.size());
     QRectF bar;
 
     if (m_orient == Qt::Horizontal) {
         for (int i = 0; i < chanCount; i++) {
-            double level = IEC_ScaleMax(m_levels[i], m_maxDb);
+            double level = m_scaledLevels[i];
             bar.setLeft(m_graphRect.left());
             bar.setRight(bar.left() + m_barSize.width() * level);
             bar.setBottom(m_graphRect.bottom() - (chanCount - 1 - i) * m_barSize.height() - 1);
@@ -253,7 +289,7 @@ void AudioMeterWidget::drawBars(QPainter& p)
         }
     } else {
         for (int i = 0; i < chanCount; i++) {
-            double level = IEC_ScaleMax(m_levels[i], m_maxDb);
+            double level = m_scaledLevels[i];
             bar.setLeft(m_graphRect.left() + i * m_barSize.width() + 1);
             bar.setRight(bar.left() + m_barSize.width() - 1);
             bar.setBottom(m_graphRect.bottom());
@@ -265,14 +301,14 @@ void AudioMeterWidget::drawBars(QPainter& p)
 
 void AudioMeterWidget::drawPeaks(QPainter& p)
 {
-    int chanCount = m_peaks.size();
+    int chanCount = qMin(m_peaks.size(), m_scaledPeaks.size());
     QRectF bar;
 
     if (m_orient == Qt::Horizontal) {
         for (int i = 0; i < chanCount; i++) {
             if (m_peaks[i] == m_levels[i])
                 continue;
-            double level = IEC_ScaleMax(m_peaks[i], m_maxDb);
+            double level = m_scaledPeaks[i];
             bar.setLeft(m_graphRect.left() + m_barSize.width() * level - 3);
             if (bar.left() < m_graphRect.left())
                 continue;
@@ -285,7 +321,7 @@ void AudioMeterWidget::drawPeaks(QPainter& p)
         for (int i = 0; i < chanCount; i++) {
             if (m_peaks[i] == m_levels[i])
                 continue;
-            double level = IEC_ScaleMax(m_peaks[i], m_maxDb);
+            double level = m_scaledPeaks[i];
             bar.setLeft(m_graphRect.left() + i * m_barSize.width() + 1);
             bar.setRight(bar.left() + m_barSize.width() - 2);
             bar.setBottom(m_graphRect.bottom() - m_barSize.height() * level + 3);
@@ -23,6 +23,8 @@
 #include <QVector>
 #include <QStringList>
 #include <QLinearGradient>
+#include <QMutex>
+#include <QTimer>
 #include <stdint.h>
 
 class QLabel;
@@ -36,10 +38,16 @@ public:
     void setChannelLabels(const QStringList& labels);
     void setChannelLabelUnits(const QString& units);
     void setOrientation(Qt::Orientation orientation);
+    /// Thread-safe: publishes the latest levels for the repaint timer to
+    /// pick up without queueing an event per audio frame.
+    void setLevels(const QVector<double>& dbLevels);
 
 public slots:
     void showAudio(const QVector<double>& dbLevels);
 
+private slots:
+    void updateMeter();
+
 protected:
     void paintEvent(QPaintEvent*) Q_DECL_OVERRIDE;
     void resizeEvent(QResizeEvent*) Q_DECL_OVERRIDE;
@@ -57,11 +65,20 @@ private:
     Qt::Orientation m_orient;
     QVector<double> m_levels;
     QVector<double> m_peaks;
+    // Bar and peak positions on the 0..1 IEC scale, converted in one batch
+    // per update instead of one IEC_ScaleMax() per channel per draw pass.
+    QVector<double> m_scaledLevels;
+    QVector<double> m_scaledPeaks;
     QVector<int> m_dbLabels;
     QStringList m_chanLabels;
     QLinearGradient m_gradient;
     double m_maxDb;
     QString m_chanLabelUnits;
+    // Latest levels published from the scope threads, drained at 30 Hz.
+    QMutex m_pendingMutex;
+    QVector<double> m_pendingLevels;
+    bool m_pendingNew;
+    QTimer m_updateTimer;
 };
 
 #endif
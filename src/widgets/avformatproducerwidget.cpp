@@ -21,8 +21,10 @@
 #include "mltcontroller.h"
 #include "shotcut_mlt_properties.h"
 #include "dialogs/filedatedialog.h"
+#include "database.h"
 #include "jobqueue.h"
 #include "jobs/ffprobejob.h"
+#include "keyframeindex.h"
 #include "jobs/ffmpegjob.h"
 #include "jobs/meltjob.h"
 #include "jobs/postjobaction.h"
@@ -179,8 +181,12 @@ void AvformatProducerWidget::onFrameDisplayed(const SharedFrame&)
     onFrameDecoded();
     // We can stop listening to this signal if this is audio-only or if we have
     // received the video resolution.
-    if (m_producer->get_int("audio_index") == -1 || m_producer->get_int("meta.media.width") || m_producer->get_int("meta.media.height"))
+    if (m_producer->get_int("audio_index") == -1 || m_producer->get_int("meta.media.width") || m_producer->get_int("meta.media.height")) {
         disconnect(MLT.videoWidget(), SIGNAL(frameDisplayed(const SharedFrame&)), this, 0);
+        // The media information is complete; build the keyframe index
+        // sidecar in the background if this file does not have one yet.
+        KeyframeIndex::singleton().buildIfMissing(*m_producer);
+    }
 }
 
 void AvformatProducerWidget::onProducerChanged()
@@ -772,51 +778,26 @@ void AvformatProducerWidget::convert(TranscodeDialog& dialog)
     if (result == QDialog::Accepted) {
         QString resource = GetFilenameFromProducer(producer());
         QString path = Settings.savePath();
-        QStringList args;
+        QString suffix;
         QString nameFilter;
-
-        args << "-loglevel" << "verbose";
-        args << "-i" << resource;
-        args << "-max_muxing_queue_size" << "9999";
-        // transcode all streams except data, subtitles, and attachments
-        if (m_producer->get_int("video_index") < m_producer->get_int("audio_index"))
-            args << "-map" << "0:V?" << "-map" << "0:a?";
-        else
-            args << "-map" << "0:a?" << "-map" << "0:V?";
-        args << "-map_metadata" << "0" << "-ignore_unknown";
-        if (ui->rangeComboBox->currentIndex())
-            args << "-vf" << "scale=flags=accurate_rnd+full_chroma_inp+full_chroma_int:in_range=full:out_range=full" << "-color_range" << "jpeg";
-        else
-            args << "-vf" << "scale=flags=accurate_rnd+full_chroma_inp+full_chroma_int:in_range=mpeg:out_range=mpeg" << "-color_range" << "mpeg";
-        if (!ui->scanComboBox->currentIndex())
-            args << "-flags" << "+ildct+ilme" << "-top" << QString::number(ui->fieldOrderComboBox->currentIndex());
+        QStringList args = TranscodeDialog::ffmpegArgs(*m_producer, resource, dialog.format(),
+            ui->scanComboBox->currentIndex(), ui->fieldOrderComboBox->currentIndex(),
+            ui->rangeComboBox->currentIndex(), &suffix);
 
         switch (dialog.format()) {
         case 0:
-            path.append("/%1 - %2.mp4");
             nameFilter = tr("MP4 (*.mp4);;All Files (*)");
-            args << "-f" << "mp4" << "-codec:a" << "ac3" << "-b:a" << "512k" << "-codec:v" << "libx264";
-            args << "-preset" << "medium" << "-g" << "1" << "-crf" << "11";
             break;
         case 1:
-            args << "-f" << "mov" << "-codec:a" << "alac";
-            if (ui->scanComboBox->currentIndex()) { // progressive
-                args << "-codec:v" << "dnxhd" << "-profile:v" << "dnxhr_hq" << "-pix_fmt" << "yuv422p";
-            } else { // interlaced
-                args << "-codec:v" << "prores_ks" << "-profile:v" << "standard";
-            }
-            path.append("/%1 - %2.mov");
             nameFilter = tr("MOV (*.mov);;All Files (*)");
             break;
         case 2:
-            args << "-f" << "matroska" << "-codec:a" << "pcm_f32le" << "-codec:v" << "utvideo";
-            args << "-pix_fmt" << "yuv422p";
-            path.append("/%1 - %2.mkv");
             nameFilter = tr("MKV (*.mkv);;All Files (*)");
             break;
         }
         QFileInfo fi(resource);
-        path = path.arg(fi.completeBaseName()).arg(tr("Converted"));
+        path.append("/%1 - %2.%3");
+        path = path.arg(fi.completeBaseName()).arg(tr("Converted")).arg(suffix);
         QString filename = QFileDialog::getSaveFileName(this, dialog.windowTitle(), path, nameFilter);
         if (!filename.isEmpty()) {
             if (filename == QDir::toNativeSeparators(resource)) {
@@ -832,9 +813,27 @@ void AvformatProducerWidget::convert(TranscodeDialog& dialog)
 
             Settings.setSavePath(QFileInfo(filename).path());
             args << "-y" << filename;
+
+            // Reuse a prior identical conversion from the job history,
+            // possibly made for another project, instead of re-encoding.
+            QString hash = Util::getHash(*m_producer);
+            QStringList fingerprint = args;
+            fingerprint.removeAll(resource);
+            fingerprint.removeAll(filename);
+            QString parameters = fingerprint.join(' ');
+            QString previous = DB.getJobRecordOutput(hash, "convert", parameters);
+            if (!previous.isEmpty() && QFileInfo(previous).size() > 0
+                    && QFile::copy(previous, filename)) {
+                LOG_INFO() << "reusing conversion" << previous << "for" << resource;
+                ConvertReplacePostJobAction action(resource, filename, hash);
+                action.doAction();
+                return;
+            }
+
             FfmpegJob* job = new FfmpegJob(filename, args, false);
             job->setLabel(tr("Convert %1").arg(Util::baseName(filename)));
-            job->setPostJobAction(new ConvertReplacePostJobAction(resource, filename, Util::getHash(*m_producer)));
+            job->setProvenance(hash, "convert", parameters, filename);
+            job->setPostJobAction(new ConvertReplacePostJobAction(resource, filename, hash));
             JOBS.add(job);
         }
     }
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frametimehud.h"
+
+#include <QFontDatabase>
+#include <QPainter>
+#include <algorithm>
+
+static const int kMaxSamples = 120; /// rolling window per stage
+static const int kRefreshMs = 500;
+static const int kPaddingPx = 6;
+static const char* kStageNames[FrameTimeHud::StageCount] = {
+    "frame", "convert", "upload", "render", "present"
+};
+
+FrameTimeHud::FrameTimeHud(QWidget* parent)
+    : QWidget(parent)
+    , m_timerId(0)
+{
+    for (int i = 0; i < StageCount; i++) {
+        m_samples[i].reserve(kMaxSamples);
+        m_nextIndex[i] = 0;
+    }
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setFocusPolicy(Qt::NoFocus);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    hide();
+}
+
+void FrameTimeHud::addSample(Stage stage, qint64 microseconds)
+{
+    // Cheap rejection so instrumented hot paths cost one atomic load while
+    // the HUD is hidden.
+    if (!m_active.load())
+        return;
+    QMutexLocker locker(&m_mutex);
+    QVector<qint64>& ring = m_samples[stage];
+    if (ring.size() < kMaxSamples)
+        ring.append(microseconds);
+    else
+        ring[m_nextIndex[stage]] = microseconds;
+    m_nextIndex[stage] = (m_nextIndex[stage] + 1) % kMaxSamples;
+}
+
+void FrameTimeHud::showEvent(QShowEvent*)
+{
+    m_active.store(1);
+    if (!m_timerId)
+        m_timerId = startTimer(kRefreshMs);
+}
+
+void FrameTimeHud::hideEvent(QHideEvent*)
+{
+    m_active.store(0);
+    if (m_timerId) {
+        killTimer(m_timerId);
+        m_timerId = 0;
+    }
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < StageCount; i++) {
+        m_samples[i].clear();
+        m_nextIndex[i] = 0;
+    }
+}
+
+void FrameTimeHud::timerEvent(QTimerEvent*)
+{
+    updateLines();
+    int w = 0;
+    foreach (const QString& line, m_lines)
+        w = qMax(w, fontMetrics().width(line));
+    resize(w + 2 * kPaddingPx, m_lines.size() * fontMetrics().lineSpacing() + 2 * kPaddingPx);
+    update();
+}
+
+void FrameTimeHud::updateLines()
+{
+    m_lines.clear();
+    m_lines << QString("%1 %2 %3 ms")
+               .arg("stage", -8).arg("p50", 7).arg("p95", 7);
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < StageCount; i++) {
+        // Copy so the percentile sort happens outside the sample rings.
+        QVector<qint64> v = m_samples[i];
+        if (v.isEmpty())
+            continue;
+        std::sort(v.begin(), v.end());
+        qint64 p50 = v.at(v.size() / 2);
+        qint64 p95 = v.at(qMin(v.size() - 1, v.size() * 95 / 100));
+        m_lines << QString("%1 %2 %3")
+                   .arg(QString::fromLatin1(kStageNames[i]), -8)
+                   .arg(p50 / 1000.0, 7, 'f', 2)
+                   .arg(p95 / 1000.0, 7, 'f', 2);
+    }
+}
+
+void FrameTimeHud::paintEvent(QPaintEvent*)
+{
+    QPainter p(this);
+    p.fillRect(rect(), QColor(0, 0, 0, 160));
+    p.setPen(Qt::white);
+    p.setFont(font());
+    int y = kPaddingPx + fontMetrics().ascent();
+    foreach (const QString& line, m_lines) {
+        p.drawText(kPaddingPx, y, line);
+        y += fontMetrics().lineSpacing();
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2020 Meltytech, LLC
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAMETIMEHUD_H
+#define FRAMETIMEHUD_H
+
+#include <QWidget>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QStringList>
+#include <QVector>
+
+/// Opt-in overlay on the video widget showing rolling per-stage timings of
+/// the preview pipeline so "playback is slow" reports can be triaged into
+/// decode/filter, conversion, upload, or present cost. Samples arrive from
+/// the consumer and render threads; the display refreshes at a slow fixed
+/// rate with p50/p95 over a rolling window. Enabled with the
+/// player/frameTimeHud setting.
+class FrameTimeHud : public QWidget
+{
+    Q_OBJECT
+public:
+    enum Stage {
+        FrameStage = 0, ///< interval between consumer-frame-show events
+                        ///< (producer fetch plus filter chain cadence)
+        ConvertStage,   ///< image format conversion for display
+        UploadStage,    ///< texture upload to the GPU
+        RenderStage,    ///< FrameRenderer::showFrame() total
+        PresentStage,   ///< paintGL() draw
+        StageCount
+    };
+
+    explicit FrameTimeHud(QWidget* parent = nullptr);
+
+    /// Thread-safe; a no-op while the HUD is hidden.
+    void addSample(Stage stage, qint64 microseconds);
+
+protected:
+    void paintEvent(QPaintEvent*) Q_DECL_OVERRIDE;
+    void timerEvent(QTimerEvent*) Q_DECL_OVERRIDE;
+    void showEvent(QShowEvent*) Q_DECL_OVERRIDE;
+    void hideEvent(QHideEvent*) Q_DECL_OVERRIDE;
+
+private:
+    void updateLines();
+
+    QAtomicInt m_active;
+    QMutex m_mutex;
+    QVector<qint64> m_samples[StageCount];
+    int m_nextIndex[StageCount];
+    QStringList m_lines;
+    int m_timerId;
+};
+
+#endif // FRAMETIMEHUD_H
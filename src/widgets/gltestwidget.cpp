@@ -50,6 +50,9 @@ void GLTestWidget::initializeGL()
                               tr("Error:\nThis program requires OpenGL version 2.0\nwith the framebuffer object extension."));
             ::exit(EXIT_FAILURE);
         }
+        // Remember that this driver passed so the next launch can skip the
+        // probe. GLWidget clears the flag when the driver identity changes.
+        Settings.setCapabilityOpenGL(true);
         deleteLater();
     }
 }
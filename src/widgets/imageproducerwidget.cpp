@@ -23,20 +23,62 @@
 #include "util.h"
 #include "dialogs/filedatedialog.h"
 #include "proxymanager.h"
+#include "taskpool.h"
 #include <Logger.h>
 #include <QFileInfo>
 #include <QDir>
 #include <QMenu>
 #include <QClipboard>
 #include <QMessageBox>
+#include <QRunnable>
+#include <QSet>
 
 // This legacy property is only used in this widget.
 #define kShotcutResourceProperty "shotcut_resource"
 
+// How many images ahead of the playhead to keep warm during playback.
+static const int kSequenceReadaheadImages = 16;
+
+// Reads an upcoming sequence image on a worker thread so the producer's
+// next open is served from the OS page cache instead of cold storage.
+class SequenceWarmTask : public QRunnable
+{
+public:
+    explicit SequenceWarmTask(const QString& path) : m_path(path) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        QFile file(m_path);
+        if (!file.open(QIODevice::ReadOnly))
+            return;
+        qint64 size = file.size();
+        uchar* data = file.map(0, size);
+        if (data) {
+            // Faulting one byte per page pulls the whole file in without
+            // copying it.
+            static const qint64 kPageSize = 4096;
+            volatile uchar sink = 0;
+            for (qint64 i = 0; i < size; i += kPageSize)
+                sink += data[i];
+            Q_UNUSED(sink);
+            file.unmap(data);
+        } else {
+            file.readAll();
+        }
+    }
+
+private:
+    QString m_path;
+};
+
 ImageProducerWidget::ImageProducerWidget(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::ImageProducerWidget),
-    m_defaultDuration(-1)
+    m_defaultDuration(-1),
+    m_sequencePadding(0),
+    m_sequenceBegin(0),
+    m_warmedUpTo(-1),
+    m_warmedDirection(0)
 {
     ui->setupUi(this);
     Util::setColorsToHighlight(ui->filenameLabel, QPalette::Base);
@@ -107,6 +149,72 @@ void ImageProducerWidget::setProducer(Mlt::Producer* p)
     ui->repeatSpinBox->setEnabled(m_producer->get_int(kShotcutSequenceProperty));
     ui->durationSpinBox->setEnabled(!p->get(kMultitrackItemProperty));
     ui->notesTextEdit->setPlainText(QString::fromUtf8(m_producer->get(kCommentProperty)));
+    connectSequenceReadahead();
+}
+
+void ImageProducerWidget::connectSequenceReadahead()
+{
+    m_sequencePadding = 0;
+    m_warmedUpTo = -1;
+    m_warmedDirection = 0;
+    if (m_producer->get_int(kShotcutSequenceProperty) && m_producer->get(kShotcutResourceProperty)) {
+        // Split the original file name into prefix, padded number, and
+        // suffix the same way on_sequenceCheckBox_clicked() does.
+        QFileInfo info(QString::fromUtf8(m_producer->get(kShotcutResourceProperty)));
+        QString name = info.fileName();
+        QString begin;
+        int i = name.length();
+        int count = 0;
+        for (; i && !name[i - 1].isDigit(); i--) {};
+        for (; i && name[i - 1].isDigit(); i--, count++)
+            begin.prepend(name[i - 1]);
+        if (count) {
+            m_sequenceDir = info.path();
+            m_sequencePrefix = name.left(i);
+            m_sequenceSuffix = name.mid(i + count);
+            m_sequencePadding = count;
+            m_sequenceBegin = begin.toInt();
+            connect(MLT.videoWidget(), SIGNAL(frameDisplayed(const SharedFrame&)),
+                    this, SLOT(onFrameDisplayed(const SharedFrame&)), Qt::UniqueConnection);
+            return;
+        }
+    }
+    disconnect(MLT.videoWidget(), SIGNAL(frameDisplayed(const SharedFrame&)), this, 0);
+}
+
+void ImageProducerWidget::onFrameDisplayed(const SharedFrame& frame)
+{
+    if (!m_producer || !m_producer->is_valid() || !m_sequencePadding)
+        return;
+    double speed = MLT.producer()? MLT.producer()->get_speed() : 0.0;
+    if (speed == 0.0)
+        return; // paused; there is nothing to get ahead of
+    int ttl = qMax(1, m_producer->get_int("ttl"));
+    int image = frame.get_position() / ttl;
+    int direction = (speed < 0.0)? -1 : 1;
+    int stride = qMax(1, qRound(qAbs(speed)));
+    int target = image + direction * stride * kSequenceReadaheadImages;
+
+    // Extend the warmed window instead of re-issuing the whole lookahead
+    // from the current position on every displayed frame. A direction
+    // change or a seek far outside the window restarts it.
+    if (direction != m_warmedDirection
+            || qAbs(target - m_warmedUpTo) > 4 * stride * kSequenceReadaheadImages) {
+        m_warmedDirection = direction;
+        m_warmedUpTo = image;
+    }
+    // Step only while the target is ahead of the warmed window in the play
+    // direction; when the window shrinks (e.g. shuttle speed drops) the
+    // warmed position is already past the target and there is nothing to do.
+    while ((target - m_warmedUpTo) * direction > 0) {
+        m_warmedUpTo += direction;
+        int number = m_sequenceBegin + m_warmedUpTo;
+        if (number < 0)
+            break;
+        const QString path = m_sequenceDir + "/" + m_sequencePrefix
+            + QString("%1").arg(number, m_sequencePadding, 10, QChar('0')) + m_sequenceSuffix;
+        TaskPool::singleton().start(new SequenceWarmTask(path), TaskPool::Background);
+    }
 }
 
 void ImageProducerWidget::updateDuration()
@@ -243,16 +351,27 @@ void ImageProducerWidget::on_sequenceCheckBox_clicked(bool checked)
                 resource = info.path() + "/" + name;
             m_producer->set("resource", resource.toUtf8().constData());
 
-            // Count the number of consecutive files.
+            // Count the number of consecutive files. Read the directory once
+            // and collect the frame numbers in a single pass instead of
+            // testing one candidate file name per frame, which issues
+            // thousands of stat calls on long sequences.
             MAIN.showStatusMessage(tr("Getting length of image sequence..."));
             QCoreApplication::processEvents();
             name = info.fileName();
-            name.replace(i, count, "%1");
-            resource = info.path().append('/').append(name);
-            for (i = j; QFile::exists(resource.arg(i, count, 10, QChar('0'))); ++i) {
-                if (i % 100 == 0)
-                    QCoreApplication::processEvents();
+            QString prefix = name.left(i);
+            QString suffix = name.mid(i + count);
+            QSet<int> frames;
+            foreach (const QString& entry, info.dir().entryList(QDir::Files)) {
+                if (!entry.startsWith(prefix) || !entry.endsWith(suffix))
+                    continue;
+                QString number = entry.mid(prefix.size(), entry.size() - prefix.size() - suffix.size());
+                bool ok = false;
+                int n = number.toInt(&ok);
+                // Require the same zero padding the resource template produces.
+                if (ok && number == QString("%1").arg(n, count, 10, QChar('0')))
+                    frames.insert(n);
             }
+            for (i = j; frames.contains(i); ++i) {}
             i -= j;
             m_producer->set("length", m_producer->frames_to_time(i * m_producer->get_int("ttl"), mlt_time_clock));
             ui->durationSpinBox->setValue(i);
@@ -21,6 +21,7 @@
 #include <QWidget>
 #include "abstractproducerwidget.h"
 #include "mltcontroller.h"
+#include "sharedframe.h"
 
 namespace Ui {
     class ImageProducerWidget;
@@ -82,12 +83,27 @@ private slots:
 
     void on_actionCopyHashCode_triggered();
 
+    void onFrameDisplayed(const SharedFrame&);
+
 private:
     Ui::ImageProducerWidget *ui;
     int m_defaultDuration;
+    // Pieces of the sequence file name derived once per producer, used to
+    // compute the files to warm ahead of the playhead. Padding is 0 when
+    // the producer is not an image sequence.
+    QString m_sequenceDir;
+    QString m_sequencePrefix;
+    QString m_sequenceSuffix;
+    int m_sequencePadding;
+    int m_sequenceBegin;
+    // The warmed window: images up to this index in the current play
+    // direction have been queued for readahead already.
+    int m_warmedUpTo;
+    int m_warmedDirection;
 
     void reopen(Mlt::Producer* p);
     void recreateProducer();
+    void connectSequenceReadahead();
 };
 
 #endif // IMAGEPRODUCERWIDGET_H
@@ -21,6 +21,7 @@
 #include "mltcontroller.h"
 #include "mainwindow.h"
 #include "util.h"
+#include <QDir>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <Logger.h>
@@ -28,6 +29,8 @@
 static const int kLumaComboDissolveIndex = 0;
 static const int kLumaComboCutIndex = 1;
 static const int kLumaComboCustomIndex = 24;
+// Height of the in-widget wipe preview; width follows the display aspect.
+static const int kPreviewHeight = 135;
 
 LumaMixTransition::LumaMixTransition(Mlt::Producer &producer, QWidget *parent)
     : QWidget(parent)
@@ -70,6 +73,11 @@ LumaMixTransition::LumaMixTransition(Mlt::Producer &producer, QWidget *parent)
         }
         ui->mixSlider->setValue(qRound(transition->get_double("start") * 100.0));
     }
+    cachePreviewFrames();
+    transition.reset(getTransition("luma"));
+    if (transition && transition->is_valid())
+        loadPreviewLuma(*transition);
+    updatePreview();
 }
 
 LumaMixTransition::~LumaMixTransition()
@@ -82,6 +90,7 @@ void LumaMixTransition::on_invertCheckBox_clicked(bool checked)
     QScopedPointer<Mlt::Transition> transition(getTransition("luma"));
     if (transition && transition->is_valid()) {
         transition->set("invert", checked);
+        updatePreview();
         MLT.refreshConsumer();
         emit modified();
     }
@@ -101,14 +110,24 @@ void LumaMixTransition::on_softnessSlider_valueChanged(int value)
     if (transition && transition->is_valid()) {
         if (kLumaComboCutIndex == ui->lumaCombo->currentIndex()) {
             setColor(transition.data(), value);
+            loadPreviewLuma(*transition);
         } else {
             transition->set("softness", value / 100.0);
         }
-        MLT.refreshConsumer();
+        updatePreview();
+        // While the slider is being dragged the in-widget preview gives the
+        // feedback; one consumer refresh on release shows the exact result.
+        if (!ui->softnessSlider->isSliderDown())
+            MLT.refreshConsumer();
         emit modified();
     }
 }
 
+void LumaMixTransition::on_softnessSlider_sliderReleased()
+{
+    MLT.refreshConsumer();
+}
+
 void LumaMixTransition::on_crossfadeRadioButton_clicked()
 {
     QScopedPointer<Mlt::Transition> transition(getTransition("mix"));
@@ -213,7 +232,102 @@ void LumaMixTransition::on_lumaCombo_activated(int index)
             }
         }
         updateCustomLumaLabel(*transition);
+        loadPreviewLuma(*transition);
+        updatePreview();
         MLT.refreshConsumer();
         emit modified();
     }
 }
+
+void LumaMixTransition::cachePreviewFrames()
+{
+    // Render the endpoints once through a clone so the player's producer is
+    // not seeked behind its back. These two renders are the only trips
+    // through the MLT pipeline the preview ever makes.
+    int width = qRound(kPreviewHeight * MLT.profile().dar());
+    width -= width % 2;
+    Mlt::Producer clone(MLT.profile(), "xml-string", MLT.XML(&m_producer).toUtf8().constData());
+    if (!clone.is_valid())
+        return;
+    m_previewA = MLT.image(clone, 0, width, kPreviewHeight)
+        .convertToFormat(QImage::Format_ARGB32);
+    m_previewB = MLT.image(clone, clone.get_length() - 1, width, kPreviewHeight)
+        .convertToFormat(QImage::Format_ARGB32);
+    if (m_previewA.size() != m_previewB.size())
+        m_previewB = m_previewB.scaled(m_previewA.size());
+}
+
+void LumaMixTransition::loadPreviewLuma(Mlt::Transition& transition)
+{
+    m_previewLuma = QImage();
+    if (m_previewA.isNull())
+        return;
+    QString resource = QString::fromUtf8(transition.get("resource"));
+    if (resource.isEmpty()) // dissolve: constant weight, no map
+        return;
+    if (resource.startsWith("color:")) {
+        // Cut: a solid gray luma whose level is the cut position.
+        m_previewLuma = QImage(m_previewA.size(), QImage::Format_Grayscale8);
+        m_previewLuma.fill(qRound(QColor(resource.mid(6)).redF() * 255.0));
+        return;
+    }
+    QString path = resource;
+    if (path.startsWith("%")) {
+        // Resolve a bundled luma against the MLT data directory the way
+        // transition_luma does, trying the per-aspect folders in turn.
+        QString name = path.mid(1);
+        QDir dataDir(QString::fromUtf8(mlt_environment("MLT_DATA")));
+        foreach (const QString& subdir, QStringList() << "lumas/16_9" << "lumas/HD"
+                 << "lumas/PAL" << "lumas/NTSC" << "lumas/square") {
+            if (dataDir.exists(subdir + "/" + name)) {
+                path = dataDir.filePath(subdir + "/" + name);
+                break;
+            }
+        }
+    }
+    QImage image(path);
+    if (!image.isNull())
+        m_previewLuma = image.scaled(m_previewA.size())
+            .convertToFormat(QImage::Format_Grayscale8);
+}
+
+void LumaMixTransition::updatePreview()
+{
+    if (m_previewA.isNull() || m_previewB.isNull()) {
+        ui->previewLabel->hide();
+        return;
+    }
+    const int width = m_previewA.width();
+    const int height = m_previewA.height();
+    // Composite at the transition midpoint so the softness of the wipe
+    // edge is visible; the weight approximates transition_luma's
+    // softness-expanded ramp.
+    const qreal position = 0.5;
+    const qreal softness = ui->softnessSlider->value() / 100.0;
+    const bool invert = ui->invertCheckBox->isChecked();
+    const qreal mix = position * (1.0 + 2.0 * softness) - softness;
+    QImage result(width, height, QImage::Format_ARGB32);
+    for (int y = 0; y < height; ++y) {
+        const QRgb* a = reinterpret_cast<const QRgb*>(m_previewA.constScanLine(y));
+        const QRgb* b = reinterpret_cast<const QRgb*>(m_previewB.constScanLine(y));
+        const uchar* luma = m_previewLuma.isNull()? nullptr : m_previewLuma.constScanLine(y);
+        QRgb* out = reinterpret_cast<QRgb*>(result.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            qreal weight = position; // dissolve
+            if (luma) {
+                qreal level = luma[x] / 255.0;
+                if (invert)
+                    level = 1.0 - level;
+                if (softness > 0.0)
+                    weight = qBound(0.0, (mix + softness - level) / (2.0 * softness), 1.0);
+                else
+                    weight = (level <= mix)? 1.0 : 0.0;
+            }
+            out[x] = qRgb(qRound(qRed(a[x]) * (1.0 - weight) + qRed(b[x]) * weight),
+                          qRound(qGreen(a[x]) * (1.0 - weight) + qGreen(b[x]) * weight),
+                          qRound(qBlue(a[x]) * (1.0 - weight) + qBlue(b[x]) * weight));
+        }
+    }
+    ui->previewLabel->setPixmap(QPixmap::fromImage(result));
+    ui->previewLabel->show();
+}
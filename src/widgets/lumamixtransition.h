@@ -18,6 +18,7 @@
 #ifndef LUMAMIXTRANSITION_H
 #define LUMAMIXTRANSITION_H
 
+#include <QImage>
 #include <QWidget>
 #include <MltProducer.h>
 #include <MltTransition.h>
@@ -41,7 +42,9 @@ private slots:
     void on_invertCheckBox_clicked(bool checked);
     
     void on_softnessSlider_valueChanged(int value);
-    
+
+    void on_softnessSlider_sliderReleased();
+
     void on_crossfadeRadioButton_clicked();
     
     void on_mixRadioButton_clicked();
@@ -53,9 +56,18 @@ private slots:
 private:
     Ui::LumaMixTransition *ui;
     Mlt::Producer m_producer;
+    // Downscaled endpoint frames rendered once when the panel opens, plus
+    // the luma map at preview size. updatePreview() composites them in
+    // software so scrubbing the sliders never renders through MLT.
+    QImage m_previewA;
+    QImage m_previewB;
+    QImage m_previewLuma;
 
     Mlt::Transition* getTransition(const QString& name);
     void updateCustomLumaLabel(Mlt::Transition &transition);
+    void cachePreviewFrames();
+    void loadPreviewLuma(Mlt::Transition& transition);
+    void updatePreview();
 };
 
 #endif // LUMAMIXTRANSITION_H
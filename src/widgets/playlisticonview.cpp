@@ -43,7 +43,8 @@ QRect PlaylistIconView::visualRect(const QModelIndex &index) const
 {
     int row = index.row() / m_itemsPerRow;
     int col = index.row() % m_itemsPerRow;
-    return QRect(col * m_gridSize.width(), row * m_gridSize.height(),
+    return QRect(col * m_gridSize.width(),
+            row * m_gridSize.height() - verticalScrollBar()->value(),
             m_gridSize.width(), m_gridSize.height());
 }
 
@@ -64,14 +65,23 @@ void PlaylistIconView::rowsAboutToBeRemoved(const QModelIndex &parent, int start
 void PlaylistIconView::dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
 {
     QAbstractItemView::dataChanged(topLeft, bottomRight, roles);
-    updateSizes();
-    viewport()->update();
+    // A data change does not move items, so invalidate only their rects.
+    if (!topLeft.isValid() || !bottomRight.isValid()) {
+        viewport()->update();
+        return;
+    }
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++)
+        viewport()->update(visualRect(model()->index(row, 0)));
 }
 
 void PlaylistIconView::selectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
 {
     QAbstractItemView::selectionChanged(selected, deselected);
-    viewport()->update();
+    // Repaint only the items whose selection state changed.
+    foreach (const QModelIndex& idx, selected.indexes())
+        viewport()->update(visualRect(idx));
+    foreach (const QModelIndex& idx, deselected.indexes())
+        viewport()->update(visualRect(idx));
 }
 
 void PlaylistIconView::scrollTo(const QModelIndex &index, ScrollHint hint)
@@ -145,23 +155,35 @@ QRegion PlaylistIconView::visualRegionForSelection(const QItemSelection &selecti
 
 void PlaylistIconView::currentChanged(const QModelIndex &current, const QModelIndex &previous)
 {
-    viewport()->update();
+    if (previous.isValid())
+        viewport()->update(visualRect(previous));
+    if (current.isValid())
+        viewport()->update(visualRect(current));
     QAbstractItemView::currentChanged(current, previous);
 }
 
-void PlaylistIconView::paintEvent(QPaintEvent*)
+void PlaylistIconView::paintEvent(QPaintEvent* event)
 {
     QPainter painter(viewport());
     QPalette pal(palette());
-    painter.fillRect(rect(), pal.base());
+    painter.fillRect(event->rect(), pal.base());
+    painter.setClipRect(event->rect());
 
     if (!model())
         return;
 
     QAbstractItemModel * m = model();
     QRect dragIndicator;
+    const int scroll = verticalScrollBar()->value();
 
-    for (int row = 0; row <= m->rowCount() / m_itemsPerRow; row++) {
+    // The grid position is pure arithmetic on the index, so lay out and
+    // paint only the rows that intersect the update rect; a one-item dirty
+    // rect (selection change) costs one item, not the whole bin.
+    const int firstRow = qMax(0, (event->rect().top() + scroll) / m_gridSize.height());
+    const int lastRow = qMin(m->rowCount() / m_itemsPerRow,
+            (event->rect().bottom() + scroll) / m_gridSize.height());
+
+    for (int row = firstRow; row <= lastRow; row++) {
         for (int col = 0; col < m_itemsPerRow; col++) {
             const int rowIdx = row * m_itemsPerRow + col;
 
@@ -169,12 +191,9 @@ void PlaylistIconView::paintEvent(QPaintEvent*)
             if (!idx.isValid())
                 break;
 
-            QRect itemRect(col * m_gridSize.width(), row * m_gridSize.height() - verticalScrollBar()->value(),
+            QRect itemRect(col * m_gridSize.width(), row * m_gridSize.height() - scroll,
                     m_gridSize.width(), m_gridSize.height());
 
-            if (itemRect.bottom() < 0 || itemRect.top() > this->height())
-                continue;
-
             const bool selected = selectedIndexes().contains(idx);
             const QImage thumb = idx.data(Qt::DecorationRole).value<QImage>();
 
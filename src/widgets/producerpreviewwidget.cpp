@@ -24,6 +24,7 @@
 #include <QHBoxLayout>
 #include <QImage>
 #include <QLabel>
+#include <QPixmap>
 #include <QProgressBar>
 #include <QVBoxLayout>
 
@@ -132,7 +133,10 @@ void ProducerPreviewWidget::timerEvent(QTimerEvent*)
     if( m_queue.count() > 0 )
     {
         QueueItem item = m_queue.pop();
-        m_imageLabel->setPixmap(item.pixmap);
+        // Convert to a pixmap here on the GUI thread; QPixmap is not safe to
+        // use from the generator thread and the conversion cost belongs to
+        // the display rate, not the decode rate.
+        m_imageLabel->setPixmap(QPixmap::fromImage(item.image));
         m_scrubber->onSeek(item.position);
     }
 }
@@ -162,9 +166,10 @@ void ProducerPreviewWidget::frameGeneratorThread()
         uint8_t* mltImage = frame->get_image( format, width, height, 0 );
         QImage image( mltImage, width, height, QImage::Format_RGB888 );
 
-        // Send the image and status in the queue
+        // Send the image and status in the queue. Copy since the buffer
+        // belongs to the frame, which is deleted below.
         QueueItem item;
-        item.pixmap.convertFromImage(image);
+        item.image = image.copy();
         item.position = position;
         m_queue.push(item);
 
@@ -21,7 +21,7 @@
 #include "dataqueue.h"
 
 #include <QFuture>
-#include <QPixmap>
+#include <QImage>
 #include <QWidget>
 
 class QLabel;
@@ -57,7 +57,7 @@ private:
     Mlt::Producer* m_producer;
     struct QueueItem
     {
-        QPixmap pixmap;
+        QImage image;
         int position;
     };
     DataQueue<QueueItem> m_queue;
@@ -43,7 +43,9 @@ AudioLoudnessScopeWidget::AudioLoudnessScopeWidget()
   , m_loudnessFilter(0)
   , m_peak(-100)
   , m_true_peak(-100)
-  , m_newData(false)
+  , m_resultsSequence(0)
+  , m_resetPeaks(0)
+  , m_displayedSequence(0)
   , m_orientation((Qt::Orientation)-1)
   , m_qview(new QQuickWidget(QmlUtilities::sharedEngine(), this))
   , m_timeLabel(new QLabel(this))
@@ -135,6 +137,12 @@ AudioLoudnessScopeWidget::~AudioLoudnessScopeWidget()
 
 void AudioLoudnessScopeWidget::refreshScope(const QSize& /*size*/, bool /*full*/)
 {
+    if (m_resetPeaks.testAndSetAcquire(1, 0)) {
+        m_peak = -100;
+        m_true_peak = -100;
+    }
+
+    bool newData = false;
     SharedFrame sFrame;
     while (m_queue.count() > 0) {
         sFrame = m_queue.pop();
@@ -153,13 +161,27 @@ void AudioLoudnessScopeWidget::refreshScope(const QSize& /*size*/, bool /*full*/
                 if( m_true_peak < m_loudnessFilter->get_double("true_peak") ) {
                     m_true_peak = m_loudnessFilter->get_double("true_peak");
                 }
-                m_newData = true;
+                newData = true;
             }
         }
     }
 
-    // Update the time with every frame.
-    m_timeLabel->setText( m_loudnessFilter->get_time( "frames_processed" ) );
+    // Publish one batch of results per refresh into the mailbox no matter
+    // how many frames were processed. The GUI thread never touches the
+    // filter's measurement properties while this thread is feeding it.
+    if (newData) {
+        Results results;
+        results.program = m_loudnessFilter->get_double("program");
+        results.shortterm = m_loudnessFilter->get_double("shortterm");
+        results.momentary = m_loudnessFilter->get_double("momentary");
+        results.range = m_loudnessFilter->get_double("range");
+        results.peak = m_peak;
+        results.truePeak = m_true_peak;
+        qstrncpy(results.time, m_loudnessFilter->get_time("frames_processed"), sizeof(results.time));
+        m_resultsSequence.fetchAndAddOrdered(1);
+        m_results = results;
+        m_resultsSequence.fetchAndAddOrdered(1);
+    }
 }
 
 QString AudioLoudnessScopeWidget::getTitle()
@@ -252,22 +274,36 @@ void AudioLoudnessScopeWidget::onTruePeakToggled(bool checked)
 
 void AudioLoudnessScopeWidget::updateMeters(void)
 {
-    if (!m_newData) return;
-    if (m_loudnessFilter->get_int("calc_program") )
-        m_qview->rootObject()->setProperty("integrated", onedec(m_loudnessFilter->get_double("program")));
-    if (m_loudnessFilter->get_int("calc_shortterm") )
-        m_qview->rootObject()->setProperty("shortterm", onedec(m_loudnessFilter->get_double("shortterm")));
-    if (m_loudnessFilter->get_int("calc_momentary") )
-        m_qview->rootObject()->setProperty("momentary", onedec(m_loudnessFilter->get_double("momentary")));
-    if (m_loudnessFilter->get_int("calc_range") )
-        m_qview->rootObject()->setProperty("range", onedec(m_loudnessFilter->get_double("range")));
-    if (m_loudnessFilter->get_int("calc_peak") )
-        m_qview->rootObject()->setProperty("peak", onedec(m_peak));
-    if (m_loudnessFilter->get_int("calc_true_peak") )
-        m_qview->rootObject()->setProperty("truePeak", onedec(m_true_peak));
-    m_peak = -100;
-    m_true_peak = -100;
-    m_newData = false;
+    // Snapshot the mailbox; retry while the scope thread is mid-publish
+    // (odd sequence) or published again during the copy.
+    Results results;
+    int sequence;
+    for (;;) {
+        sequence = m_resultsSequence.loadAcquire();
+        if (!(sequence & 1)) {
+            results = m_results;
+            if (m_resultsSequence.loadAcquire() == sequence)
+                break;
+        }
+    }
+
+    if (sequence == m_displayedSequence) return;
+    m_displayedSequence = sequence;
+
+    if (Settings.loudnessScopeShowMeter("integrated"))
+        m_qview->rootObject()->setProperty("integrated", onedec(results.program));
+    if (Settings.loudnessScopeShowMeter("shortterm"))
+        m_qview->rootObject()->setProperty("shortterm", onedec(results.shortterm));
+    if (Settings.loudnessScopeShowMeter("momentary"))
+        m_qview->rootObject()->setProperty("momentary", onedec(results.momentary));
+    if (Settings.loudnessScopeShowMeter("range"))
+        m_qview->rootObject()->setProperty("range", onedec(results.range));
+    if (Settings.loudnessScopeShowMeter("peak"))
+        m_qview->rootObject()->setProperty("peak", onedec(results.peak));
+    if (Settings.loudnessScopeShowMeter("truepeak"))
+        m_qview->rootObject()->setProperty("truePeak", onedec(results.truePeak));
+    m_timeLabel->setText(results.time);
+    m_resetPeaks.storeRelease(1);
 }
 
 bool AudioLoudnessScopeWidget::event(QEvent *event)
@@ -20,6 +20,7 @@
 #define AUDIOLOUDNESSSCOPEWIDGET_H
 
 #include "scopewidget.h"
+#include <QAtomicInt>
 #include <QMutex>
 #include <QImage>
 #include <QVector>
@@ -58,13 +59,33 @@ private:
     // Functions run in scope thread.
     void refreshScope(const QSize& size, bool full) Q_DECL_OVERRIDE;
 
+    // One batch of measurements published by the scope thread.
+    struct Results
+    {
+        double program;
+        double shortterm;
+        double momentary;
+        double range;
+        double peak;
+        double truePeak;
+        char time[20];
+    };
+
     // Members accessed by scope thread.
     Mlt::Filter* m_loudnessFilter;
     double m_peak;
     double m_true_peak;
-    bool m_newData;
+
+    // Seqlock-style mailbox between the scope thread and the 10Hz timer:
+    // the writer bumps the sequence to odd, stores, and bumps to even; the
+    // reader retries until it sees a stable even sequence. Neither side
+    // ever blocks the other.
+    Results m_results;
+    QAtomicInt m_resultsSequence;
+    QAtomicInt m_resetPeaks;
 
     // Members accessed by GUI thread.
+    int m_displayedSequence;
     Qt::Orientation m_orientation;
     QQuickWidget* m_qview;
     QLabel* m_timeLabel;
@@ -22,18 +22,14 @@
 #include <MltProfile.h>
 #include "widgets/audiometerwidget.h"
 #include "mltcontroller.h"
-#include <cmath> // log10()
 
 AudioPeakMeterScopeWidget::AudioPeakMeterScopeWidget()
   : ScopeWidget("AudioPeakMeter")
-  , m_filter(0)
   , m_audioMeter(0)
   , m_orientation((Qt::Orientation)-1)
   , m_channels( 0 )
 {
     LOG_DEBUG() << "begin";
-    m_filter = new Mlt::Filter(MLT.profile(), "audiolevel");
-    m_filter->set("iec_scale", 0);
     qRegisterMetaType< QVector<double> >("QVector<double>");
     setAutoFillBackground(true);
 
@@ -50,7 +46,6 @@ AudioPeakMeterScopeWidget::AudioPeakMeterScopeWidget()
 
 AudioPeakMeterScopeWidget::~AudioPeakMeterScopeWidget()
 {
-    delete m_filter;
 }
 
 void AudioPeakMeterScopeWidget::refreshScope(const QSize& /*size*/, bool /*full*/)
@@ -59,24 +54,18 @@ void AudioPeakMeterScopeWidget::refreshScope(const QSize& /*size*/, bool /*full*
     while (m_queue.count() > 0) {
         sFrame = m_queue.pop();
         if (sFrame.is_valid() && sFrame.get_audio_samples() > 0) {
-            mlt_audio_format format = mlt_audio_s16;
             int channels = sFrame.get_audio_channels();
-            int frequency = sFrame.get_audio_frequency();
-            int samples = sFrame.get_audio_samples();
-            Mlt::Frame mFrame = sFrame.clone(true, false, false);
-            m_filter->process(mFrame);
-            mFrame.get_audio( format, frequency, channels, samples );
+            // The frame caches the analysis, so other meters fed the same
+            // frame do not repeat it.
+            const double* peaks = sFrame.get_audio_peaks();
+            if (!peaks)
+                continue;
             QVector<double> levels;
-            for (int i = 0; i < channels; i++) {
-                QString s = QString("meta.media.audio_level.%1").arg(i);
-                double audioLevel = mFrame.get_double(s.toLatin1().constData());
-                if (audioLevel == 0.0) {
-                    levels << -100.0;
-                } else {
-                    levels << 20 * log10(audioLevel);
-                }
-            }
-            QMetaObject::invokeMethod(m_audioMeter, "showAudio", Qt::QueuedConnection, Q_ARG(const QVector<double>&, levels));
+            for (int i = 0; i < channels; i++)
+                levels << peaks[i];
+            // Publish directly; the meter repaints from its own 30 Hz timer
+            // instead of queueing an event per audio frame.
+            m_audioMeter->setLevels(levels);
             if (m_channels != channels) {
                 m_channels = channels;
                 QMetaObject::invokeMethod(this, "reconfigureMeter", Qt::QueuedConnection);
@@ -23,7 +23,6 @@
 #include <QMutex>
 #include <QImage>
 #include <QVector>
-#include <MltFilter.h>
 
 class AudioMeterWidget;
 
@@ -41,9 +40,6 @@ private:
     // Functions run in scope thread.
     void refreshScope(const QSize& size, bool full) Q_DECL_OVERRIDE;
 
-    // Members accessed by scope thread.
-    Mlt::Filter* m_filter;
-
     // Members accessed by GUI thread.
     AudioMeterWidget* m_audioMeter;
     Qt::Orientation m_orientation;
@@ -18,14 +18,14 @@
 
 #include "audiospectrumscopewidget.h"
 #include "widgets/audiometerwidget.h"
+#include "widgets/iecscale.h"
 #include <Logger.h>
 #include <QPainter>
 #include <QtAlgorithms>
 #include <QVBoxLayout>
-#include <MltProfile.h>
 #include <cmath>
 
-static const int WINDOW_SIZE = 8000; // 6 Hz FFT bins at 48kHz
+static const int WINDOW_SIZE = 8192; // ~6 Hz FFT bins at 48kHz
 
 struct band
 {
@@ -96,12 +96,12 @@ AudioSpectrumScopeWidget::AudioSpectrumScopeWidget()
     LOG_DEBUG() << "begin";
 
     // Setup this widget
+    setTargetRefreshRate(30);
     qRegisterMetaType< QVector<double> >("QVector<double>");
 
-    // Create the FFT filter
-    Mlt::Profile profile;
-    m_filter = new Mlt::Filter(profile, "fft");
-    m_filter->set("window_size", WINDOW_SIZE);
+    // Create the incremental FFT engine. It keeps the sliding sample window
+    // between refreshes so each frame only contributes its new samples.
+    m_stft.reset(new StftEngine(WINDOW_SIZE));
 
     // Add the audio signal widget
     QVBoxLayout *vlayout = new QVBoxLayout(this);
@@ -131,15 +131,14 @@ AudioSpectrumScopeWidget::AudioSpectrumScopeWidget()
 
 AudioSpectrumScopeWidget::~AudioSpectrumScopeWidget()
 {
-    delete m_filter;
 }
 
-void AudioSpectrumScopeWidget::processSpectrum()
+void AudioSpectrumScopeWidget::processSpectrum(int frequency)
 {
     QVector<double> bands(AUDIBLE_BAND_COUNT);
-    float* bins = (float*)m_filter->get_data("bins");
-    int bin_count = m_filter->get_int("bin_count");
-    double bin_width = m_filter->get_double("bin_width");
+    const float* bins = m_magnitudes.constData();
+    int bin_count = m_magnitudes.size();
+    double bin_width = m_stft->binWidth(frequency);
 
     int band = 0;
     bool firstBandFound = false;
@@ -172,38 +171,35 @@ void AudioSpectrumScopeWidget::processSpectrum()
     }
 
     // At this point, bands contains the magnitude of the signal for each
-    // band. Convert to dB.
-    for (band = 0; band < bands.size(); band++) {
-        double mag = bands[band];
-        double dB = mag > 0.0 ? 20 * log10( mag ) : -1000.0;
-        bands[band] = dB;
-    }
-
-    // Update the audio signal widget
-    QMetaObject::invokeMethod(m_audioMeter, "showAudio", Qt::QueuedConnection, Q_ARG(const QVector<double>&, bands));
+    // band. Convert to dB, all bands in one batch.
+    float magnitude[AUDIBLE_BAND_COUNT];
+    for (band = 0; band < bands.size(); band++)
+        magnitude[band] = bands[band];
+    IEC_DbBatch(magnitude, bands.data(), bands.size(), -1000.0);
+
+    // Update the audio signal widget. Publish directly; the meter repaints
+    // from its own 30 Hz timer instead of queueing an event per audio frame.
+    m_audioMeter->setLevels(bands);
 }
 
 void AudioSpectrumScopeWidget::refreshScope(const QSize& /*size*/, bool /*full*/)
 {
-    bool refresh = false;
+    int frequency = 0;
     SharedFrame sFrame;
 
     while (m_queue.count() > 0) {
         sFrame = m_queue.pop();
         if (sFrame.is_valid() && sFrame.get_audio_samples() > 0) {
-            mlt_audio_format format = mlt_audio_s16;
-            int channels = sFrame.get_audio_channels();
-            int frequency = sFrame.get_audio_frequency();
-            int samples = sFrame.get_audio_samples();
-            Mlt::Frame mFrame = sFrame.clone(true, false, false);
-            m_filter->process(mFrame);
-            mFrame.get_audio( format, frequency, channels, samples );
-            refresh = true;
+            frequency = sFrame.get_audio_frequency();
+            m_stft->push(sFrame.get_audio(), sFrame.get_audio_samples(),
+                         sFrame.get_audio_channels());
         }
     }
 
-    if (refresh) {
-        processSpectrum();
+    // One transform per refresh over the sliding window, no matter how many
+    // frames were queued while this thread was busy.
+    if (frequency && m_stft->analyze(m_magnitudes)) {
+        processSpectrum(frequency);
     }
 }
 
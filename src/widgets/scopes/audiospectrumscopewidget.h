@@ -21,7 +21,8 @@
 
 
 #include "scopewidget.h"
-#include <MltFilter.h>
+#include "stftengine.h"
+#include <QScopedPointer>
 
 class AudioMeterWidget;
 
@@ -37,10 +38,11 @@ public:
 private:
     // Functions run in scope thread.
     void refreshScope(const QSize& size, bool full) Q_DECL_OVERRIDE;
-    void processSpectrum();
+    void processSpectrum(int frequency);
 
     // Members accessed by scope thread.
-    Mlt::Filter* m_filter;
+    QScopedPointer<StftEngine> m_stft;
+    QVector<float> m_magnitudes;
 
     // Members accessed only in the GUI thread
     AudioMeterWidget* m_audioMeter;
@@ -24,8 +24,11 @@
 #include <QResizeEvent>
 #include <QToolTip>
 #include <cmath>
+#include <string.h>
 
 static const qreal MAX_AMPLITUDE = 32768.0;
+// Seconds of audio history across the width of the scrolling backbuffer.
+static const qreal WINDOW_SECONDS = 2.0;
 
 static int graphHeight(const QSize& widgetSize, int maxChan, int padding)
 {
@@ -55,11 +58,12 @@ AudioWaveformScopeWidget::AudioWaveformScopeWidget()
   : ScopeWidget("AudioWaveform")
   , m_renderWave()
   , m_graphTopPadding(0)
-  , m_channels(0)
+  , m_pendingSamples(0.0)
   , m_cursorPos(-1)
   , m_mutex(QMutex::NonRecursive)
   , m_displayWave()
   , m_displayGrid()
+  , m_channels(0)
 {
     LOG_DEBUG() << "begin";
     setAutoFillBackground(true);
@@ -74,102 +78,118 @@ AudioWaveformScopeWidget::~AudioWaveformScopeWidget()
 
 void AudioWaveformScopeWidget::refreshScope(const QSize& size, bool full)
 {
-    m_mutex.lock();
-    QSize prevSize = m_displayWave.size();
+    QVector<SharedFrame> newFrames;
     while (m_queue.count() > 0) {
-        m_frame = m_queue.pop();
+        SharedFrame frame = m_queue.pop();
+        if (frame.is_valid() && frame.get_audio_samples() > 0) {
+            newFrames.append(frame);
+        }
     }
-    m_mutex.unlock();
 
     // Check if a full refresh should be forced.
-    int channels = 2;
-    if (m_frame.is_valid() && m_frame.get_audio_channels() > 0) {
-        channels = m_frame.get_audio_channels();
+    int channels = m_channels > 0 ? m_channels : 2;
+    if (!newFrames.isEmpty() && newFrames.last().get_audio_channels() > 0) {
+        channels = newFrames.last().get_audio_channels();
     }
-    if (prevSize != size || channels != m_channels) {
+    if (m_renderWave.size() != size || channels != m_channels) {
+        m_mutex.lock();
         m_channels = channels;
+        m_mutex.unlock();
         full = true;
     }
 
     if (full) {
         createGrid(size);
+        m_renderWave = QImage(size, QImage::Format_ARGB32_Premultiplied);
+        m_renderWave.fill(Qt::transparent);
+        m_pendingMin.fill(0.0, m_channels);
+        m_pendingMax.fill(0.0, m_channels);
+        m_pendingSamples = 0.0;
+        m_mutex.lock();
+        m_columnPeaks.fill(0, size.width() * m_channels);
+        m_mutex.unlock();
     }
 
-    if (m_renderWave.size() != size) {
-        m_renderWave = QImage(size, QImage::Format_ARGB32_Premultiplied);
+    // Reduce the newly arrived samples to per-column min/max pairs at the
+    // window's time per column. Partial columns carry over to the next
+    // refresh in the pending accumulators.
+    QVector<qreal> colMins;
+    QVector<qreal> colMaxs;
+    foreach (const SharedFrame& frame, newFrames) {
+        int samples = frame.get_audio_samples();
+        int frameChannels = frame.get_audio_channels();
+        qreal samplesPerColumn =
+            qMax((qreal)frame.get_audio_frequency() * WINDOW_SECONDS / size.width(), 1.0);
+        const int16_t* audio = frame.get_audio();
+        for (int i = 0; i < samples; i++) {
+            for (int c = 0; c < m_channels; c++) {
+                // Invert the polarity because QT draws from top to bottom.
+                qreal value = -audio[i * frameChannels + qMin(c, frameChannels - 1)];
+                if (value > m_pendingMax[c]) m_pendingMax[c] = value;
+                if (value < m_pendingMin[c]) m_pendingMin[c] = value;
+            }
+            if (++m_pendingSamples >= samplesPerColumn) {
+                m_pendingSamples -= samplesPerColumn;
+                for (int c = 0; c < m_channels; c++) {
+                    colMins.append(m_pendingMin[c]);
+                    colMaxs.append(m_pendingMax[c]);
+                    m_pendingMin[c] = 0.0;
+                    m_pendingMax[c] = 0.0;
+                }
+            }
+        }
     }
 
-    m_renderWave.fill(Qt::transparent);
+    int newCols = colMins.size() / qMax(m_channels, 1);
+    if (newCols > 0) {
+        // Scroll the backbuffer left and paint only the trailing strip like
+        // a hardware scope; the surviving columns are just moved.
+        int shift = qMin(newCols, size.width());
+        int keep = size.width() - shift;
+        for (int y = 0; y < m_renderWave.height(); y++) {
+            uchar* line = m_renderWave.scanLine(y);
+            memmove(line, line + shift * 4, keep * 4);
+        }
 
-    QPainter p(&m_renderWave);
-    p.setRenderHint(QPainter::Antialiasing, true);
-    QColor penColor(palette().text().color());
-    penColor.setAlpha(255/2);
-    QPen pen(penColor);
-    pen.setWidth(0);
-    p.setPen(pen);
+        QPainter p(&m_renderWave);
+        p.setCompositionMode(QPainter::CompositionMode_Source);
+        p.fillRect(keep, 0, shift, size.height(), Qt::transparent);
+        p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        QColor penColor(palette().text().color());
+        penColor.setAlpha(255/2);
+        QPen pen(penColor);
+        pen.setWidth(0);
+        p.setPen(pen);
 
-    if (m_frame.is_valid() && m_frame.get_audio_samples() > 0) {
-        int samples = m_frame.get_audio_samples();
-        int16_t* audio = (int16_t*)m_frame.get_audio();
         int waveAmplitude = graphHeight(size, m_channels, m_graphTopPadding) / 2;
         qreal scaleFactor = (qreal)waveAmplitude / (qreal)MAX_AMPLITUDE;
 
-        for (int c = 0; c < m_channels; c++)
-        {
-            p.save();
-            int y = graphCenterY(size, c, m_channels, m_graphTopPadding);
-            p.translate(0, y);
-
-            // For each x position on the waveform, find the min and max sample
-            // values that apply to that position. Draw a vertical line from the
-            // min value to the max value.
-            QPoint high;
-            QPoint low;
-            int lastX = 0;
-            const int16_t* q = audio + c;
-            // Invert the polarity because QT draws from top to bottom.
-            int16_t value = *q * -1;
-            qreal max = value;
-            qreal min = value;
-
-            for (int i = 0; i <= samples; i++)
-            {
-                int x = ( i * size.width() ) / samples;
-                if (x != lastX) {
-                    // The min and max have been determined for the previous x
-                    // So draw the line
-                    high.setX(lastX);
-                    high.setY(max * scaleFactor);
-                    low.setX(lastX);
-                    low.setY(min * scaleFactor);
-                    if (high.y() == low.y()) {
-                        p.drawPoint(high);
-                    } else {
-                        p.drawLine(low, high);
-                    }
-                    lastX = x;
-
-                    // Swap max and min so that the next line picks up where
-                    // this one left off.
-                    int tmp = max;
-                    max = min;
-                    min = tmp;
+        m_mutex.lock();
+        memmove(m_columnPeaks.data(), m_columnPeaks.constData() + shift * m_channels,
+                keep * m_channels * sizeof(int16_t));
+        for (int j = 0; j < shift; j++) {
+            // When more columns arrived than fit, only the newest survive.
+            int col = newCols - shift + j;
+            int x = keep + j;
+            for (int c = 0; c < m_channels; c++) {
+                qreal min = colMins[col * m_channels + c];
+                qreal max = colMaxs[col * m_channels + c];
+                int y = graphCenterY(size, c, m_channels, m_graphTopPadding);
+                if (qRound(max * scaleFactor) == qRound(min * scaleFactor)) {
+                    p.drawPoint(x, y + max * scaleFactor);
+                } else {
+                    p.drawLine(x, y + min * scaleFactor, x, y + max * scaleFactor);
                 }
-
-                if (value > max) max = value;
-                if (value < min) min = value;
-                q += m_channels;
-                value = *q * -1;
+                m_columnPeaks[x * m_channels + c] = qMin(qMax(-min, max), MAX_AMPLITUDE - 1);
             }
-            p.restore();
         }
+        m_mutex.unlock();
+        p.end();
     }
 
-    p.end();
-
     m_mutex.lock();
-    m_displayWave.swap(m_renderWave);
+    // Shallow copy; the next refresh detaches the backbuffer on write.
+    m_displayWave = m_renderWave;
     m_mutex.unlock();
 }
 
@@ -252,25 +272,19 @@ void AudioWaveformScopeWidget::paintEvent(QPaintEvent*)
 void AudioWaveformScopeWidget::mouseMoveEvent(QMouseEvent *event)
 {
     QMutexLocker locker(&m_mutex);
-    if (!m_frame.is_valid()) return;
-
-    int channels = m_frame.get_audio_channels();
-    int samples = m_frame.get_audio_samples();
-    int16_t* audio = (int16_t*)m_frame.get_audio();
-    if (samples < 10 || channels < 1) return;
+    if (m_columnPeaks.isEmpty() || m_channels < 1) return;
 
-    qreal position = (qreal)event->pos().x() / (qreal)width();
-    int sample = (qreal)samples * position;
-    QString text = tr("Sample: %1\n").arg(QString::number(sample+1));
+    int columns = m_columnPeaks.size() / m_channels;
+    int column = qBound(0, event->pos().x() * columns / qMax(width(), 1), columns - 1);
+    QString text;
 
-    for (int c = 0; c < channels; c++)
+    for (int c = 0; c < m_channels; c++)
     {
-        const int16_t* q = audio + (channels * sample) + c;
-        qreal scaledValue = (qreal)*q / MAX_AMPLITUDE;
+        qreal scaledValue = (qreal)m_columnPeaks[column * m_channels + c] / MAX_AMPLITUDE;
         qreal dbValue = 20 * log(fabs(scaledValue));
         if (dbValue < 0.01 && dbValue > -0.01) dbValue = 0.0;
         text += tr("Ch: %1: %2 (%3 dBFS)").arg(QString::number(c+1)).arg(QString::number(scaledValue, 'f', 2)).arg(QString::number(dbValue, 'f', 2));
-        if ( c != channels -1 )
+        if ( c != m_channels -1 )
         {
             text += "\n";
         }
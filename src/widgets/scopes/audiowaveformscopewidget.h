@@ -21,6 +21,7 @@
 #include "scopewidget.h"
 #include <QMutex>
 #include <QImage>
+#include <QVector>
 
 class AudioWaveformScopeWidget Q_DECL_FINAL : public ScopeWidget
 {
@@ -42,10 +43,12 @@ private:
     void leaveEvent(QEvent *event) Q_DECL_OVERRIDE;
 
     // Members accessed only in scope thread (no thread protection).
-    QImage m_renderWave;
+    QImage m_renderWave;       // scrolling backbuffer
     int m_graphTopPadding;
     int m_graphLeftPadding;
-    int m_channels;
+    QVector<qreal> m_pendingMin;    // partial column accumulators
+    QVector<qreal> m_pendingMax;
+    qreal m_pendingSamples;
 
     // Members accessed only in GUI thread (no thread protection).
     int m_cursorPos;
@@ -54,7 +57,8 @@ private:
     QMutex m_mutex;
     QImage m_displayWave;
     QImage m_displayGrid;
-    SharedFrame m_frame;
+    QVector<int16_t> m_columnPeaks; // per column and channel, for the tooltip
+    int m_channels;
 };
 
 #endif // AUDIOWAVEFORMSCOPEWIDGET_H
@@ -17,14 +17,21 @@
  */
 
 #include "scopewidget.h"
+#include "controllers/scopecontroller.h"
+#include "taskpool.h"
 #include <Logger.h>
+#include <QTimer>
 #include <QtConcurrent/QtConcurrent>
 
-ScopeWidget::ScopeWidget(const QString& name)
+ScopeWidget::ScopeWidget(const QString& name, int queueSize)
   : QWidget()
-  , m_queue(3, DataQueue<SharedFrame>::OverflowModeDiscardOldest)
+  , m_queue(queueSize, SpscDataQueue<SharedFrame>::OverflowModeDiscardOldest)
   , m_future()
   , m_refreshPending(false)
+  , m_frameHub(0)
+  , m_frameSerial(0)
+  , m_targetRefreshRate(0)
+  , m_deferredScheduled(false)
   , m_mutex(QMutex::NonRecursive)
   , m_forceRefresh(false)
   , m_size(0, 0)
@@ -41,13 +48,45 @@ ScopeWidget::~ScopeWidget()
 void ScopeWidget::onNewFrame(const SharedFrame& frame)
 {
     m_queue.push(frame);
+    requestRefreshThrottled();
+}
+
+void ScopeWidget::onFrameAvailable()
+{
+    requestRefreshThrottled();
+}
+
+void ScopeWidget::requestRefreshThrottled()
+{
+    // Frame-driven refreshes honor the scope's target rate: requests that
+    // arrive before the deadline collapse into one deferred refresh that
+    // processes the latest data when it fires.
+    if (m_targetRefreshRate > 0) {
+        qint64 interval = 1000 / m_targetRefreshRate;
+        if (m_lastRefresh.isValid() && m_lastRefresh.elapsed() < interval) {
+            if (!m_deferredScheduled) {
+                m_deferredScheduled = true;
+                QTimer::singleShot(interval - m_lastRefresh.elapsed(), this,
+                                   SLOT(onDeferredRefresh()));
+            }
+            return;
+        }
+        m_lastRefresh.start();
+    }
     requestRefresh();
 }
 
+void ScopeWidget::onDeferredRefresh()
+{
+    m_deferredScheduled = false;
+    requestRefreshThrottled();
+}
+
 void ScopeWidget::requestRefresh()
 {
     if (m_future.isFinished()) {
-        m_future = QtConcurrent::run(this, &ScopeWidget::refreshInThread);
+        m_future = QtConcurrent::run(TaskPool::singleton().pool(),
+                                     this, &ScopeWidget::refreshInThread);
     } else {
         m_refreshPending = true;
     }
@@ -66,6 +105,13 @@ void ScopeWidget::refreshInThread()
     m_mutex.unlock();
 
     m_refreshPending = false;
+    // Pull the latest frame from the hub; the serial acts as this scope's
+    // dirty flag, so a coalesced refresh fetches the frame only once.
+    if (m_frameHub) {
+        SharedFrame frame = m_frameHub->fetch(m_frameSerial);
+        if (frame.is_valid())
+            m_queue.push(frame);
+    }
     refreshScope(size, full);
     // Tell the GUI thread that the refresh is complete.
     QMetaObject::invokeMethod(this, "onRefreshThreadComplete", Qt::QueuedConnection);
@@ -23,11 +23,14 @@
 #include <QString>
 #include <Logger.h>
 #include <QThread>
+#include <QElapsedTimer>
 #include <QFuture>
 #include <QMutex>
 #include "sharedframe.h"
 #include "dataqueue.h"
 
+class SharedFrameHub;
+
 /*!
   \class ScopeWidget
   \brief The ScopeWidget provides a common interface for all scopes in Shotcut.
@@ -38,7 +41,7 @@
   is the ability to trigger the "heavy lifting" to be done in a worker thread.
 
   Frames are received by the onNewFrame() slot. The ScopeWidget automatically
-  places new frames in the DataQueue (m_queue). Subclasses shall implement the
+  places new frames in the SpscDataQueue (m_queue). Subclasses shall implement the
   refreshScope() function and can check for new frames in m_queue.
 
   refreshScope() is run from a separate thread. Therefore, any members that are
@@ -63,9 +66,11 @@ public:
       Constructs an ScopeWidget.
 
       The \a name will be set as the objectName and should be initialized by
-      subclasses.
+      subclasses. A scope that lowers its refresh rate but must still see
+      every frame (e.g. the loudness meters) can request a deeper
+      \a queueSize so frames are not discarded between refreshes.
     */
-    explicit ScopeWidget(const QString& name);
+    explicit ScopeWidget(const QString& name, int queueSize = 3);
 
     //! Destructs a ScopeWidget.
     virtual ~ScopeWidget();
@@ -82,10 +87,20 @@ public:
     */
     virtual void setOrientation(Qt::Orientation) {};
 
+    /*!
+      Attaches the shared frame hub. When set, the scope fetches the latest
+      frame from the hub as its refresh runs instead of receiving frames
+      through onNewFrame().
+    */
+    void setFrameHub(SharedFrameHub* hub) { m_frameHub = hub; }
+
 public slots:
     //! Provides a new frame to the scope. Should be called by the application.
     virtual void onNewFrame(const SharedFrame& frame) Q_DECL_FINAL;
 
+    //! Notifies the scope that the attached hub holds a newer frame.
+    void onFrameAvailable();
+
 protected:
     /*!
       Triggers refreshScope() to be called in a new thread context.
@@ -103,22 +118,42 @@ protected:
     */
     virtual void refreshScope(const QSize& size, bool full) = 0;
 
+    /*!
+      Limits how often frame arrivals start a refresh.
+
+      A scope whose useful update rate is below the project frame rate
+      (e.g. the loudness meters at 10Hz) can set a target \a hz; refreshes
+      requested before the deadline are coalesced into one deferred refresh
+      that processes the latest data. 0 (the default) refreshes at the full
+      frame rate. Resize and palette changes always refresh promptly.
+    */
+    void setTargetRefreshRate(int hz) { m_targetRefreshRate = hz; }
+
     /*!
       Stores frames received by onNewFrame().
 
       Subclasses should check this queue for new frames in the refreshScope()
       implementation.
     */
-    DataQueue<SharedFrame> m_queue;
+    SpscDataQueue<SharedFrame> m_queue;
 
     void resizeEvent(QResizeEvent*) Q_DECL_OVERRIDE;
     void changeEvent(QEvent*) Q_DECL_OVERRIDE;
 
+private slots:
+    void onDeferredRefresh();
+
 private:
     Q_INVOKABLE virtual void onRefreshThreadComplete() Q_DECL_FINAL;
+    void requestRefreshThrottled();
     virtual void refreshInThread() Q_DECL_FINAL;
     QFuture<void> m_future;
     bool m_refreshPending;
+    SharedFrameHub* m_frameHub;
+    int m_frameSerial;
+    int m_targetRefreshRate;
+    bool m_deferredScheduled;
+    QElapsedTimer m_lastRefresh;
 
     // Members accessed in multiple threads (mutex protected).
     QMutex m_mutex;
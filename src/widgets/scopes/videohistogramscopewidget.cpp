@@ -19,7 +19,9 @@
 #include <Logger.h>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QThread>
 #include <QToolTip>
+#include <QtConcurrent>
 
 const qreal IRE0 = 16;
 const qreal IRE100 = 235;
@@ -35,6 +37,7 @@ VideoHistogramScopeWidget::VideoHistogramScopeWidget()
 {
     LOG_DEBUG() << "begin";
     setMouseTracking(true);
+    setTargetRefreshRate(30);
     LOG_DEBUG() << "end";
 }
 
@@ -55,17 +58,55 @@ void VideoHistogramScopeWidget::refreshScope(const QSize& size, bool full)
     if (m_frame.is_valid() && m_frame.get_image_width() && m_frame.get_image_height()) {
         const uint8_t* pYUV = m_frame.get_image(mlt_image_yuv420p);
         const uint8_t* pRGB = m_frame.get_image(mlt_image_rgb24);
-        size_t count = m_frame.get_image_width() * m_frame.get_image_height();
-        unsigned int* pYbin = yBins.data();
-        unsigned int* pRbin = rBins.data();
-        unsigned int* pGbin = gBins.data();
-        unsigned int* pBbin = bBins.data();
-        while (count--)
-        {
-            pYbin[*pYUV++]++;
-            pRbin[*pRGB++]++;
-            pGbin[*pRGB++]++;
-            pBbin[*pRGB++]++;
+        int width = m_frame.get_image_width();
+        int height = m_frame.get_image_height();
+
+        // Count row bands into per-thread partial histograms and merge.
+        struct Band {
+            int startY;
+            int endY;
+            QVector<unsigned int> y, r, g, b;
+        };
+        int bandHeight = qMax((height + QThread::idealThreadCount() - 1) /
+                              QThread::idealThreadCount(), 64);
+        QVector<Band> bands;
+        for (int y = 0; y < height; y += bandHeight) {
+            Band band;
+            band.startY = y;
+            band.endY = qMin(y + bandHeight, height);
+            bands.append(band);
+        }
+
+        QtConcurrent::blockingMap(bands, [=](Band& band) {
+            band.y.fill(0, 256);
+            band.r.fill(0, 256);
+            band.g.fill(0, 256);
+            band.b.fill(0, 256);
+            unsigned int* pYbin = band.y.data();
+            unsigned int* pRbin = band.r.data();
+            unsigned int* pGbin = band.g.data();
+            unsigned int* pBbin = band.b.data();
+            const uint8_t* pY = pYUV + size_t(band.startY) * width;
+            const uint8_t* pC = pRGB + size_t(band.startY) * width * 3;
+            size_t count = size_t(band.endY - band.startY) * width;
+            while (count--)
+            {
+                pYbin[*pY++]++;
+                pRbin[*pC++]++;
+                pGbin[*pC++]++;
+                pBbin[*pC++]++;
+            }
+        });
+
+        // The merge is a straight sum over the bins; the compiler keeps
+        // this in vector registers.
+        foreach (const Band& band, bands) {
+            for (int i = 0; i < 256; i++) {
+                yBins[i] += band.y[i];
+                rBins[i] += band.r[i];
+                gBins[i] += band.g[i];
+                bBins[i] += band.b[i];
+            }
         }
     }
 
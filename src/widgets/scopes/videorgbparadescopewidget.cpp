@@ -18,7 +18,9 @@
 #include "videorgbparadescopewidget.h"
 #include <QMouseEvent>
 #include <QPainter>
+#include <QThread>
 #include <QToolTip>
+#include <QtConcurrent>
 
 static const QColor TEXT_COLOR = {255, 255, 255, 127};
 
@@ -31,6 +33,7 @@ VideoRgbParadeScopeWidget::VideoRgbParadeScopeWidget()
 {
     LOG_DEBUG() << "begin";
     setMouseTracking(true);
+    setTargetRefreshRate(30);
     LOG_DEBUG() << "end";
 }
 
@@ -62,30 +65,41 @@ void VideoRgbParadeScopeWidget::refreshScope(const QSize& size, bool full)
         size_t gOffset = rOffset + width;
         size_t bOffset = gOffset + width;
 
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                uint8_t ry = 255 - src[0];
-                size_t rIndex = (ry * imgWidth + rOffset + x) * 4;
-                if (dst[rIndex] < 0xff) {
-                    dst[rIndex] += 0x0f;
+        // A source column only ever lights the same column of each channel's
+        // parade, so column tiles touch disjoint output columns and can run
+        // concurrently without a merge step.
+        int tileWidth = qMax((width + QThread::idealThreadCount() - 1) /
+                             QThread::idealThreadCount(), 64);
+        QVector<int> tiles;
+        for (int x = 0; x < width; x += tileWidth)
+            tiles << x;
+
+        QtConcurrent::blockingMap(tiles, [=](const int& tileX) {
+            const int tileEnd = qMin(tileX + tileWidth, width);
+            for (int y = 0; y < height; y++) {
+                const uint8_t* s = src + (size_t(y) * width + tileX) * 3;
+                for (int x = tileX; x < tileEnd; x++) {
+                    uint8_t ry = 255 - s[0];
+                    size_t rIndex = (ry * imgWidth + rOffset + x) * 4;
+                    if (dst[rIndex] < 0xff) {
+                        dst[rIndex] += 0x0f;
+                    }
+
+                    uint8_t gy = 255 - s[1];
+                    size_t gIndex = (gy * imgWidth + gOffset + x) * 4 + 1;
+                    if (dst[gIndex] < 0xff) {
+                        dst[gIndex] += 0x0f;
+                    }
+
+                    uint8_t by = 255 - s[2];
+                    size_t bIndex = (by * imgWidth + bOffset + x) * 4 + 2;
+                    if (dst[bIndex] < 0xff) {
+                        dst[bIndex] += 0x0f;
+                    }
+                    s += 3;
                 }
-
-                uint8_t gy = 255 - src[1];
-                size_t gIndex = (gy * imgWidth + gOffset + x) * 4 + 1;
-                if (dst[gIndex] < 0xff) {
-                    dst[gIndex] += 0x0f;
-                }
-
-                uint8_t by = 255 - src[2];
-                size_t bIndex = (by * imgWidth + bOffset + x) * 4 + 2;
-                if (dst[bIndex] < 0xff) {
-                    dst[bIndex] += 0x0f;
-                }
-                src += 3;
             }
-        }
-
-        QImage scaledImage = m_renderImg.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(QImage::Format_RGB32);
+        });
 
         m_mutex.lock();
         m_displayImg.swap(m_renderImg);
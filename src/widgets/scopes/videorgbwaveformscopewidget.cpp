@@ -31,6 +31,7 @@ VideoRgbWaveformScopeWidget::VideoRgbWaveformScopeWidget()
 {
     LOG_DEBUG() << "begin";
     setMouseTracking(true);
+    setTargetRefreshRate(30);
     LOG_DEBUG() << "end";
 }
 
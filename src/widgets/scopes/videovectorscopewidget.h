@@ -21,6 +21,7 @@
 #include "scopewidget.h"
 #include <QMutex>
 #include <QImage>
+#include <QVector>
 
 class VideoVectorScopeWidget Q_DECL_FINAL : public ScopeWidget
 {
@@ -64,6 +65,8 @@ private:
     SharedFrame m_frame;
     QImage m_renderImg;
     QImage m_graticuleImg;
+    QVector<quint32> m_hitCounts;   // 256x256 (U,V) accumulation plane
+    uint8_t m_intensityLut[256];    // hit count -> plot brightness
 
     // Variables accessed from multiple threads (mutex protected)
     QMutex m_mutex;
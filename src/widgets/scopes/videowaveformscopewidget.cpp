@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2019 Meltytech, LLC
+ * Copyright (c) 2015-2020 Meltytech, LLC
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,28 +20,235 @@
 #include <QMouseEvent>
 #include <QPainter>
 #include <QToolTip>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLFramebufferObject>
+#include <cstring>
 
 static const qreal IRE0 = 16;
 static const qreal IRE100 = 235;
 static const QColor TEXT_COLOR = {255, 255, 255, 127};
 
+// Intensity each luma sample contributes to its waveform cell, matching the
+// 0x0f per-hit accumulation of the software path.
+static const float POINT_INTENSITY = 15.0f / 255.0f;
+
+// Cap on scatter points per frame; rows are subsampled beyond this and the
+// point intensity is scaled to compensate.
+static const int MAX_POINTS = 2000000;
+
+WaveformRenderThread::WaveformRenderThread()
+    : QThread(0)
+    , m_context(0)
+    , m_program(0)
+    , m_fbo(0)
+    , m_lumaTexture(0)
+    , m_gridBuffer(0)
+    , m_gridWidth(0)
+    , m_gridHeight(0)
+    , m_pending(false)
+    , m_running(true)
+    , m_failed(false)
+{
+    setObjectName("WaveformRenderThread");
+    // The surface and context must be created on the GUI thread; the context
+    // is then moved to this thread like GLWidget's FrameRenderer.
+    m_surface.create();
+    m_context = new QOpenGLContext;
+    if (m_surface.isValid() && m_context->create()) {
+        m_context->moveToThread(this);
+        start();
+    } else {
+        m_failed = true;
+        delete m_context;
+        m_context = 0;
+    }
+}
+
+WaveformRenderThread::~WaveformRenderThread()
+{
+    m_mutex.lock();
+    m_running = false;
+    m_requestCondition.wakeOne();
+    m_mutex.unlock();
+    wait();
+    delete m_context;
+    m_surface.destroy();
+}
+
+bool WaveformRenderThread::render(const SharedFrame& frame, QImage& result)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_failed || !m_running)
+        return false;
+    m_frame = frame;
+    m_pending = true;
+    m_requestCondition.wakeOne();
+    while (m_pending && m_running && !m_failed)
+        m_completeCondition.wait(&m_mutex);
+    if (m_failed)
+        return false;
+    // Copy mirrored into the caller's image: row 0 of the FBO is luma 0,
+    // which belongs at the bottom of the scope. The caller's buffer is not
+    // shared, so writing it each render does not detach or allocate once
+    // the size has settled.
+    if (result.width() != m_readback.width()
+            || result.format() != m_readback.format())
+        result = QImage(m_readback.width(), 256, m_readback.format());
+    for (int y = 0; y < 256; ++y)
+        memcpy(result.scanLine(y), m_readback.constScanLine(255 - y),
+               m_readback.bytesPerLine());
+    return true;
+}
+
+bool WaveformRenderThread::initializeGL()
+{
+    m_program = new QOpenGLShaderProgram;
+    bool ok = m_program->addShaderFromSourceCode(QOpenGLShader::Vertex,
+        "#version 110\n"
+        "attribute vec2 texCoord;"
+        "uniform sampler2D luma;"
+        "void main() {"
+        "  float y = texture2D(luma, texCoord).r;"
+        "  gl_Position = vec4(texCoord.x * 2.0 - 1.0, y * 2.0 - 1.0, 0.0, 1.0);"
+        "}");
+    ok &= m_program->addShaderFromSourceCode(QOpenGLShader::Fragment,
+        "#version 110\n"
+        "uniform float intensity;"
+        "void main() {"
+        "  gl_FragColor = vec4(intensity, intensity, intensity, 1.0);"
+        "}");
+    ok &= m_program->link();
+    if (!ok)
+        LOG_WARNING() << "waveform shader failed; using software path";
+    return ok;
+}
+
+void WaveformRenderThread::run()
+{
+    if (!m_context->makeCurrent(&m_surface) || !initializeGL()) {
+        QMutexLocker locker(&m_mutex);
+        m_failed = true;
+        m_completeCondition.wakeAll();
+        return;
+    }
+
+    forever {
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_running && !m_pending)
+                m_requestCondition.wait(&m_mutex);
+            if (!m_running)
+                break;
+        }
+        renderWaveform();
+        QMutexLocker locker(&m_mutex);
+        m_pending = false;
+        m_completeCondition.wakeOne();
+    }
+
+    QOpenGLFunctions* f = m_context->functions();
+    if (m_lumaTexture)
+        f->glDeleteTextures(1, &m_lumaTexture);
+    if (m_gridBuffer)
+        f->glDeleteBuffers(1, &m_gridBuffer);
+    delete m_fbo;
+    delete m_program;
+    m_context->doneCurrent();
+}
+
+void WaveformRenderThread::renderWaveform()
+{
+    QOpenGLFunctions* f = m_context->functions();
+    int width = m_frame.get_image_width();
+    int height = m_frame.get_image_height();
+    const uint8_t* image = m_frame.get_image(mlt_image_yuv420p);
+
+    // Subsample rows when the frame has more samples than the point budget.
+    int rowStep = qMax(1, width * height / MAX_POINTS);
+    int rows = height / rowStep;
+
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (!m_lumaTexture)
+        f->glGenTextures(1, &m_lumaTexture);
+    f->glBindTexture(GL_TEXTURE_2D, m_lumaTexture);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    f->glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0,
+                    GL_LUMINANCE, GL_UNSIGNED_BYTE, image);
+
+    // One point per sampled texel; the grid only depends on the dimensions.
+    if (width != m_gridWidth || rows != m_gridHeight) {
+        QVector<float> grid;
+        grid.reserve(width * rows * 2);
+        for (int y = 0; y < rows; y++) {
+            float v = (y * rowStep + 0.5f) / height;
+            for (int x = 0; x < width; x++) {
+                grid.append((x + 0.5f) / width);
+                grid.append(v);
+            }
+        }
+        if (!m_gridBuffer)
+            f->glGenBuffers(1, &m_gridBuffer);
+        f->glBindBuffer(GL_ARRAY_BUFFER, m_gridBuffer);
+        f->glBufferData(GL_ARRAY_BUFFER, grid.size() * sizeof(float),
+                        grid.constData(), GL_STATIC_DRAW);
+        m_gridWidth = width;
+        m_gridHeight = rows;
+    }
+
+    if (!m_fbo || m_fbo->width() != width) {
+        delete m_fbo;
+        m_fbo = new QOpenGLFramebufferObject(width, 256);
+    }
+
+    m_fbo->bind();
+    f->glViewport(0, 0, width, 256);
+    f->glDisable(GL_DEPTH_TEST);
+    f->glEnable(GL_BLEND);
+    f->glBlendFunc(GL_ONE, GL_ONE);
+    f->glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    f->glClear(GL_COLOR_BUFFER_BIT);
+
+    m_program->bind();
+    m_program->setUniformValue("luma", 0);
+    m_program->setUniformValue("intensity", qMin(1.0f, POINT_INTENSITY * rowStep));
+    f->glActiveTexture(GL_TEXTURE0);
+    f->glBindTexture(GL_TEXTURE_2D, m_lumaTexture);
+    f->glBindBuffer(GL_ARRAY_BUFFER, m_gridBuffer);
+    m_program->enableAttributeArray("texCoord");
+    m_program->setAttributeBuffer("texCoord", GL_FLOAT, 0, 2);
+    f->glDrawArrays(GL_POINTS, 0, width * rows);
+    m_program->disableAttributeArray("texCoord");
+    m_program->release();
+
+    // Read back the small accumulation image into the reused buffer.
+    if (m_readback.width() != width)
+        m_readback = QImage(width, 256, QImage::Format_RGBX8888);
+    f->glReadPixels(0, 0, width, 256, GL_RGBA, GL_UNSIGNED_BYTE, m_readback.bits());
+    m_fbo->release();
+}
 
 VideoWaveformScopeWidget::VideoWaveformScopeWidget()
   : ScopeWidget("VideoZoom")
   , m_frame()
   , m_renderImg()
+  , m_renderThread()
   , m_mutex(QMutex::NonRecursive)
   , m_displayImg()
 {
     LOG_DEBUG() << "begin";
     setMouseTracking(true);
+    setTargetRefreshRate(30);
     LOG_DEBUG() << "end";
 }
 
 
 void VideoWaveformScopeWidget::refreshScope(const QSize& size, bool full)
 {
-    Q_UNUSED(size)
     Q_UNUSED(full)
 
     while (m_queue.count() > 0) {
@@ -52,28 +259,8 @@ void VideoWaveformScopeWidget::refreshScope(const QSize& size, bool full)
     int height = m_frame.get_image_height();
 
     if (m_frame.is_valid() && width && height) {
-        if (m_renderImg.width() != width) {
-            m_renderImg = QImage(width, 256, QImage::Format_RGBX8888);
-        }
-
-        QColor bgColor( 0, 0, 0 ,0xff );
-        m_renderImg.fill(bgColor);
-
-        const uint8_t* src = m_frame.get_image(mlt_image_yuv420p);
-        uint8_t* dst = m_renderImg.scanLine(0);
-
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                uint8_t dy = 255 - src[0];
-                size_t dIndex = (dy * width + x) * 4;
-                if (dst[dIndex] < 0xff) {
-                    dst[dIndex] += 0x0f;
-                    dst[dIndex + 1] += 0x0f;
-                    dst[dIndex + 2] += 0x0f;
-                }
-                src ++;
-            }
-        }
+        if (!m_renderThread.render(m_frame, m_renderImg))
+            refreshScopeSoftware(width, height);
 
         QImage scaledImage = m_renderImg.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(QImage::Format_RGB32);
 
@@ -83,6 +270,32 @@ void VideoWaveformScopeWidget::refreshScope(const QSize& size, bool full)
     }
 }
 
+void VideoWaveformScopeWidget::refreshScopeSoftware(int width, int height)
+{
+    if (m_renderImg.width() != width) {
+        m_renderImg = QImage(width, 256, QImage::Format_RGBX8888);
+    }
+
+    QColor bgColor( 0, 0, 0 ,0xff );
+    m_renderImg.fill(bgColor);
+
+    const uint8_t* src = m_frame.get_image(mlt_image_yuv420p);
+    uint8_t* dst = m_renderImg.scanLine(0);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t dy = 255 - src[0];
+            size_t dIndex = (dy * width + x) * 4;
+            if (dst[dIndex] < 0xff) {
+                dst[dIndex] += 0x0f;
+                dst[dIndex + 1] += 0x0f;
+                dst[dIndex + 2] += 0x0f;
+            }
+            src ++;
+        }
+    }
+}
+
 void VideoWaveformScopeWidget::paintEvent(QPaintEvent*)
 {
     if (!isVisible())
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2019 Meltytech, LLC
+ * Copyright (c) 2015-2020 Meltytech, LLC
  *
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,23 +20,82 @@
 
 #include "scopewidget.h"
 #include <QMutex>
+#include <QWaitCondition>
 #include <QImage>
+#include <QThread>
+#include <QOffscreenSurface>
+
+class QOpenGLContext;
+class QOpenGLShaderProgram;
+class QOpenGLFramebufferObject;
+
+/*!
+  \class WaveformRenderThread
+  \brief Accumulates the waveform histogram on the GPU.
+
+  The waveform is a scatter of every luma sample into a width x 256 grid.
+  This thread owns an offscreen GL context (scope refreshes run on varying
+  QtConcurrent pool threads, which may not share a context) and renders the
+  scatter as additively blended points whose height the vertex shader reads
+  from a luma texture, then reads the small result image back. render() is
+  a blocking hand-off from the refresh thread and returns false when GL is
+  unavailable so the caller can fall back to the CPU walk.
+*/
+class WaveformRenderThread : public QThread
+{
+public:
+    WaveformRenderThread();
+    ~WaveformRenderThread();
+
+    //! Renders \a frame into \a result (width x 256). Blocking; threadsafe.
+    bool render(const SharedFrame& frame, QImage& result);
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    bool initializeGL();
+    void renderWaveform();
+
+    QOffscreenSurface m_surface;
+    QOpenGLContext* m_context;
+    QOpenGLShaderProgram* m_program;
+    QOpenGLFramebufferObject* m_fbo;
+    unsigned m_lumaTexture;
+    unsigned m_gridBuffer;
+    int m_gridWidth;
+    int m_gridHeight;
+
+    // Members accessed in multiple threads (mutex protected).
+    QMutex m_mutex;
+    QWaitCondition m_requestCondition;
+    QWaitCondition m_completeCondition;
+    SharedFrame m_frame;
+    // FBO readback buffer; reused across renders so steady-state playback
+    // with the scope open performs no per-frame image allocations.
+    QImage m_readback;
+    bool m_pending;
+    bool m_running;
+    bool m_failed;
+};
 
 class VideoWaveformScopeWidget Q_DECL_FINAL : public ScopeWidget
 {
     Q_OBJECT
-    
+
 public:
     explicit VideoWaveformScopeWidget();
     QString getTitle() Q_DECL_OVERRIDE;
 
 private:
     void refreshScope(const QSize& size, bool full) Q_DECL_OVERRIDE;
+    void refreshScopeSoftware(int width, int height);
     void paintEvent(QPaintEvent*) Q_DECL_OVERRIDE;
     void mouseMoveEvent(QMouseEvent *event) Q_DECL_OVERRIDE;
 
     SharedFrame m_frame;
     QImage m_renderImg;
+    WaveformRenderThread m_renderThread;
 
     // Variables accessed from multiple threads (mutex protected)
     QMutex m_mutex;
@@ -17,6 +17,7 @@
 
 #include "videozoomwidget.h"
 
+#include "videoconvert.h"
 #include <Logger.h>
 
 #include <QMouseEvent>
@@ -53,9 +54,9 @@ void VideoZoomWidget::putFrame(SharedFrame frame)
 {
     if (!frame.is_valid()) return;
 
-    // Make sure the images are pre-cached for the UI thread
+    // Make sure the native image is pre-cached for the UI thread. RGB is
+    // converted on demand from just the visible crop.
     frame.get_image(mlt_image_yuv420p);
-    frame.get_image(mlt_image_rgb24);
 
     m_mutex.lock();
     m_frame = frame;
@@ -132,22 +133,31 @@ void VideoZoomWidget::paintEvent(QPaintEvent*)
     QPainter p(this);
     p.setRenderHint(QPainter::Antialiasing, true);
 
-    const uint8_t* pImg = m_frame.get_image(mlt_image_rgb24);
+    const uint8_t* pImg = m_frame.get_image(mlt_image_yuv420p);
     int iWidth = m_frame.get_image_width();
     int iHeight = m_frame.get_image_height();
     int wWidth = width() - (width() % m_zoom);
     int wHeight = height() - (height() % m_zoom);
     int ix = m_imageOffset.x();
     int iy = m_imageOffset.y();
+    int colorspace = m_frame.get_int("colorspace");
+    int cols = qMin(wWidth / m_zoom, iWidth - ix);
+    int rows = qMin(wHeight / m_zoom, iHeight - iy);
+    if (cols <= 0 || rows <= 0) return;
+
+    // Convert just the visible crop from the native planes; the cost is the
+    // crop size (a few thousand pixels at high zoom), not the frame size.
+    m_cropBuffer.resize(cols * rows * 4);
+    VideoConvert::yuv420pRectToRgba(pImg, m_cropBuffer.data(), iWidth, iHeight,
+                                    ix, iy, cols, rows, colorspace);
 
     // draw the pixels
-    for (int y = 0; y < wHeight && iy < iHeight; y += m_zoom) {
-        const uint8_t* pPixel = pImg + ((iy * iWidth) + ix) * 3;
-        for (int x = 0; x < wWidth; x += m_zoom) {
-            p.fillRect(x, y, m_zoom, m_zoom, QColor(pPixel[0], pPixel[1], pPixel[2], 255 ));
-            pPixel += 3;
+    for (int row = 0; row < rows; row++) {
+        const uint8_t* pPixel = m_cropBuffer.constData() + row * cols * 4;
+        for (int col = 0; col < cols; col++) {
+            p.fillRect(col * m_zoom, row * m_zoom, m_zoom, m_zoom, QColor(pPixel[0], pPixel[1], pPixel[2], 255 ));
+            pPixel += 4;
         }
-        iy++;
     }
 
     // Outline the selected pixel
@@ -155,10 +165,11 @@ void VideoZoomWidget::paintEvent(QPaintEvent*)
         m_selectedPixel.y() >= 0 &&
         m_selectedPixel.x() < iWidth &&
         m_selectedPixel.y() < iHeight) {
-        const uint8_t* pPixel = pImg + ((m_selectedPixel.y() * iWidth) + m_selectedPixel.x()) * 3;
+        uint8_t rgb[3] = {0, 0, 0};
+        m_frame.get_pixel_rgb(m_selectedPixel.x(), m_selectedPixel.y(), rgb);
         int posX = (m_selectedPixel.x() - m_imageOffset.x()) * m_zoom;
         int posY = (m_selectedPixel.y() - m_imageOffset.y()) * m_zoom;
-        QColor pixelcolor(pPixel[0], pPixel[1], pPixel[2]);
+        QColor pixelcolor(rgb[0], rgb[1], rgb[2]);
         p.setPen(getHighContrastColor(pixelcolor));
         p.drawRect(posX, posY, m_zoom, m_zoom);
     }
@@ -282,16 +293,17 @@ VideoZoomWidget::PixelValues VideoZoomWidget::pixelToValues(const QPoint& pixel)
     int iWidth = m_frame.get_image_width();
     int iHeight = m_frame.get_image_height();
     int imageOffset = iWidth * pixel.y() + pixel.x();
-    const uint8_t* pRgb = m_frame.get_image(mlt_image_rgb24) + imageOffset * 3;
     const uint8_t* pYuv = m_frame.get_image(mlt_image_yuv420p);
     const uint8_t* pY = pYuv + imageOffset;
     const uint8_t* pU = pYuv + (iWidth * iHeight) + (iWidth / 2 * (pixel.y() / 2)) + (pixel.x() / 2);
     const uint8_t* pV = pYuv + (iWidth * iHeight * 5 / 4) + (iWidth / 2 * (pixel.y() / 2)) + (pixel.x() / 2);
+    uint8_t rgb[3] = {0, 0, 0};
+    m_frame.get_pixel_rgb(pixel.x(), pixel.y(), rgb);
     values.y = *pY;
     values.u = *pU;
     values.v = *pV;
-    values.r = pRgb[0];
-    values.g = pRgb[1];
-    values.b = pRgb[2];
+    values.r = rgb[0];
+    values.g = rgb[1];
+    values.b = rgb[2];
     return values;
 }
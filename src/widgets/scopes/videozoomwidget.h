@@ -22,6 +22,7 @@
 
 #include <QWidget>
 #include <QMutex>
+#include <QVector>
 
 class VideoZoomWidget : public QWidget
 {
@@ -74,6 +75,7 @@ private:
     QPoint m_imageOffset;
     QPoint m_mouseGrabPixel;
     QPoint m_selectedPixel;
+    QVector<uint8_t> m_cropBuffer;  // visible crop converted to RGBA
 
     // Variables accessed from multiple threads (mutex protected)
     QMutex m_mutex;
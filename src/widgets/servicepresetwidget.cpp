@@ -23,8 +23,66 @@
 #include <Logger.h>
 
 #include <QDir>
+#include <QFileSystemWatcher>
+#include <QHash>
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QMutex>
+#include <QSet>
+
+// Caches the preset directory listings so opening a filter panel does not
+// re-enumerate the (possibly network-mounted) presets folder every time.
+// A QFileSystemWatcher drops a cached listing when its directory changes,
+// e.g. when a preset is saved or deleted.
+class PresetListingCache
+{
+public:
+    static PresetListingCache& singleton()
+    {
+        static PresetListingCache instance;
+        return instance;
+    }
+
+    QStringList entries(const QString& dirPath, QDir::Filters filters)
+    {
+        QMutexLocker locker(&m_mutex);
+        const QString key = dirPath + QChar('\n') + QString::number(filters);
+        QHash<QString, QStringList>::const_iterator it = m_listings.constFind(key);
+        if (it == m_listings.constEnd()) {
+            QDir dir(dirPath);
+            if (!dir.exists())
+                return QStringList();
+            if (!m_watched.contains(dirPath)) {
+                if (!m_watcher.addPath(dirPath)) {
+                    // Unwatchable (e.g. some network mounts): list directly.
+                    return dir.entryList(filters);
+                }
+                m_watched.insert(dirPath);
+            }
+            it = m_listings.insert(key, dir.entryList(filters));
+        }
+        return it.value();
+    }
+
+private:
+    PresetListingCache()
+    {
+        QObject::connect(&m_watcher, &QFileSystemWatcher::directoryChanged, [this](const QString& path) {
+            QMutexLocker locker(&m_mutex);
+            // A directory caches one listing per filter set; keys are
+            // prefixed with the directory path.
+            foreach (const QString& key, m_listings.keys()) {
+                if (key.startsWith(path + QChar('\n')))
+                    m_listings.remove(key);
+            }
+        });
+    }
+
+    QFileSystemWatcher m_watcher;
+    QMutex m_mutex;
+    QHash<QString, QStringList> m_listings;
+    QSet<QString> m_watched;
+};
 
 ServicePresetWidget::ServicePresetWidget(QWidget *parent) :
     QWidget(parent),
@@ -42,16 +100,18 @@ ServicePresetWidget::~ServicePresetWidget()
 // This should be called after saveDefaultPreset()
 void ServicePresetWidget::loadPresets()
 {
-    // build the presets combo
+    // build the presets combo from the cached directory snapshots
     ui->presetCombo->clear();
     QDir dir(Settings.appDataLocation());
     if (dir.cd("presets")) {
-        ui->presetCombo->addItems(dir.entryList(QDir::Files));
-        QStringList entries = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Executable);
+        PresetListingCache& cache = PresetListingCache::singleton();
+        ui->presetCombo->addItems(cache.entries(dir.path(), QDir::Files));
+        QStringList entries = cache.entries(dir.path(),
+            QDir::Dirs | QDir::NoDotAndDotDot | QDir::Executable);
         foreach (QString s, entries) {
             if (s == m_widgetName && dir.cd(s)) {
                 ui->presetCombo->addItem("", "");
-                QStringList entries2 = dir.entryList(QDir::Files | QDir::Readable);
+                QStringList entries2 = cache.entries(dir.path(), QDir::Files | QDir::Readable);
                 foreach (QString s2, entries2)
                     ui->presetCombo->addItem(s2);
                 dir.cdUp();
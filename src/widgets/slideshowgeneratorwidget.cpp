@@ -161,29 +161,46 @@ Mlt::Playlist* SlideshowGeneratorWidget::getSlideshow()
     Mlt::Playlist* slideshow = new Mlt::Playlist(*m_clips->profile());
     Mlt::ClipInfo info;
 
-    // Copy clips
+    // Copy clips and add filters.
+    // Constructing each copy re-opens and probes its image file, which
+    // dominates for large slideshows, so build the copies and their filters
+    // across the thread pool, then append them in order.
+    struct Slide {
+        QString xml;
+        int frameIn;
+        Mlt::Producer* producer;
+    };
+    QVector<Slide> slides(count);
     for (int i = 0; i < count; i++)
     {
         Mlt::ClipInfo* c = m_clips->clip_info(i, &info);
+        slides[i].producer = nullptr;
         if (c)
         {
-            Mlt::Producer producer(*c->producer->profile(), "xml-string", MLT.XML(c->producer).toUtf8().constData());
-            slideshow->append(producer, c->frame_in, c->frame_in + framesPerClip - 1);
+            slides[i].xml = MLT.XML(c->producer);
+            slides[i].frameIn = c->frame_in;
         }
     }
-
-    // Add filters
-    if (config.zoomPercent > 0 || config.aspectConversion != ASPECT_CONVERSION_PAD_BLACK)
+    QtConcurrent::blockingMap(slides, [this, &config, framesPerClip](Slide& slide) {
+        if (slide.xml.isEmpty())
+            return;
+        slide.producer = new Mlt::Producer(*m_clips->profile(), "xml-string", slide.xml.toUtf8().constData());
+        if (!slide.producer->is_valid())
+            return;
+        if (config.zoomPercent > 0 || config.aspectConversion != ASPECT_CONVERSION_PAD_BLACK)
+        {
+            Mlt::Filter filter(*slide.producer->profile(), "affine");
+            applyAffineFilterProperties(&filter, config, slide.producer, slide.frameIn + framesPerClip - 1);
+            slide.producer->attach(filter);
+        }
+    });
+    foreach (const Slide& slide, slides)
     {
-        for (int i = 0; i < count; i++)
+        if (slide.producer)
         {
-            Mlt::ClipInfo* c = slideshow->clip_info(i, &info);
-            if (c)
-            {
-                Mlt::Filter filter(*c->producer->profile(), "affine");
-                applyAffineFilterProperties(&filter, config, c->producer, c->frame_in + framesPerClip - 1);
-                c->producer->attach(filter);
-            }
+            if (slide.producer->is_valid())
+                slideshow->append(*slide.producer, slide.frameIn, slide.frameIn + framesPerClip - 1);
+            delete slide.producer;
         }
     }
 
@@ -23,8 +23,24 @@
 #include <QFontDatabase>
 #include <QGuiApplication>
 
+static Mlt::Producer& fallbackProducer()
+{
+    // frames_to_time() only needs a producer for its profile's frame rate.
+    // Reuse one colour producer instead of constructing and probing a new
+    // one on every conversion while no producer is open.
+    static QScopedPointer<Mlt::Producer> producer;
+    static double fps = 0.0;
+    if (!producer || fps != MLT.profile().fps()) {
+        producer.reset(new Mlt::Producer(MLT.profile(), "colour"));
+        fps = MLT.profile().fps();
+    }
+    return *producer;
+}
+
 TimeSpinBox::TimeSpinBox(QWidget *parent)
     : QSpinBox(parent)
+    , m_cachedValue(-1)
+    , m_cachedFps(0.0)
 {
     setLineEdit(new TimeSpinBoxLineEdit);
     setRange(0, INT_MAX);
@@ -41,6 +57,10 @@ TimeSpinBox::TimeSpinBox(QWidget *parent)
 
 QValidator::State TimeSpinBox::validate(QString &input, int &pos) const
 {
+    // The common case during playback is our own formatted text echoed
+    // back by setValue(); skip the regex for it.
+    if (!m_cachedText.isEmpty() && input == m_cachedText)
+        return QValidator::Acceptable;
     return m_validator->validate(input, pos);
 }
 
@@ -49,19 +69,28 @@ int TimeSpinBox::valueFromText(const QString &text) const
     if (MLT.producer() && MLT.producer()->is_valid()) {
         return MLT.producer()->time_to_frames(text.toLatin1().constData());
     } else {
-        return Mlt::Producer(MLT.profile(), "colour").time_to_frames(text.toLatin1().constData());
+        return fallbackProducer().time_to_frames(text.toLatin1().constData());
     }
     return 0;
 }
 
 QString TimeSpinBox::textFromValue(int val) const
 {
+    // QSpinBox asks for the text several times per update (edit, size
+    // hints); format each value once per frame rate.
+    double fps = MLT.profile().fps();
+    if (val == m_cachedValue && fps == m_cachedFps && !m_cachedText.isEmpty())
+        return m_cachedText;
+    QString text;
     if (MLT.producer() && MLT.producer()->is_valid()) {
-        return MLT.producer()->frames_to_time(val);
+        text = MLT.producer()->frames_to_time(val);
     } else {
-        return Mlt::Producer(MLT.profile(), "colour").frames_to_time(val);
+        text = fallbackProducer().frames_to_time(val);
     }
-    return QString();
+    m_cachedValue = val;
+    m_cachedFps = fps;
+    m_cachedText = text;
+    return text;
 }
 
 void TimeSpinBox::keyPressEvent(QKeyEvent* event)
@@ -39,6 +39,11 @@ protected:
 
 private:
     QRegExpValidator* m_validator;
+    // Last formatted value; lets the per-frame position updates skip both
+    // the timecode formatting and the validator regex.
+    mutable int m_cachedValue;
+    mutable double m_cachedFps;
+    mutable QString m_cachedText;
 };
 
 class TimeSpinBoxLineEdit : public QLineEdit